@@ -657,6 +657,10 @@ bool CApplication::Create()
   CAEFactory::SetMute     (m_muted);
   CAEFactory::SetSoundMode(CSettings::GetInstance().GetInt(CSettings::SETTING_AUDIOOUTPUT_GUISOUNDMODE));
 
+  // the throughput of the engine is logged when it shuts down
+  if (g_advancedSettings.m_audioFreewheel)
+    CAEFactory::SetFreewheel(true, g_advancedSettings.m_audioFreewheelFile);
+
   // initialize m_replayGainSettings
   m_replayGainSettings.iType = CSettings::GetInstance().GetInt(CSettings::SETTING_MUSICPLAYER_REPLAYGAINTYPE);
   m_replayGainSettings.iPreAmp = CSettings::GetInstance().GetInt(CSettings::SETTING_MUSICPLAYER_REPLAYGAINPREAMP);
@@ -1876,7 +1880,7 @@ void CApplication::Render()
   // reset our info cache - we do this at the end of Render so that it is
   // fresh for the next process(), or after a windowclose animation (where process()
   // isn't called)
-  g_infoManager.ResetCache();
+  g_infoManager.ResetFrameCache();
 
   if (hasRendered)
   {
@@ -148,6 +148,10 @@ CGUIInfoManager::CGUIInfoManager(void) :
   m_playerShowTime = false;
   m_playerShowInfo = false;
   m_fps = 0.0f;
+  m_changedDependencies = DEPENDS_ALWAYS;
+  m_playerActive = false;
+  m_boolsEvaluated = 0;
+  m_boolsSkipped = 0;
   ResetLibraryBools();
 }
 
@@ -6583,6 +6587,101 @@ bool CGUIInfoManager::EvaluateBool(const std::string &expression, int contextWin
   return result;
 }
 
+unsigned int CGUIInfoManager::GetDependencies(int condition) const
+{
+  condition = abs(condition);
+
+  if (condition >= MULTI_INFO_START && condition <= MULTI_INFO_END)
+  {
+    const GUIInfo &info = m_multiInfo[condition - MULTI_INFO_START];
+    switch (abs(info.m_info))
+    {
+      case SKIN_BOOL:
+      case SKIN_STRING:
+        return DEPENDS_SKIN;
+      case LIBRARY_HAS_ROLE:
+        return DEPENDS_LIBRARY;
+      case STRING_IS_EMPTY:
+      case STRING_STARTS_WITH:
+      case STRING_ENDS_WITH:
+      case STRING_CONTAINS:
+      case INTEGER_IS_EQUAL:
+      case INTEGER_GREATER_THAN:
+      case INTEGER_GREATER_OR_EQUAL:
+      case INTEGER_LESS_THAN:
+      case INTEGER_LESS_OR_EQUAL:
+        return GetLabelDependencies(info.GetData1());
+      case STRING_IS_EQUAL:
+        if (info.GetData2() < 0) // info labels are stored with negative numbers
+          return GetLabelDependencies(info.GetData1()) | GetLabelDependencies(-info.GetData2());
+        return GetLabelDependencies(info.GetData1());
+    }
+    return DEPENDS_ALWAYS;
+  }
+
+  // everything in the player section of GetBool() is false while nothing is playing
+  if (condition >= PLAYER_HAS_MEDIA && condition <= PLAYER_DISPLAY_AFTER_SEEK)
+    return DEPENDS_PLAYER;
+
+  switch (condition)
+  {
+    case SYSTEM_ALWAYS_TRUE:
+    case SYSTEM_ALWAYS_FALSE:
+    case SYSTEM_ETHERNET_LINK_ACTIVE:
+    case SYSTEM_PLATFORM_LINUX:
+    case SYSTEM_PLATFORM_LINUX_RASPBERRY_PI:
+    case SYSTEM_PLATFORM_WINDOWS:
+    case SYSTEM_PLATFORM_DARWIN:
+    case SYSTEM_PLATFORM_DARWIN_OSX:
+    case SYSTEM_PLATFORM_DARWIN_IOS:
+    case SYSTEM_PLATFORM_ANDROID:
+      return DEPENDS_NONE;
+    case LIBRARY_HAS_MUSIC:
+    case LIBRARY_HAS_VIDEO:
+    case LIBRARY_HAS_MOVIES:
+    case LIBRARY_HAS_MOVIE_SETS:
+    case LIBRARY_HAS_TVSHOWS:
+    case LIBRARY_HAS_MUSICVIDEOS:
+    case LIBRARY_HAS_SINGLES:
+    case LIBRARY_HAS_COMPILATIONS:
+      return DEPENDS_LIBRARY;
+    case PLAYER_SEEKBAR:
+    case PLAYER_SEEKING:
+    case PLAYER_SHOWTIME:
+    case PLAYER_HASDURATION:
+    case PLAYER_CAN_PAUSE:
+    case PLAYER_CAN_SEEK:
+    case PLAYER_PASSTHROUGH:
+    case PLAYER_ISINTERNETSTREAM:
+    case VIDEOPLAYER_HASMENU:
+    case VIDEOPLAYER_ISFULLSCREEN:
+    case VIDEOPLAYER_HASSUBTITLES:
+    case VIDEOPLAYER_SUBTITLESENABLED:
+    case VIDEOPLAYER_HASTELETEXT:
+    case VIDEOPLAYER_HAS_EPG:
+    case VIDEOPLAYER_IS_STEREOSCOPIC:
+    case MUSICPLAYER_HASPREVIOUS:
+    case MUSICPLAYER_HASNEXT:
+    case MUSICPLAYER_PLAYLISTPLAYING:
+      return DEPENDS_PLAYER;
+  }
+  return DEPENDS_ALWAYS;
+}
+
+unsigned int CGUIInfoManager::GetLabelDependencies(int info) const
+{
+  if (info >= MULTI_INFO_START && info <= MULTI_INFO_END)
+  {
+    const GUIInfo &multiInfo = m_multiInfo[info - MULTI_INFO_START];
+    if (multiInfo.m_info == SKIN_STRING || multiInfo.m_info == SKIN_BOOL)
+      return DEPENDS_SKIN;
+    // properties of the active window change along with the window
+    if (multiInfo.m_info == WINDOW_PROPERTY && multiInfo.GetData1())
+      return DEPENDS_WINDOW;
+  }
+  return DEPENDS_ALWAYS;
+}
+
 // checks the condition and returns it as necessary.  Currently used
 // for toggle button controls and visibility of images.
 bool CGUIInfoManager::GetBool(int condition1, int contextWindow, const CGUIListItem *item)
@@ -9051,9 +9150,13 @@ void CGUIInfoManager::Clear()
     m_bools.erase(i, m_bools.end());
     i = std::remove_if(m_bools.begin(), m_bools.end(), std::mem_fun_ref(&InfoPtr::unique));
   }
-  // log which ones are used - they should all be gone by now
+  // log which ones are used - they should all be gone by now. The skin settings
+  // they may depend on go with the skin, so make sure they get updated.
   for (std::vector<InfoPtr>::const_iterator i = m_bools.begin(); i != m_bools.end(); ++i)
+  {
     CLog::Log(LOGDEBUG, "Infobool '%s' still used by %u instances", (*i)->GetExpression().c_str(), (unsigned int) i->use_count());
+    (*i)->SetDirty();
+  }
 }
 
 void CGUIInfoManager::UpdateFPS()
@@ -10370,6 +10473,38 @@ void CGUIInfoManager::ResetCache()
     (*i)->SetDirty();
 }
 
+void CGUIInfoManager::ResetFrameCache()
+{
+  // reset any animation triggers as well
+  m_containerMoves.clear();
+
+  // player state is polled, so anything depending on it is refreshed while
+  // playing and once more after playback finished
+  bool playerActive = g_application.m_pPlayer->IsPlaying();
+  unsigned int changed = m_changedDependencies.exchange(DEPENDS_NONE) | DEPENDS_ALWAYS;
+  if (playerActive || m_playerActive)
+    changed |= DEPENDS_PLAYER;
+  m_playerActive = playerActive;
+
+  CSingleLock lock(m_critInfo);
+  m_boolsEvaluated = 0;
+  m_boolsSkipped = 0;
+  for (std::vector<InfoPtr>::iterator i = m_bools.begin(); i != m_bools.end(); ++i)
+  {
+    bool dirty = (*i)->IsDirty();
+    if ((*i)->Invalidate(changed))
+      m_boolsEvaluated++;
+    else if (!dirty)
+      m_boolsSkipped++;
+  }
+}
+
+void CGUIInfoManager::GetBoolStats(unsigned int &evaluated, unsigned int &skipped) const
+{
+  evaluated = m_boolsEvaluated;
+  skipped = m_boolsSkipped;
+}
+
 std::string CGUIInfoManager::GetPictureLabel(int info)
 {
   if (info == SLIDE_FILE_NAME)
@@ -10537,6 +10672,7 @@ void CGUIInfoManager::SetLibraryBool(int condition, bool value)
     default:
       break;
   }
+  NotifyChanged(DEPENDS_LIBRARY);
 }
 
 void CGUIInfoManager::ResetLibraryBools()
@@ -10549,6 +10685,7 @@ void CGUIInfoManager::ResetLibraryBools()
   m_libraryHasSingles = -1;
   m_libraryHasCompilations = -1;
   m_libraryRoleCounts.clear();
+  NotifyChanged(DEPENDS_LIBRARY);
 }
 
 bool CGUIInfoManager::GetLibraryBool(int condition)
@@ -38,6 +38,7 @@
 #include "cores/IPlayer.h"
 #include "FileItem.h"
 
+#include <atomic>
 #include <list>
 #include <map>
 
@@ -211,7 +212,29 @@ public:
   void SetNextWindow(int windowID) { m_nextWindowID = windowID; };
   void SetPreviousWindow(int windowID) { m_prevWindowID = windowID; };
 
+  /*! \brief Set all info bools dirty, regardless of their dependencies
+   \sa ResetFrameCache
+   */
   void ResetCache();
+
+  /*! \brief Set those info bools dirty whose dependencies changed since the last call
+   Called once per frame. Info bools depending on anything that isn't tracked are always set dirty.
+   \sa NotifyChanged
+   */
+  void ResetFrameCache();
+
+  /*! \brief Notify that inputs of info bools changed
+   Safe to call from any thread, takes effect on the next ResetFrameCache().
+   \param dependencies the INFO::InfoDependency flags that changed
+   */
+  void NotifyChanged(unsigned int dependencies) { m_changedDependencies |= dependencies; }
+
+  /*! \brief Get the info bool statistics of the last frame
+   \param evaluated number of info bools that were evaluated
+   \param skipped number of info bools that were kept as their dependencies didn't change
+   */
+  void GetBoolStats(unsigned int &evaluated, unsigned int &skipped) const;
+
   bool GetItemInt(int &value, const CGUIListItem *item, int info) const;
   std::string GetItemLabel(const CFileItem *item, int info, std::string *fallback = NULL);
   std::string GetItemImage(const CFileItem *item, int info, std::string *fallback = NULL);
@@ -246,6 +269,11 @@ protected:
   bool GetBool(int condition, int contextWindow = 0, const CGUIListItem *item=NULL);
   int TranslateSingleString(const std::string &strCondition, bool &listItemDependent);
 
+  /*! \brief Get the INFO::InfoDependency flags of a translated condition
+   */
+  unsigned int GetDependencies(int condition) const;
+  unsigned int GetLabelDependencies(int info) const;
+
   // routines for window retrieval
   bool CheckWindowCondition(CGUIWindow *window, int condition) const;
   CGUIWindow *GetWindowWithCondition(int contextWindow, int condition) const;
@@ -335,6 +363,10 @@ protected:
   int m_prevWindowID;
 
   std::vector<INFO::InfoPtr> m_bools;
+  std::atomic<unsigned int> m_changedDependencies;
+  bool m_playerActive;
+  unsigned int m_boolsEvaluated;
+  unsigned int m_boolsSkipped;
   std::vector<INFO::CSkinVariableString> m_skinVariableStrings;
 
   int m_libraryHasMusic;
@@ -34,6 +34,7 @@
 #include "settings/lib/Setting.h"
 #include "utils/log.h"
 #include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
 #include "utils/URIUtils.h"
 #include "utils/XMLUtils.h"
 #include "utils/Variant.h"
@@ -290,6 +291,30 @@ void CSkinInfo::ResolveIncludes(TiXmlElement *node, std::map<INFO::InfoPtr, bool
   m_includes.ResolveIncludes(node, xmlIncludeConditions);
 }
 
+void CSkinInfo::ResolveWindowIncludes(TiXmlElement *node, const std::string &path, std::map<INFO::InfoPtr, bool> &xmlIncludeConditions, float parseTime)
+{
+  int64_t start = CurrentHostCounter();
+  size_t preloaded = m_includes.GetFiles().size();
+  ResolveIncludes(node, &xmlIncludeConditions);
+  float resolveTime = 1000.f * (CurrentHostCounter() - start) / CurrentHostFrequency();
+
+  CLog::Log(LOGDEBUG, "Parsed %s in %.2fms, resolved includes in %.2fms", path.c_str(), parseTime, resolveTime);
+  CGUIWindowCache::Save(path, node, m_includes, preloaded, xmlIncludeConditions, parseTime + resolveTime);
+}
+
+TiXmlElement* CSkinInfo::LoadCachedWindow(CGUIWindowCache::Entry &entry, std::map<INFO::InfoPtr, bool> &xmlIncludeConditions)
+{
+  int64_t start = CurrentHostCounter();
+  TiXmlElement *node = CGUIWindowCache::Load(entry, m_includes, xmlIncludeConditions);
+  if (node)
+  {
+    float checkTime = 1000.f * (CurrentHostCounter() - start) / CurrentHostFrequency();
+    CLog::Log(LOGDEBUG, "Loaded %s from skin cache in %.2fms (%.2fms reading, %.2fms checking), parsing and resolving took %.2fms",
+              entry.path.c_str(), entry.readTime + checkTime, entry.readTime, checkTime, entry.loadTime);
+  }
+  return node;
+}
+
 int CSkinInfo::GetStartWindow() const
 {
   int windowID = CSettings::GetInstance().GetInt(CSettings::SETTING_LOOKANDFEEL_STARTUPWINDOW);
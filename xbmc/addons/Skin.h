@@ -28,6 +28,7 @@
 #include "addons/Addon.h"
 #include "guilib/GraphicContext.h" // needed for the RESOLUTION members
 #include "guilib/GUIIncludes.h"    // needed for the GUIInclude member
+#include "guilib/GUIWindowCache.h"
 
 #define CREDIT_LINE_LENGTH 50
 
@@ -164,6 +165,21 @@ public:
 
   void ResolveIncludes(TiXmlElement *node, std::map<INFO::InfoPtr, bool>* xmlIncludeConditions = NULL);
 
+  /*! \brief Resolve the includes of a window and store the result in the skin cache
+   \param node root element of the window as loaded from path
+   \param path the window file
+   \param xmlIncludeConditions [out] the include conditions used to resolve the window
+   \param parseTime time in ms it took to parse the window file
+   */
+  void ResolveWindowIncludes(TiXmlElement *node, const std::string &path, std::map<INFO::InfoPtr, bool> &xmlIncludeConditions, float parseTime);
+
+  /*! \brief Load a window with its includes resolved from an entry of the skin cache
+   \param entry the entry read for the window by CGUIWindowCache::Read()
+   \param xmlIncludeConditions [out] the include conditions the window depends on
+   \return the root element or NULL if the entry is out of date. Must be deleted by the caller.
+   */
+  TiXmlElement* LoadCachedWindow(CGUIWindowCache::Entry &entry, std::map<INFO::InfoPtr, bool> &xmlIncludeConditions);
+
   float GetEffectsSlowdown() const { return m_effectsSlowDown; };
 
   const std::vector<CStartupWindow> &GetStartupWindows() const { return m_startupWindows; };
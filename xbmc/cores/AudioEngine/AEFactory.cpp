@@ -404,3 +404,24 @@ void CAEFactory::DeviceChange()
   if (AE)
     AE->DeviceChange();
 }
+
+bool CAEFactory::GetBufferStats(AEBufferStats &stats)
+{
+  if (AE)
+    return AE->GetBufferStats(stats);
+  return false;
+}
+
+bool CAEFactory::SetFreewheel(bool enable, const std::string &file)
+{
+  if (AE)
+    return AE->SetFreewheel(enable, file);
+  return false;
+}
+
+bool CAEFactory::GetRenderStats(AERenderStats &stats)
+{
+  if (AE)
+    return AE->GetRenderStats(stats);
+  return false;
+}
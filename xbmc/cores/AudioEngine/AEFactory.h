@@ -71,6 +71,9 @@ public:
   static bool IsSettingVisible(const std::string &condition, const std::string &value, const CSetting *setting, void *data);
   static void KeepConfiguration(unsigned int millis);
   static void DeviceChange();
+  static bool GetBufferStats(AEBufferStats &stats);
+  static bool SetFreewheel(bool enable, const std::string &file = "");
+  static bool GetRenderStats(AERenderStats &stats);
 
   static void RegisterAudioCallback(IAudioCallback* pCallback);
   static void UnregisterAudioCallback(IAudioCallback* pCallback);
@@ -20,6 +20,7 @@
 
 #include "AEResampleFactory.h"
 #include "cores/AudioEngine/Engines/ActiveAE/ActiveAEResampleFFMPEG.h"
+#include "cores/AudioEngine/Engines/ActiveAE/ActiveAEResamplePolyphase.h"
 #if defined(TARGET_RASPBERRY_PI)
   #include "settings/Settings.h"
   #include "cores/AudioEngine/Engines/ActiveAE/ActiveAEResamplePi.h"
@@ -28,12 +29,17 @@
 namespace ActiveAE
 {
 
-IAEResample *CAEResampleFactory::Create(uint32_t flags /* = 0 */)
+IAEResample *CAEResampleFactory::Create(uint32_t flags /* = 0 */, AEQuality quality /* = AE_QUALITY_UNKNOWN */)
 {
 #if defined(TARGET_RASPBERRY_PI)
   if (!(flags & AERESAMPLEFACTORY_QUICK_RESAMPLE) && CSettings::GetInstance().GetInt(CSettings::SETTING_AUDIOOUTPUT_PROCESSQUALITY) == AE_QUALITY_GPU)
     return new CActiveAEResamplePi();
 #endif
+  // low quality stays with swresample, above that the polyphase filters
+  // pay off and allow for cheap ratio changes
+  if (!(flags & AERESAMPLEFACTORY_QUICK_RESAMPLE) &&
+      (quality == AE_QUALITY_MID || quality == AE_QUALITY_HIGH || quality == AE_QUALITY_REALLYHIGH))
+    return new CActiveAEResamplePolyphase();
   return new CActiveAEResampleFFMPEG();
 }
 
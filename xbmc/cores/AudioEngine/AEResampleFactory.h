@@ -38,7 +38,11 @@ enum AEResampleFactoryOptions
 class CAEResampleFactory
 {
 public:
-  static IAEResample *Create(uint32_t flags = 0U);
+  /**
+   * Creates a resampler, quality selects the implementation where several
+   * are available. The same quality should be passed to IAEResample::Init.
+   */
+  static IAEResample *Create(uint32_t flags = 0U, AEQuality quality = AE_QUALITY_UNKNOWN);
 };
 
 }
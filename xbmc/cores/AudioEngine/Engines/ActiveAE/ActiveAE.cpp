@@ -23,16 +23,20 @@
 using namespace ActiveAE;
 #include "ActiveAESound.h"
 #include "ActiveAEStream.h"
+#include "ActiveAEZone.h"
 #include "cores/AudioEngine/DSPAddons/ActiveAEDSP.h"
 #include "cores/AudioEngine/DSPAddons/ActiveAEDSPProcess.h"
 #include "cores/AudioEngine/Utils/AEUtil.h"
+#include "cores/AudioEngine/Utils/AEMixKernels.h"
 #include "cores/AudioEngine/Utils/AEStreamInfo.h"
 #include "cores/AudioEngine/AEResampleFactory.h"
 #include "cores/AudioEngine/Encoders/AEEncoderFFmpeg.h"
 
+#include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "windowing/WindowingFactory.h"
 #include "utils/log.h"
+#include "utils/TimeUtils.h"
 
 #define MAX_CACHE_LEVEL 0.4   // total cache time of stream in seconds
 #define MAX_WATER_LEVEL 0.2   // buffered time after stream stages in seconds
@@ -287,6 +291,8 @@ CActiveAE::CActiveAE() :
   m_aeGUISoundForce = false;
   m_stats.Reset(44100, true);
   m_streamIdGen = 0;
+  m_settings.freewheel = false;
+  m_freewheel = false;
 }
 
 CActiveAE::~CActiveAE()
@@ -305,7 +311,15 @@ void CActiveAE::Dispose()
   StopThread();
   m_controlPort.Purge();
   m_dataPort.Purge();
+  if (m_settings.freewheel)
+    LogRenderStats();
   m_sink.Dispose();
+
+  for (auto zone : m_zones)
+    delete zone;
+  m_zones.clear();
+
+  m_bufferCache.Clear();
 }
 
 //-----------------------------------------------------------------------------
@@ -1090,6 +1104,14 @@ void CActiveAE::Configure(AEAudioFormat *desiredFmt)
   AEAudioFormat oldInternalFormat = m_internalFormat;
   AEAudioFormat oldSinkRequestFormat = m_sinkRequestFormat;
 
+  // the zones have to exist before InitSink(), it leaves the volume to the
+  // engine when there are any
+  if (m_zones.empty())
+  {
+    for (auto &setting : g_advancedSettings.m_audioZones)
+      m_zones.push_back(new CActiveAEZone(setting.device, setting.latency, &m_outMsgEvent));
+  }
+
   inputFormat = GetInputFormat(desiredFmt);
 
   m_sinkRequestFormat = inputFormat;
@@ -1350,6 +1372,18 @@ void CActiveAE::Configure(AEAudioFormat *desiredFmt)
     m_sinkBuffers->Create(MAX_WATER_LEVEL*1000, true, false);
   }
 
+  // measure the processing stages while freewheeling
+  CActiveAEStageStats *stageStats = m_settings.freewheel ? &m_stageStats : NULL;
+  for (auto stream : m_streams)
+  {
+    if (stream->m_resampleBuffers)
+      stream->m_resampleBuffers->m_stageStats = stageStats;
+  }
+  m_sinkBuffers->m_stageStats = stageStats;
+  m_sinkBuffers->m_resampleStage = AE_STAGE_SINK;
+
+  ConfigureZones();
+
   // reset gui sounds
   if (!CompareFormat(oldInternalFormat, m_internalFormat))
   {
@@ -1503,6 +1537,9 @@ void CActiveAE::FlushEngine()
     m_extError = true;
   }
   m_stats.Reset(m_sinkFormat.m_sampleRate, m_mode == MODE_PCM);
+
+  for (auto zone : m_zones)
+    zone->Flush();
 }
 
 void CActiveAE::ClearDiscardedBuffers()
@@ -1738,11 +1775,45 @@ bool CActiveAE::NeedReconfigureSink()
   return false;
 }
 
+void CActiveAE::ConfigureZones()
+{
+  // zones play the mix, there is none for passthrough
+  if (m_mode == MODE_RAW || m_settings.freewheel)
+  {
+    UnconfigureZones();
+    return;
+  }
+
+  for (auto zone : m_zones)
+  {
+    if (!zone->Configure(m_internalFormat, m_settings.resampleQuality, m_sink))
+      zone->Unconfigure();
+  }
+}
+
+void CActiveAE::UnconfigureZones()
+{
+  for (auto zone : m_zones)
+    zone->Unconfigure();
+}
+
+void CActiveAE::FeedZones(CSampleBuffer *samples)
+{
+  // time until the main sink plays what is mixed now
+  AEDelayStatus status;
+  m_stats.GetDelay(status);
+  double delay = status.GetDelay() + m_stats.GetSinkLatency();
+
+  for (auto zone : m_zones)
+    zone->AddSamples(samples, delay);
+}
+
 bool CActiveAE::InitSink()
 {
   SinkConfig config;
   config.format = m_sinkRequestFormat;
   config.stats = &m_stats;
+  config.stageStats = m_settings.freewheel ? &m_stageStats : NULL;
   config.device = (m_sinkRequestFormat.m_dataFormat == AE_FMT_RAW) ? &m_settings.passthoughdevice :
                                                                      &m_settings.device;
 
@@ -1766,7 +1837,8 @@ bool CActiveAE::InitSink()
     if (data)
     {
       m_sinkFormat = data->format;
-      m_sinkHasVolume = data->hasVolume;
+      // with zones the engine applies the volume, so that all outputs follow it
+      m_sinkHasVolume = data->hasVolume && m_zones.empty();
       m_stats.SetSinkCacheTotal(data->cacheTotal);
       m_stats.SetSinkLatency(data->latency);
       m_stats.SetCurrentSinkFormat(m_sinkFormat);
@@ -1837,6 +1909,8 @@ void CActiveAE::UnconfigureSink()
     m_extError = true;
   }
 
+  UnconfigureZones();
+
   // make sure we open sink on next configure
   m_currDevice = "";
 
@@ -1921,7 +1995,7 @@ bool CActiveAE::RunStages()
       if ((*it)->m_paused || !(*it)->m_started || !(*it)->m_resampleBuffers || !(*it)->m_pClock)
         continue;
 
-      if ((*it)->m_resampleBuffers->m_outputSamples.empty())
+      if ((*it)->m_resampleBuffers->m_outputSamples.empty() || m_settings.freewheel)
         continue;
 
       CSampleBuffer *buf = (*it)->m_resampleBuffers->m_outputSamples.front();
@@ -1969,7 +2043,12 @@ bool CActiveAE::RunStages()
           allStreamsReady = false;
       }
 
-      bool needClamp = false;
+      // work out the gains of all streams first and mix them
+      // in a single pass over the output buffer
+      int64_t mixStart = m_settings.freewheel ? CurrentHostCounter() : 0;
+      int64_t mixTicks = 0;
+      m_mixStreams.clear();
+      bool outIsStream = false;
       for (it = m_streams.begin(); it != m_streams.end() && allStreamsReady; ++it)
       {
         if ((*it)->m_paused || !(*it)->m_resampleBuffers)
@@ -1988,173 +2067,24 @@ bool CActiveAE::RunStages()
 
           (*it)->m_started = true;
 
+          CSampleBuffer *buf = (*it)->m_resampleBuffers->m_outputSamples.front();
+          (*it)->m_resampleBuffers->m_outputSamples.pop_front();
+
           if (!out)
           {
-            out = (*it)->m_resampleBuffers->m_outputSamples.front();
-            (*it)->m_resampleBuffers->m_outputSamples.pop_front();
-
-            int nb_floats = out->pkt->nb_samples * out->pkt->config.channels / out->pkt->planes;
-            int nb_loops = 1;
-            float fadingStep = 0.0f;
-
-            // fading
-            if ((*it)->m_fadingSamples == -1)
-            {
-              (*it)->m_fadingSamples = m_internalFormat.m_sampleRate * (float)(*it)->m_fadingTime / 1000.0f;
-              if ((*it)->m_fadingSamples > 0)
-                (*it)->m_volume = (*it)->m_fadingBase;
-              else
-              {
-                (*it)->m_volume = (*it)->m_fadingTarget;
-                CSingleLock lock((*it)->m_streamLock);
-                (*it)->m_streamFading = false;
-              }
-            }
-            if ((*it)->m_fadingSamples > 0)
-            {
-              nb_floats = out->pkt->config.channels / out->pkt->planes;
-              nb_loops = out->pkt->nb_samples;
-              float delta = (*it)->m_fadingTarget - (*it)->m_fadingBase;
-              int samples = m_internalFormat.m_sampleRate * (float)(*it)->m_fadingTime / 1000.0f;
-              fadingStep = delta / samples;
-            }
-
-            // for stream amplification, 
-            // turned off downmix normalization,
-            // or if sink format is float (in order to prevent from clipping)
-            // we need to run on a per sample basis
-            if ((*it)->m_amplify != 1.0 || !(*it)->m_resampleBuffers->m_normalize || (m_sinkFormat.m_dataFormat == AE_FMT_FLOAT))
-            {
-              nb_floats = out->pkt->config.channels / out->pkt->planes;
-              nb_loops = out->pkt->nb_samples;
-            }
-
-            for(int i=0; i<nb_loops; i++)
-            {
-              if ((*it)->m_fadingSamples > 0)
-              {
-                (*it)->m_volume += fadingStep;
-                (*it)->m_fadingSamples--;
-
-                if ((*it)->m_fadingSamples == 0)
-                {
-                  // set variables being polled via stream interface
-                  CSingleLock lock((*it)->m_streamLock);
-                  (*it)->m_streamFading = false;
-                }
-              }
-
-              // volume for stream
-              float volume = (*it)->m_volume * (*it)->m_rgain;
-              if(nb_loops > 1)
-                volume *= (*it)->m_limiter.Run((float**)out->pkt->data, out->pkt->config.channels, i*nb_floats, out->pkt->planes > 1);
-
-              for(int j=0; j<out->pkt->planes; j++)
-              {
-#ifdef __SSE__
-                CAEUtil::SSEMulArray((float*)out->pkt->data[j]+i*nb_floats, volume, nb_floats);
-#else
-                float* fbuffer = (float*) out->pkt->data[j]+i*nb_floats;
-                for (int k = 0; k < nb_floats; ++k)
-                {
-                  fbuffer[k] *= volume;
-                }
-#endif
-              }
-            }
+            out = buf;
+            outIsStream = true;
           }
-          else
-          {
-            CSampleBuffer *mix = NULL;
-            mix = (*it)->m_resampleBuffers->m_outputSamples.front();
-            (*it)->m_resampleBuffers->m_outputSamples.pop_front();
-
-            int nb_floats = mix->pkt->nb_samples * mix->pkt->config.channels / mix->pkt->planes;
-            int nb_loops = 1;
-            float fadingStep = 0.0f;
 
-            // fading
-            if ((*it)->m_fadingSamples == -1)
-            {
-              (*it)->m_fadingSamples = m_internalFormat.m_sampleRate * (float)(*it)->m_fadingTime / 1000.0f;
-              (*it)->m_volume = (*it)->m_fadingBase;
-            }
-            if ((*it)->m_fadingSamples > 0)
-            {
-              nb_floats = mix->pkt->config.channels / mix->pkt->planes;
-              nb_loops = mix->pkt->nb_samples;
-              float delta = (*it)->m_fadingTarget - (*it)->m_fadingBase;
-              int samples = m_internalFormat.m_sampleRate * (float)(*it)->m_fadingTime / 1000.0f;
-              fadingStep = delta / samples;
-            }
-
-            // for streams amplification of turned off downmix normalization
-            // we need to run on a per sample basis
-            if ((*it)->m_amplify != 1.0 || !(*it)->m_resampleBuffers->m_normalize)
-            {
-              nb_floats = out->pkt->config.channels / out->pkt->planes;
-              nb_loops = out->pkt->nb_samples;
-            }
-
-            for(int i=0; i<nb_loops; i++)
-            {
-              if ((*it)->m_fadingSamples > 0)
-              {
-                (*it)->m_volume += fadingStep;
-                (*it)->m_fadingSamples--;
-
-                if ((*it)->m_fadingSamples == 0)
-                {
-                  // set variables being polled via stream interface
-                  CSingleLock lock((*it)->m_streamLock);
-                  (*it)->m_streamFading = false;
-                }
-              }
-
-              // volume for stream
-              float volume = (*it)->m_volume * (*it)->m_rgain;
-              if(nb_loops > 1)
-                volume *= (*it)->m_limiter.Run((float**)mix->pkt->data, mix->pkt->config.channels, i*nb_floats, mix->pkt->planes > 1);
-
-              for(int j=0; j<out->pkt->planes && j<mix->pkt->planes; j++)
-              {
-                float *dst = (float*)out->pkt->data[j]+i*nb_floats;
-                float *src = (float*)mix->pkt->data[j]+i*nb_floats;
-#ifdef __SSE__
-                CAEUtil::SSEMulAddArray(dst, src, volume, nb_floats);
-                for (int k = 0; k < nb_floats; ++k)
-                {
-                  if (fabs(dst[k]) > 1.0f)
-                  {
-                    needClamp = true;
-                    break;
-                  }
-                }
-#else
-                for (int k = 0; k < nb_floats; ++k)
-                {
-                  dst[k] += src[k] * volume;
-                  if (fabs(dst[k]) > 1.0f)
-                    needClamp = true;
-                }
-#endif
-              }
-            }
-            mix->Return();
-          }
+          PrepareMixStream(*it, buf);
           busy = true;
         }
       }// for
 
-      // finally clamp samples
-      if(out && needClamp)
-      {
-        int nb_floats = out->pkt->nb_samples * out->pkt->config.channels / out->pkt->planes;
-        for(int i=0; i<out->pkt->planes; i++)
-        {
-          CAEUtil::ClampArray((float*)out->pkt->data[i], nb_floats);
-        }
-      }
+      if (out && !m_mixStreams.empty())
+        MixStreams(out, outIsStream);
+      if (m_settings.freewheel)
+        mixTicks = CurrentHostCounter() - mixStart;
 
       // process output buffer, gui sounds, encode, viz
       if (out)
@@ -2212,15 +2142,25 @@ bool CActiveAE::RunStages()
         }
 
         // mix gui sounds
+        if (m_settings.freewheel)
+          mixStart = CurrentHostCounter();
         MixSounds(*(out->pkt));
         if (!m_sinkHasVolume || m_muted)
           Deamplify(*(out->pkt));
+        if (m_settings.freewheel)
+          m_stageStats.Add(AE_STAGE_MIX, out->pkt->nb_samples, mixTicks + CurrentHostCounter() - mixStart);
+
+        if (!m_zones.empty())
+          FeedZones(out);
 
         if (m_mode == MODE_TRANSCODE && m_encoder)
         {
           CSampleBuffer *buf = m_encoderBuffers->GetFreeBuffer();
+          int64_t encodeStart = m_settings.freewheel ? CurrentHostCounter() : 0;
           buf->pkt->nb_samples = m_encoder->Encode(out->pkt->data[0], out->pkt->planes*out->pkt->linesize,
                                                    buf->pkt->data[0], buf->pkt->planes*buf->pkt->linesize);
+          if (m_settings.freewheel)
+            m_stageStats.Add(AE_STAGE_ENCODE, out->pkt->nb_samples, CurrentHostCounter() - encodeStart);
 
           // set pts of last sample
           buf->pkt_start_offset = buf->pkt->nb_samples;
@@ -2264,6 +2204,10 @@ bool CActiveAE::RunStages()
     }
   }
 
+  // serve zones
+  for (auto zone : m_zones)
+    busy |= zone->Process();
+
   // serve sink buffers
   busy |= m_sinkBuffers->ResampleBuffers();
   while(!m_sinkBuffers->m_outputSamples.empty())
@@ -2306,7 +2250,8 @@ CSampleBuffer* CActiveAE::SyncStream(CActiveAEStream *stream)
 {
   CSampleBuffer *ret = NULL;
 
-  if (!stream->m_pClock)
+  // there is no clock to follow while freewheeling
+  if (!stream->m_pClock || m_settings.freewheel)
     return ret;
 
   if (stream->m_syncState == CAESyncInfo::AESyncState::SYNC_START)
@@ -2483,11 +2428,181 @@ CSampleBuffer* CActiveAE::SyncStream(CActiveAEStream *stream)
   return ret;
 }
 
+void CActiveAE::PrepareMixStream(CActiveAEStream *stream, CSampleBuffer *buffer)
+{
+  size_t index = m_mixStreams.size();
+  if (m_mixGains.size() <= index)
+    m_mixGains.resize(index + 1);
+
+  MixStream mix;
+  mix.buffer = buffer;
+  mix.gain = 1.0f;
+  mix.perSample = false;
+
+  float fadingStep = 0.0f;
+
+  // fading
+  if (stream->m_fadingSamples == -1)
+  {
+    stream->m_fadingSamples = m_internalFormat.m_sampleRate * (float)stream->m_fadingTime / 1000.0f;
+    if (stream->m_fadingSamples > 0)
+      stream->m_volume = stream->m_fadingBase;
+    else
+    {
+      stream->m_volume = stream->m_fadingTarget;
+      CSingleLock lock(stream->m_streamLock);
+      stream->m_streamFading = false;
+    }
+  }
+  if (stream->m_fadingSamples > 0)
+  {
+    float delta = stream->m_fadingTarget - stream->m_fadingBase;
+    int samples = m_internalFormat.m_sampleRate * (float)stream->m_fadingTime / 1000.0f;
+    fadingStep = delta / samples;
+    mix.perSample = true;
+  }
+
+  // for stream amplification,
+  // turned off downmix normalization,
+  // or if sink format is float (in order to prevent from clipping)
+  // we need to run on a per sample basis
+  if (stream->m_amplify != 1.0 || !stream->m_resampleBuffers->m_normalize || (m_sinkFormat.m_dataFormat == AE_FMT_FLOAT))
+    mix.perSample = true;
+
+  if (!mix.perSample)
+  {
+    mix.gain = stream->m_volume * stream->m_rgain;
+    m_mixStreams.push_back(mix);
+    return;
+  }
+
+  const CAEMixKernels::Kernels &kernels = CAEMixKernels::Get();
+  int frames = buffer->pkt->nb_samples;
+  int planes = buffer->pkt->planes;
+  int channels = buffer->pkt->config.channels;
+  int floats = channels / planes;
+
+  // largest magnitude of each frame for the limiter
+  m_mixPeaks.assign(frames, 0.0f);
+  if (planes > 1)
+  {
+    for (int j = 0; j < planes; j++)
+      kernels.maxAbs(m_mixPeaks.data(), (float*)buffer->pkt->data[j], frames);
+  }
+  else
+  {
+    float *data = (float*)buffer->pkt->data[0];
+    for (int i = 0; i < frames; i++, data += channels)
+    {
+      float highest = 0.0f;
+      for (int k = 0; k < channels; k++)
+        highest = std::max(highest, fabsf(data[k]));
+      m_mixPeaks[i] = highest;
+    }
+  }
+
+  std::vector<float> &gains = m_mixGains[index];
+  gains.resize(frames * floats);
+  float *gain = gains.data();
+  for (int i = 0; i < frames; i++)
+  {
+    if (stream->m_fadingSamples > 0)
+    {
+      stream->m_volume += fadingStep;
+      stream->m_fadingSamples--;
+
+      if (stream->m_fadingSamples == 0)
+      {
+        // set variables being polled via stream interface
+        CSingleLock lock(stream->m_streamLock);
+        stream->m_streamFading = false;
+      }
+    }
+
+    // volume for stream
+    float volume = stream->m_volume * stream->m_rgain;
+    volume *= stream->m_limiter.Run(m_mixPeaks[i]);
+
+    for (int k = 0; k < floats; k++)
+      *gain++ = volume;
+  }
+
+  m_mixStreams.push_back(mix);
+}
+
+CAEMixKernels::MixSource CActiveAE::GetMixSource(size_t stream, int plane)
+{
+  CAEMixKernels::MixSource src;
+  src.data = (float*)m_mixStreams[stream].buffer->pkt->data[plane];
+  src.gains = m_mixStreams[stream].perSample ? m_mixGains[stream].data() : nullptr;
+  src.gain = m_mixStreams[stream].gain;
+  return src;
+}
+
+void CActiveAE::MixStreams(CSampleBuffer *out, bool outIsStream)
+{
+  const CAEMixKernels::Kernels &kernels = CAEMixKernels::Get();
+  int outFloats = out->pkt->nb_samples * out->pkt->config.channels / out->pkt->planes;
+  bool mixing = !outIsStream || m_mixStreams.size() > 1;
+  float peak = 0.0f;
+
+  for (int j = 0; j < out->pkt->planes; j++)
+  {
+    float *dst = (float*)out->pkt->data[j];
+
+    m_mixSources.clear();
+    if (!outIsStream)
+    {
+      CAEMixKernels::MixSource src = { dst, nullptr, 1.0f };
+      m_mixSources.push_back(src);
+    }
+
+    for (size_t i = 0; i < m_mixStreams.size(); i++)
+    {
+      CSampleBuffer *buffer = m_mixStreams[i].buffer;
+      if (j < buffer->pkt->planes &&
+          buffer->pkt->nb_samples * buffer->pkt->config.channels / buffer->pkt->planes == outFloats)
+        m_mixSources.push_back(GetMixSource(i, j));
+    }
+
+    // a single stream at unity gain is already in place
+    if (m_mixSources.size() > 1 || m_mixSources[0].data != dst ||
+        m_mixSources[0].gains || m_mixSources[0].gain != 1.0f)
+      peak = std::max(peak, kernels.mix(dst, m_mixSources.data(), m_mixSources.size(), outFloats));
+
+    // buffers of a different size are added on their own
+    for (size_t i = 0; i < m_mixStreams.size(); i++)
+    {
+      CSampleBuffer *buffer = m_mixStreams[i].buffer;
+      int floats = buffer->pkt->nb_samples * buffer->pkt->config.channels / buffer->pkt->planes;
+      if (j >= buffer->pkt->planes || floats == outFloats)
+        continue;
+
+      CAEMixKernels::MixSource src[2] = { { dst, nullptr, 1.0f }, GetMixSource(i, j) };
+      peak = std::max(peak, kernels.mix(dst, src, 2, std::min(floats, outFloats)));
+    }
+  }
+
+  // finally clamp samples
+  if (mixing && peak > 1.0f)
+  {
+    for (int j = 0; j < out->pkt->planes; j++)
+      kernels.softClamp((float*)out->pkt->data[j], outFloats);
+  }
+
+  for (size_t i = 0; i < m_mixStreams.size(); i++)
+  {
+    if (m_mixStreams[i].buffer != out)
+      m_mixStreams[i].buffer->Return();
+  }
+}
+
 void CActiveAE::MixSounds(CSoundPacket &dstSample)
 {
   if (m_sounds_playing.empty())
     return;
 
+  const CAEMixKernels::Kernels &kernels = CAEMixKernels::Get();
   float volume;
   float *out;
   float *sample_buffer;
@@ -2511,12 +2626,8 @@ void CActiveAE::MixSounds(CSoundPacket &dstSample)
       out = (float*)dstSample.data[j];
       sample_buffer = (float*)(it->sound->GetSound(false)->data[j]+start);
       int nb_floats = mix_samples * dstSample.config.channels / dstSample.planes;
-#ifdef __SSE__
-      CAEUtil::SSEMulAddArray(out, sample_buffer, volume, nb_floats);
-#else
-      for (int k = 0; k < nb_floats; ++k)
-        *out++ += *sample_buffer++ * volume;
-#endif
+      CAEMixKernels::MixSource src[2] = { { out, nullptr, 1.0f }, { sample_buffer, nullptr, volume } };
+      kernels.mix(out, src, 2, nb_floats);
     }
 
     it->samples_played += mix_samples;
@@ -2542,13 +2653,7 @@ void CActiveAE::Deamplify(CSoundPacket &dstSample)
     for(int j=0; j<dstSample.planes; j++)
     {
       buffer = (float*)dstSample.data[j];
-#ifdef __SSE__
-      CAEUtil::SSEMulArray(buffer, volume, nb_floats);
-#else
-      float *fbuffer = buffer;
-      for (int i = 0; i < nb_floats; i++)
-        *fbuffer++ *= volume;
-#endif
+      CAEMixKernels::Get().mul(buffer, volume, nb_floats);
     }
   }
 }
@@ -2562,6 +2667,30 @@ void CActiveAE::LoadSettings()
   m_settings.device = CSettings::GetInstance().GetString(CSettings::SETTING_AUDIOOUTPUT_AUDIODEVICE);
   m_settings.passthoughdevice = CSettings::GetInstance().GetString(CSettings::SETTING_AUDIOOUTPUT_PASSTHROUGHDEVICE);
 
+  // freewheel replaces the configured devices by the NULL sink
+  bool freewheel;
+  std::string freewheelFile;
+  {
+    CSingleLock lock(m_freewheelLock);
+    freewheel = m_freewheel;
+    freewheelFile = m_freewheelFile;
+  }
+  if (freewheel && !m_settings.freewheel)
+  {
+    CLog::Log(LOGNOTICE, "ActiveAE - start freewheeling");
+    m_stageStats.Reset();
+  }
+  else if (!freewheel && m_settings.freewheel)
+    LogRenderStats();
+  m_settings.freewheel = freewheel;
+  if (m_settings.freewheel)
+  {
+    m_settings.device = "NULL:FREEWHEEL";
+    if (!freewheelFile.empty())
+      m_settings.device += ":" + freewheelFile;
+    m_settings.passthoughdevice = m_settings.device;
+  }
+
   m_settings.config = CSettings::GetInstance().GetInt(CSettings::SETTING_AUDIOOUTPUT_CONFIG);
   m_settings.channels = (m_sink.GetDeviceType(m_settings.device) == AE_DEVTYPE_IEC958) ? AE_CH_LAYOUT_2_0 : CSettings::GetInstance().GetInt(CSettings::SETTING_AUDIOOUTPUT_CHANNELS);
   m_settings.samplerate = CSettings::GetInstance().GetInt(CSettings::SETTING_AUDIOOUTPUT_SAMPLERATE);
@@ -2573,7 +2702,7 @@ void CActiveAE::LoadSettings()
   m_settings.guisoundmode = CSettings::GetInstance().GetInt(CSettings::SETTING_AUDIOOUTPUT_GUISOUNDMODE);
 
   m_settings.passthrough = m_settings.config == AE_CONFIG_FIXED ? false : CSettings::GetInstance().GetBool(CSettings::SETTING_AUDIOOUTPUT_PASSTHROUGH);
-  if (!m_sink.HasPassthroughDevice())
+  if (!m_sink.HasPassthroughDevice() && !m_settings.freewheel)
     m_settings.passthrough = false;
   m_settings.ac3passthrough = CSettings::GetInstance().GetBool(CSettings::SETTING_AUDIOOUTPUT_AC3PASSTHROUGH);
   m_settings.ac3transcode = CSettings::GetInstance().GetBool(CSettings::SETTING_AUDIOOUTPUT_AC3TRANSCODE);
@@ -2684,7 +2813,8 @@ bool CActiveAE::HasHDAudioChannelCount()
 
 bool CActiveAE::SupportsQualityLevel(enum AEQuality level)
 {
-  if (level == AE_QUALITY_LOW || level == AE_QUALITY_MID || level == AE_QUALITY_HIGH)
+  if (level == AE_QUALITY_LOW || level == AE_QUALITY_MID || level == AE_QUALITY_HIGH ||
+      level == AE_QUALITY_REALLYHIGH)
     return true;
 #if defined(TARGET_RASPBERRY_PI)
   if (level == AE_QUALITY_GPU)
@@ -2865,6 +2995,48 @@ AEAudioFormat CActiveAE::GetCurrentSinkFormat()
   return m_stats.GetCurrentSinkFormat();
 }
 
+bool CActiveAE::GetBufferStats(AEBufferStats &stats)
+{
+  m_bufferCache.GetStats(stats);
+  return true;
+}
+
+bool CActiveAE::SetFreewheel(bool enable, const std::string &file)
+{
+  {
+    CSingleLock lock(m_freewheelLock);
+    m_freewheel = enable;
+    m_freewheelFile = file;
+  }
+  m_controlPort.SendOutMessage(CActiveAEControlProtocol::RECONFIGURE);
+  return true;
+}
+
+bool CActiveAE::GetRenderStats(AERenderStats &stats)
+{
+  {
+    CSingleLock lock(m_freewheelLock);
+    if (!m_freewheel)
+      return false;
+  }
+  m_stageStats.GetStats(stats);
+  return true;
+}
+
+void CActiveAE::LogRenderStats()
+{
+  static const char *stages[AE_STAGE_COUNT] = { "resample", "dsp", "mix", "encode", "sink" };
+
+  AERenderStats stats;
+  m_stageStats.GetStats(stats);
+  CLog::Log(LOGNOTICE, "ActiveAE - stop freewheeling after %.3f s", stats.elapsed);
+  for (int i = 0; i < AE_STAGE_COUNT; i++)
+  {
+    CLog::Log(LOGNOTICE, "  %-8s: %" PRIu64 " frames in %.3f s, %.0f frames/s",
+              stages[i], stats.samples[i], stats.seconds[i], stats.SamplesPerSecond((AERenderStage)i));
+  }
+}
+
 void CActiveAE::OnLostDisplay()
 {
   Message *reply;
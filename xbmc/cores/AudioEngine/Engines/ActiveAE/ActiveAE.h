@@ -27,6 +27,7 @@
 #include "cores/AudioEngine/Interfaces/AESound.h"
 #include "cores/AudioEngine/AEFactory.h"
 #include "cores/AudioEngine/Engines/ActiveAE/ActiveAEBuffer.h"
+#include "cores/AudioEngine/Utils/AEMixKernels.h"
 
 #include "guilib/DispResource.h"
 #include <queue>
@@ -46,6 +47,7 @@ namespace ActiveAE
 
 class CActiveAESound;
 class CActiveAEStream;
+class CActiveAEZone;
 
 struct AudioSettings
 {
@@ -67,6 +69,7 @@ struct AudioSettings
   int guisoundmode;
   unsigned int samplerate;
   AEQuality resampleQuality;
+  bool freewheel;
 };
 
 class CActiveAEControlProtocol : public Protocol
@@ -190,6 +193,7 @@ public:
   void SetCurrentSinkFormat(AEAudioFormat SinkFormat);
   void SetSinkCacheTotal(float time) { m_sinkCacheTotal = time; }
   void SetSinkLatency(float time) { m_sinkLatency = time; }
+  float GetSinkLatency() { return m_sinkLatency; }
   bool IsSuspended();
   bool HasDSP();
   AEAudioFormat GetCurrentSinkFormat();
@@ -227,6 +231,7 @@ protected:
   friend class CActiveAESound;
   friend class CActiveAEStream;
   friend class CSoundPacket;
+  friend class CActiveAEBufferPool;
   friend class CActiveAEBufferPoolResample;
   CActiveAE();
   virtual ~CActiveAE();
@@ -267,6 +272,9 @@ public:
   virtual void DeviceChange();
   virtual bool HasDSP();
   virtual AEAudioFormat GetCurrentSinkFormat();
+  virtual bool GetBufferStats(AEBufferStats &stats);
+  virtual bool SetFreewheel(bool enable, const std::string &file = "");
+  virtual bool GetRenderStats(AERenderStats &stats);
 
   virtual void RegisterAudioCallback(IAudioCallback* pCallback);
   virtual void UnregisterAudioCallback(IAudioCallback* pCallback);
@@ -277,8 +285,9 @@ public:
 
 protected:
   void PlaySound(CActiveAESound *sound);
-  uint8_t **AllocSoundSample(SampleConfig &config, int &samples, int &bytes_per_sample, int &planes, int &linesize);
-  void FreeSoundSample(uint8_t **data);
+  static uint8_t **AllocSoundSample(SampleConfig &config, int &samples, int &bytes_per_sample, int &planes, int &linesize);
+  static void FreeSoundSample(uint8_t **data);
+  CActiveAEBufferCache &GetBufferCache() { return m_bufferCache; }
   void GetDelay(AEDelayStatus& status, CActiveAEStream *stream) { m_stats.GetDelay(status, stream); }
   void GetSyncInfo(CAESyncInfo& info, CActiveAEStream *stream) { m_stats.GetSyncInfo(info, stream); }
   float GetCacheTime(CActiveAEStream *stream) { return m_stats.GetCacheTime(stream); }
@@ -300,9 +309,13 @@ protected:
   bool InitSink();
   void DrainSink();
   void UnconfigureSink();
+  void ConfigureZones();
+  void UnconfigureZones();
+  void FeedZones(CSampleBuffer *samples);
   void Start();
   void Dispose();
   void LoadSettings();
+  void LogRenderStats();
   bool NeedReconfigureBuffers();
   bool NeedReconfigureSink();
   void ApplySettingsToFormat(AEAudioFormat &format, AudioSettings &settings, int *mode = NULL);
@@ -320,6 +333,9 @@ protected:
   bool RunStages();
   bool HasWork();
   CSampleBuffer* SyncStream(CActiveAEStream *stream);
+  void PrepareMixStream(CActiveAEStream *stream, CSampleBuffer *buffer);
+  void MixStreams(CSampleBuffer *out, bool outIsStream);
+  CAEMixKernels::MixSource GetMixSource(size_t stream, int plane);
 
   void ResampleSounds();
   bool ResampleSound(CActiveAESound *sound);
@@ -350,6 +366,7 @@ protected:
   }m_mode;
 
   CActiveAESink m_sink;
+  std::vector<CActiveAEZone*> m_zones;
   AEAudioFormat m_sinkFormat;
   AEAudioFormat m_sinkRequestFormat;
   AEAudioFormat m_encoderFormat;
@@ -360,7 +377,14 @@ protected:
   IAEEncoder *m_encoder;
   std::string m_currDevice;
 
+  // freewheel, requested via the interface
+  CCriticalSection m_freewheelLock;
+  bool m_freewheel;
+  std::string m_freewheelFile;
+  CActiveAEStageStats m_stageStats;
+
   // buffers
+  CActiveAEBufferCache m_bufferCache;
   CActiveAEBufferPoolResample *m_sinkBuffers;
   CActiveAEBufferPoolResample *m_vizBuffers;
   CActiveAEBufferPool *m_vizBuffersInput;
@@ -369,6 +393,16 @@ protected:
 
   // streams
   std::list<CActiveAEStream*> m_streams;
+  struct MixStream
+  {
+    CSampleBuffer *buffer;
+    float gain;
+    bool perSample; // use m_mixGains of the same index instead of gain
+  };
+  std::vector<MixStream> m_mixStreams;
+  std::vector<std::vector<float> > m_mixGains;
+  std::vector<float> m_mixPeaks;
+  std::vector<CAEMixKernels::MixSource> m_mixSources;
   std::list<CActiveAEBufferPool*> m_discardBufferPools;
   unsigned int m_streamIdGen;
 
@@ -24,6 +24,9 @@
 #include "cores/AudioEngine/Engines/ActiveAE/ActiveAE.h"
 #include "cores/AudioEngine/Utils/AEUtil.h"
 #include "cores/AudioEngine/AEResampleFactory.h"
+#include "utils/TimeUtils.h"
+
+#include <algorithm>
 
 using namespace ActiveAE;
 
@@ -32,8 +35,9 @@ using namespace ActiveAE;
 
 CSoundPacket::CSoundPacket(SampleConfig conf, int samples) : config(conf)
 {
-  data = AE.AllocSoundSample(config, samples, bytes_per_sample, planes, linesize);
+  data = CActiveAE::AllocSoundSample(config, samples, bytes_per_sample, planes, linesize);
   max_nb_samples = samples;
+  alloc_nb_samples = samples;
   nb_samples = 0;
   pause_burst_ms = 0;
 }
@@ -41,7 +45,7 @@ CSoundPacket::CSoundPacket(SampleConfig conf, int samples) : config(conf)
 CSoundPacket::~CSoundPacket()
 {
   if (data)
-    AE.FreeSoundSample(data);
+    CActiveAE::FreeSoundSample(data);
 }
 
 CSampleBuffer::CSampleBuffer() : pkt(NULL), pool(NULL)
@@ -69,7 +73,170 @@ void CSampleBuffer::Return()
     pool->ReturnBuffer(this);
 }
 
+//-----------------------------------------------------------------------------
+
+// don't keep more than this around for pools that might never come back
+#define BUFFER_CACHE_MAX_BYTES (16 * 1024 * 1024)
+
+CActiveAEBufferCache::CActiveAEBufferCache()
+{
+  m_cachedBytes = 0;
+  m_allocations = 0;
+  m_reused = 0;
+  m_returns = 0;
+  m_misses = 0;
+  m_cachedBytesStat = 0;
+}
+
+CActiveAEBufferCache::~CActiveAEBufferCache()
+{
+  Clear();
+}
+
+int CActiveAEBufferCache::SizeClass(int samples)
+{
+  // four classes per power of two, so at most 25% is wasted
+  int size = 4;
+  while (size < samples && size < (1 << 28))
+    size <<= 1;
+  int step = std::max(size / 8, 1);
+  return (samples + step - 1) / step * step;
+}
+
+size_t CActiveAEBufferCache::GetSize(const CSoundPacket *pkt)
+{
+  return av_samples_get_buffer_size(NULL, pkt->config.channels, pkt->alloc_nb_samples, pkt->config.fmt, 16);
+}
+
+CSampleBuffer* CActiveAEBufferCache::Get(const SampleConfig &config, int samples)
+{
+  CSampleBuffer *buffer = NULL;
+  int size = SizeClass(samples);
+
+  {
+    CSingleLock lock(m_lock);
+    for (auto it = m_buffers.begin(); it != m_buffers.end(); ++it)
+    {
+      CSoundPacket *pkt = (*it)->pkt;
+      if (pkt->config.fmt == config.fmt &&
+          pkt->config.channels == config.channels &&
+          pkt->alloc_nb_samples == size)
+      {
+        buffer = *it;
+        m_buffers.erase(it);
+        m_cachedBytes -= GetSize(pkt);
+        m_cachedBytesStat = m_cachedBytes;
+        break;
+      }
+    }
+  }
+
+  if (buffer)
+  {
+    m_reused++;
+    buffer->pkt->config = config;
+  }
+  else
+  {
+    m_allocations++;
+    buffer = new CSampleBuffer();
+    buffer->pkt = new CSoundPacket(config, size);
+  }
+
+  // lay the planes out in the allocation as if it was made for samples
+  // frames, the encoder and the code clearing planes rely on linesize
+  CSoundPacket *pkt = buffer->pkt;
+  av_samples_fill_arrays(pkt->data, &pkt->linesize, pkt->data[0], config.channels, samples, config.fmt, 16);
+  pkt->max_nb_samples = samples;
+  pkt->nb_samples = 0;
+  pkt->pause_burst_ms = 0;
+  buffer->refCount = 0;
+  buffer->timestamp = 0;
+  buffer->pkt_start_offset = 0;
+  return buffer;
+}
+
+void CActiveAEBufferCache::Release(CSampleBuffer *buffer)
+{
+  buffer->pool = NULL;
+
+  CSingleLock lock(m_lock);
+  m_buffers.push_back(buffer);
+  m_cachedBytes += GetSize(buffer->pkt);
+
+  // drop the oldest ones first
+  while (m_cachedBytes > BUFFER_CACHE_MAX_BYTES && !m_buffers.empty())
+  {
+    CSampleBuffer *old = m_buffers.front();
+    m_buffers.pop_front();
+    m_cachedBytes -= GetSize(old->pkt);
+    delete old;
+  }
+  m_cachedBytesStat = m_cachedBytes;
+}
+
+void CActiveAEBufferCache::Clear()
+{
+  CSingleLock lock(m_lock);
+  while (!m_buffers.empty())
+  {
+    delete m_buffers.front();
+    m_buffers.pop_front();
+  }
+  m_cachedBytes = 0;
+  m_cachedBytesStat = 0;
+}
+
+void CActiveAEBufferCache::GetStats(AEBufferStats &stats)
+{
+  stats.allocations = m_allocations;
+  stats.reused = m_reused;
+  stats.returns = m_returns;
+  stats.misses = m_misses;
+  stats.cachedBytes = m_cachedBytesStat;
+}
+
+//-----------------------------------------------------------------------------
+
+CActiveAEStageStats::CActiveAEStageStats()
+{
+  Reset();
+}
+
+void CActiveAEStageStats::Reset()
+{
+  CSingleLock lock(m_lock);
+  for (int i = 0; i < AE_STAGE_COUNT; i++)
+  {
+    m_samples[i] = 0;
+    m_ticks[i] = 0;
+  }
+  m_start = CurrentHostCounter();
+}
+
+void CActiveAEStageStats::Add(AERenderStage stage, int samples, int64_t ticks)
+{
+  CSingleLock lock(m_lock);
+  m_samples[stage] += samples;
+  m_ticks[stage] += ticks;
+}
+
+void CActiveAEStageStats::GetStats(AERenderStats &stats)
+{
+  double freq = (double)CurrentHostFrequency();
+  CSingleLock lock(m_lock);
+  for (int i = 0; i < AE_STAGE_COUNT; i++)
+  {
+    stats.samples[i] = m_samples[i];
+    stats.seconds[i] = m_ticks[i] / freq;
+  }
+  stats.elapsed = (CurrentHostCounter() - m_start) / freq;
+}
+
+//-----------------------------------------------------------------------------
+
 CActiveAEBufferPool::CActiveAEBufferPool(AEAudioFormat format)
+  : m_cache(AE.GetBufferCache())
 {
   m_format = format;
   if (m_format.m_dataFormat == AE_FMT_RAW)
@@ -88,7 +255,7 @@ CActiveAEBufferPool::~CActiveAEBufferPool()
   {
     buffer = m_allSamples.front();
     m_allSamples.pop_front();
-    delete buffer;
+    m_cache.Release(buffer);
   }
 }
 
@@ -102,6 +269,8 @@ CSampleBuffer* CActiveAEBufferPool::GetFreeBuffer()
     m_freeSamples.pop_front();
     buf->refCount = 1;
   }
+  else
+    m_cache.CountMiss();
   return buf;
 }
 
@@ -110,6 +279,7 @@ void CActiveAEBufferPool::ReturnBuffer(CSampleBuffer *buffer)
   buffer->pkt->nb_samples = 0;
   buffer->pkt->pause_burst_ms = 0;
   m_freeSamples.push_back(buffer);
+  m_cache.CountReturn();
 }
 
 bool CActiveAEBufferPool::Create(unsigned int totaltime)
@@ -132,9 +302,8 @@ bool CActiveAEBufferPool::Create(unsigned int totaltime)
   unsigned int n = 0;
   while (time < totaltime || n < 5)
   {
-    buffer = new CSampleBuffer();
+    buffer = m_cache.Get(config, m_format.m_frames);
     buffer->pool = this;
-    buffer->pkt = new CSoundPacket(config, m_format.m_frames);
 
     m_allSamples.push_back(buffer);
     m_freeSamples.push_back(buffer);
@@ -176,6 +345,8 @@ CActiveAEBufferPoolResample::CActiveAEBufferPoolResample(AEAudioFormat inputForm
   m_changeResampler = false;
   m_changeDSP = false;
   m_lastSamplePts = 0;
+  m_stageStats = NULL;
+  m_resampleStage = AE_STAGE_RESAMPLE;
 }
 
 CActiveAEBufferPoolResample::~CActiveAEBufferPoolResample()
@@ -261,7 +432,7 @@ bool CActiveAEBufferPoolResample::Create(unsigned int totaltime, bool remap, boo
 
   if (m_useResampler || m_changeResampler)
   {
-    m_resampler = CAEResampleFactory::Create();
+    m_resampler = CAEResampleFactory::Create(0, m_resampleQuality);
     m_resampler->Init(CAEUtil::GetAVChannelLayout(m_format.m_channelLayout),
                                 m_format.m_channelLayout.Count(),
                                 m_format.m_sampleRate,
@@ -298,7 +469,7 @@ void CActiveAEBufferPoolResample::ChangeResampler()
   if (m_useDSP && m_processor && m_processor->GetChannelLayout().Count() > 2)
     upmix = false;
 
-  m_resampler = CAEResampleFactory::Create();
+  m_resampler = CAEResampleFactory::Create(0, m_resampleQuality);
   m_resampler->Init(CAEUtil::GetAVChannelLayout(m_format.m_channelLayout),
                                 m_format.m_channelLayout.Count(),
                                 m_format.m_sampleRate,
@@ -436,6 +607,7 @@ bool CActiveAEBufferPoolResample::ResampleBuffers(int64_t timestamp)
         if (!m_dspSample)
           m_dspSample = m_dspBuffer->GetFreeBuffer();
 
+        int64_t start = m_stageStats ? CurrentHostCounter() : 0;
         if (m_dspSample && m_processor->Process(in, m_dspSample))
         {
           in->Return();
@@ -447,6 +619,8 @@ bool CActiveAEBufferPoolResample::ResampleBuffers(int64_t timestamp)
           in->Return();
           in = NULL;
         }
+        if (m_stageStats)
+          m_stageStats->Add(AE_STAGE_DSP, in ? in->pkt->nb_samples : 0, CurrentHostCounter() - start);
       }
 
       int start = m_procSample->pkt->nb_samples *
@@ -459,11 +633,18 @@ bool CActiveAEBufferPoolResample::ResampleBuffers(int64_t timestamp)
         m_planes[i] = m_procSample->pkt->data[i] + start;
       }
 
+      int64_t resampleStart = m_stageStats ? CurrentHostCounter() : 0;
       int out_samples = m_resampler->Resample(m_planes,
                                               m_procSample->pkt->max_nb_samples - m_procSample->pkt->nb_samples,
                                               in ? in->pkt->data : NULL,
                                               in ? in->pkt->nb_samples : 0,
                                               m_resampleRatio);
+      if (m_stageStats)
+      {
+        // frames of the sink stage are counted once when the sink takes them
+        int frames = (m_resampleStage == AE_STAGE_SINK) ? 0 : std::max(out_samples, 0);
+        m_stageStats->Add(m_resampleStage, frames, CurrentHostCounter() - resampleStart);
+      }
       // in case of error, trigger re-create of resampler
       if (out_samples < 0)
       {
@@ -22,6 +22,8 @@
 #include "cores/AudioEngine/Utils/AEAudioFormat.h"
 #include "cores/AudioEngine/Interfaces/AE.h"
 #include "cores/AudioEngine/DSPAddons/ActiveAEDSP.h"
+#include "threads/CriticalSection.h"
+#include <atomic>
 #include <deque>
 
 extern "C" {
@@ -57,6 +59,7 @@ public:
   int planes;                            // 1 for non planar formats, #channels for planar
   int nb_samples;                        // number of frames used
   int max_nb_samples;                    // max number of frames this packet can hold
+  int alloc_nb_samples;                  // number of frames the planes were allocated for
   int pause_burst_ms;
 };
 
@@ -76,6 +79,59 @@ public:
   int refCount;
 };
 
+/**
+ * Keeps the sample buffers of discarded pools, so pools created after a
+ * format change can take them over instead of allocating new planes.
+ * Buffers are matched on sample format, channel count and a size class
+ * of the number of frames. The planes of a buffer handed out are laid out
+ * for the frames asked for, like a new allocation of that size would be.
+ * Only used from the engine thread, the counters may be read from anywhere.
+ */
+class CActiveAEBufferCache
+{
+public:
+  CActiveAEBufferCache();
+  ~CActiveAEBufferCache();
+  CSampleBuffer *Get(const SampleConfig &config, int samples);
+  void Release(CSampleBuffer *buffer);
+  void Clear();
+  void CountReturn() { m_returns++; }
+  void CountMiss() { m_misses++; }
+  void GetStats(AEBufferStats &stats);
+  static int SizeClass(int samples);
+
+protected:
+  static size_t GetSize(const CSoundPacket *pkt);
+
+  CCriticalSection m_lock;
+  std::deque<CSampleBuffer*> m_buffers;
+  size_t m_cachedBytes;
+  std::atomic<uint64_t> m_allocations;
+  std::atomic<uint64_t> m_reused;
+  std::atomic<uint64_t> m_returns;
+  std::atomic<uint64_t> m_misses;
+  std::atomic<uint64_t> m_cachedBytesStat;
+};
+
+/**
+ * Accumulates frames and processing time per stage while the engine
+ * freewheels. Stages report from the engine and the sink thread.
+ */
+class CActiveAEStageStats
+{
+public:
+  CActiveAEStageStats();
+  void Reset();
+  void Add(AERenderStage stage, int samples, int64_t ticks);
+  void GetStats(AERenderStats &stats);
+
+protected:
+  CCriticalSection m_lock;
+  uint64_t m_samples[AE_STAGE_COUNT];
+  int64_t m_ticks[AE_STAGE_COUNT];
+  int64_t m_start;
+};
+
 class CActiveAEBufferPool
 {
 public:
@@ -87,6 +143,8 @@ public:
   AEAudioFormat m_format;
   std::deque<CSampleBuffer*> m_allSamples;
   std::deque<CSampleBuffer*> m_freeSamples;
+protected:
+  CActiveAEBufferCache &m_cache;
 };
 
 class IAEResample;
@@ -132,6 +190,8 @@ public:
   enum AVMatrixEncoding m_MatrixEncoding;
   enum AVAudioServiceType m_AudioServiceType;
   int m_Profile;
+  CActiveAEStageStats *m_stageStats;     // only set while measuring
+  AERenderStage m_resampleStage;         // stage the resampler accounts to
 };
 
 }
@@ -0,0 +1,403 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "ActiveAEResamplePolyphase.h"
+#include "ActiveAEResampleFFMPEG.h"
+#include "cores/AudioEngine/Utils/AEMixKernels.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <map>
+#include <math.h>
+#include <string.h>
+#include <tuple>
+
+extern "C" {
+#include "libavutil/channel_layout.h"
+}
+
+using namespace ActiveAE;
+
+namespace
+{
+
+struct FilterDesign
+{
+  int taps;
+  double beta;
+  double cutoff;
+};
+
+FilterDesign GetDesign(AEQuality quality)
+{
+  switch (quality)
+  {
+    case AE_QUALITY_REALLYHIGH:
+      return { 128, 11.0, 0.97 };
+    case AE_QUALITY_HIGH:
+      return { 64, 9.0, 0.95 };
+    default:
+      return { 32, 7.0, 0.91 };
+  }
+}
+
+double BesselI0(double x)
+{
+  double sum = 1.0;
+  double term = 1.0;
+  for (int k = 1; k < 50; k++)
+  {
+    term *= (x / (2.0 * k)) * (x / (2.0 * k));
+    sum += term;
+    if (term < sum * 1e-12)
+      break;
+  }
+  return sum;
+}
+
+int Gcd(int a, int b)
+{
+  while (b)
+  {
+    int t = a % b;
+    a = b;
+    b = t;
+  }
+  return a;
+}
+
+bool IsFloat(AVSampleFormat fmt)
+{
+  return fmt == AV_SAMPLE_FMT_FLT || fmt == AV_SAMPLE_FMT_FLTP;
+}
+
+std::shared_ptr<const CActiveAEResamplePolyphase::FilterBank> BuildFilterBank(int src_rate, int dst_rate, AEQuality quality)
+{
+  std::shared_ptr<CActiveAEResamplePolyphase::FilterBank> bank(new CActiveAEResamplePolyphase::FilterBank);
+  FilterDesign design = GetDesign(quality);
+
+  // when decimating the cutoff moves down and the filter gets longer
+  double scale = std::min(1.0, (double)dst_rate / src_rate);
+  double fc = design.cutoff * scale;
+  int half = (int)ceil(design.taps / 2 / scale);
+  half = std::min((half + 3) & ~3, 512);
+  bank->taps = half * 2;
+
+  // a phase for every output position of the rational ratio if that is
+  // reasonably small, otherwise enough phases to interpolate between
+  int phases = dst_rate / Gcd(src_rate, dst_rate);
+  bank->exact = phases <= 1024;
+  if (bank->exact)
+  {
+    while (phases < 256)
+      phases *= 2;
+  }
+  else
+    phases = 256;
+  bank->phases = phases;
+
+  double norm = BesselI0(design.beta);
+  bank->coeffs.resize((phases + 1) * bank->taps);
+  for (int p = 0; p <= phases; p++)
+  {
+    float *row = &bank->coeffs[p * bank->taps];
+    double frac = (double)p / phases;
+    double sum = 0.0;
+    for (int k = 0; k < bank->taps; k++)
+    {
+      double d = k - (half - 1) - frac;
+      double x = d / half;
+      double window = (fabs(x) < 1.0) ? BesselI0(design.beta * sqrt(1.0 - x * x)) / norm : 0.0;
+      double arg = M_PI * fc * d;
+      double sinc = (fabs(arg) < 1e-9) ? 1.0 : sin(arg) / arg;
+      row[k] = (float)(fc * sinc * window);
+      sum += row[k];
+    }
+    // unity gain at dc for every phase
+    for (int k = 0; k < bank->taps; k++)
+      row[k] = (float)(row[k] / sum);
+  }
+
+  return bank;
+}
+
+}
+
+std::shared_ptr<const CActiveAEResamplePolyphase::FilterBank> CActiveAEResamplePolyphase::GetFilterBank(int src_rate, int dst_rate, AEQuality quality)
+{
+  static CCriticalSection lock;
+  static std::map<std::tuple<int, int, int>, std::shared_ptr<const FilterBank> > banks;
+
+  // only the filter length depends on the quality
+  int taps = GetDesign(quality).taps;
+
+  CSingleLock cacheLock(lock);
+  auto key = std::make_tuple(src_rate, dst_rate, taps);
+  auto it = banks.find(key);
+  if (it != banks.end())
+    return it->second;
+
+  std::shared_ptr<const FilterBank> bank = BuildFilterBank(src_rate, dst_rate, quality);
+  banks[key] = bank;
+  CLog::Log(LOGDEBUG, "CActiveAEResamplePolyphase::%s - filter bank %d -> %d: %d phases, %d taps",
+            __FUNCTION__, src_rate, dst_rate, bank->phases, bank->taps);
+  return bank;
+}
+
+CActiveAEResamplePolyphase::CActiveAEResamplePolyphase()
+{
+  m_converter = NULL;
+  m_delegate = false;
+  m_src_rate = m_dst_rate = 0;
+  m_src_channels = m_dst_channels = 0;
+  m_src_fmt = m_dst_fmt = AV_SAMPLE_FMT_NONE;
+  m_frames = 0;
+  m_position = 0.0;
+  m_padding = 0;
+}
+
+CActiveAEResamplePolyphase::~CActiveAEResamplePolyphase()
+{
+  delete m_converter;
+}
+
+bool CActiveAEResamplePolyphase::Init(uint64_t dst_chan_layout, int dst_channels, int dst_rate, AVSampleFormat dst_fmt, int dst_bits, int dst_dither, uint64_t src_chan_layout, int src_channels, int src_rate, AVSampleFormat src_fmt, int src_bits, int src_dither, bool upmix, bool normalize, CAEChannelInfo *remapLayout, AEQuality quality, bool force_resample)
+{
+  m_src_rate = src_rate;
+  m_dst_rate = dst_rate;
+  m_src_channels = src_channels;
+  m_dst_channels = dst_channels;
+  m_src_fmt = src_fmt;
+  m_dst_fmt = dst_fmt;
+
+  // nothing to filter or an output we don't write ourselves
+  m_delegate = !IsFloat(dst_fmt) || (src_rate == dst_rate && !force_resample);
+  if (m_delegate)
+  {
+    m_converter = new CActiveAEResampleFFMPEG();
+    return m_converter->Init(dst_chan_layout, dst_channels, dst_rate, dst_fmt, dst_bits, dst_dither,
+                             src_chan_layout, src_channels, src_rate, src_fmt, src_bits, src_dither,
+                             upmix, normalize, remapLayout, quality, force_resample);
+  }
+
+  if (dst_chan_layout == 0)
+    dst_chan_layout = av_get_default_channel_layout(dst_channels);
+  if (src_chan_layout == 0)
+    src_chan_layout = av_get_default_channel_layout(src_channels);
+
+  bool convert = !IsFloat(src_fmt) ||
+                 src_chan_layout != dst_chan_layout ||
+                 src_channels != dst_channels ||
+                 remapLayout ||
+                 (upmix && src_channels == 2 && dst_channels > 2);
+  if (convert)
+  {
+    // planar float at the source rate, channels already in output order
+    m_converter = new CActiveAEResampleFFMPEG();
+    if (!m_converter->Init(dst_chan_layout, dst_channels, src_rate, AV_SAMPLE_FMT_FLTP, 32, 0,
+                           src_chan_layout, src_channels, src_rate, src_fmt, src_bits, src_dither,
+                           upmix, normalize, remapLayout, quality, false))
+    {
+      CLog::Log(LOGERROR, "CActiveAEResamplePolyphase::Init - init converter failed");
+      return false;
+    }
+  }
+
+  m_bank = GetFilterBank(src_rate, dst_rate, quality);
+  m_history.assign(dst_channels, std::vector<float>());
+  m_planes.resize(dst_channels);
+  m_coeffs.resize(m_bank->taps);
+
+  // center the first input sample under the filter
+  int half = m_bank->taps / 2;
+  m_frames = 0;
+  AddSilence(half - 1);
+  m_position = (double)(half - 1) * m_bank->phases;
+  m_padding = 0;
+  return true;
+}
+
+bool CActiveAEResamplePolyphase::AddInput(uint8_t **src_buffer, int src_samples)
+{
+  for (auto &history : m_history)
+    history.resize(m_frames + src_samples);
+
+  if (m_converter)
+  {
+    for (int ch = 0; ch < m_dst_channels; ch++)
+      m_planes[ch] = (uint8_t*)(m_history[ch].data() + m_frames);
+    int ret = m_converter->Resample(m_planes.data(), src_samples, src_buffer, src_samples, 1.0);
+    if (ret < 0)
+      return false;
+    m_frames += ret;
+    for (auto &history : m_history)
+      history.resize(m_frames);
+  }
+  else if (m_src_fmt == AV_SAMPLE_FMT_FLTP)
+  {
+    for (int ch = 0; ch < m_dst_channels; ch++)
+      memcpy(m_history[ch].data() + m_frames, src_buffer[ch], src_samples * sizeof(float));
+    m_frames += src_samples;
+  }
+  else
+  {
+    const float *src = (const float*)src_buffer[0];
+    for (int ch = 0; ch < m_dst_channels; ch++)
+    {
+      float *dst = m_history[ch].data() + m_frames;
+      for (int i = 0; i < src_samples; i++)
+        dst[i] = src[i * m_dst_channels + ch];
+    }
+    m_frames += src_samples;
+  }
+  return true;
+}
+
+void CActiveAEResamplePolyphase::AddSilence(int samples)
+{
+  for (auto &history : m_history)
+    history.resize(m_frames + samples, 0.0f);
+  m_frames += samples;
+}
+
+void CActiveAEResamplePolyphase::Consume()
+{
+  // keep what the filter still needs for the next output sample
+  int half = m_bank->taps / 2;
+  int drop = (int)(m_position / m_bank->phases) - (half - 1);
+  if (drop <= 0)
+    return;
+
+  for (auto &history : m_history)
+    history.erase(history.begin(), history.begin() + drop);
+  m_frames -= drop;
+  m_position -= (double)drop * m_bank->phases;
+}
+
+int CActiveAEResamplePolyphase::Resample(uint8_t **dst_buffer, int dst_samples, uint8_t **src_buffer, int src_samples, double ratio)
+{
+  if (m_delegate)
+    return m_converter->Resample(dst_buffer, dst_samples, src_buffer, src_samples, ratio);
+
+  if (src_buffer && src_samples > 0)
+  {
+    if (!AddInput(src_buffer, src_samples))
+    {
+      CLog::Log(LOGERROR, "CActiveAEResamplePolyphase::Resample - convert failed");
+      return -1;
+    }
+    m_padding = 0;
+  }
+
+  const CAEMixKernels::Kernels &kernels = CAEMixKernels::Get();
+  const int phases = m_bank->phases;
+  const int taps = m_bank->taps;
+  const int half = taps / 2;
+  const bool planar = (m_dst_fmt == AV_SAMPLE_FMT_FLTP);
+
+  // a ratio above 1 stretches, so we advance slower through the input
+  double step = (double)m_src_rate * phases / m_dst_rate / ratio;
+
+  int out = 0;
+  while (out < dst_samples)
+  {
+    int64_t pos = (int64_t)m_position;
+    int first = (int)(pos / phases) - half + 1;
+    if (first + taps > m_frames)
+    {
+      // without new input push the tail out once, like swresample does
+      if (!src_buffer && !m_padding)
+      {
+        AddSilence(half);
+        m_padding = half;
+        continue;
+      }
+      break;
+    }
+
+    int phase = (int)(pos % phases);
+    float frac = (float)(m_position - pos);
+    const float *row = &m_bank->coeffs[phase * taps];
+    if (frac > 1e-6f)
+    {
+      // between two phases, happens for odd ratios or while nudging
+      const float *next = row + taps;
+      for (int k = 0; k < taps; k++)
+        m_coeffs[k] = row[k] + (next[k] - row[k]) * frac;
+      row = m_coeffs.data();
+    }
+
+    for (int ch = 0; ch < m_dst_channels; ch++)
+    {
+      float value = kernels.dot(row, m_history[ch].data() + first, taps);
+      if (planar)
+        ((float*)dst_buffer[ch])[out] = value;
+      else
+        ((float*)dst_buffer[0])[out * m_dst_channels + ch] = value;
+    }
+
+    m_position += step;
+    out++;
+  }
+
+  Consume();
+  return out;
+}
+
+int64_t CActiveAEResamplePolyphase::GetDelay(int64_t base)
+{
+  if (m_delegate)
+    return m_converter->GetDelay(base);
+
+  return (int64_t)(Buffered() * base / m_src_rate);
+}
+
+int CActiveAEResamplePolyphase::GetBufferedSamples()
+{
+  if (m_delegate)
+    return m_converter->GetBufferedSamples();
+
+  return (int)ceil(Buffered() * m_dst_rate / m_src_rate);
+}
+
+double CActiveAEResamplePolyphase::Buffered()
+{
+  // input samples not yet passed by the read position
+  double buffered = m_frames - m_padding - m_position / m_bank->phases;
+  return std::max(buffered, 0.0);
+}
+
+int CActiveAEResamplePolyphase::CalcDstSampleCount(int src_samples, int dst_rate, int src_rate)
+{
+  return (int)(((int64_t)src_samples * dst_rate + src_rate - 1) / src_rate);
+}
+
+int CActiveAEResamplePolyphase::GetSrcBufferSize(int samples)
+{
+  return av_samples_get_buffer_size(NULL, m_src_channels, samples, m_src_fmt, 1);
+}
+
+int CActiveAEResamplePolyphase::GetDstBufferSize(int samples)
+{
+  return av_samples_get_buffer_size(NULL, m_dst_channels, samples, m_dst_fmt, 1);
+}
@@ -0,0 +1,96 @@
+#pragma once
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "cores/AudioEngine/Interfaces/AEResample.h"
+
+#include <memory>
+#include <vector>
+
+namespace ActiveAE
+{
+
+class CActiveAEResampleFFMPEG;
+
+/**
+ * Windowed sinc polyphase resampler for float output.
+ *
+ * Filter banks only depend on the rates and the quality, so they are built
+ * once and shared by all instances. The ratio passed to Resample only moves
+ * the read position, changing it costs nothing. Format and channel
+ * conversion is done by swresample at the source rate, if the destination is
+ * not float or no rate conversion is needed everything is left to it.
+ */
+class CActiveAEResamplePolyphase : public IAEResample
+{
+public:
+  struct FilterBank
+  {
+    int phases;
+    // taps per phase, a multiple of 8
+    int taps;
+    // set if a unit ratio always hits a phase
+    bool exact;
+    // phases + 1 rows, the last one is the first shifted by one sample
+    std::vector<float> coeffs;
+  };
+
+  const char *GetName() { return "ActiveAEResamplePolyphase"; }
+  CActiveAEResamplePolyphase();
+  virtual ~CActiveAEResamplePolyphase();
+  bool Init(uint64_t dst_chan_layout, int dst_channels, int dst_rate, AVSampleFormat dst_fmt, int dst_bits, int dst_dither, uint64_t src_chan_layout, int src_channels, int src_rate, AVSampleFormat src_fmt, int src_bits, int src_dither, bool upmix, bool normalize, CAEChannelInfo *remapLayout, AEQuality quality, bool force_resample);
+  int Resample(uint8_t **dst_buffer, int dst_samples, uint8_t **src_buffer, int src_samples, double ratio);
+  int64_t GetDelay(int64_t base);
+  int GetBufferedSamples();
+  bool WantsNewSamples(int samples) { return GetBufferedSamples() <= samples * 2; }
+  int CalcDstSampleCount(int src_samples, int dst_rate, int src_rate);
+  int GetSrcBufferSize(int samples);
+  int GetDstBufferSize(int samples);
+
+  /**
+   * Returns the cached bank for the conversion, building it on first use.
+   */
+  static std::shared_ptr<const FilterBank> GetFilterBank(int src_rate, int dst_rate, AEQuality quality);
+
+protected:
+  bool AddInput(uint8_t **src_buffer, int src_samples);
+  void AddSilence(int samples);
+  void Consume();
+  double Buffered();
+
+  CActiveAEResampleFFMPEG *m_converter;
+  bool m_delegate;
+  int m_src_rate, m_dst_rate;
+  int m_src_channels, m_dst_channels;
+  AVSampleFormat m_src_fmt, m_dst_fmt;
+
+  std::shared_ptr<const FilterBank> m_bank;
+  // input history per channel and the read position in phase units
+  std::vector<std::vector<float> > m_history;
+  int m_frames;
+  double m_position;
+  // silence appended to drain the filter, not counted as buffered
+  int m_padding;
+  std::vector<float> m_coeffs;
+  std::vector<uint8_t*> m_planes;
+};
+
+}
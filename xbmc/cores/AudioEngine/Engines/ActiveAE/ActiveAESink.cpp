@@ -30,6 +30,7 @@
 
 #include "settings/Settings.h"
 #include "utils/log.h"
+#include "utils/TimeUtils.h"
 
 #include <new> // for std::bad_alloc
 #include <algorithm>
@@ -48,6 +49,7 @@ CActiveAESink::CActiveAESink(CEvent *inMsgEvent) :
   m_inMsgEvent = inMsgEvent;
   m_sink = nullptr;
   m_stats = nullptr;
+  m_stageStats = nullptr;
   m_volume = 0.0;
   m_packer = nullptr;
 }
@@ -259,11 +261,14 @@ void CActiveAESink::StateMachine(int signal, Protocol *port, Message *msg)
           {
             m_requestedFormat = data->format;
             m_stats = data->stats;
+            m_stageStats = data->stageStats;
             m_device = *(data->device);
           }
           m_extError = false;
           m_extSilenceTimer = 0;
           m_extStreaming = false;
+          if (m_stageStats)
+            SetSilenceTimer();
           ReturnBuffers();
           OpenSink();
 
@@ -411,8 +416,12 @@ void CActiveAESink::StateMachine(int signal, Protocol *port, Message *msg)
         case CSinkDataProtocol::SAMPLE:
           CSampleBuffer *samples;
           unsigned int delay;
+          int64_t start;
           samples = *((CSampleBuffer**)msg->data);
+          start = m_stageStats ? CurrentHostCounter() : 0;
           delay = OutputSamples(samples);
+          if (m_stageStats)
+            m_stageStats->Add(AE_STAGE_SINK, samples->pkt->nb_samples, CurrentHostCounter() - start);
           msg->Reply(CSinkDataProtocol::RETURNSAMPLE, &samples, sizeof(CSampleBuffer*));
           if (m_extError)
           {
@@ -908,6 +917,10 @@ unsigned int CActiveAESink::OutputSamples(CSampleBuffer* samples)
   uint8_t* p_mergebuffer = NULL;
   AEDelayStatus status;
 
+  // keep the output of a freewheeling engine free of padding
+  if (m_stageStats && samples == &m_sampleOfSilence)
+    return 0;
+
   if (m_requestedFormat.m_dataFormat == AE_FMT_RAW)
   {
     if (m_needIecPack)
@@ -1106,7 +1119,10 @@ void CActiveAESink::GenerateNoise()
 
 void CActiveAESink::SetSilenceTimer()
 {
-  if (m_extStreaming)
+  // a freewheeling engine must not get silence mixed into its output
+  if (m_stageStats)
+    m_extSilenceTimeout = 0;
+  else if (m_extStreaming)
     m_extSilenceTimeout = XbmcThreads::EndTime::InfiniteValue;
   else if (m_extAppFocused)
     m_extSilenceTimeout = CSettings::GetInstance().GetInt(CSettings::SETTING_AUDIOOUTPUT_STREAMSILENCE) * 60000;
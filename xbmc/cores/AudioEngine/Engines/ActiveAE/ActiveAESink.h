@@ -34,11 +34,13 @@ namespace ActiveAE
 using namespace Actor;
 
 class CEngineStats;
+class CActiveAEStageStats;
 
 struct SinkConfig
 {
   AEAudioFormat format;
   CEngineStats *stats;
+  CActiveAEStageStats *stageStats; // set while the engine freewheels
   const std::string *device;
 };
 
@@ -93,6 +95,7 @@ class CActiveAESink : private CThread
 public:
   CActiveAESink(CEvent *inMsgEvent);
   void EnumerateSinkList(bool force);
+  void CopySinkList(const CActiveAESink &sink) { m_sinkInfoList = sink.m_sinkInfoList; }
   void EnumerateOutputDevices(AEDeviceList &devices, bool passthrough);
   std::string GetDefaultDevice(bool passthrough);
   void Start();
@@ -144,6 +147,7 @@ protected:
   IAESink *m_sink;
   AEAudioFormat m_sinkFormat, m_requestedFormat;
   CEngineStats *m_stats;
+  CActiveAEStageStats *m_stageStats;
   float m_volume;
   int m_sinkLatency;
   CAEBitstreamPacker *m_packer;
@@ -0,0 +1,313 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "ActiveAEZone.h"
+#include "cores/AudioEngine/Utils/AEUtil.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <math.h>
+#include <string.h>
+
+using namespace ActiveAE;
+
+#define ZONE_CACHE_TIME      1.0   // mixed audio a zone may hold in seconds
+#define ZONE_WATER_LEVEL     0.2   // buffered time after the resampler in seconds
+#define ZONE_SYNC_THRESHOLD  50    // larger errors in ms are corrected by padding or skipping
+#define ZONE_SYNC_INTERVAL   1000  // ms over which the error is averaged once in sync
+#define ZONE_MAX_RATIO_ADJUST 0.05 // limit of the drift correction
+
+CActiveAEZone::CActiveAEZone(const std::string &device, int latency, CEvent *inMsgEvent) :
+  m_device(device),
+  m_latency(latency / 1000.0),
+  m_sink(inMsgEvent)
+{
+  m_inputBuffers = NULL;
+  m_buffers = NULL;
+  m_configured = false;
+  m_started = false;
+  m_synced = false;
+  m_resampleIntegral = 0;
+  m_skipFrames = 0;
+  m_dropped = 0;
+  m_stats.Reset(44100, true);
+}
+
+CActiveAEZone::~CActiveAEZone()
+{
+  Dispose();
+}
+
+bool CActiveAEZone::Configure(const AEAudioFormat &format, AEQuality quality, CActiveAESink &master)
+{
+  if (m_configured &&
+      format.m_channelLayout == m_format.m_channelLayout &&
+      format.m_dataFormat == m_format.m_dataFormat &&
+      format.m_sampleRate == m_format.m_sampleRate &&
+      format.m_frames == m_format.m_frames)
+    return true;
+
+  Unconfigure();
+
+  if (!m_started)
+  {
+    m_sink.CopySinkList(master);
+    m_sink.Start();
+    m_started = true;
+  }
+
+  SinkConfig config;
+  config.format = format;
+  config.stats = &m_stats;
+  config.stageStats = NULL;
+  config.device = &m_device;
+
+  Message *reply;
+  if (!m_sink.m_controlPort.SendOutMessageSync(CSinkControlProtocol::CONFIGURE,
+                                               &reply, 5000, &config, sizeof(config)))
+  {
+    CLog::Log(LOGERROR, "CActiveAEZone::%s - failed to init %s", __FUNCTION__, m_device.c_str());
+    return false;
+  }
+
+  bool success = reply->signal == CSinkControlProtocol::ACC;
+  SinkReply *data = (SinkReply*)reply->data;
+  if (success && data)
+  {
+    m_sinkFormat = data->format;
+    m_stats.Reset(m_sinkFormat.m_sampleRate, true);
+    m_stats.SetSinkCacheTotal(data->cacheTotal);
+    m_stats.SetSinkLatency(data->latency);
+    m_stats.SetCurrentSinkFormat(m_sinkFormat);
+  }
+  reply->Release();
+
+  if (!success || !data || m_sinkFormat.m_dataFormat == AE_FMT_RAW)
+  {
+    CLog::Log(LOGERROR, "CActiveAEZone::%s - unable to open %s", __FUNCTION__, m_device.c_str());
+    return false;
+  }
+
+  // volume is applied by the engine, keep the sink from going idle
+  float volume = 1.0f;
+  bool streaming = true;
+  m_sink.m_controlPort.SendOutMessage(CSinkControlProtocol::VOLUME, &volume, sizeof(float));
+  m_sink.m_controlPort.SendOutMessage(CSinkControlProtocol::STREAMING, &streaming, sizeof(bool));
+
+  if ((double)m_sinkFormat.m_frames / m_sinkFormat.m_sampleRate > ZONE_WATER_LEVEL / 2)
+    m_sinkFormat.m_frames = ZONE_WATER_LEVEL / 2 * m_sinkFormat.m_sampleRate;
+
+  m_format = format;
+  m_inputBuffers = new CActiveAEBufferPool(m_format);
+  m_inputBuffers->Create(ZONE_CACHE_TIME * 1000);
+
+  // always resample, the ratio follows the drift to the main sink
+  m_buffers = new CActiveAEBufferPoolResample(m_format, m_sinkFormat, quality);
+  m_buffers->m_forceResampler = true;
+  m_buffers->Create(ZONE_WATER_LEVEL * 1000, true, false);
+
+  m_synced = false;
+  m_resampleIntegral = 0;
+  m_skipFrames = 0;
+  m_syncError.Flush(100);
+  m_configured = true;
+
+  CLog::Log(LOGNOTICE, "CActiveAEZone::%s - %s playing at %d Hz, %d channels", __FUNCTION__,
+            m_device.c_str(), m_sinkFormat.m_sampleRate, m_sinkFormat.m_channelLayout.Count());
+  return true;
+}
+
+void CActiveAEZone::Unconfigure()
+{
+  if (!m_started)
+    return;
+
+  Message *reply;
+  if (m_sink.m_controlPort.SendOutMessageSync(CSinkControlProtocol::UNCONFIGURE,
+                                               &reply, 2000))
+    reply->Release();
+  else
+    CLog::Log(LOGERROR, "CActiveAEZone::%s - failed to unconfigure %s", __FUNCTION__, m_device.c_str());
+
+  // the sink has given back everything it held
+  ReturnSamples();
+
+  if (m_buffers)
+  {
+    m_buffers->Flush();
+    delete m_buffers;
+    m_buffers = NULL;
+  }
+  delete m_inputBuffers;
+  m_inputBuffers = NULL;
+
+  if (m_dropped)
+    CLog::Log(LOGWARNING, "CActiveAEZone::%s - %s dropped %u buffers", __FUNCTION__, m_device.c_str(), m_dropped);
+  m_dropped = 0;
+  m_configured = false;
+}
+
+void CActiveAEZone::Dispose()
+{
+  Unconfigure();
+  if (m_started)
+  {
+    m_sink.Dispose();
+    m_started = false;
+  }
+}
+
+void CActiveAEZone::Flush()
+{
+  if (!m_configured)
+    return;
+
+  Message *reply;
+  if (m_sink.m_controlPort.SendOutMessageSync(CSinkControlProtocol::FLUSH,
+                                               &reply, 2000))
+    reply->Release();
+  ReturnSamples();
+  m_buffers->Flush();
+
+  m_synced = false;
+  m_resampleIntegral = 0;
+  m_skipFrames = 0;
+  m_buffers->m_resampleRatio = 1.0;
+  m_syncError.Flush(100);
+}
+
+void CActiveAEZone::AddSamples(CSampleBuffer *samples, double masterDelay)
+{
+  if (!m_configured)
+    return;
+
+  // positive if the zone would play this buffer earlier than the main sink
+  Sync((masterDelay - GetDelay()) * 1000);
+
+  int skip = std::min(m_skipFrames, samples->pkt->nb_samples);
+  m_skipFrames -= skip;
+  if (skip == samples->pkt->nb_samples)
+    return;
+
+  if (m_inputBuffers->m_freeSamples.empty())
+  {
+    m_dropped++;
+    m_synced = false;
+    return;
+  }
+
+  CSampleBuffer *buf = m_inputBuffers->GetFreeBuffer();
+  CSoundPacket *src = samples->pkt;
+  int frames = src->nb_samples - skip;
+  int bytesPerFrame = src->bytes_per_sample * src->config.channels / src->planes;
+  for (int i = 0; i < src->planes; i++)
+    memcpy(buf->pkt->data[i], src->data[i] + skip * bytesPerFrame, frames * bytesPerFrame);
+  buf->pkt->nb_samples = frames;
+  buf->timestamp = 0;
+  m_buffers->m_inputSamples.push_back(buf);
+}
+
+bool CActiveAEZone::Process()
+{
+  if (!m_configured)
+    return false;
+
+  ReturnSamples();
+
+  bool busy = m_buffers->ResampleBuffers();
+  while (!m_buffers->m_outputSamples.empty())
+  {
+    CSampleBuffer *out = m_buffers->m_outputSamples.front();
+    m_buffers->m_outputSamples.pop_front();
+    m_stats.AddSamples(out->pkt->nb_samples, m_noStreams);
+    m_sink.m_dataPort.SendOutMessage(CSinkDataProtocol::SAMPLE, &out, sizeof(CSampleBuffer*));
+    busy = true;
+  }
+  return busy;
+}
+
+void CActiveAEZone::ReturnSamples()
+{
+  Message *msg;
+  while (m_sink.m_dataPort.ReceiveInMessage(&msg))
+  {
+    if (msg->signal == CSinkDataProtocol::RETURNSAMPLE)
+    {
+      CSampleBuffer **buffer = (CSampleBuffer**)msg->data;
+      if (buffer)
+        (*buffer)->Return();
+    }
+    msg->Release();
+  }
+}
+
+double CActiveAEZone::GetDelay()
+{
+  AEDelayStatus status;
+  m_stats.GetDelay(status);
+  return status.GetDelay() + m_buffers->GetDelay() + m_latency;
+}
+
+void CActiveAEZone::Sync(double error)
+{
+  m_syncError.Add(error);
+
+  double average;
+  if (!m_syncError.Get(average, m_synced ? ZONE_SYNC_INTERVAL : 100))
+    return;
+
+  if (!m_synced || fabs(average) > ZONE_SYNC_THRESHOLD)
+  {
+    CLog::Log(LOGDEBUG, "CActiveAEZone::%s - %s off by %f ms", __FUNCTION__, m_device.c_str(), average);
+    int frames = fabs(average) / 1000 * m_format.m_sampleRate;
+    if (average > 0)
+      Pad(frames);
+    else
+      m_skipFrames = frames;
+
+    m_buffers->m_resampleRatio = 1.0;
+    m_resampleIntegral = 0;
+    m_syncError.Flush(100);
+    m_synced = true;
+    return;
+  }
+
+  // follow the clock drift between the sinks, same controller as for streams
+  if (fabs(average) > 5)
+    m_resampleIntegral += average / 1000 / 50;
+  double ratio = 1.0 + average / ZONE_SYNC_INTERVAL / 2.0 + m_resampleIntegral;
+  m_buffers->m_resampleRatio = std::max(1.0 - ZONE_MAX_RATIO_ADJUST, std::min(1.0 + ZONE_MAX_RATIO_ADJUST, ratio));
+}
+
+void CActiveAEZone::Pad(int frames)
+{
+  while (frames > 0 && !m_inputBuffers->m_freeSamples.empty())
+  {
+    CSampleBuffer *buf = m_inputBuffers->GetFreeBuffer();
+    int count = std::min(frames, buf->pkt->max_nb_samples);
+    for (int i = 0; i < buf->pkt->planes; i++)
+      memset(buf->pkt->data[i], 0, buf->pkt->linesize);
+    buf->pkt->nb_samples = count;
+    buf->timestamp = 0;
+    m_buffers->m_inputSamples.push_back(buf);
+    frames -= count;
+  }
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "ActiveAE.h"
+#include "ActiveAEStream.h"
+
+#include <list>
+#include <string>
+
+namespace ActiveAE
+{
+
+/**
+ * An additional output playing the mix of the engine. A zone has its own
+ * sink thread and resampler. It gets a copy of every mixed buffer and keeps
+ * its playing position aligned to the main sink: large offsets are fixed by
+ * padding or skipping frames, clock drift by the resample ratio.
+ */
+class CActiveAEZone
+{
+public:
+  CActiveAEZone(const std::string &device, int latency, CEvent *inMsgEvent);
+  ~CActiveAEZone();
+  bool Configure(const AEAudioFormat &format, AEQuality quality, CActiveAESink &master);
+  void Unconfigure();
+  void Dispose();
+  void Flush();
+  void AddSamples(CSampleBuffer *samples, double masterDelay);
+  bool Process();
+  bool IsConfigured() { return m_configured; }
+  const std::string& GetDevice() { return m_device; }
+
+protected:
+  void ReturnSamples();
+  double GetDelay();
+  void Sync(double error);
+  void Pad(int frames);
+
+  std::string m_device;
+  double m_latency;
+  CActiveAESink m_sink;
+  CEngineStats m_stats;
+  std::list<CActiveAEStream*> m_noStreams;
+  AEAudioFormat m_format;
+  AEAudioFormat m_sinkFormat;
+  CActiveAEBufferPool *m_inputBuffers;
+  CActiveAEBufferPoolResample *m_buffers;
+  bool m_configured;
+  bool m_started;
+  bool m_synced;
+  CSyncError m_syncError;
+  double m_resampleIntegral;
+  int m_skipFrames;
+  unsigned int m_dropped;
+};
+
+}
@@ -23,6 +23,7 @@
 #include <list>
 #include <vector>
 #include <utility>
+#include <stdint.h>
 
 #include "system.h"
 
@@ -65,6 +66,46 @@ enum AEQuality
   AE_QUALITY_GPU        = 101, /* GPU acceleration */
 };
 
+/**
+ * Counters of the sample buffer pools of an engine
+ */
+struct AEBufferStats
+{
+  uint64_t allocations; /* sample buffers allocated from the heap */
+  uint64_t reused;      /* sample buffers taken over from a discarded pool */
+  uint64_t returns;     /* buffers given back to their pool */
+  uint64_t misses;      /* requests for a buffer that found the pool empty */
+  uint64_t cachedBytes; /* memory held by buffers waiting to be reused */
+};
+
+/**
+ * Processing stages of an engine, see AERenderStats
+ */
+enum AERenderStage
+{
+  AE_STAGE_RESAMPLE = 0, /* resampling, remixing and format conversion of streams */
+  AE_STAGE_DSP,          /* audio dsp addons */
+  AE_STAGE_MIX,          /* mixing of streams and gui sounds */
+  AE_STAGE_ENCODE,       /* encoding for transcode output */
+  AE_STAGE_SINK,         /* conversion to and writing into the sink */
+  AE_STAGE_COUNT
+};
+
+/**
+ * Work done by each processing stage while the engine runs in freewheel mode
+ */
+struct AERenderStats
+{
+  uint64_t samples[AE_STAGE_COUNT]; /* frames produced by the stage */
+  double seconds[AE_STAGE_COUNT];   /* time spent in the stage */
+  double elapsed;                   /* wall clock time since freewheeling started */
+
+  double SamplesPerSecond(AERenderStage stage) const
+  {
+    return seconds[stage] > 0.0 ? samples[stage] / seconds[stage] : 0.0;
+  }
+};
+
 /**
  * IAE Interface
  */
@@ -263,5 +304,33 @@ public:
    * @return Returns true on success, else false.
    */
   virtual bool GetCurrentSinkFormat(AEAudioFormat &SinkFormat) { return false; }
+
+  /**
+   * Get the counters of the engine's sample buffer pools. Steady state
+   * playback must not increase the number of allocations.
+   *
+   * @param stats Counters, for more details see AEBufferStats.
+   * @return Returns true if the engine keeps these counters, else false.
+   */
+  virtual bool GetBufferStats(AEBufferStats &stats) { return false; }
+
+  /**
+   * Switch the engine to freewheel mode. Output is not paced to the clock of
+   * an audio device, streams are pulled as fast as they deliver data and
+   * rendered into a file or discarded. Used for benchmarking the engine.
+   *
+   * @param enable true for freewheel mode, false to return to the configured device
+   * @param file optional wav file the output is written to
+   * @return Returns true if the engine supports freewheel mode, else false.
+   */
+  virtual bool SetFreewheel(bool enable, const std::string &file = "") { return false; }
+
+  /**
+   * Get the throughput of the processing stages since freewheel mode was enabled
+   *
+   * @param stats Counters, for more details see AERenderStats.
+   * @return Returns true if the engine is freewheeling, else false.
+   */
+  virtual bool GetRenderStats(AERenderStats &stats) { return false; }
 };
 
@@ -21,19 +21,29 @@
 #include "system.h"
 
 #include <stdint.h>
+#include <inttypes.h>
 #include <limits.h>
+#include <string.h>
+#include <algorithm>
 
 #include "AESinkNULL.h"
 #include "cores/AudioEngine/Utils/AEUtil.h"
+#include "utils/EndianSwap.h"
+#include "utils/StringUtils.h"
 #include "utils/log.h"
 
+#define FREEWHEEL_DEVICE "FREEWHEEL"
+
 CAESinkNULL::CAESinkNULL()
   : CThread("AESinkNull"),
     m_draining(false),
     m_sink_frameSize(0),
     m_sinkbuffer_size(0),
     m_sinkbuffer_level(0),
-    m_sinkbuffer_sec_per_byte(0)
+    m_sinkbuffer_sec_per_byte(0),
+    m_freewheel(false),
+    m_fileOpen(false),
+    m_fileBytes(0)
 {
 }
 
@@ -55,6 +65,19 @@ bool CAESinkNULL::Initialize(AEAudioFormat &format, std::string &device)
   m_sinkbuffer_sec_per_byte = 1.0 / (double)(m_sink_frameSize * format.m_sampleRate);
 
   m_draining = false;
+
+  m_freewheel = StringUtils::StartsWith(device, FREEWHEEL_DEVICE);
+  if (m_freewheel)
+  {
+    // no thread, data is consumed as soon as it arrives
+    std::string file;
+    if (device.size() > strlen(FREEWHEEL_DEVICE) + 1)
+      file = device.substr(strlen(FREEWHEEL_DEVICE) + 1);
+    if (!file.empty() && !OpenFile(file))
+      return false;
+    return true;
+  }
+
   m_wake.Reset();
   m_inited.Reset();
   Create();
@@ -69,6 +92,18 @@ bool CAESinkNULL::Initialize(AEAudioFormat &format, std::string &device)
 
 void CAESinkNULL::Deinitialize()
 {
+  if (m_freewheel)
+  {
+    if (m_fileOpen)
+    {
+      WriteHeader();
+      m_file.Close();
+      m_fileOpen = false;
+      CLog::Log(LOGDEBUG, "CAESinkNULL::Deinitialize - wrote %" PRIu64 " bytes", m_fileBytes);
+    }
+    return;
+  }
+
   // force m_bStop and set m_wake, if might be sleeping.
   m_bStop = true;
   StopThread();
@@ -76,6 +111,12 @@ void CAESinkNULL::Deinitialize()
 
 void CAESinkNULL::GetDelay(AEDelayStatus& status)
 {
+  if (m_freewheel)
+  {
+    status.SetDelay(0);
+    return;
+  }
+
   double sinkbuffer_seconds_to_empty = m_sinkbuffer_sec_per_byte * (double)m_sinkbuffer_level;
   status.SetDelay(sinkbuffer_seconds_to_empty);
 }
@@ -87,6 +128,18 @@ double CAESinkNULL::GetCacheTotal()
 
 unsigned int CAESinkNULL::AddPackets(uint8_t **data, unsigned int frames, unsigned int offset)
 {
+  if (m_freewheel)
+  {
+    if (m_fileOpen)
+    {
+      unsigned int bytes = frames * m_sink_frameSize;
+      if (m_file.Write(data[0] + offset * m_sink_frameSize, bytes) != (ssize_t)bytes)
+        return INT_MAX; // more than requested signals an error
+      m_fileBytes += bytes;
+    }
+    return frames;
+  }
+
   unsigned int max_frames = (m_sinkbuffer_size - m_sinkbuffer_level) / m_sink_frameSize;
   if (frames > max_frames)
     frames = max_frames;
@@ -102,6 +155,9 @@ unsigned int CAESinkNULL::AddPackets(uint8_t **data, unsigned int frames, unsign
 
 void CAESinkNULL::Drain()
 {
+  if (m_freewheel)
+    return;
+
   m_draining = true;
   m_wake.Set();
 }
@@ -161,3 +217,45 @@ void CAESinkNULL::Process()
   }
   SetPriority(THREAD_PRIORITY_NORMAL);
 }
+
+bool CAESinkNULL::OpenFile(const std::string &file)
+{
+  if (!m_file.OpenForWrite(file, true))
+  {
+    CLog::Log(LOGERROR, "CAESinkNULL::OpenFile - unable to open %s", file.c_str());
+    return false;
+  }
+  m_fileOpen = true;
+  m_fileBytes = 0;
+
+  // reserve space for the header, sizes are filled in when closing
+  WriteHeader();
+  return true;
+}
+
+void CAESinkNULL::WriteHeader()
+{
+  unsigned int channels = m_format.m_channelLayout.Count();
+  unsigned int bits = CAEUtil::DataFormatToBits(m_format.m_dataFormat);
+  uint32_t dataSize = (uint32_t)std::min<uint64_t>(m_fileBytes, (uint64_t)0xFFFFFFFF - 36);
+
+  uint8_t header[44];
+  uint32_t *p32;
+  uint16_t *p16;
+  memcpy(header, "RIFF", 4);
+  p32 = (uint32_t*)(header + 4);  *p32 = Endian_SwapLE32(36 + dataSize);
+  memcpy(header + 8, "WAVEfmt ", 8);
+  p32 = (uint32_t*)(header + 16); *p32 = Endian_SwapLE32(16);
+  p16 = (uint16_t*)(header + 20); *p16 = Endian_SwapLE16(m_format.m_dataFormat == AE_FMT_FLOAT ? 3 : 1);
+  p16 = (uint16_t*)(header + 22); *p16 = Endian_SwapLE16(channels);
+  p32 = (uint32_t*)(header + 24); *p32 = Endian_SwapLE32(m_format.m_sampleRate);
+  p32 = (uint32_t*)(header + 28); *p32 = Endian_SwapLE32(m_format.m_sampleRate * m_sink_frameSize);
+  p16 = (uint16_t*)(header + 32); *p16 = Endian_SwapLE16(m_sink_frameSize);
+  p16 = (uint16_t*)(header + 34); *p16 = Endian_SwapLE16(bits);
+  memcpy(header + 36, "data", 4);
+  p32 = (uint32_t*)(header + 40); *p32 = Endian_SwapLE32(dataSize);
+
+  m_file.Seek(0, SEEK_SET);
+  m_file.Write(header, sizeof(header));
+  m_file.Seek(0, SEEK_END);
+}
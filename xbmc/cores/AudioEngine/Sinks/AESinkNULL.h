@@ -22,6 +22,7 @@
 #include "system.h"
 #include "threads/Thread.h"
 #include "cores/AudioEngine/Interfaces/AESink.h"
+#include "filesystem/File.h"
 
 class CAESinkNULL : public CThread, public IAESink
 {
@@ -42,6 +43,17 @@ public:
   static void          EnumerateDevices(AEDeviceList &devices, bool passthrough);
 private:
   virtual void         Process();
+  bool                 OpenFile(const std::string &file);
+  void                 WriteHeader();
+
+  /*!
+   \brief device "FREEWHEEL[:file]" takes data as fast as it comes in instead
+   of draining at the sample rate, optionally writing it to a wav file.
+   */
+  bool                 m_freewheel;
+  XFILE::CFile         m_file;
+  bool                 m_fileOpen;
+  uint64_t             m_fileBytes;
 
   CEvent               m_wake;
   CEvent               m_inited;
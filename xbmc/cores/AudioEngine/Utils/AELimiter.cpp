@@ -52,6 +52,11 @@ float CAELimiter::Run(float* frame[AE_CH_MAX], int channels, int offset /*= 0*/,
     }
   }
 
+  return Run(highest);
+}
+
+float CAELimiter::Run(float highest)
+{
   float sample = highest * m_amplify;
   if (sample * m_attenuation > 1.0f)
   {
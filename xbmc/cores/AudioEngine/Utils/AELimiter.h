@@ -50,4 +50,7 @@ class CAELimiter
     }
 
     float Run(float* frame[AE_CH_MAX], int channels, int offset = 0, bool planar = false);
+
+    // same as above, for a frame whose largest magnitude is already known
+    float Run(float highest);
 };
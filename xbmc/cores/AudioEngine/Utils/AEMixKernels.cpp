@@ -0,0 +1,525 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "AEMixKernels.h"
+#include "utils/CPUInfo.h"
+
+#include <algorithm>
+#include <math.h>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define HAS_X86_KERNELS
+#include <immintrin.h>
+#if defined(__GNUC__)
+#define TARGET_SSE __attribute__((target("sse")))
+#define TARGET_AVX __attribute__((target("avx")))
+#else
+#define TARGET_SSE
+#define TARGET_AVX
+#endif
+#endif
+
+#if defined(__ARM_NEON__) || defined(__aarch64__)
+#define HAS_NEON_KERNELS
+#include <arm_neon.h>
+#endif
+
+namespace
+{
+
+inline float SoftClampSample(float x)
+{
+  x = std::max(std::min(x, 3.0f), -3.0f);
+  float y = x * x;
+  return x * (27.0f + y) / (27.0f + 9.0f * y);
+}
+
+inline float MixSample(const CAEMixKernels::MixSource* src, int sources, int i)
+{
+  float acc = 0.0f;
+  for (int s = 0; s < sources; s++)
+    acc += src[s].data[i] * (src[s].gains ? src[s].gains[i] : src[s].gain);
+  return acc;
+}
+
+//------------------------------------------------------------------------
+// C
+//------------------------------------------------------------------------
+
+void MulC(float* data, float gain, int count)
+{
+  for (int i = 0; i < count; i++)
+    data[i] *= gain;
+}
+
+float MixC(float* dst, const CAEMixKernels::MixSource* src, int sources, int count)
+{
+  float peak = 0.0f;
+  for (int i = 0; i < count; i++)
+  {
+    dst[i] = MixSample(src, sources, i);
+    peak = std::max(peak, fabsf(dst[i]));
+  }
+  return peak;
+}
+
+void MaxAbsC(float* peaks, const float* data, int count)
+{
+  for (int i = 0; i < count; i++)
+    peaks[i] = std::max(peaks[i], fabsf(data[i]));
+}
+
+void SoftClampC(float* data, int count)
+{
+  for (int i = 0; i < count; i++)
+    data[i] = SoftClampSample(data[i]);
+}
+
+float DotC(const float* a, const float* b, int count)
+{
+  float acc = 0.0f;
+  for (int i = 0; i < count; i++)
+    acc += a[i] * b[i];
+  return acc;
+}
+
+const CAEMixKernels::Kernels kernelsC =
+{
+  "C",
+  MulC,
+  MixC,
+  MaxAbsC,
+  SoftClampC,
+  DotC
+};
+
+#if defined(HAS_X86_KERNELS)
+
+//------------------------------------------------------------------------
+// SSE
+//------------------------------------------------------------------------
+
+TARGET_SSE inline __m128 AbsSSE(__m128 x)
+{
+  return _mm_max_ps(x, _mm_sub_ps(_mm_setzero_ps(), x));
+}
+
+TARGET_SSE inline float HorizontalMaxSSE(__m128 x)
+{
+  x = _mm_max_ps(x, _mm_movehl_ps(x, x));
+  x = _mm_max_ss(x, _mm_shuffle_ps(x, x, 1));
+  return _mm_cvtss_f32(x);
+}
+
+TARGET_SSE void MulSSE(float* data, float gain, int count)
+{
+  const __m128 g = _mm_set1_ps(gain);
+  int i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    _mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), g));
+    _mm_storeu_ps(data + i + 4, _mm_mul_ps(_mm_loadu_ps(data + i + 4), g));
+  }
+  for (; i < count; i++)
+    data[i] *= gain;
+}
+
+TARGET_SSE float MixSSE(float* dst, const CAEMixKernels::MixSource* src, int sources, int count)
+{
+  __m128 peak = _mm_setzero_ps();
+  int i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    for (int s = 0; s < sources; s++)
+    {
+      __m128 g0, g1;
+      if (src[s].gains)
+      {
+        g0 = _mm_loadu_ps(src[s].gains + i);
+        g1 = _mm_loadu_ps(src[s].gains + i + 4);
+      }
+      else
+        g0 = g1 = _mm_set1_ps(src[s].gain);
+      acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(src[s].data + i), g0));
+      acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(src[s].data + i + 4), g1));
+    }
+    _mm_storeu_ps(dst + i, acc0);
+    _mm_storeu_ps(dst + i + 4, acc1);
+    peak = _mm_max_ps(peak, _mm_max_ps(AbsSSE(acc0), AbsSSE(acc1)));
+  }
+
+  float result = HorizontalMaxSSE(peak);
+  for (; i < count; i++)
+  {
+    dst[i] = MixSample(src, sources, i);
+    result = std::max(result, fabsf(dst[i]));
+  }
+  return result;
+}
+
+TARGET_SSE void MaxAbsSSE(float* peaks, const float* data, int count)
+{
+  int i = 0;
+  for (; i + 4 <= count; i += 4)
+    _mm_storeu_ps(peaks + i, _mm_max_ps(_mm_loadu_ps(peaks + i), AbsSSE(_mm_loadu_ps(data + i))));
+  for (; i < count; i++)
+    peaks[i] = std::max(peaks[i], fabsf(data[i]));
+}
+
+TARGET_SSE void SoftClampSSE(float* data, int count)
+{
+  const __m128 hi = _mm_set1_ps(3.0f);
+  const __m128 lo = _mm_set1_ps(-3.0f);
+  const __m128 c27 = _mm_set1_ps(27.0f);
+  const __m128 c9 = _mm_set1_ps(9.0f);
+  int i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    __m128 x = _mm_max_ps(_mm_min_ps(_mm_loadu_ps(data + i), hi), lo);
+    __m128 y = _mm_mul_ps(x, x);
+    __m128 num = _mm_mul_ps(x, _mm_add_ps(c27, y));
+    __m128 den = _mm_add_ps(c27, _mm_mul_ps(c9, y));
+    _mm_storeu_ps(data + i, _mm_div_ps(num, den));
+  }
+  for (; i < count; i++)
+    data[i] = SoftClampSample(data[i]);
+}
+
+TARGET_SSE float DotSSE(const float* a, const float* b, int count)
+{
+  __m128 acc0 = _mm_setzero_ps();
+  __m128 acc1 = _mm_setzero_ps();
+  int i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+  }
+  __m128 acc = _mm_add_ps(acc0, acc1);
+  acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+  acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, 1));
+  float result = _mm_cvtss_f32(acc);
+  for (; i < count; i++)
+    result += a[i] * b[i];
+  return result;
+}
+
+const CAEMixKernels::Kernels kernelsSSE =
+{
+  "SSE",
+  MulSSE,
+  MixSSE,
+  MaxAbsSSE,
+  SoftClampSSE,
+  DotSSE
+};
+
+//------------------------------------------------------------------------
+// AVX
+//------------------------------------------------------------------------
+
+TARGET_AVX inline __m256 AbsAVX(__m256 x)
+{
+  return _mm256_max_ps(x, _mm256_sub_ps(_mm256_setzero_ps(), x));
+}
+
+TARGET_AVX inline float HorizontalMaxAVX(__m256 x)
+{
+  __m128 m = _mm_max_ps(_mm256_castps256_ps128(x), _mm256_extractf128_ps(x, 1));
+  m = _mm_max_ps(m, _mm_movehl_ps(m, m));
+  m = _mm_max_ss(m, _mm_shuffle_ps(m, m, 1));
+  return _mm_cvtss_f32(m);
+}
+
+TARGET_AVX void MulAVX(float* data, float gain, int count)
+{
+  const __m256 g = _mm256_set1_ps(gain);
+  int i = 0;
+  for (; i + 16 <= count; i += 16)
+  {
+    _mm256_storeu_ps(data + i, _mm256_mul_ps(_mm256_loadu_ps(data + i), g));
+    _mm256_storeu_ps(data + i + 8, _mm256_mul_ps(_mm256_loadu_ps(data + i + 8), g));
+  }
+  for (; i < count; i++)
+    data[i] *= gain;
+}
+
+TARGET_AVX float MixAVX(float* dst, const CAEMixKernels::MixSource* src, int sources, int count)
+{
+  __m256 peak = _mm256_setzero_ps();
+  int i = 0;
+  for (; i + 16 <= count; i += 16)
+  {
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    for (int s = 0; s < sources; s++)
+    {
+      __m256 g0, g1;
+      if (src[s].gains)
+      {
+        g0 = _mm256_loadu_ps(src[s].gains + i);
+        g1 = _mm256_loadu_ps(src[s].gains + i + 8);
+      }
+      else
+        g0 = g1 = _mm256_set1_ps(src[s].gain);
+      acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(_mm256_loadu_ps(src[s].data + i), g0));
+      acc1 = _mm256_add_ps(acc1, _mm256_mul_ps(_mm256_loadu_ps(src[s].data + i + 8), g1));
+    }
+    _mm256_storeu_ps(dst + i, acc0);
+    _mm256_storeu_ps(dst + i + 8, acc1);
+    peak = _mm256_max_ps(peak, _mm256_max_ps(AbsAVX(acc0), AbsAVX(acc1)));
+  }
+
+  float result = HorizontalMaxAVX(peak);
+  for (; i < count; i++)
+  {
+    dst[i] = MixSample(src, sources, i);
+    result = std::max(result, fabsf(dst[i]));
+  }
+  return result;
+}
+
+TARGET_AVX void MaxAbsAVX(float* peaks, const float* data, int count)
+{
+  int i = 0;
+  for (; i + 8 <= count; i += 8)
+    _mm256_storeu_ps(peaks + i, _mm256_max_ps(_mm256_loadu_ps(peaks + i), AbsAVX(_mm256_loadu_ps(data + i))));
+  for (; i < count; i++)
+    peaks[i] = std::max(peaks[i], fabsf(data[i]));
+}
+
+TARGET_AVX void SoftClampAVX(float* data, int count)
+{
+  const __m256 hi = _mm256_set1_ps(3.0f);
+  const __m256 lo = _mm256_set1_ps(-3.0f);
+  const __m256 c27 = _mm256_set1_ps(27.0f);
+  const __m256 c9 = _mm256_set1_ps(9.0f);
+  int i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m256 x = _mm256_max_ps(_mm256_min_ps(_mm256_loadu_ps(data + i), hi), lo);
+    __m256 y = _mm256_mul_ps(x, x);
+    __m256 num = _mm256_mul_ps(x, _mm256_add_ps(c27, y));
+    __m256 den = _mm256_add_ps(c27, _mm256_mul_ps(c9, y));
+    _mm256_storeu_ps(data + i, _mm256_div_ps(num, den));
+  }
+  for (; i < count; i++)
+    data[i] = SoftClampSample(data[i]);
+}
+
+TARGET_AVX float DotAVX(const float* a, const float* b, int count)
+{
+  __m256 acc0 = _mm256_setzero_ps();
+  __m256 acc1 = _mm256_setzero_ps();
+  int i = 0;
+  for (; i + 16 <= count; i += 16)
+  {
+    acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+    acc1 = _mm256_add_ps(acc1, _mm256_mul_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8)));
+  }
+  for (; i + 8 <= count; i += 8)
+    acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+  acc0 = _mm256_add_ps(acc0, acc1);
+  __m128 acc = _mm_add_ps(_mm256_castps256_ps128(acc0), _mm256_extractf128_ps(acc0, 1));
+  acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+  acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, 1));
+  float result = _mm_cvtss_f32(acc);
+  for (; i < count; i++)
+    result += a[i] * b[i];
+  return result;
+}
+
+const CAEMixKernels::Kernels kernelsAVX =
+{
+  "AVX",
+  MulAVX,
+  MixAVX,
+  MaxAbsAVX,
+  SoftClampAVX,
+  DotAVX
+};
+
+#endif
+
+#if defined(HAS_NEON_KERNELS)
+
+//------------------------------------------------------------------------
+// NEON
+//------------------------------------------------------------------------
+
+inline float HorizontalMaxNEON(float32x4_t x)
+{
+  float32x2_t m = vpmax_f32(vget_low_f32(x), vget_high_f32(x));
+  m = vpmax_f32(m, m);
+  return vget_lane_f32(m, 0);
+}
+
+void MulNEON(float* data, float gain, int count)
+{
+  const float32x4_t g = vdupq_n_f32(gain);
+  int i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    vst1q_f32(data + i, vmulq_f32(vld1q_f32(data + i), g));
+    vst1q_f32(data + i + 4, vmulq_f32(vld1q_f32(data + i + 4), g));
+  }
+  for (; i < count; i++)
+    data[i] *= gain;
+}
+
+float MixNEON(float* dst, const CAEMixKernels::MixSource* src, int sources, int count)
+{
+  float32x4_t peak = vdupq_n_f32(0.0f);
+  int i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    float32x4_t acc0 = vdupq_n_f32(0.0f);
+    float32x4_t acc1 = vdupq_n_f32(0.0f);
+    for (int s = 0; s < sources; s++)
+    {
+      float32x4_t g0, g1;
+      if (src[s].gains)
+      {
+        g0 = vld1q_f32(src[s].gains + i);
+        g1 = vld1q_f32(src[s].gains + i + 4);
+      }
+      else
+        g0 = g1 = vdupq_n_f32(src[s].gain);
+      // no vmla here, the fused result would differ from the C kernels
+      acc0 = vaddq_f32(acc0, vmulq_f32(vld1q_f32(src[s].data + i), g0));
+      acc1 = vaddq_f32(acc1, vmulq_f32(vld1q_f32(src[s].data + i + 4), g1));
+    }
+    vst1q_f32(dst + i, acc0);
+    vst1q_f32(dst + i + 4, acc1);
+    peak = vmaxq_f32(peak, vmaxq_f32(vabsq_f32(acc0), vabsq_f32(acc1)));
+  }
+
+  float result = HorizontalMaxNEON(peak);
+  for (; i < count; i++)
+  {
+    dst[i] = MixSample(src, sources, i);
+    result = std::max(result, fabsf(dst[i]));
+  }
+  return result;
+}
+
+void MaxAbsNEON(float* peaks, const float* data, int count)
+{
+  int i = 0;
+  for (; i + 4 <= count; i += 4)
+    vst1q_f32(peaks + i, vmaxq_f32(vld1q_f32(peaks + i), vabsq_f32(vld1q_f32(data + i))));
+  for (; i < count; i++)
+    peaks[i] = std::max(peaks[i], fabsf(data[i]));
+}
+
+void SoftClampNEON(float* data, int count)
+{
+  const float32x4_t hi = vdupq_n_f32(3.0f);
+  const float32x4_t lo = vdupq_n_f32(-3.0f);
+  const float32x4_t c27 = vdupq_n_f32(27.0f);
+  const float32x4_t c9 = vdupq_n_f32(9.0f);
+  int i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    float32x4_t x = vmaxq_f32(vminq_f32(vld1q_f32(data + i), hi), lo);
+    float32x4_t y = vmulq_f32(x, x);
+    float32x4_t num = vmulq_f32(x, vaddq_f32(c27, y));
+    float32x4_t den = vaddq_f32(c27, vmulq_f32(c9, y));
+#if defined(__aarch64__)
+    vst1q_f32(data + i, vdivq_f32(num, den));
+#else
+    // armv7 has no divide, refine the reciprocal estimate twice
+    float32x4_t r = vrecpeq_f32(den);
+    r = vmulq_f32(r, vrecpsq_f32(den, r));
+    r = vmulq_f32(r, vrecpsq_f32(den, r));
+    vst1q_f32(data + i, vmulq_f32(num, r));
+#endif
+  }
+  for (; i < count; i++)
+    data[i] = SoftClampSample(data[i]);
+}
+
+float DotNEON(const float* a, const float* b, int count)
+{
+  float32x4_t acc0 = vdupq_n_f32(0.0f);
+  float32x4_t acc1 = vdupq_n_f32(0.0f);
+  int i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    acc0 = vmlaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+    acc1 = vmlaq_f32(acc1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+  }
+  acc0 = vaddq_f32(acc0, acc1);
+  float32x2_t acc = vadd_f32(vget_low_f32(acc0), vget_high_f32(acc0));
+  acc = vpadd_f32(acc, acc);
+  float result = vget_lane_f32(acc, 0);
+  for (; i < count; i++)
+    result += a[i] * b[i];
+  return result;
+}
+
+const CAEMixKernels::Kernels kernelsNEON =
+{
+  "NEON",
+  MulNEON,
+  MixNEON,
+  MaxAbsNEON,
+  SoftClampNEON,
+  DotNEON
+};
+
+#endif
+
+}
+
+std::vector<const CAEMixKernels::Kernels*> CAEMixKernels::GetAvailable()
+{
+  std::vector<const Kernels*> kernels;
+  kernels.push_back(&kernelsC);
+
+#if defined(HAS_X86_KERNELS)
+  unsigned int features = g_cpuInfo.GetCPUFeatures();
+  if (features & CPU_FEATURE_SSE)
+    kernels.push_back(&kernelsSSE);
+  if (features & CPU_FEATURE_AVX)
+    kernels.push_back(&kernelsAVX);
+#endif
+
+#if defined(HAS_NEON_KERNELS)
+#if defined(__aarch64__)
+  kernels.push_back(&kernelsNEON);
+#else
+  if (g_cpuInfo.GetCPUFeatures() & CPU_FEATURE_NEON)
+    kernels.push_back(&kernelsNEON);
+#endif
+#endif
+
+  return kernels;
+}
+
+const CAEMixKernels::Kernels& CAEMixKernels::Get()
+{
+  // the last one is the most capable
+  static const Kernels* kernels = GetAvailable().back();
+  return *kernels;
+}
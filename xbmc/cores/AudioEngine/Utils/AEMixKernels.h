@@ -0,0 +1,63 @@
+#pragma once
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <vector>
+
+/**
+ * Sample kernels for the float mixing stage of ActiveAE. Every set
+ * implements the same operations, Get() returns the fastest one supported
+ * by the cpu (see CCPUInfo). Counts are in floats, buffers may be unaligned.
+ */
+class CAEMixKernels
+{
+public:
+  struct MixSource
+  {
+    const float* data;
+    // one gain per float, nullptr to use gain for all of them
+    const float* gains;
+    float gain;
+  };
+
+  struct Kernels
+  {
+    const char* name;
+    // data[i] *= gain
+    void (*mul)(float* data, float gain, int count);
+    // dst[i] = sum of src[s].data[i] * gain, in source order. dst may be one
+    // of the sources. Returns the largest magnitude written.
+    float (*mix)(float* dst, const MixSource* src, int sources, int count);
+    // peaks[i] = max(peaks[i], |data[i]|)
+    void (*maxAbs)(float* peaks, const float* data, int count);
+    // rational tanh approximation, see CAEUtil::SoftClamp
+    void (*softClamp)(float* data, int count);
+    // sum of a[i] * b[i], the order of additions is up to the kernel
+    float (*dot)(const float* a, const float* b, int count);
+  };
+
+  static const Kernels& Get();
+
+  /**
+   * All kernel sets that can run on this cpu, the plain C one first.
+   */
+  static std::vector<const Kernels*> GetAvailable();
+};
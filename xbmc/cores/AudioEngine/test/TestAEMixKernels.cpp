@@ -0,0 +1,168 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "cores/AudioEngine/Utils/AEMixKernels.h"
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace
+{
+// odd count so the scalar tails are exercised too
+const int count = 1021;
+
+std::vector<float> Pattern(int size, int seed)
+{
+  std::vector<float> data(size);
+  for (int i = 0; i < size; i++)
+    data[i] = std::sin((i + 1) * 0.37f * seed) * 0.8f;
+  return data;
+}
+
+// what ActiveAE did before the fused mix: one pass per stream, followed by a
+// pass looking for clipping
+void MixSeparately(const CAEMixKernels::Kernels& kernels, float* out,
+                   const std::vector<CAEMixKernels::MixSource>& src, int samples)
+{
+  CAEMixKernels::MixSource first = src[0];
+  kernels.mix(out, &first, 1, samples);
+  for (size_t s = 1; s < src.size(); s++)
+  {
+    CAEMixKernels::MixSource pair[2] = { { out, nullptr, 1.0f }, src[s] };
+    kernels.mix(out, pair, 2, samples);
+  }
+  CAEMixKernels::MixSource self = { out, nullptr, 1.0f };
+  kernels.mix(out, &self, 1, samples);
+}
+}
+
+TEST(TestAEMixKernels, MatchC)
+{
+  const CAEMixKernels::Kernels& ref = *CAEMixKernels::GetAvailable().front();
+
+  std::vector<float> a = Pattern(count, 1);
+  std::vector<float> b = Pattern(count, 2);
+  std::vector<float> c = Pattern(count, 3);
+  std::vector<float> gains = Pattern(count, 4);
+
+  for (auto kernels : CAEMixKernels::GetAvailable())
+  {
+    SCOPED_TRACE(kernels->name);
+
+    std::vector<float> mul(a), mulRef(a);
+    kernels->mul(mul.data(), 0.3f, count);
+    ref.mul(mulRef.data(), 0.3f, count);
+    EXPECT_EQ(mulRef, mul);
+
+    // in place, like ActiveAE does with the first stream
+    std::vector<float> mix(a), mixRef(a);
+    CAEMixKernels::MixSource src[3] = { { mix.data(), nullptr, 0.5f },
+                                        { b.data(), gains.data(), 0.0f },
+                                        { c.data(), nullptr, 2.0f } };
+    CAEMixKernels::MixSource srcRef[3] = { { mixRef.data(), nullptr, 0.5f },
+                                           { b.data(), gains.data(), 0.0f },
+                                           { c.data(), nullptr, 2.0f } };
+    float peak = kernels->mix(mix.data(), src, 3, count);
+    float peakRef = ref.mix(mixRef.data(), srcRef, 3, count);
+    EXPECT_EQ(mixRef, mix);
+    EXPECT_EQ(peakRef, peak);
+
+    std::vector<float> peaks(count, 0.1f), peaksRef(count, 0.1f);
+    kernels->maxAbs(peaks.data(), b.data(), count);
+    ref.maxAbs(peaksRef.data(), b.data(), count);
+    EXPECT_EQ(peaksRef, peaks);
+
+    // summation order differs between the sets
+    float dot = kernels->dot(a.data(), b.data(), count);
+    float dotRef = ref.dot(a.data(), b.data(), count);
+    EXPECT_NEAR(dotRef, dot, 1e-3f);
+
+    // the armv7 reciprocal is not exact
+    std::vector<float> clamp(mix), clampRef(mix);
+    kernels->softClamp(clamp.data(), count);
+    ref.softClamp(clampRef.data(), count);
+    for (int i = 0; i < count; i++)
+      EXPECT_NEAR(clampRef[i], clamp[i], 1e-6f);
+  }
+}
+
+TEST(TestAEMixKernels, SoftClamp)
+{
+  for (auto kernels : CAEMixKernels::GetAvailable())
+  {
+    SCOPED_TRACE(kernels->name);
+
+    std::vector<float> data = { -100.0f, -3.0f, -1.0f, 0.0f, 0.5f, 1.0f, 3.0f, 100.0f };
+    kernels->softClamp(data.data(), data.size());
+
+    EXPECT_FLOAT_EQ(-1.0f, data[0]);
+    EXPECT_FLOAT_EQ(-1.0f, data[1]);
+    EXPECT_FLOAT_EQ(0.0f, data[3]);
+    EXPECT_FLOAT_EQ(1.0f, data[6]);
+    EXPECT_FLOAT_EQ(1.0f, data[7]);
+    for (size_t i = 1; i < data.size(); i++)
+      EXPECT_LE(data[i - 1], data[i]);
+    EXPECT_LT(data[4], 0.5f);
+  }
+}
+
+TEST(TestAEMixKernels, DISABLED_MixStreams)
+{
+  // up to 4 streams of 8 channel interleaved audio, one sink period each
+  const int samples = 8 * 1024;
+  const int periods = 2000;
+
+  std::vector<std::vector<float> > streams;
+  for (int s = 0; s < 4; s++)
+    streams.push_back(Pattern(samples, s + 1));
+  std::vector<float> gains(samples, 0.7f);
+  std::vector<float> out(samples);
+
+  for (auto kernels : CAEMixKernels::GetAvailable())
+  {
+    SCOPED_TRACE(kernels->name);
+
+    std::vector<CAEMixKernels::MixSource> src;
+    for (size_t n = 1; n <= streams.size(); n++)
+    {
+      CAEMixKernels::MixSource source = { streams[n - 1].data(), n > 1 ? nullptr : gains.data(), 0.5f };
+      src.push_back(source);
+
+      auto start = std::chrono::steady_clock::now();
+      for (int p = 0; p < periods; p++)
+        MixSeparately(*kernels, out.data(), src, samples);
+      auto fused = std::chrono::steady_clock::now();
+      for (int p = 0; p < periods; p++)
+        kernels->mix(out.data(), src.data(), n, samples);
+      auto end = std::chrono::steady_clock::now();
+
+      // ns per sample
+      double total = (double)samples * periods;
+      std::string key = std::string(kernels->name) + "_" + std::to_string(n) + "_streams";
+      RecordProperty(key + "_separate", std::to_string(std::chrono::duration<double, std::nano>(fused - start).count() / total));
+      RecordProperty(key + "_fused", std::to_string(std::chrono::duration<double, std::nano>(end - fused).count() / total));
+    }
+  }
+}
@@ -0,0 +1,178 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "cores/AudioEngine/Engines/ActiveAE/ActiveAEResampleFFMPEG.h"
+#include "cores/AudioEngine/Engines/ActiveAE/ActiveAEResamplePolyphase.h"
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include "libavutil/channel_layout.h"
+}
+
+using namespace ActiveAE;
+
+namespace
+{
+const int channels = 2;
+const int frames = 1024;
+
+// Feeds a 1 kHz stereo sine in packets of frames samples and returns the
+// output of the first channel.
+std::vector<float> Feed(IAEResample &resampler, int srcRate, int packets, double ratio = 1.0)
+{
+  std::vector<float> in(channels * frames);
+  std::vector<float> out(channels * frames * 8);
+  std::vector<float> result;
+  long pos = 0;
+
+  for (int p = 0; p < packets; p++)
+  {
+    for (int i = 0; i < frames; i++, pos++)
+    {
+      float value = 0.5f * std::sin(2.0 * M_PI * 1000.0 * pos / srcRate);
+      for (int c = 0; c < channels; c++)
+        in[i * channels + c] = value;
+    }
+    uint8_t *src[1] = { (uint8_t*)in.data() };
+    uint8_t *dst[1] = { (uint8_t*)out.data() };
+    int samples = resampler.Resample(dst, frames * 8, src, frames, ratio);
+    EXPECT_GE(samples, 0);
+    for (int i = 0; i < samples; i++)
+      result.push_back(out[i * channels]);
+  }
+  return result;
+}
+
+// rms difference to the best aligned reference sine in dB below full scale
+double Error(const std::vector<float> &data, int rate)
+{
+  double best = 1e9;
+  for (int lag = 0; lag < rate / 1000; lag++)
+  {
+    double sum = 0.0;
+    for (size_t i = 2048; i < data.size() - 2048; i++)
+    {
+      double ref = 0.5 * std::sin(2.0 * M_PI * 1000.0 * (i + lag) / rate);
+      sum += (data[i] - ref) * (data[i] - ref);
+    }
+    best = std::min(best, sum);
+  }
+  return 20.0 * std::log10(std::sqrt(best / (data.size() - 4096)));
+}
+
+bool InitStereo(IAEResample &resampler, int srcRate, int dstRate, AEQuality quality)
+{
+  return resampler.Init(AV_CH_LAYOUT_STEREO, channels, dstRate, AV_SAMPLE_FMT_FLT, 32, 0,
+                        AV_CH_LAYOUT_STEREO, channels, srcRate, AV_SAMPLE_FMT_FLT, 32, 0,
+                        false, false, nullptr, quality, true);
+}
+}
+
+TEST(TestAEResample, FilterBankCache)
+{
+  auto bank = CActiveAEResamplePolyphase::GetFilterBank(44100, 48000, AE_QUALITY_HIGH);
+  EXPECT_EQ(bank, CActiveAEResamplePolyphase::GetFilterBank(44100, 48000, AE_QUALITY_HIGH));
+  EXPECT_NE(bank, CActiveAEResamplePolyphase::GetFilterBank(48000, 44100, AE_QUALITY_HIGH));
+  EXPECT_TRUE(bank->exact);
+  EXPECT_EQ(0, bank->taps % 8);
+  EXPECT_EQ(0, bank->phases % 160);
+}
+
+TEST(TestAEResample, Quality)
+{
+  const AEQuality qualities[] = { AE_QUALITY_MID, AE_QUALITY_HIGH, AE_QUALITY_REALLYHIGH };
+  const double limits[] = { -80.0, -95.0, -110.0 };
+
+  for (int q = 0; q < 3; q++)
+  {
+    for (int rate : { 44100, 96000 })
+    {
+      SCOPED_TRACE(rate);
+      CActiveAEResamplePolyphase resampler;
+      ASSERT_TRUE(InitStereo(resampler, rate, 48000, qualities[q]));
+      std::vector<float> out = Feed(resampler, rate, 100);
+
+      // everything that went in is either out or still buffered
+      double expected = 100.0 * frames * 48000 / rate;
+      EXPECT_NEAR(expected, out.size() + resampler.GetBufferedSamples(), 2.0);
+      EXPECT_LT(Error(out, 48000), limits[q]);
+    }
+  }
+}
+
+TEST(TestAEResample, Ratio)
+{
+  CActiveAEResamplePolyphase resampler;
+  ASSERT_TRUE(InitStereo(resampler, 48000, 48000, AE_QUALITY_HIGH));
+
+  // stretching by one percent yields one percent more samples, no re-init
+  std::vector<float> out = Feed(resampler, 48000, 100, 1.01);
+  double expected = 100.0 * frames * 1.01;
+  EXPECT_NEAR(expected, out.size() + resampler.GetBufferedSamples(), 2.0);
+
+  // draining pushes out the rest
+  std::vector<float> tail(channels * frames);
+  uint8_t *dst[1] = { (uint8_t*)tail.data() };
+  while (resampler.Resample(dst, frames, nullptr, 0, 1.0) > 0)
+    ;
+  EXPECT_EQ(0, resampler.GetBufferedSamples());
+}
+
+TEST(TestAEResample, DISABLED_CompareWithFFmpeg)
+{
+  const AEQuality qualities[] = { AE_QUALITY_LOW, AE_QUALITY_MID, AE_QUALITY_HIGH };
+  const char *names[] = { "low", "mid", "high" };
+  const int packets = 2000;
+
+  for (int q = 0; q < 3; q++)
+  {
+    for (int rate : { 44100, 48000 })
+    {
+      SCOPED_TRACE(rate);
+      CActiveAEResampleFFMPEG ffmpeg;
+      CActiveAEResamplePolyphase polyphase;
+      IAEResample *resamplers[] = { &ffmpeg, &polyphase };
+
+      for (IAEResample *resampler : resamplers)
+      {
+        ASSERT_TRUE(InitStereo(*resampler, rate, 48000, qualities[q]));
+
+        // 48k -> 48k is the sync playback case, nudge the ratio every packet
+        double ratio = (rate == 48000) ? 1.001 : 1.0;
+        auto start = std::chrono::steady_clock::now();
+        std::vector<float> out = Feed(*resampler, rate, packets, ratio);
+        auto end = std::chrono::steady_clock::now();
+
+        std::string key = std::string(resampler->GetName()) + "_" + names[q] + "_" + std::to_string(rate);
+        RecordProperty(key + "_ns", std::to_string(std::chrono::duration<double, std::nano>(end - start).count() / (out.size() * channels)));
+        if (rate != 48000)
+          RecordProperty(key + "_db", std::to_string(Error(out, 48000)));
+      }
+    }
+  }
+}
@@ -0,0 +1,114 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "cores/AudioEngine/Sinks/AESinkNULL.h"
+#include "filesystem/File.h"
+
+#include "gtest/gtest.h"
+
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+namespace
+{
+const char *wavFile = "special://temp/freewheel.wav";
+
+AEAudioFormat StereoFloat()
+{
+  AEAudioFormat format;
+  format.m_dataFormat = AE_FMT_FLOAT;
+  format.m_sampleRate = 48000;
+  format.m_channelLayout = AE_CH_LAYOUT_2_0;
+  return format;
+}
+
+uint32_t ReadLE32(const uint8_t *p)
+{
+  return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+}
+
+class TestAESinkNULL : public testing::Test
+{
+protected:
+  virtual void TearDown()
+  {
+    XFILE::CFile::Delete(wavFile);
+  }
+};
+
+TEST_F(TestAESinkNULL, FreewheelTakesAllFrames)
+{
+  CAESinkNULL sink;
+  AEAudioFormat format = StereoFloat();
+  std::string device = "FREEWHEEL";
+  ASSERT_TRUE(sink.Initialize(format, device));
+
+  // ten seconds, far more than the buffer of the paced sink
+  unsigned int frames = format.m_sampleRate * 10;
+  std::vector<uint8_t> buffer(frames * format.m_frameSize);
+  uint8_t *data = buffer.data();
+  EXPECT_EQ(frames, sink.AddPackets(&data, frames, 0));
+
+  AEDelayStatus status;
+  sink.GetDelay(status);
+  EXPECT_EQ(0.0, status.delay);
+
+  sink.Drain();
+  sink.Deinitialize();
+}
+
+TEST_F(TestAESinkNULL, FreewheelWritesWav)
+{
+  CAESinkNULL sink;
+  AEAudioFormat format = StereoFloat();
+  std::string device = std::string("FREEWHEEL:") + wavFile;
+  ASSERT_TRUE(sink.Initialize(format, device));
+
+  unsigned int frames = 1000;
+  std::vector<uint8_t> buffer(frames * format.m_frameSize, 0x55);
+  uint8_t *data = buffer.data();
+  EXPECT_EQ(frames / 2, sink.AddPackets(&data, frames / 2, 0));
+  EXPECT_EQ(frames / 2, sink.AddPackets(&data, frames / 2, frames / 2));
+  sink.Deinitialize();
+
+  XFILE::CFile file;
+  ASSERT_TRUE(file.Open(wavFile));
+  uint32_t dataSize = frames * format.m_frameSize;
+  ASSERT_EQ(44 + dataSize, file.GetLength());
+
+  uint8_t header[44];
+  ASSERT_EQ(44, file.Read(header, sizeof(header)));
+  EXPECT_EQ(0, memcmp(header, "RIFF", 4));
+  EXPECT_EQ(36 + dataSize, ReadLE32(header + 4));
+  EXPECT_EQ(0, memcmp(header + 8, "WAVEfmt ", 8));
+  EXPECT_EQ(3, header[20]); // float
+  EXPECT_EQ(2, header[22]);
+  EXPECT_EQ(48000u, ReadLE32(header + 24));
+  EXPECT_EQ(0, memcmp(header + 36, "data", 4));
+  EXPECT_EQ(dataSize, ReadLE32(header + 40));
+
+  std::vector<uint8_t> samples(dataSize);
+  ASSERT_EQ((ssize_t)dataSize, file.Read(samples.data(), dataSize));
+  EXPECT_EQ(buffer, samples);
+  file.Close();
+}
@@ -19,6 +19,14 @@
 */
 
 #include "cores/DataCacheCore.h"
+#include "threads/SingleLock.h"
+
+CDataCacheCore::CDataCacheCore() :
+  m_hasAVInfoChanges(false)
+{
+  m_playerVideoInfo.decoderThreads = 0;
+  m_playerVideoInfo.decodeTime = 0.0;
+}
 
 bool CDataCacheCore::HasAVInfoChanges()
 {
@@ -35,4 +43,68 @@ void CDataCacheCore::SignalVideoInfoChange()
 void CDataCacheCore::SignalAudioInfoChange()
 {
   m_hasAVInfoChanges = true;
-}
\ No newline at end of file
+}
+
+void CDataCacheCore::SetVideoDecoderThreading(int threads, const std::string &type)
+{
+  CSingleLock lock(m_videoPlayerSection);
+
+  m_playerVideoInfo.decoderThreads = threads;
+  m_playerVideoInfo.decoderThreadType = type;
+}
+
+int CDataCacheCore::GetVideoDecoderThreads()
+{
+  CSingleLock lock(m_videoPlayerSection);
+
+  return m_playerVideoInfo.decoderThreads;
+}
+
+std::string CDataCacheCore::GetVideoDecoderThreadType()
+{
+  CSingleLock lock(m_videoPlayerSection);
+
+  return m_playerVideoInfo.decoderThreadType;
+}
+
+void CDataCacheCore::SetVideoDecodeTime(double ms)
+{
+  CSingleLock lock(m_videoPlayerSection);
+
+  m_playerVideoInfo.decodeTime = ms;
+}
+
+double CDataCacheCore::GetVideoDecodeTime()
+{
+  CSingleLock lock(m_videoPlayerSection);
+
+  return m_playerVideoInfo.decodeTime;
+}
+
+void CDataCacheCore::SetAVSyncStats(const CVariant &stats)
+{
+  CSingleLock lock(m_syncStatsSection);
+
+  m_syncStats = stats;
+}
+
+void CDataCacheCore::GetAVSyncStats(CVariant &stats)
+{
+  CSingleLock lock(m_syncStatsSection);
+
+  stats = m_syncStats;
+}
+
+void CDataCacheCore::SetCacheStatus(const XFILE::SCacheStatus &status)
+{
+  CSingleLock lock(m_cacheStatusSection);
+
+  m_cacheStatus = status;
+}
+
+XFILE::SCacheStatus CDataCacheCore::GetCacheStatus()
+{
+  CSingleLock lock(m_cacheStatusSection);
+
+  return m_cacheStatus;
+}
@@ -20,15 +20,51 @@
 *
 */
 
+#include "filesystem/IFileTypes.h"
+#include "threads/CriticalSection.h"
+#include "utils/Variant.h"
+
+#include <string>
+
 class CDataCacheCore
 {
 public:
+  CDataCacheCore();
   bool HasAVInfoChanges();
   void SignalVideoInfoChange();
   void SignalAudioInfoChange();
 
+  // player video info
+  void SetVideoDecoderThreading(int threads, const std::string &type);
+  int GetVideoDecoderThreads();
+  std::string GetVideoDecoderThreadType();
+  void SetVideoDecodeTime(double ms);
+  double GetVideoDecodeTime();
+
+  // player a/v sync statistics, see CProcessInfo::GetAVSyncStats
+  void SetAVSyncStats(const CVariant &stats);
+  void GetAVSyncStats(CVariant &stats);
+
+  // input cache of the player, see CFileCache
+  void SetCacheStatus(const XFILE::SCacheStatus &status);
+  XFILE::SCacheStatus GetCacheStatus();
+
 protected:
   volatile bool m_hasAVInfoChanges;
+
+  CCriticalSection m_videoPlayerSection;
+  struct SPlayerVideoInfo
+  {
+    int decoderThreads;
+    std::string decoderThreadType;
+    double decodeTime;
+  } m_playerVideoInfo;
+
+  CCriticalSection m_syncStatsSection;
+  CVariant m_syncStats;
+
+  CCriticalSection m_cacheStatusSection;
+  XFILE::SCacheStatus m_cacheStatus;
 };
 
 extern CDataCacheCore g_dataCacheCore;
\ No newline at end of file
@@ -238,6 +238,11 @@ bool CDVDClock::GetClockInfo(int& MissedVblanks, double& ClockSpeed, double& Ref
   return m_videoRefClock->GetClockInfo(MissedVblanks, ClockSpeed, RefreshRate);
 }
 
+bool CDVDClock::GetVblankJitter(CHistogram& jitter)
+{
+  return m_videoRefClock->GetVblankJitter(jitter);
+}
+
 double CDVDClock::SystemToAbsolute(int64_t system)
 {
   return DVD_TIME_BASE * (double)(system - m_systemOffset) / m_systemFrequency;
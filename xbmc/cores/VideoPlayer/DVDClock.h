@@ -35,6 +35,7 @@
 #define DVD_PLAYSPEED_PAUSE       0       // frame stepping
 #define DVD_PLAYSPEED_NORMAL      1000
 
+class CHistogram;
 class CVideoReferenceClock;
 
 class CDVDClock
@@ -72,6 +73,7 @@ public:
 
   double GetRefreshRate();
   bool GetClockInfo(int& MissedVblanks, double& ClockSpeed, double& RefreshRate) const;
+  bool GetVblankJitter(CHistogram& jitter);
   void SetVsyncAdjust(double adjustment);
   double GetVsyncAdjust();
 
@@ -20,6 +20,7 @@
 
 #include "DVDCodecUtils.h"
 #include "DVDClock.h"
+#include "PictureKernels.h"
 #include "cores/VideoPlayer/VideoRenderers/RenderManager.h"
 #include "utils/log.h"
 #include "cores/FFmpeg.h"
@@ -82,93 +83,85 @@ void CDVDCodecUtils::FreePicture(DVDVideoPicture* pPicture)
 
 bool CDVDCodecUtils::CopyPicture(DVDVideoPicture* pDst, DVDVideoPicture* pSrc)
 {
-  uint8_t *s, *d;
   int w = pSrc->iWidth;
   int h = pSrc->iHeight;
 
-  s = pSrc->data[0];
-  d = pDst->data[0];
-
-  for (int y = 0; y < h; y++)
-  {
-    memcpy(d, s, w);
-    s += pSrc->iLineSize[0];
-    d += pDst->iLineSize[0];
-  }
+  CPictureKernels::CopyPlane(pDst->data[0], pDst->iLineSize[0], pSrc->data[0], pSrc->iLineSize[0], w, h);
 
   w >>= 1;
   h >>= 1;
 
-  s = pSrc->data[1];
-  d = pDst->data[1];
-  for (int y = 0; y < h; y++)
-  {
-    memcpy(d, s, w);
-    s += pSrc->iLineSize[1];
-    d += pDst->iLineSize[1];
-  }
-
-  s = pSrc->data[2];
-  d = pDst->data[2];
-  for (int y = 0; y < h; y++)
-  {
-    memcpy(d, s, w);
-    s += pSrc->iLineSize[2];
-    d += pDst->iLineSize[2];
-  }
+  CPictureKernels::CopyPlane(pDst->data[1], pDst->iLineSize[1], pSrc->data[1], pSrc->iLineSize[1], w, h);
+  CPictureKernels::CopyPlane(pDst->data[2], pDst->iLineSize[2], pSrc->data[2], pSrc->iLineSize[2], w, h);
   return true;
 }
 
 bool CDVDCodecUtils::CopyPicture(YV12Image* pImage, DVDVideoPicture *pSrc)
 {
-  uint8_t *s = pSrc->data[0];
-  uint8_t *d = pImage->plane[0];
   int w = pImage->width * pImage->bpp;
   int h = pImage->height;
-  if ((w == pSrc->iLineSize[0]) && ((unsigned int) pSrc->iLineSize[0] == pImage->stride[0]))
-  {
-    memcpy(d, s, w*h);
-  }
-  else
+  CPictureKernels::CopyPlane(pImage->plane[0], pImage->stride[0], pSrc->data[0], pSrc->iLineSize[0], w, h);
+
+  w = (pImage->width  >> pImage->cshift_x) * pImage->bpp;
+  h = (pImage->height >> pImage->cshift_y);
+  CPictureKernels::CopyPlane(pImage->plane[1], pImage->stride[1], pSrc->data[1], pSrc->iLineSize[1], w, h);
+  CPictureKernels::CopyPlane(pImage->plane[2], pImage->stride[2], pSrc->data[2], pSrc->iLineSize[2], w, h);
+  return true;
+}
+
+bool CDVDCodecUtils::CopyPicture10To8(DVDVideoPicture* pDst, DVDVideoPicture *pSrc)
+{
+  const CPictureKernels::Kernels& kernels = CPictureKernels::Get();
+
+  for (int plane = 0; plane < 3; plane++)
   {
+    int w = plane ? (pSrc->iWidth  + 1) >> 1 : pSrc->iWidth;
+    int h = plane ? (pSrc->iHeight + 1) >> 1 : pSrc->iHeight;
+    uint8_t *s = pSrc->data[plane];
+    uint8_t *d = pDst->data[plane];
     for (int y = 0; y < h; y++)
     {
-      memcpy(d, s, w);
-      s += pSrc->iLineSize[0];
-      d += pImage->stride[0];
+      kernels.pack10To8Row(d, (const uint16_t*)s, w);
+      s += pSrc->iLineSize[plane];
+      d += pDst->iLineSize[plane];
     }
   }
-  s = pSrc->data[1];
-  d = pImage->plane[1];
-  w =(pImage->width  >> pImage->cshift_x) * pImage->bpp;
-  h =(pImage->height >> pImage->cshift_y);
-  if ((w==pSrc->iLineSize[1]) && ((unsigned int) pSrc->iLineSize[1]==pImage->stride[1]))
-  {
-    memcpy(d, s, w*h);
-  }
-  else
+  return true;
+}
+
+bool CDVDCodecUtils::CopyPicture10To16(DVDVideoPicture* pDst, DVDVideoPicture *pSrc)
+{
+  const CPictureKernels::Kernels& kernels = CPictureKernels::Get();
+
+  for (int plane = 0; plane < 3; plane++)
   {
+    int w = plane ? (pSrc->iWidth  + 1) >> 1 : pSrc->iWidth;
+    int h = plane ? (pSrc->iHeight + 1) >> 1 : pSrc->iHeight;
+    uint8_t *s = pSrc->data[plane];
+    uint8_t *d = pDst->data[plane];
     for (int y = 0; y < h; y++)
     {
-      memcpy(d, s, w);
-      s += pSrc->iLineSize[1];
-      d += pImage->stride[1];
+      kernels.pack10To16Row((uint16_t*)d, (const uint16_t*)s, w);
+      s += pSrc->iLineSize[plane];
+      d += pDst->iLineSize[plane];
     }
   }
-  s = pSrc->data[2];
-  d = pImage->plane[2];
-  if ((w==pSrc->iLineSize[2]) && ((unsigned int) pSrc->iLineSize[2]==pImage->stride[2]))
+  return true;
+}
+
+bool CDVDCodecUtils::CopyNV12ToYV12Picture(DVDVideoPicture* pDst, DVDVideoPicture *pSrc)
+{
+  CPictureKernels::CopyPlane(pDst->data[0], pDst->iLineSize[0], pSrc->data[0], pSrc->iLineSize[0],
+                             pSrc->iWidth, pSrc->iHeight);
+
+  const CPictureKernels::Kernels& kernels = CPictureKernels::Get();
+  int w = (pSrc->iWidth  + 1) >> 1;
+  int h = (pSrc->iHeight + 1) >> 1;
+  for (int y = 0; y < h; y++)
   {
-    memcpy(d, s, w*h);
-  }
-  else
-  {
-    for (int y = 0; y < h; y++)
-    {
-      memcpy(d, s, w);
-      s += pSrc->iLineSize[2];
-      d += pImage->stride[2];
-    }
+    kernels.deinterleaveRow(pDst->data[1] + y * pDst->iLineSize[1],
+                            pDst->data[2] + y * pDst->iLineSize[2],
+                            pSrc->data[1] + y * pSrc->iLineSize[1], w);
   }
   return true;
 }
@@ -199,26 +192,18 @@ DVDVideoPicture* CDVDCodecUtils::ConvertToNV12Picture(DVDVideoPicture *pSrc)
       pPicture->format = RENDER_FMT_NV12;
       
       // copy luma
-      uint8_t *s = pSrc->data[0];
-      uint8_t *d = pPicture->data[0];
-      for (int y = 0; y < (int)pSrc->iHeight; y++)
-      {
-        memcpy(d, s, pSrc->iWidth);
-        s += pSrc->iLineSize[0];
-        d += pPicture->iLineSize[0];
-      }
+      CPictureKernels::CopyPlane(pPicture->data[0], pPicture->iLineSize[0], pSrc->data[0], pSrc->iLineSize[0],
+                                 pSrc->iWidth, pSrc->iHeight);
 
       //copy chroma
+      const CPictureKernels::Kernels& kernels = CPictureKernels::Get();
       for (int y = 0; y < (int)pSrc->iHeight/2; y++) {
         uint8_t *s_u = pSrc->data[1] + (y * pSrc->iLineSize[1]);
         uint8_t *s_v = pSrc->data[2] + (y * pSrc->iLineSize[2]);
         uint8_t *d_uv = pPicture->data[1] + (y * pPicture->iLineSize[1]);
-        for (int x = 0; x < (int)pSrc->iWidth/2; x++) {
-          *d_uv++ = *s_u++;
-          *d_uv++ = *s_v++;
-        }
+        kernels.interleaveRow(d_uv, s_u, s_v, pSrc->iWidth/2);
       }
-      
+
     }
     else
     {
@@ -287,69 +272,23 @@ DVDVideoPicture* CDVDCodecUtils::ConvertToYUV422PackedPicture(DVDVideoPicture *p
 
 bool CDVDCodecUtils::CopyNV12Picture(YV12Image* pImage, DVDVideoPicture *pSrc)
 {
-  uint8_t *s = pSrc->data[0];
-  uint8_t *d = pImage->plane[0];
-  int w = pSrc->iWidth;
-  int h = pSrc->iHeight;
   // Copy Y
-  if ((w == pSrc->iLineSize[0]) && ((unsigned int) pSrc->iLineSize[0] == pImage->stride[0]))
-  {
-    memcpy(d, s, w*h);
-  }
-  else
-  {
-    for (int y = 0; y < h; y++)
-    {
-      memcpy(d, s, w);
-      s += pSrc->iLineSize[0];
-      d += pImage->stride[0];
-    }
-  }
-  
-  s = pSrc->data[1];
-  d = pImage->plane[1];
-  w = pSrc->iWidth;
-  h = pSrc->iHeight >> 1;
+  CPictureKernels::CopyPlane(pImage->plane[0], pImage->stride[0], pSrc->data[0], pSrc->iLineSize[0],
+                             pSrc->iWidth, pSrc->iHeight);
+
   // Copy packed UV (width is same as for Y as it's both U and V components)
-  if ((w==pSrc->iLineSize[1]) && ((unsigned int) pSrc->iLineSize[1]==pImage->stride[1]))
-  {
-    memcpy(d, s, w*h);
-  }
-  else
-  {
-    for (int y = 0; y < h; y++)
-    {
-      memcpy(d, s, w);
-      s += pSrc->iLineSize[1];
-      d += pImage->stride[1];
-    }
-  }
+  CPictureKernels::CopyPlane(pImage->plane[1], pImage->stride[1], pSrc->data[1], pSrc->iLineSize[1],
+                             pSrc->iWidth, pSrc->iHeight >> 1);
 
   return true;
 }
 
 bool CDVDCodecUtils::CopyYUV422PackedPicture(YV12Image* pImage, DVDVideoPicture *pSrc)
 {
-  uint8_t *s = pSrc->data[0];
-  uint8_t *d = pImage->plane[0];
-  int w = pSrc->iWidth;
-  int h = pSrc->iHeight;
-
   // Copy YUYV
-  if ((w * 2 == pSrc->iLineSize[0]) && ((unsigned int) pSrc->iLineSize[0] == pImage->stride[0]))
-  {
-    memcpy(d, s, w*h*2);
-  }
-  else
-  {
-    for (int y = 0; y < h; y++)
-    {
-      memcpy(d, s, w*2);
-      s += pSrc->iLineSize[0];
-      d += pImage->stride[0];
-    }
-  }
-  
+  CPictureKernels::CopyPlane(pImage->plane[0], pImage->stride[0], pSrc->data[0], pSrc->iLineSize[0],
+                             pSrc->iWidth * 2, pSrc->iHeight);
+
   return true;
 }
 
@@ -32,6 +32,10 @@ public:
   static void FreePicture(DVDVideoPicture* pPicture);
   static bool CopyPicture(DVDVideoPicture* pDst, DVDVideoPicture* pSrc);
   static bool CopyPicture(YV12Image* pDst, DVDVideoPicture *pSrc);
+  // 10 bit yuv420p to 8 bit, or to full range 16 bit
+  static bool CopyPicture10To8(DVDVideoPicture* pDst, DVDVideoPicture *pSrc);
+  static bool CopyPicture10To16(DVDVideoPicture* pDst, DVDVideoPicture *pSrc);
+  static bool CopyNV12ToYV12Picture(DVDVideoPicture* pDst, DVDVideoPicture *pSrc);
   
   static DVDVideoPicture* ConvertToNV12Picture(DVDVideoPicture *pSrc);
   static DVDVideoPicture* ConvertToYUV422PackedPicture(DVDVideoPicture *pSrc, ERenderFormat format);
@@ -0,0 +1,410 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "PictureKernels.h"
+#include "utils/CPUInfo.h"
+
+#include <algorithm>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define HAS_X86_KERNELS
+#include <immintrin.h>
+#if defined(__GNUC__)
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_SSE2
+#define TARGET_AVX2
+#endif
+#endif
+
+#if defined(__ARM_NEON__) || defined(__aarch64__)
+#define HAS_NEON_KERNELS
+#include <arm_neon.h>
+#endif
+
+namespace
+{
+
+//------------------------------------------------------------------------
+// C
+//------------------------------------------------------------------------
+
+void CopyRowC(uint8_t* dst, const uint8_t* src, int width)
+{
+  memcpy(dst, src, width);
+}
+
+void InterleaveRowC(uint8_t* dst, const uint8_t* srcU, const uint8_t* srcV, int width)
+{
+  for (int x = 0; x < width; x++)
+  {
+    *dst++ = srcU[x];
+    *dst++ = srcV[x];
+  }
+}
+
+void DeinterleaveRowC(uint8_t* dstU, uint8_t* dstV, const uint8_t* src, int width)
+{
+  for (int x = 0; x < width; x++)
+  {
+    dstU[x] = *src++;
+    dstV[x] = *src++;
+  }
+}
+
+void Pack10To8RowC(uint8_t* dst, const uint16_t* src, int width)
+{
+  for (int x = 0; x < width; x++)
+    dst[x] = std::min(src[x] >> 2, 255);
+}
+
+void Pack10To16RowC(uint16_t* dst, const uint16_t* src, int width)
+{
+  // replicate the high bits into the low ones so 1023 becomes 65535
+  for (int x = 0; x < width; x++)
+    dst[x] = (src[x] << 6) | (src[x] >> 4);
+}
+
+const CPictureKernels::Kernels kernelsC =
+{
+  "C",
+  CopyRowC,
+  InterleaveRowC,
+  DeinterleaveRowC,
+  Pack10To8RowC,
+  Pack10To16RowC
+};
+
+#if defined(HAS_X86_KERNELS)
+
+//------------------------------------------------------------------------
+// SSE2
+//------------------------------------------------------------------------
+
+TARGET_SSE2 void CopyRowSSE2(uint8_t* dst, const uint8_t* src, int width)
+{
+  int x = 0;
+  for (; x + 64 <= width; x += 64)
+  {
+    __m128i a = _mm_loadu_si128((const __m128i*)(src + x));
+    __m128i b = _mm_loadu_si128((const __m128i*)(src + x + 16));
+    __m128i c = _mm_loadu_si128((const __m128i*)(src + x + 32));
+    __m128i d = _mm_loadu_si128((const __m128i*)(src + x + 48));
+    _mm_storeu_si128((__m128i*)(dst + x), a);
+    _mm_storeu_si128((__m128i*)(dst + x + 16), b);
+    _mm_storeu_si128((__m128i*)(dst + x + 32), c);
+    _mm_storeu_si128((__m128i*)(dst + x + 48), d);
+  }
+  if (x < width)
+    memcpy(dst + x, src + x, width - x);
+}
+
+TARGET_SSE2 void InterleaveRowSSE2(uint8_t* dst, const uint8_t* srcU, const uint8_t* srcV, int width)
+{
+  int x = 0;
+  for (; x + 16 <= width; x += 16)
+  {
+    __m128i u = _mm_loadu_si128((const __m128i*)(srcU + x));
+    __m128i v = _mm_loadu_si128((const __m128i*)(srcV + x));
+    _mm_storeu_si128((__m128i*)(dst + 2 * x), _mm_unpacklo_epi8(u, v));
+    _mm_storeu_si128((__m128i*)(dst + 2 * x + 16), _mm_unpackhi_epi8(u, v));
+  }
+  InterleaveRowC(dst + 2 * x, srcU + x, srcV + x, width - x);
+}
+
+TARGET_SSE2 void DeinterleaveRowSSE2(uint8_t* dstU, uint8_t* dstV, const uint8_t* src, int width)
+{
+  const __m128i mask = _mm_set1_epi16(0x00ff);
+  int x = 0;
+  for (; x + 16 <= width; x += 16)
+  {
+    __m128i a = _mm_loadu_si128((const __m128i*)(src + 2 * x));
+    __m128i b = _mm_loadu_si128((const __m128i*)(src + 2 * x + 16));
+    __m128i u = _mm_packus_epi16(_mm_and_si128(a, mask), _mm_and_si128(b, mask));
+    __m128i v = _mm_packus_epi16(_mm_srli_epi16(a, 8), _mm_srli_epi16(b, 8));
+    _mm_storeu_si128((__m128i*)(dstU + x), u);
+    _mm_storeu_si128((__m128i*)(dstV + x), v);
+  }
+  DeinterleaveRowC(dstU + x, dstV + x, src + 2 * x, width - x);
+}
+
+TARGET_SSE2 void Pack10To8RowSSE2(uint8_t* dst, const uint16_t* src, int width)
+{
+  int x = 0;
+  for (; x + 16 <= width; x += 16)
+  {
+    __m128i a = _mm_srli_epi16(_mm_loadu_si128((const __m128i*)(src + x)), 2);
+    __m128i b = _mm_srli_epi16(_mm_loadu_si128((const __m128i*)(src + x + 8)), 2);
+    _mm_storeu_si128((__m128i*)(dst + x), _mm_packus_epi16(a, b));
+  }
+  Pack10To8RowC(dst + x, src + x, width - x);
+}
+
+TARGET_SSE2 void Pack10To16RowSSE2(uint16_t* dst, const uint16_t* src, int width)
+{
+  int x = 0;
+  for (; x + 8 <= width; x += 8)
+  {
+    __m128i a = _mm_loadu_si128((const __m128i*)(src + x));
+    a = _mm_or_si128(_mm_slli_epi16(a, 6), _mm_srli_epi16(a, 4));
+    _mm_storeu_si128((__m128i*)(dst + x), a);
+  }
+  Pack10To16RowC(dst + x, src + x, width - x);
+}
+
+const CPictureKernels::Kernels kernelsSSE2 =
+{
+  "SSE2",
+  CopyRowSSE2,
+  InterleaveRowSSE2,
+  DeinterleaveRowSSE2,
+  Pack10To8RowSSE2,
+  Pack10To16RowSSE2
+};
+
+//------------------------------------------------------------------------
+// AVX2
+// pack and unpack work per 128 bit lane, hence the permutes
+//------------------------------------------------------------------------
+
+TARGET_AVX2 void CopyRowAVX2(uint8_t* dst, const uint8_t* src, int width)
+{
+  int x = 0;
+  for (; x + 128 <= width; x += 128)
+  {
+    __m256i a = _mm256_loadu_si256((const __m256i*)(src + x));
+    __m256i b = _mm256_loadu_si256((const __m256i*)(src + x + 32));
+    __m256i c = _mm256_loadu_si256((const __m256i*)(src + x + 64));
+    __m256i d = _mm256_loadu_si256((const __m256i*)(src + x + 96));
+    _mm256_storeu_si256((__m256i*)(dst + x), a);
+    _mm256_storeu_si256((__m256i*)(dst + x + 32), b);
+    _mm256_storeu_si256((__m256i*)(dst + x + 64), c);
+    _mm256_storeu_si256((__m256i*)(dst + x + 96), d);
+  }
+  if (x < width)
+    memcpy(dst + x, src + x, width - x);
+}
+
+TARGET_AVX2 void InterleaveRowAVX2(uint8_t* dst, const uint8_t* srcU, const uint8_t* srcV, int width)
+{
+  int x = 0;
+  for (; x + 32 <= width; x += 32)
+  {
+    __m256i u = _mm256_loadu_si256((const __m256i*)(srcU + x));
+    __m256i v = _mm256_loadu_si256((const __m256i*)(srcV + x));
+    __m256i lo = _mm256_unpacklo_epi8(u, v);
+    __m256i hi = _mm256_unpackhi_epi8(u, v);
+    _mm256_storeu_si256((__m256i*)(dst + 2 * x), _mm256_permute2x128_si256(lo, hi, 0x20));
+    _mm256_storeu_si256((__m256i*)(dst + 2 * x + 32), _mm256_permute2x128_si256(lo, hi, 0x31));
+  }
+  InterleaveRowC(dst + 2 * x, srcU + x, srcV + x, width - x);
+}
+
+TARGET_AVX2 void DeinterleaveRowAVX2(uint8_t* dstU, uint8_t* dstV, const uint8_t* src, int width)
+{
+  const __m256i mask = _mm256_set1_epi16(0x00ff);
+  int x = 0;
+  for (; x + 32 <= width; x += 32)
+  {
+    __m256i a = _mm256_loadu_si256((const __m256i*)(src + 2 * x));
+    __m256i b = _mm256_loadu_si256((const __m256i*)(src + 2 * x + 32));
+    __m256i u = _mm256_packus_epi16(_mm256_and_si256(a, mask), _mm256_and_si256(b, mask));
+    __m256i v = _mm256_packus_epi16(_mm256_srli_epi16(a, 8), _mm256_srli_epi16(b, 8));
+    _mm256_storeu_si256((__m256i*)(dstU + x), _mm256_permute4x64_epi64(u, 0xD8));
+    _mm256_storeu_si256((__m256i*)(dstV + x), _mm256_permute4x64_epi64(v, 0xD8));
+  }
+  DeinterleaveRowC(dstU + x, dstV + x, src + 2 * x, width - x);
+}
+
+TARGET_AVX2 void Pack10To8RowAVX2(uint8_t* dst, const uint16_t* src, int width)
+{
+  int x = 0;
+  for (; x + 32 <= width; x += 32)
+  {
+    __m256i a = _mm256_srli_epi16(_mm256_loadu_si256((const __m256i*)(src + x)), 2);
+    __m256i b = _mm256_srli_epi16(_mm256_loadu_si256((const __m256i*)(src + x + 16)), 2);
+    _mm256_storeu_si256((__m256i*)(dst + x), _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xD8));
+  }
+  Pack10To8RowC(dst + x, src + x, width - x);
+}
+
+TARGET_AVX2 void Pack10To16RowAVX2(uint16_t* dst, const uint16_t* src, int width)
+{
+  int x = 0;
+  for (; x + 16 <= width; x += 16)
+  {
+    __m256i a = _mm256_loadu_si256((const __m256i*)(src + x));
+    a = _mm256_or_si256(_mm256_slli_epi16(a, 6), _mm256_srli_epi16(a, 4));
+    _mm256_storeu_si256((__m256i*)(dst + x), a);
+  }
+  Pack10To16RowC(dst + x, src + x, width - x);
+}
+
+const CPictureKernels::Kernels kernelsAVX2 =
+{
+  "AVX2",
+  CopyRowAVX2,
+  InterleaveRowAVX2,
+  DeinterleaveRowAVX2,
+  Pack10To8RowAVX2,
+  Pack10To16RowAVX2
+};
+
+#endif
+
+#if defined(HAS_NEON_KERNELS)
+
+//------------------------------------------------------------------------
+// NEON
+//------------------------------------------------------------------------
+
+void CopyRowNEON(uint8_t* dst, const uint8_t* src, int width)
+{
+  int x = 0;
+  for (; x + 64 <= width; x += 64)
+  {
+    uint8x16_t a = vld1q_u8(src + x);
+    uint8x16_t b = vld1q_u8(src + x + 16);
+    uint8x16_t c = vld1q_u8(src + x + 32);
+    uint8x16_t d = vld1q_u8(src + x + 48);
+    vst1q_u8(dst + x, a);
+    vst1q_u8(dst + x + 16, b);
+    vst1q_u8(dst + x + 32, c);
+    vst1q_u8(dst + x + 48, d);
+  }
+  if (x < width)
+    memcpy(dst + x, src + x, width - x);
+}
+
+void InterleaveRowNEON(uint8_t* dst, const uint8_t* srcU, const uint8_t* srcV, int width)
+{
+  int x = 0;
+  for (; x + 16 <= width; x += 16)
+  {
+    uint8x16x2_t uv;
+    uv.val[0] = vld1q_u8(srcU + x);
+    uv.val[1] = vld1q_u8(srcV + x);
+    vst2q_u8(dst + 2 * x, uv);
+  }
+  InterleaveRowC(dst + 2 * x, srcU + x, srcV + x, width - x);
+}
+
+void DeinterleaveRowNEON(uint8_t* dstU, uint8_t* dstV, const uint8_t* src, int width)
+{
+  int x = 0;
+  for (; x + 16 <= width; x += 16)
+  {
+    uint8x16x2_t uv = vld2q_u8(src + 2 * x);
+    vst1q_u8(dstU + x, uv.val[0]);
+    vst1q_u8(dstV + x, uv.val[1]);
+  }
+  DeinterleaveRowC(dstU + x, dstV + x, src + 2 * x, width - x);
+}
+
+void Pack10To8RowNEON(uint8_t* dst, const uint16_t* src, int width)
+{
+  int x = 0;
+  for (; x + 16 <= width; x += 16)
+  {
+    uint8x8_t a = vqshrn_n_u16(vld1q_u16(src + x), 2);
+    uint8x8_t b = vqshrn_n_u16(vld1q_u16(src + x + 8), 2);
+    vst1q_u8(dst + x, vcombine_u8(a, b));
+  }
+  Pack10To8RowC(dst + x, src + x, width - x);
+}
+
+void Pack10To16RowNEON(uint16_t* dst, const uint16_t* src, int width)
+{
+  int x = 0;
+  for (; x + 8 <= width; x += 8)
+  {
+    uint16x8_t a = vld1q_u16(src + x);
+    vst1q_u16(dst + x, vorrq_u16(vshlq_n_u16(a, 6), vshrq_n_u16(a, 4)));
+  }
+  Pack10To16RowC(dst + x, src + x, width - x);
+}
+
+const CPictureKernels::Kernels kernelsNEON =
+{
+  "NEON",
+  CopyRowNEON,
+  InterleaveRowNEON,
+  DeinterleaveRowNEON,
+  Pack10To8RowNEON,
+  Pack10To16RowNEON
+};
+
+#endif
+
+}
+
+std::vector<const CPictureKernels::Kernels*> CPictureKernels::GetAvailable()
+{
+  std::vector<const Kernels*> kernels;
+  kernels.push_back(&kernelsC);
+
+#if defined(HAS_X86_KERNELS)
+  unsigned int features = g_cpuInfo.GetCPUFeatures();
+  if (features & CPU_FEATURE_SSE2)
+    kernels.push_back(&kernelsSSE2);
+  if (features & CPU_FEATURE_AVX2)
+    kernels.push_back(&kernelsAVX2);
+#endif
+
+#if defined(HAS_NEON_KERNELS)
+#if defined(__aarch64__)
+  kernels.push_back(&kernelsNEON);
+#else
+  if (g_cpuInfo.GetCPUFeatures() & CPU_FEATURE_NEON)
+    kernels.push_back(&kernelsNEON);
+#endif
+#endif
+
+  return kernels;
+}
+
+const CPictureKernels::Kernels& CPictureKernels::Get()
+{
+  // the last one is the most capable
+  static const Kernels* kernels = GetAvailable().back();
+  return *kernels;
+}
+
+void CPictureKernels::CopyPlane(uint8_t* dst, int dstStride, const uint8_t* src, int srcStride,
+                                int width, int height)
+{
+  const Kernels& kernels = Get();
+
+  if (width == srcStride && width == dstStride)
+  {
+    kernels.copyRow(dst, src, width * height);
+    return;
+  }
+
+  for (int y = 0; y < height; y++)
+  {
+    kernels.copyRow(dst, src, width);
+    src += srcStride;
+    dst += dstStride;
+  }
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <stdint.h>
+#include <vector>
+
+/**
+ * Row kernels used by CDVDCodecUtils for copying and converting software
+ * decoded pictures. Every set implements the same operations, Get() returns
+ * the fastest one supported by the cpu (see CCPUInfo).
+ * All widths are in elements, not bytes, and rows may be unaligned.
+ */
+class CPictureKernels
+{
+public:
+  struct Kernels
+  {
+    const char* name;
+    // dst = src, width in bytes
+    void (*copyRow)(uint8_t* dst, const uint8_t* src, int width);
+    // dst = u0 v0 u1 v1 ..., width = number of u (and v) samples
+    void (*interleaveRow)(uint8_t* dst, const uint8_t* srcU, const uint8_t* srcV, int width);
+    // inverse of interleaveRow
+    void (*deinterleaveRow)(uint8_t* dstU, uint8_t* dstV, const uint8_t* src, int width);
+    // 10 bit samples in the low bits of 16 bit words to 8 bit
+    void (*pack10To8Row)(uint8_t* dst, const uint16_t* src, int width);
+    // 10 bit samples in the low bits of 16 bit words to full range 16 bit
+    void (*pack10To16Row)(uint16_t* dst, const uint16_t* src, int width);
+  };
+
+  static const Kernels& Get();
+
+  /**
+   * All kernel sets that can run on this cpu, the plain C one first.
+   */
+  static std::vector<const Kernels*> GetAvailable();
+
+  static void CopyPlane(uint8_t* dst, int dstStride, const uint8_t* src, int srcStride,
+                        int width, int height);
+};
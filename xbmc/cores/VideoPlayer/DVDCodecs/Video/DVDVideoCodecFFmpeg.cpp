@@ -36,6 +36,7 @@
 #include "settings/VideoSettings.h"
 #include "settings/MediaSettings.h"
 #include "utils/log.h"
+#include "utils/TimeUtils.h"
 #include <memory>
 
 #ifndef TARGET_POSIX
@@ -208,6 +209,7 @@ CDVDVideoCodecFFmpeg::CDVDVideoCodecFFmpeg(CProcessInfo &processInfo) : CDVDVide
   m_pFilterIn = nullptr;
   m_pFilterOut = nullptr;
   m_pFilterFrame = nullptr;
+  m_pConvertFrame = nullptr;
 
   m_iPictureWidth = 0;
   m_iPictureHeight = 0;
@@ -228,6 +230,7 @@ CDVDVideoCodecFFmpeg::CDVDVideoCodecFFmpeg(CProcessInfo &processInfo) : CDVDVide
   m_skippedDeint = 0;
   m_droppedFrames = 0;
   m_interlaced = false;
+  m_decodeTime = 0;
 }
 
 CDVDVideoCodecFFmpeg::~CDVDVideoCodecFFmpeg()
@@ -299,12 +302,8 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
     }
     else
     {
-      int num_threads = std::min(8 /*MAX_THREADS*/, g_cpuInfo.getCPUCount());
-      if( num_threads > 1)
-        m_pCodecContext->thread_count = num_threads;
-      m_pCodecContext->thread_safe_callbacks = 1;
+      SetThreading(pCodec, hints);
       m_decoderState = STATE_SW_MULTI;
-      CLog::Log(LOGDEBUG, "CDVDVideoCodecFFmpeg - open frame threaded with %d threads", num_threads);
     }
   }
   else
@@ -370,15 +369,82 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
   if (!m_pFilterFrame)
     return false;
 
+  m_pConvertFrame = av_frame_alloc();
+  if (!m_pConvertFrame)
+    return false;
+
   UpdateName();
+  UpdateThreadingInfo();
+  m_processInfo.ResetVideoDecodeTime();
+  m_decodeTime = 0;
   return true;
 }
 
+void CDVDVideoCodecFFmpeg::SetThreading(AVCodec* pCodec, const CDVDStreamInfo &hints)
+{
+  int num_threads = g_advancedSettings.m_videoDecoderThreads;
+
+  std::map<std::string, int>::const_iterator it = g_advancedSettings.m_videoDecoderCodecThreads.find(pCodec->name);
+  if (it != g_advancedSettings.m_videoDecoderCodecThreads.end())
+    num_threads = it->second;
+
+  if (num_threads <= 0)
+    num_threads = std::min(8 /*MAX_THREADS*/, g_cpuInfo.getCPUCount());
+
+  if (num_threads > 1)
+    m_pCodecContext->thread_count = num_threads;
+
+  switch (g_advancedSettings.m_videoDecoderThreadType)
+  {
+  case DECODER_THREADS_FRAME:
+    m_pCodecContext->thread_type = FF_THREAD_FRAME;
+    break;
+  case DECODER_THREADS_SLICE:
+    m_pCodecContext->thread_type = FF_THREAD_SLICE;
+    break;
+  case DECODER_THREADS_FRAME_SLICE:
+    m_pCodecContext->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+    break;
+  default:
+    break;
+  }
+
+  // frame threading holds back one frame per thread before the first picture
+  // comes out. live tv would rather have the picture now.
+  if (hints.realtime && g_advancedSettings.m_videoDecoderLowLatencyLive)
+    m_pCodecContext->thread_type = FF_THREAD_SLICE;
+
+  m_pCodecContext->thread_safe_callbacks = 1;
+
+  CLog::Log(LOGDEBUG, "CDVDVideoCodecFFmpeg - open threaded with %d threads, type %d%s",
+            num_threads, m_pCodecContext->thread_type, hints.realtime ? " (live)" : "");
+}
+
+void CDVDVideoCodecFFmpeg::UpdateThreadingInfo()
+{
+  // ffmpeg settles on the thread type it can actually do during open
+  int threads = 1;
+  std::string type = "none";
+  if (m_pCodecContext->active_thread_type & FF_THREAD_FRAME)
+  {
+    threads = m_pCodecContext->thread_count;
+    type = "frame";
+  }
+  else if (m_pCodecContext->active_thread_type & FF_THREAD_SLICE)
+  {
+    threads = m_pCodecContext->thread_count;
+    type = "slice";
+  }
+
+  m_processInfo.SetVideoDecoderThreading(threads, type);
+}
+
 void CDVDVideoCodecFFmpeg::Dispose()
 {
   av_frame_free(&m_pFrame);
   av_frame_free(&m_pDecodedFrame);
   av_frame_free(&m_pFilterFrame);
+  av_frame_free(&m_pConvertFrame);
 
   if (m_pCodecContext)
   {
@@ -557,7 +623,9 @@ int CDVDVideoCodecFFmpeg::Decode(uint8_t* pData, int iSize, double dts, double p
   /* We lie, but this flag is only used by pngdec.c.
    * Setting it correctly would allow CorePNG decoding. */
   avpkt.flags = AV_PKT_FLAG_KEY;
+  int64_t decodeStart = CurrentHostCounter();
   len = avcodec_decode_video2(m_pCodecContext, m_pDecodedFrame, &iGotPicture, &avpkt);
+  m_decodeTime += CurrentHostCounter() - decodeStart;
 
   if (m_decoderState == STATE_HW_FAILED && !m_pHardware)
     return VC_REOPEN;
@@ -599,6 +667,10 @@ int CDVDVideoCodecFFmpeg::Decode(uint8_t* pData, int iSize, double dts, double p
       return VC_BUFFER;
   }
 
+  // time spent in the decoder for all packets that went into this picture
+  m_processInfo.UpdateVideoDecodeTime(1000.0 * m_decodeTime / CurrentHostFrequency());
+  m_decodeTime = 0;
+
   if (m_pDecodedFrame->key_frame)
   {
     m_started = true;
@@ -621,9 +693,11 @@ int CDVDVideoCodecFFmpeg::Decode(uint8_t* pData, int iSize, double dts, double p
 
   if (m_pHardware == nullptr)
   {
+    // GetPicture() converts formats our own kernels handle, that's cheaper than swscale
     bool need_scale = std::find( m_formats.begin()
                                , m_formats.end()
-                               , m_pCodecContext->pix_fmt) == m_formats.end();
+                               , m_pCodecContext->pix_fmt) == m_formats.end()
+                   && GetConvertFormat(m_pCodecContext->pix_fmt) == AV_PIX_FMT_NONE;
 
     bool need_reopen  = false;
     if (m_filters != m_filters_next)
@@ -684,6 +758,7 @@ void CDVDVideoCodecFFmpeg::Reset()
   m_decoderPts = DVD_NOPTS_VALUE;
   m_skippedDeint = 0;
   m_droppedFrames = 0;
+  m_decodeTime = 0;
   m_iLastKeyframe = m_pCodecContext->has_b_frames;
   avcodec_flush_buffers(m_pCodecContext);
 
@@ -835,21 +910,92 @@ bool CDVDVideoCodecFFmpeg::GetPicture(DVDVideoPicture* pDvdVideoPicture)
   if (!GetPictureCommon(pDvdVideoPicture))
     return false;
 
+  AVFrame *frame = m_pFrame;
+  AVPixelFormat convertFormat = GetConvertFormat((AVPixelFormat)m_pFrame->format);
+  if (convertFormat != AV_PIX_FMT_NONE && m_pFrame->data[0])
+  {
+    if (!ConvertFrame(convertFormat))
+      return false;
+    frame = m_pConvertFrame;
+  }
+
   for (int i = 0; i < 4; i++)
-    pDvdVideoPicture->data[i] = m_pFrame->data[i];
+    pDvdVideoPicture->data[i] = frame->data[i];
   for (int i = 0; i < 4; i++)
-    pDvdVideoPicture->iLineSize[i] = m_pFrame->linesize[i];
+    pDvdVideoPicture->iLineSize[i] = frame->linesize[i];
 
   pDvdVideoPicture->iFlags |= pDvdVideoPicture->data[0] ? 0 : DVP_FLAG_DROPPED;
   pDvdVideoPicture->extended_format = 0;
 
   AVPixelFormat pix_fmt;
-  pix_fmt = (AVPixelFormat)m_pFrame->format;
+  pix_fmt = (AVPixelFormat)frame->format;
 
   pDvdVideoPicture->format = CDVDCodecUtils::EFormatFromPixfmt(pix_fmt);
   return true;
 }
 
+AVPixelFormat CDVDVideoCodecFFmpeg::GetConvertFormat(AVPixelFormat pix_fmt)
+{
+  if (std::find(m_formats.begin(), m_formats.end(), pix_fmt) != m_formats.end())
+    return AV_PIX_FMT_NONE;
+
+  // in order of preference
+  std::vector<AVPixelFormat> targets;
+  if (pix_fmt == AV_PIX_FMT_YUV420P10)
+  {
+    targets.push_back(AV_PIX_FMT_YUV420P16);
+    targets.push_back(AV_PIX_FMT_YUV420P);
+  }
+  else if (pix_fmt == AV_PIX_FMT_NV12)
+    targets.push_back(AV_PIX_FMT_YUV420P);
+
+  for (std::vector<AVPixelFormat>::iterator it = targets.begin(); it != targets.end(); ++it)
+  {
+    if (std::find(m_formats.begin(), m_formats.end(), *it) != m_formats.end())
+      return *it;
+  }
+  return AV_PIX_FMT_NONE;
+}
+
+bool CDVDVideoCodecFFmpeg::ConvertFrame(AVPixelFormat pix_fmt)
+{
+  // the buffer is kept while the format and size stay the same
+  if (m_pConvertFrame->format != pix_fmt ||
+      m_pConvertFrame->width != m_pFrame->width ||
+      m_pConvertFrame->height != m_pFrame->height ||
+      !m_pConvertFrame->data[0])
+  {
+    av_frame_unref(m_pConvertFrame);
+    m_pConvertFrame->format = pix_fmt;
+    m_pConvertFrame->width = m_pFrame->width;
+    m_pConvertFrame->height = m_pFrame->height;
+    if (av_frame_get_buffer(m_pConvertFrame, 64) < 0)
+    {
+      CLog::Log(LOGERROR, "CDVDVideoCodecFFmpeg::ConvertFrame - unable to allocate %ix%i frame", m_pFrame->width, m_pFrame->height);
+      av_frame_unref(m_pConvertFrame);
+      return false;
+    }
+  }
+
+  DVDVideoPicture src, dst;
+  src.iWidth = dst.iWidth = m_pFrame->width;
+  src.iHeight = dst.iHeight = m_pFrame->height;
+  for (int i = 0; i < 4; i++)
+  {
+    src.data[i] = m_pFrame->data[i];
+    src.iLineSize[i] = m_pFrame->linesize[i];
+    dst.data[i] = m_pConvertFrame->data[i];
+    dst.iLineSize[i] = m_pConvertFrame->linesize[i];
+  }
+
+  if (m_pFrame->format == AV_PIX_FMT_NV12)
+    return CDVDCodecUtils::CopyNV12ToYV12Picture(&dst, &src);
+  else if (pix_fmt == AV_PIX_FMT_YUV420P16)
+    return CDVDCodecUtils::CopyPicture10To16(&dst, &src);
+  else
+    return CDVDCodecUtils::CopyPicture10To8(&dst, &src);
+}
+
 int CDVDVideoCodecFFmpeg::FilterOpen(const std::string& filters, bool scale)
 {
   int result;
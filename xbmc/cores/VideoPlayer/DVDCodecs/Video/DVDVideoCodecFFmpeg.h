@@ -82,7 +82,11 @@ protected:
   int  FilterOpen(const std::string& filters, bool scale);
   void FilterClose();
   int  FilterProcess(AVFrame* frame);
+  AVPixelFormat GetConvertFormat(AVPixelFormat pix_fmt);
+  bool ConvertFrame(AVPixelFormat pix_fmt);
   void SetFilters();
+  void SetThreading(AVCodec* pCodec, const CDVDStreamInfo &hints);
+  void UpdateThreadingInfo();
 
   void UpdateName()
   {
@@ -107,6 +111,8 @@ protected:
   AVFrame*         m_pFilterFrame;
   bool m_filterEof;
 
+  AVFrame*         m_pConvertFrame;  // m_pFrame converted by CDVDCodecUtils
+
   int m_iPictureWidth;
   int m_iPictureHeight;
 
@@ -129,6 +135,7 @@ protected:
   bool   m_requestSkipDeint;
   int    m_codecControlFlags;
   bool m_interlaced;
+  int64_t m_decodeTime;
   CDVDStreamInfo m_hints;
   CDVDCodecOptions m_options;
 };
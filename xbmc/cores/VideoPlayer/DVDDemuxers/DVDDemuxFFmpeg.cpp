@@ -27,6 +27,7 @@
 #include "cores/FFmpeg.h"
 #include "DVDClock.h" // for DVD_TIME_BASE
 #include "DVDDemuxUtils.h"
+#include "DemuxPacketPool.h"
 #include "DVDInputStreams/DVDInputStream.h"
 #include "DVDInputStreams/DVDInputStreamFFmpeg.h"
 #include "filesystem/CurlFile.h"
@@ -39,6 +40,7 @@
 #include "URL.h"
 #include "utils/log.h"
 #include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
 
 #ifdef HAVE_LIBBLURAY
 #include "DVDInputStreams/DVDInputStreamBluray.h"
@@ -163,6 +165,7 @@ CDVDDemuxFFmpeg::CDVDDemuxFFmpeg() : CDVDDemux()
   m_currentPts = DVD_NOPTS_VALUE;
   m_bMatroska = false;
   m_bAVI = false;
+  m_bContainerIndex = false;
   m_speed = DVD_PLAYSPEED_NORMAL;
   m_program = UINT_MAX;
   m_pkt.result = -1;
@@ -431,6 +434,15 @@ bool CDVDDemuxFFmpeg::Open(CDVDInputStream* pInput, bool streaminfo, bool filein
   m_bMatroska = strncmp(m_pFormatContext->iformat->name, "matroska", 8) == 0;	// for "matroska.webm"
   m_bAVI = strcmp(m_pFormatContext->iformat->name, "avi") == 0;
 
+  // look at the index before probing: matroska files without cues add
+  // keyframes of their own while packets are read for stream info
+  m_bContainerIndex = false;
+  for (unsigned int i = 0; i < m_pFormatContext->nb_streams; i++)
+  {
+    if (m_pFormatContext->streams[i]->nb_index_entries > 1)
+      m_bContainerIndex = true;
+  }
+
   if (m_streaminfo)
   {
     for (unsigned int i = 0; i < m_pFormatContext->nb_streams; i++)
@@ -502,6 +514,9 @@ bool CDVDDemuxFFmpeg::Open(CDVDInputStream* pInput, bool streaminfo, bool filein
   m_displayTime = 0;
   m_dtsAtDisplayTime = DVD_NOPTS_VALUE;
 
+  if (!fileinfo)
+    OpenSeekIndex();
+
   return true;
 }
 
@@ -510,6 +525,8 @@ void CDVDDemuxFFmpeg::Dispose()
   m_pkt.result = -1;
   av_packet_unref(&m_pkt.pkt);
 
+  m_seekIndex.Close();
+
   if (m_pFormatContext)
   {
     for (unsigned int i = 0; i < m_pFormatContext->nb_streams; i++)
@@ -701,6 +718,31 @@ double CDVDDemuxFFmpeg::ConvertTimestamp(int64_t pts, int den, int num)
   return timestamp*DVD_TIME_BASE;
 }
 
+DemuxPacket* CDVDDemuxFFmpeg::AllocatePacket(AVPacket *pkt)
+{
+  // reference ffmpeg's buffer if we can, saves a copy of the payload
+  if (g_advancedSettings.m_videoDemuxZeroCopy)
+  {
+    DemuxPacket* pPacket = CDVDDemuxUtils::WrapDemuxPacket(pkt);
+    if (pPacket)
+      return pPacket;
+  }
+
+  DemuxPacket* pPacket = CDVDDemuxUtils::AllocateDemuxPacket(pkt->size);
+  if (!pPacket)
+    return NULL;
+
+  // copy contents into our own packet
+  pPacket->iSize = pkt->size;
+  if (pkt->data)
+  {
+    memcpy(pPacket->pData, pkt->data, pPacket->iSize);
+    CDemuxPacketPool::GetInstance().AddBytesCopied(pPacket->iSize);
+  }
+
+  return pPacket;
+}
+
 DemuxPacket* CDVDDemuxFFmpeg::Read()
 {
   DemuxPacket* pPacket = NULL;
@@ -768,6 +810,7 @@ DemuxPacket* CDVDDemuxFFmpeg::Read()
     else
     {
       ParsePacket(&m_pkt.pkt);
+      AddSeekIndexEntry(&m_pkt.pkt);
 
       AVStream *stream = m_pFormatContext->streams[m_pkt.pkt.stream_index];
 
@@ -780,7 +823,7 @@ DemuxPacket* CDVDDemuxFFmpeg::Read()
           {
             if(m_pkt.pkt.stream_index == (int)m_pFormatContext->programs[m_program]->stream_index[i])
             {
-              pPacket = CDVDDemuxUtils::AllocateDemuxPacket(m_pkt.pkt.size);
+              pPacket = AllocatePacket(&m_pkt.pkt);
               break;
             }
           }
@@ -789,7 +832,7 @@ DemuxPacket* CDVDDemuxFFmpeg::Read()
             bReturnEmpty = true;
         }
         else
-          pPacket = CDVDDemuxUtils::AllocateDemuxPacket(m_pkt.pkt.size);
+          pPacket = AllocatePacket(&m_pkt.pkt);
       }
       else
         bReturnEmpty = true;
@@ -824,13 +867,6 @@ DemuxPacket* CDVDDemuxFFmpeg::Read()
           m_pkt.pkt.pts = AV_NOPTS_VALUE;
         }
 
-        // copy contents into our own packet
-        pPacket->iSize = m_pkt.pkt.size;
-
-        // maybe we can avoid a memcpy here by detecting where pkt.destruct is pointing too?
-        if (m_pkt.pkt.data)
-          memcpy(pPacket->pData, m_pkt.pkt.data, pPacket->iSize);
-
         pPacket->pts = ConvertTimestamp(m_pkt.pkt.pts, stream->time_base.den, stream->time_base.num);
         pPacket->dts = ConvertTimestamp(m_pkt.pkt.dts, stream->time_base.den, stream->time_base.num);
         pPacket->duration =  DVD_SEC_TO_TIME((double)m_pkt.pkt.duration * stream->time_base.num / stream->time_base.den);
@@ -1784,6 +1820,52 @@ void CDVDDemuxFFmpeg::ResetVideoStreams()
   }
 }
 
+void CDVDDemuxFFmpeg::OpenSeekIndex()
+{
+  // only worth it where seeking is expensive, local files bisect fast enough
+  if (!g_advancedSettings.m_videoSeekIndex ||
+      !m_pInput->IsStreamType(DVDSTREAM_TYPE_FILE) ||
+      m_pInput->IsRealtime() ||
+      !m_pInput->CanSeek() ||
+      !URIUtils::IsRemote(m_pInput->GetFileName()))
+    return;
+
+  int index = av_find_default_stream_index(m_pFormatContext);
+  if (index < 0 || index >= (int)m_pFormatContext->nb_streams)
+    return;
+
+  // containers with a proper index (mp4, mkv with cues, ...) don't need us
+  if (m_bContainerIndex)
+    return;
+
+  AVStream *st = m_pFormatContext->streams[index];
+
+  if (!m_seekIndex.Open(m_pInput->GetFileName(), index, st->time_base.num, st->time_base.den))
+    return;
+
+  // hand the stored keyframes to lavf, av_seek_frame picks them up from the
+  // stream index: matroska jumps directly, binary search formats like mpegts
+  // narrow their search window to the two surrounding entries
+  for (auto &entry : m_seekIndex.GetEntries())
+    av_add_index_entry(st, entry.pos, entry.ts, 0, 0, AVINDEX_KEYFRAME);
+}
+
+void CDVDDemuxFFmpeg::AddSeekIndexEntry(AVPacket *pkt)
+{
+  if (!m_seekIndex.IsOpen() ||
+      pkt->stream_index != m_seekIndex.GetStream() ||
+      !(pkt->flags & AV_PKT_FLAG_KEY) ||
+      pkt->pos < 0)
+    return;
+
+  // same timestamp lavf uses for its own index
+  int64_t ts = pkt->dts != AV_NOPTS_VALUE ? pkt->dts : pkt->pts;
+  if (ts == AV_NOPTS_VALUE)
+    return;
+
+  m_seekIndex.Add(ts, pkt->pos);
+}
+
 void CDVDDemuxFFmpeg::GetL16Parameters(int &channels, int &samplerate)
 {
   std::string content;
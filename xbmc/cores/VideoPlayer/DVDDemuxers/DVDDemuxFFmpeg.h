@@ -21,6 +21,7 @@
  */
 
 #include "DVDDemux.h"
+#include "DemuxSeekIndex.h"
 #include "threads/CriticalSection.h"
 #include "threads/SystemClock.h"
 #include <map>
@@ -130,8 +131,11 @@ protected:
   void CreateStreams(unsigned int program = UINT_MAX);
   void DisposeStreams();
   void ParsePacket(AVPacket *pkt);
+  DemuxPacket* AllocatePacket(AVPacket *pkt);
   bool IsVideoReady();
   void ResetVideoStreams();
+  void OpenSeekIndex();
+  void AddSeekIndexEntry(AVPacket *pkt);
 
   AVDictionary *GetFFMpegOptionsFromInput();
   double ConvertTimestamp(int64_t pts, int den, int num);
@@ -152,6 +156,7 @@ protected:
   double   m_currentPts; // used for stream length estimation
   bool     m_bMatroska;
   bool     m_bAVI;
+  bool     m_bContainerIndex; // the file came with an index of its own
   int      m_speed;
   unsigned m_program;
   XbmcThreads::EndTime  m_timeout;
@@ -169,5 +174,8 @@ protected:
   bool m_checkvideo;
   int m_displayTime;
   double m_dtsAtDisplayTime;
+
+  // keyframe offsets learned while playing, persisted for the next open
+  CDemuxSeekIndex m_seekIndex;
 };
 
@@ -22,74 +22,19 @@
   #include "config.h"
 #endif
 #include "DVDDemuxUtils.h"
-#include "DVDClock.h"
-#include "utils/log.h"
-#include "system.h"
-
-#ifdef TARGET_POSIX
-#include "linux/XMemUtils.h"
-#endif
-
-extern "C" {
-#include "libavcodec/avcodec.h"
-}
+#include "DemuxPacketPool.h"
 
 void CDVDDemuxUtils::FreeDemuxPacket(DemuxPacket* pPacket)
 {
-  if (pPacket)
-  {
-    try {
-      if (pPacket->pData) _aligned_free(pPacket->pData);
-      delete pPacket;
-    }
-    catch(...) {
-      CLog::Log(LOGERROR, "%s - Exception thrown while freeing packet", __FUNCTION__);
-    }
-  }
+  CDemuxPacketPool::GetInstance().Free(pPacket);
 }
 
 DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(int iDataSize)
 {
-  DemuxPacket* pPacket = new DemuxPacket;
-  if (!pPacket) return NULL;
-
-  try
-  {
-    memset(pPacket, 0, sizeof(DemuxPacket));
-
-    if (iDataSize > 0)
-    {
-      // need to allocate a few bytes more.
-      // From avcodec.h (ffmpeg)
-      /**
-        * Required number of additionally allocated bytes at the end of the input bitstream for decoding.
-        * this is mainly needed because some optimized bitstream readers read
-        * 32 or 64 bit at once and could read over the end<br>
-        * Note, if the first 23 bits of the additional bytes are not 0 then damaged
-        * MPEG bitstreams could cause overread and segfault
-        */
-      pPacket->pData =(uint8_t*)_aligned_malloc(iDataSize + FF_INPUT_BUFFER_PADDING_SIZE, 16);
-      if (!pPacket->pData)
-      {
-        FreeDemuxPacket(pPacket);
-        return NULL;
-      }
-
-      // reset the last 8 bytes to 0;
-      memset(pPacket->pData + iDataSize, 0, FF_INPUT_BUFFER_PADDING_SIZE);
-    }
+  return CDemuxPacketPool::GetInstance().Allocate(iDataSize);
+}
 
-    // setup defaults
-    pPacket->dts       = DVD_NOPTS_VALUE;
-    pPacket->pts       = DVD_NOPTS_VALUE;
-    pPacket->iStreamId = -1;
-    pPacket->dispTime = 0;
-  }
-  catch(...)
-  {
-    CLog::Log(LOGERROR, "%s - Exception thrown", __FUNCTION__);
-    FreeDemuxPacket(pPacket);
-    pPacket = NULL;
-  }
-  return pPacket;
+DemuxPacket* CDVDDemuxUtils::WrapDemuxPacket(AVPacket* pkt)
+{
+  return CDemuxPacketPool::GetInstance().Wrap(pkt);
 }
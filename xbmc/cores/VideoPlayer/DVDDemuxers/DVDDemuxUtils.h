@@ -22,10 +22,14 @@
 
 #include "DVDDemuxPacket.h"
 
+struct AVPacket;
+
 class CDVDDemuxUtils
 {
 public:
   static void FreeDemuxPacket(DemuxPacket* pPacket);
   static DemuxPacket* AllocateDemuxPacket(int iDataSize = 0);
+  // zero copy, returns NULL if pkt's buffer can't be referenced
+  static DemuxPacket* WrapDemuxPacket(AVPacket* pkt);
 };
 
@@ -0,0 +1,242 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "DemuxPacketPool.h"
+#include "DVDClock.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+
+#ifdef TARGET_POSIX
+#include "linux/XMemUtils.h"
+#endif
+
+#include <cstddef>
+#include <cstring>
+
+extern "C" {
+#include "libavcodec/avcodec.h"
+}
+
+struct DemuxPoolPacket
+{
+  DemuxPacket packet;     // must stay first, we get DemuxPacket* back on Free()
+  int sizeClass;          // -1 for unpooled payloads, -2 for payload less shells
+  int capacity;
+  uint8_t* storage;
+  AVBufferRef* buffer;
+};
+
+static const int SIZE_CLASS_UNPOOLED = -1;
+static const int SIZE_CLASS_SHELL = -2;
+
+CDemuxPacketPool& CDemuxPacketPool::GetInstance()
+{
+  // never destroyed, packets may still be released during static destruction
+  static CDemuxPacketPool* pool = new CDemuxPacketPool();
+  return *pool;
+}
+
+int CDemuxPacketPool::GetSizeClass(int iDataSize)
+{
+  if (iDataSize <= 0)
+    return SIZE_CLASS_SHELL;
+
+  int sizeClass = 0;
+  while ((1024 << sizeClass) < iDataSize)
+  {
+    if (++sizeClass >= SIZE_CLASSES)
+      return SIZE_CLASS_UNPOOLED;
+  }
+  return sizeClass;
+}
+
+DemuxPoolPacket* CDemuxPacketPool::GetFree(int sizeClass)
+{
+  CSingleLock lock(m_critSection);
+
+  std::vector<DemuxPoolPacket*> &list = sizeClass == SIZE_CLASS_SHELL ? m_freeShells : m_free[sizeClass];
+  if (list.empty())
+    return nullptr;
+
+  DemuxPoolPacket* packet = list.back();
+  list.pop_back();
+  m_cachedBytes -= packet->capacity;
+  return packet;
+}
+
+DemuxPacket* CDemuxPacketPool::Allocate(int iDataSize)
+{
+  int sizeClass = GetSizeClass(iDataSize);
+
+  DemuxPoolPacket* packet = nullptr;
+  if (sizeClass != SIZE_CLASS_UNPOOLED)
+    packet = GetFree(sizeClass);
+
+  if (!packet)
+  {
+    m_poolMisses++;
+
+    packet = new DemuxPoolPacket;
+    packet->sizeClass = sizeClass;
+    packet->buffer = nullptr;
+    packet->storage = nullptr;
+    packet->capacity = 0;
+
+    if (iDataSize > 0)
+    {
+      packet->capacity = sizeClass == SIZE_CLASS_UNPOOLED ? iDataSize : 1024 << sizeClass;
+      // need to allocate a few bytes more.
+      // From avcodec.h (ffmpeg)
+      /**
+        * Required number of additionally allocated bytes at the end of the input bitstream for decoding.
+        * this is mainly needed because some optimized bitstream readers read
+        * 32 or 64 bit at once and could read over the end<br>
+        * Note, if the first 23 bits of the additional bytes are not 0 then damaged
+        * MPEG bitstreams could cause overread and segfault
+        */
+      packet->storage = (uint8_t*)_aligned_malloc(packet->capacity + FF_INPUT_BUFFER_PADDING_SIZE, 16);
+      if (!packet->storage)
+      {
+        CLog::Log(LOGERROR, "CDemuxPacketPool::%s - failed to allocate %d bytes", __FUNCTION__, iDataSize);
+        delete packet;
+        return nullptr;
+      }
+    }
+  }
+
+  m_allocations++;
+
+  memset(&packet->packet, 0, sizeof(DemuxPacket));
+  if (iDataSize > 0)
+  {
+    packet->packet.pData = packet->storage;
+    // reset the padding behind the payload
+    memset(packet->storage + iDataSize, 0, FF_INPUT_BUFFER_PADDING_SIZE);
+  }
+
+  // setup defaults
+  packet->packet.dts       = DVD_NOPTS_VALUE;
+  packet->packet.pts       = DVD_NOPTS_VALUE;
+  packet->packet.iStreamId = -1;
+  packet->packet.dispTime  = 0;
+
+  return &packet->packet;
+}
+
+DemuxPacket* CDemuxPacketPool::Wrap(AVPacket* pkt)
+{
+  // we need to own the buffer exclusively and ffmpeg's padding has to be there
+  if (!pkt->buf || !pkt->data || pkt->size <= 0 || !av_buffer_is_writable(pkt->buf))
+    return nullptr;
+  if (pkt->data < pkt->buf->data ||
+      pkt->data + pkt->size + FF_INPUT_BUFFER_PADDING_SIZE > pkt->buf->data + pkt->buf->size)
+    return nullptr;
+
+  AVBufferRef* buffer = av_buffer_ref(pkt->buf);
+  if (!buffer)
+    return nullptr;
+
+  DemuxPacket* pPacket = Allocate(0);
+  if (!pPacket)
+  {
+    av_buffer_unref(&buffer);
+    return nullptr;
+  }
+
+  DemuxPoolPacket* packet = reinterpret_cast<DemuxPoolPacket*>(pPacket);
+  packet->buffer = buffer;
+  pPacket->pData = pkt->data;
+  pPacket->iSize = pkt->size;
+
+  m_wrapped++;
+
+  return pPacket;
+}
+
+void CDemuxPacketPool::Free(DemuxPacket* pPacket)
+{
+  if (!pPacket)
+    return;
+
+  DemuxPoolPacket* packet = reinterpret_cast<DemuxPoolPacket*>(pPacket);
+  if (packet->buffer)
+    av_buffer_unref(&packet->buffer);
+
+  if (packet->sizeClass != SIZE_CLASS_UNPOOLED)
+  {
+    CSingleLock lock(m_critSection);
+
+    if (packet->sizeClass == SIZE_CLASS_SHELL)
+    {
+      if (m_freeShells.size() < MAX_CACHED_SHELLS)
+      {
+        m_freeShells.push_back(packet);
+        return;
+      }
+    }
+    else if (m_cachedBytes + packet->capacity <= MAX_CACHED_BYTES)
+    {
+      m_free[packet->sizeClass].push_back(packet);
+      m_cachedBytes += packet->capacity;
+      return;
+    }
+  }
+
+  Destroy(packet);
+}
+
+void CDemuxPacketPool::Destroy(DemuxPoolPacket* packet)
+{
+  if (packet->storage)
+    _aligned_free(packet->storage);
+  delete packet;
+}
+
+void CDemuxPacketPool::Trim()
+{
+  CSingleLock lock(m_critSection);
+
+  for (auto &list : m_free)
+  {
+    for (auto packet : list)
+      Destroy(packet);
+    list.clear();
+  }
+  for (auto packet : m_freeShells)
+    Destroy(packet);
+  m_freeShells.clear();
+
+  m_cachedBytes = 0;
+}
+
+DemuxPacketStats CDemuxPacketPool::GetStats() const
+{
+  DemuxPacketStats stats;
+  stats.allocations = m_allocations;
+  stats.poolMisses = m_poolMisses;
+  stats.wrapped = m_wrapped;
+  stats.bytesCopied = m_bytesCopied;
+  {
+    CSingleLock lock(m_critSection);
+    stats.cachedBytes = m_cachedBytes;
+  }
+  return stats;
+}
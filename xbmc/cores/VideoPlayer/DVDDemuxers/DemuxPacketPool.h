@@ -0,0 +1,95 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "DVDDemuxPacket.h"
+#include "threads/CriticalSection.h"
+
+#include <atomic>
+#include <vector>
+
+struct AVPacket;
+struct DemuxPoolPacket;
+
+struct DemuxPacketStats
+{
+  uint64_t allocations = 0; // packets handed out
+  uint64_t poolMisses = 0;  // packets that needed a fresh allocation
+  uint64_t wrapped = 0;     // packets referencing ffmpeg's buffer, no copy
+  uint64_t bytesCopied = 0; // payload bytes memcpy'd into packets
+  uint64_t cachedBytes = 0; // payload memory currently kept for reuse
+};
+
+/**
+ * Size class pool for DemuxPacket. Packets are recycled instead of being
+ * freed so steady state demuxing does not hit the heap. Payload buffers are
+ * bucketed in power of two classes, packets above the largest class are not
+ * pooled. The pool lives for the whole process, VideoPlayer trims it when a
+ * playback session ends.
+ */
+class CDemuxPacketPool
+{
+public:
+  static CDemuxPacketPool& GetInstance();
+
+  DemuxPacket* Allocate(int iDataSize);
+
+  /**
+   * Create a packet referencing the refcounted buffer of pkt instead of
+   * copying it. Returns nullptr if the buffer can't be shared, the caller
+   * has to fall back to Allocate() + copy then.
+   */
+  DemuxPacket* Wrap(AVPacket* pkt);
+
+  void Free(DemuxPacket* pPacket);
+
+  /**
+   * Release all cached packets.
+   */
+  void Trim();
+
+  void AddBytesCopied(int bytes) { m_bytesCopied += bytes; }
+  DemuxPacketStats GetStats() const;
+
+private:
+  CDemuxPacketPool() = default;
+  CDemuxPacketPool(const CDemuxPacketPool&) = delete;
+  CDemuxPacketPool& operator=(const CDemuxPacketPool&) = delete;
+
+  static int GetSizeClass(int iDataSize);
+  DemuxPoolPacket* GetFree(int sizeClass);
+  static void Destroy(DemuxPoolPacket* packet);
+
+  static const int SIZE_CLASSES = 14;               // 1 KiB ... 8 MiB
+  static const uint64_t MAX_CACHED_BYTES = 64 * 1024 * 1024;
+  static const size_t MAX_CACHED_SHELLS = 1024;
+
+  mutable CCriticalSection m_critSection;
+  std::vector<DemuxPoolPacket*> m_free[SIZE_CLASSES];
+  std::vector<DemuxPoolPacket*> m_freeShells;
+  uint64_t m_cachedBytes = 0;
+
+  std::atomic<uint64_t> m_allocations{0};
+  std::atomic<uint64_t> m_poolMisses{0};
+  std::atomic<uint64_t> m_wrapped{0};
+  std::atomic<uint64_t> m_bytesCopied{0};
+};
@@ -0,0 +1,215 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "DemuxSeekIndex.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "FileItem.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "URL.h"
+#include "utils/auto_buffer.h"
+#include "utils/Crc32.h"
+#include "utils/log.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+
+#define SEEKINDEX_PATH    "special://temp/seekindex/"
+#define SEEKINDEX_MAGIC   0x5849534b  // "KSIX"
+#define SEEKINDEX_VERSION 1
+
+namespace
+{
+struct SeekIndexHeader
+{
+  uint32_t magic;
+  uint32_t version;
+  int32_t stream;
+  int32_t timebaseNum;
+  int32_t timebaseDen;
+  uint32_t count;
+};
+
+bool CompareTs(const CDemuxSeekIndex::Entry& entry, int64_t ts)
+{
+  return entry.ts < ts;
+}
+}
+
+std::string CDemuxSeekIndex::GetCacheFile(const std::string& path, int64_t size, int64_t mtime)
+{
+  Crc32 crc;
+  crc.Compute(StringUtils::Format("%s|%" PRId64 "|%" PRId64, path.c_str(), size, mtime));
+  return StringUtils::Format(SEEKINDEX_PATH "%08x.idx", (uint32_t)crc);
+}
+
+bool CDemuxSeekIndex::Open(const std::string& path, int stream, int timebaseNum, int timebaseDen)
+{
+  Close();
+
+  struct __stat64 st;
+  if (XFILE::CFile::Stat(path, &st) != 0 || st.st_size <= 0)
+    return false;
+
+  m_file = GetCacheFile(path, st.st_size, st.st_mtime);
+  m_stream = stream;
+  m_timebaseNum = timebaseNum;
+  m_timebaseDen = timebaseDen;
+  // keep roughly one entry per second
+  m_minDistance = timebaseNum > 0 ? timebaseDen / timebaseNum : 0;
+
+  XFILE::CFile file;
+  XUTILS::auto_buffer buffer;
+  if (!XFILE::CFile::Exists(m_file) || file.LoadFile(m_file, buffer) <= 0)
+    return true;
+
+  if (!Deserialize(std::string(buffer.get(), buffer.size())))
+  {
+    CLog::Log(LOGDEBUG, "CDemuxSeekIndex::Open - discarding stale index %s", m_file.c_str());
+    m_entries.clear();
+    return true;
+  }
+
+  CLog::Log(LOGDEBUG, "CDemuxSeekIndex::Open - loaded %d keyframes for %s",
+            (int)m_entries.size(), CURL::GetRedacted(path).c_str());
+  return true;
+}
+
+void CDemuxSeekIndex::Close()
+{
+  if (m_modified && m_entries.size() >= MIN_ENTRIES)
+    Save();
+
+  m_file.clear();
+  m_stream = -1;
+  m_modified = false;
+  m_entries.clear();
+}
+
+void CDemuxSeekIndex::Add(int64_t ts, int64_t pos)
+{
+  if (pos < 0)
+    return;
+
+  auto it = std::lower_bound(m_entries.begin(), m_entries.end(), ts, CompareTs);
+  if (it != m_entries.end() && it->ts - ts < std::max<int64_t>(m_minDistance, 1))
+    return;
+  if (it != m_entries.begin() && ts - (it - 1)->ts < std::max<int64_t>(m_minDistance, 1))
+    return;
+
+  m_entries.insert(it, Entry{ts, pos});
+  m_modified = true;
+}
+
+bool CDemuxSeekIndex::Serialize(std::string& data) const
+{
+  SeekIndexHeader header;
+  header.magic = SEEKINDEX_MAGIC;
+  header.version = SEEKINDEX_VERSION;
+  header.stream = m_stream;
+  header.timebaseNum = m_timebaseNum;
+  header.timebaseDen = m_timebaseDen;
+  header.count = m_entries.size();
+
+  data.assign(reinterpret_cast<const char*>(&header), sizeof(header));
+  if (!m_entries.empty())
+    data.append(reinterpret_cast<const char*>(m_entries.data()), m_entries.size() * sizeof(Entry));
+  return true;
+}
+
+bool CDemuxSeekIndex::Deserialize(const std::string& data)
+{
+  SeekIndexHeader header;
+  if (data.size() < sizeof(header))
+    return false;
+
+  memcpy(&header, data.data(), sizeof(header));
+  if (header.magic != SEEKINDEX_MAGIC ||
+      header.version != SEEKINDEX_VERSION ||
+      header.stream != m_stream ||
+      header.timebaseNum != m_timebaseNum ||
+      header.timebaseDen != m_timebaseDen ||
+      data.size() != sizeof(header) + header.count * sizeof(Entry))
+    return false;
+
+  m_entries.resize(header.count);
+  if (header.count)
+    memcpy(m_entries.data(), data.data() + sizeof(header), header.count * sizeof(Entry));
+
+  // don't trust the file blindly, Add() keeps the entries sorted by binary search
+  for (size_t i = 1; i < m_entries.size(); i++)
+  {
+    if (m_entries[i].ts <= m_entries[i - 1].ts)
+    {
+      m_entries.clear();
+      return false;
+    }
+  }
+
+  m_modified = false;
+  return true;
+}
+
+bool CDemuxSeekIndex::Save() const
+{
+  std::string data;
+  if (!Serialize(data))
+    return false;
+
+  if (!XFILE::CDirectory::Exists(SEEKINDEX_PATH))
+    XFILE::CDirectory::Create(SEEKINDEX_PATH);
+
+  XFILE::CFile file;
+  if (!file.OpenForWrite(m_file, true) ||
+      file.Write(data.data(), data.size()) != (ssize_t)data.size())
+  {
+    CLog::Log(LOGERROR, "CDemuxSeekIndex::Save - failed to write %s", m_file.c_str());
+    file.Close();
+    XFILE::CFile::Delete(m_file);
+    return false;
+  }
+  file.Close();
+
+  Prune();
+  return true;
+}
+
+void CDemuxSeekIndex::Prune()
+{
+  CFileItemList items;
+  if (!XFILE::CDirectory::GetDirectory(SEEKINDEX_PATH, items, ".idx", XFILE::DIR_FLAG_NO_FILE_DIRS) ||
+      items.Size() <= (int)MAX_FILES)
+    return;
+
+  std::vector<CFileItemPtr> files;
+  for (int i = 0; i < items.Size(); i++)
+    files.push_back(items[i]);
+
+  std::sort(files.begin(), files.end(), [](const CFileItemPtr& a, const CFileItemPtr& b)
+  {
+    return a->m_dateTime < b->m_dateTime;
+  });
+
+  for (size_t i = 0; i < files.size() - MAX_FILES; i++)
+    XFILE::CFile::Delete(files[i]->GetPath());
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/**
+ * Keyframe index (timestamp -> byte offset) for one stream of a file.
+ * It is filled from the packets the demuxer reads anyway and persisted in
+ * special://temp/seekindex, keyed by path, size and mtime, so the next
+ * time the file is opened seeks can jump straight to the right offset
+ * instead of bisecting or scanning over the network. Timestamps are in the
+ * time base of the indexed stream, the cache is discarded if that doesn't
+ * match on load.
+ */
+class CDemuxSeekIndex
+{
+public:
+  struct Entry
+  {
+    int64_t ts;
+    int64_t pos;
+  };
+
+  CDemuxSeekIndex() = default;
+
+  /**
+   * Bind the index to a file and load a previously stored one if it is
+   * still valid. Returns false if the file can't be identified, the index
+   * stays unusable then.
+   */
+  bool Open(const std::string& path, int stream, int timebaseNum, int timebaseDen);
+
+  /**
+   * Store the index if it grew since it was loaded and release it.
+   */
+  void Close();
+
+  /**
+   * Record a keyframe. Entries closer than the minimum distance to an
+   * existing one are dropped to keep the cache small.
+   */
+  void Add(int64_t ts, int64_t pos);
+
+  bool IsOpen() const { return !m_file.empty(); }
+  int GetStream() const { return m_stream; }
+  const std::vector<Entry>& GetEntries() const { return m_entries; }
+
+  void SetMinDistance(int64_t distance) { m_minDistance = distance; }
+
+  bool Serialize(std::string& data) const;
+  bool Deserialize(const std::string& data);
+
+  static std::string GetCacheFile(const std::string& path, int64_t size, int64_t mtime);
+
+  static const size_t MIN_ENTRIES = 16;  // don't bother storing less
+  static const size_t MAX_FILES = 500;   // oldest cache files get pruned
+
+private:
+  bool Save() const;
+  static void Prune();
+
+  std::string m_file;
+  int m_stream = -1;
+  int m_timebaseNum = 0;
+  int m_timebaseDen = 0;
+  int64_t m_minDistance = 0;
+  bool m_modified = false;
+  std::vector<Entry> m_entries;
+};
@@ -0,0 +1,196 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "DVDExtractorPool.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "DVDStreamInfo.h"
+#include "DVDCodecs/DVDCodecs.h"
+#include "DVDCodecs/DVDFactoryCodec.h"
+#include "DVDCodecs/Video/DVDVideoCodecFFmpeg.h"
+#include "Process/ProcessInfo.h"
+#include "settings/AdvancedSettings.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/CPUInfo.h"
+#include "utils/log.h"
+
+namespace
+{
+// only what the decoder setup depends on, fps, ids and the like may differ
+bool IsCompatible(const CDVDStreamInfo& a, const CDVDStreamInfo& b)
+{
+  if (a.codec != b.codec ||
+      a.codec_tag != b.codec_tag ||
+      a.width != b.width ||
+      a.height != b.height ||
+      a.bitsperpixel != b.bitsperpixel ||
+      a.extrasize != b.extrasize)
+    return false;
+
+  return a.extrasize == 0 || memcmp(a.extradata, b.extradata, a.extrasize) == 0;
+}
+}
+
+CDVDExtractorPool& CDVDExtractorPool::GetInstance()
+{
+  static CDVDExtractorPool instance;
+  return instance;
+}
+
+CDVDExtractorPool::~CDVDExtractorPool()
+{
+  for (auto codec : m_idle)
+    Destroy(codec);
+}
+
+unsigned int CDVDExtractorPool::GetThreadCount()
+{
+  if (g_advancedSettings.m_videoExtractionThreads > 0)
+    return g_advancedSettings.m_videoExtractionThreads;
+
+  return std::max(1, g_cpuInfo.getCPUCount() / 2);
+}
+
+CDVDExtractorPool::Codec* CDVDExtractorPool::Acquire(const CDVDStreamInfo& hint)
+{
+  {
+    CSingleLock lock(m_critSection);
+    for (auto it = m_idle.begin(); it != m_idle.end(); ++it)
+    {
+      if (IsCompatible(*(*it)->hint, hint))
+      {
+        Codec* codec = *it;
+        m_idle.erase(it);
+        m_stats.codecsReused++;
+        lock.Leave();
+
+        codec->codec->Reset();
+        return codec;
+      }
+    }
+  }
+
+  Codec* codec = new Codec;
+  codec->hint = new CDVDStreamInfo(hint, true);
+  codec->hint->software = true;
+  // never given a data cache, the gui keeps showing the state of the player
+  codec->processInfo = CProcessInfo::CreateInstance();
+
+  // we only ever want the first picture after a seek, which lands on a
+  // keyframe. skipping everything else means no decoding in between, frame
+  // threading and reordering delay would only hold that picture back
+  CDVDCodecOptions options;
+  options.m_keys.push_back(CDVDCodecOption("skip_frame", "nokey"));
+  options.m_keys.push_back(CDVDCodecOption("threads", "1"));
+  options.m_keys.push_back(CDVDCodecOption("flags", "+low_delay"));
+
+  codec->codec = CDVDFactoryCodec::OpenCodec(new CDVDVideoCodecFFmpeg(*codec->processInfo), *codec->hint, options);
+  if (!codec->codec)
+  {
+    Destroy(codec);
+    return nullptr;
+  }
+
+  CSingleLock lock(m_critSection);
+  m_stats.codecsOpened++;
+  return codec;
+}
+
+void CDVDExtractorPool::Release(Codec* codec, bool reusable)
+{
+  if (!codec)
+    return;
+
+  CSingleLock lock(m_critSection);
+  if (reusable && m_idle.size() < MAX_IDLE)
+  {
+    m_idle.push_back(codec);
+    return;
+  }
+  lock.Leave();
+
+  Destroy(codec);
+}
+
+void CDVDExtractorPool::Trim()
+{
+  std::vector<Codec*> idle;
+  DVDExtractorStats stats;
+  {
+    CSingleLock lock(m_critSection);
+    idle.swap(m_idle);
+    stats = m_stats;
+    stats.filesPerMinute = GetFilesPerMinute();
+    m_stats = DVDExtractorStats();
+    m_batchStart = 0;
+  }
+
+  for (auto codec : idle)
+    Destroy(codec);
+
+  if (stats.files)
+    CLog::Log(LOGDEBUG, "CDVDExtractorPool - batch done: %" PRIu64 " files (%" PRIu64 " failed), %.1f files/min, "
+              "decoders opened %" PRIu64 " reused %" PRIu64,
+              stats.files, stats.failed, stats.filesPerMinute, stats.codecsOpened, stats.codecsReused);
+}
+
+void CDVDExtractorPool::AddFile(bool success)
+{
+  CSingleLock lock(m_critSection);
+  if (m_stats.files == 0)
+    m_batchStart = XbmcThreads::SystemClockMillis();
+
+  m_stats.files++;
+  if (!success)
+    m_stats.failed++;
+
+  if (m_stats.files % LOG_INTERVAL == 0)
+    CLog::Log(LOGDEBUG, "CDVDExtractorPool - %" PRIu64 " files, %.1f files/min",
+              m_stats.files, GetFilesPerMinute());
+}
+
+DVDExtractorStats CDVDExtractorPool::GetStats() const
+{
+  CSingleLock lock(m_critSection);
+  DVDExtractorStats stats = m_stats;
+  stats.filesPerMinute = GetFilesPerMinute();
+  return stats;
+}
+
+double CDVDExtractorPool::GetFilesPerMinute() const
+{
+  unsigned int elapsed = XbmcThreads::SystemClockMillis() - m_batchStart;
+  if (m_stats.files == 0 || elapsed == 0)
+    return 0.0;
+
+  return m_stats.files * 60000.0 / elapsed;
+}
+
+void CDVDExtractorPool::Destroy(Codec* codec)
+{
+  delete codec->codec;
+  delete codec->processInfo;
+  delete codec->hint;
+  delete codec;
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "threads/CriticalSection.h"
+
+#include <stdint.h>
+#include <vector>
+
+class CDVDStreamInfo;
+class CDVDVideoCodec;
+class CProcessInfo;
+
+struct DVDExtractorStats
+{
+  uint64_t files = 0;          // files probed since the batch started
+  uint64_t failed = 0;         // files without a thumb
+  uint64_t codecsOpened = 0;   // decoders created
+  uint64_t codecsReused = 0;   // decoders taken from the pool
+  double filesPerMinute = 0.0;
+};
+
+/**
+ * Shared state of thumbnail and stream details extraction. Decoders are
+ * opened for keyframe only, single threaded software decoding and kept
+ * around after a file is done, the next file with the same stream
+ * parameters only flushes it instead of going through avcodec_open again.
+ * Parallelism comes from running several extraction jobs at once, which
+ * is why each decoder uses one thread only.
+ */
+class CDVDExtractorPool
+{
+public:
+  struct Codec
+  {
+    CDVDStreamInfo* hint = nullptr;
+    CProcessInfo* processInfo = nullptr;
+    CDVDVideoCodec* codec = nullptr;
+  };
+
+  static CDVDExtractorPool& GetInstance();
+
+  /**
+   * Number of extraction jobs to run concurrently, <video><extractionthreads>
+   * or half of the cores if not set.
+   */
+  static unsigned int GetThreadCount();
+
+  /**
+   * Get a decoder for hint, reset and ready for a new file. Returns nullptr
+   * if no decoder could be opened.
+   */
+  Codec* Acquire(const CDVDStreamInfo& hint);
+
+  /**
+   * Hand a decoder back. Pass reusable = false if it failed, it is
+   * destroyed then instead of being pooled.
+   */
+  void Release(Codec* codec, bool reusable = true);
+
+  /**
+   * Free idle decoders and log the throughput of the finished batch.
+   */
+  void Trim();
+
+  void AddFile(bool success);
+  DVDExtractorStats GetStats() const;
+
+private:
+  CDVDExtractorPool() = default;
+  CDVDExtractorPool(const CDVDExtractorPool&) = delete;
+  CDVDExtractorPool& operator=(const CDVDExtractorPool&) = delete;
+  ~CDVDExtractorPool();
+
+  static void Destroy(Codec* codec);
+  double GetFilesPerMinute() const;
+
+  static const size_t MAX_IDLE = 8;
+  static const unsigned int LOG_INTERVAL = 50; // files
+
+  mutable CCriticalSection m_critSection;
+  std::vector<Codec*> m_idle;
+  DVDExtractorStats m_stats;
+  unsigned int m_batchStart = 0;
+};
@@ -29,6 +29,7 @@
 #include "utils/URIUtils.h"
 
 #include "DVDStreamInfo.h"
+#include "DVDExtractorPool.h"
 #include "DVDInputStreams/DVDInputStream.h"
 #ifdef HAVE_LIBBLURAY
 #include "DVDInputStreams/DVDInputStreamBluray.h"
@@ -199,28 +200,20 @@ bool CDVDFileInfo::ExtractThumb(const std::string &strPath,
 
   if (nVideoStream != -1)
   {
-    CDVDVideoCodec *pVideoCodec;
-    std::unique_ptr<CProcessInfo> pProcessInfo(CProcessInfo::CreateInstance());
-
     CDVDStreamInfo hint(*pDemuxer->GetStream(demuxerId, nVideoStream), true);
     hint.software = true;
 
-    if (hint.codec == AV_CODEC_ID_MPEG2VIDEO || hint.codec == AV_CODEC_ID_MPEG1VIDEO)
-    {
-      // libmpeg2 is not thread safe so use ffmepg for mpeg2/mpeg1 thumb extraction
-      CDVDCodecOptions dvdOptions;
-      pVideoCodec = CDVDFactoryCodec::OpenCodec(new CDVDVideoCodecFFmpeg(*pProcessInfo), hint, dvdOptions);
-    }
-    else
-    {
-      pVideoCodec = CDVDFactoryCodec::CreateVideoCodec(hint, *pProcessInfo);
-    }
+    // decoders are pooled and only decode keyframes, see CDVDExtractorPool
+    CDVDExtractorPool::Codec *pCodec = CDVDExtractorPool::GetInstance().Acquire(hint);
+    CDVDVideoCodec *pVideoCodec = pCodec ? pCodec->codec : NULL;
 
     if (pVideoCodec)
     {
       int nTotalLen = pDemuxer->GetStreamLength();
       int nSeekTo = (pos==-1?nTotalLen / 3:pos);
 
+      bool reusable = true;
+
       CLog::Log(LOGDEBUG,"%s - seeking to pos %dms (total: %dms) in %s", __FUNCTION__, nSeekTo, nTotalLen, redactPath.c_str());
       if (pDemuxer->SeekTime(nSeekTo, true))
       {
@@ -263,6 +256,8 @@ bool CDVDFileInfo::ExtractThumb(const std::string &strPath,
 
         } while (abort_index--);
 
+        reusable = !(iDecoderState & VC_ERROR);
+
         if (iDecoderState & VC_PICTURE && !(picture.iFlags & DVP_FLAG_DROPPED))
         {
           {
@@ -299,7 +294,7 @@ bool CDVDFileInfo::ExtractThumb(const std::string &strPath,
           CLog::Log(LOGDEBUG,"%s - decode failed in %s after %d packets.", __FUNCTION__, redactPath.c_str(), packetsTried);
         }
       }
-      delete pVideoCodec;
+      CDVDExtractorPool::GetInstance().Release(pCodec, reusable);
     }
   }
 
@@ -315,6 +310,8 @@ bool CDVDFileInfo::ExtractThumb(const std::string &strPath,
       file.Close();
   }
 
+  CDVDExtractorPool::GetInstance().AddFile(bOk);
+
   unsigned int nTotalTime = XbmcThreads::SystemClockMillis() - nTime;
   CLog::Log(LOGDEBUG,"%s - measured %u ms to extract thumb from file <%s> in %d packets. ", __FUNCTION__, nTotalTime, redactPath.c_str(), packetsTried);
   return bOk;
@@ -364,6 +361,7 @@ bool CDVDFileInfo::GetFileStreamDetails(CFileItem *pItem)
     bool retVal = DemuxerToStreamDetails(pInputStream, pDemuxer, pItem->GetVideoInfoTag()->m_streamDetails, strFileNameAndPath);
     delete pDemuxer;
     delete pInputStream;
+    CDVDExtractorPool::GetInstance().AddFile(retVal);
     return retVal;
   }
   else
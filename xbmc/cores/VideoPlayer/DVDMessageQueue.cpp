@@ -25,6 +25,8 @@
 #include "DVDClock.h"
 #include "utils/MathUtils.h"
 
+#include <thread>
+
 CDVDMessageQueue::CDVDMessageQueue(const std::string &owner) : m_hEvent(true), m_owner(owner)
 {
   m_iDataSize     = 0;
@@ -35,12 +37,35 @@ CDVDMessageQueue::CDVDMessageQueue(const std::string &owner) : m_hEvent(true), m
   m_TimeFront = DVD_NOPTS_VALUE;
   m_TimeSize = 1.0 / 4.0; /* 4 seconds */
   m_iMaxDataSize = 0;
+
+  m_generation = 0;
+  m_ringPackets = 0;
+  m_ringFlushPending = false;
+  m_consumerPopping = false;
+  m_listSize = 0;
+  m_overflowSize = 0;
+  m_consumerWaiting = false;
 }
 
 CDVDMessageQueue::~CDVDMessageQueue()
 {
   // remove all remaining messages
   Flush(CDVDMsg::NONE);
+  DrainRing();
+}
+
+void CDVDMessageQueue::SetPacketRing(size_t capacity)
+{
+  CSingleLock lock(m_section);
+
+  if (m_bInitialized)
+  {
+    CLog::Log(LOGERROR, "CDVDMessageQueue(%s)::SetPacketRing - queue already initialized", m_owner.c_str());
+    return;
+  }
+
+  DrainRing();
+  m_ring.Resize(capacity);
 }
 
 void CDVDMessageQueue::Init()
@@ -50,15 +75,40 @@ void CDVDMessageQueue::Init()
   m_bInitialized = true;
   m_TimeBack = DVD_NOPTS_VALUE;
   m_TimeFront = DVD_NOPTS_VALUE;
+  m_ringPackets = 0;
 }
 
 void CDVDMessageQueue::Flush(CDVDMsg::Message type)
 {
+  CSingleLock producer(m_producerSection);
   CSingleLock lock(m_section);
 
-  m_list.remove_if([type](const DVDMessageListItem &item){
-      return type == CDVDMsg::NONE || item.message->IsType(type);
+  m_list.remove_if([this, type](const DVDMessageListItem &item){
+      if (type != CDVDMsg::NONE && !item.message->IsType(type))
+        return false;
+      if (item.priority == 0 && IsPacketRing())
+        m_overflowSize--;
+      return true;
     });
+  m_listSize = m_list.size();
+
+  CSingleLock flush(m_flushSection);
+
+  if (IsPacketRing())
+  {
+    // from here on the consumer checks for staleness and does its accounting
+    // under m_flushSection. a pop that started without it is waited for, so
+    // it can't undo the reset below with a message it popped before the flush
+    m_ringFlushPending = true;
+    while (m_consumerPopping)
+      std::this_thread::yield();
+
+    // the ring belongs to the consumer, so only mark its content as stale.
+    // the consumer drops stale messages when it gets to them.
+    m_ringFlushes.push_back(std::make_pair(++m_generation, type));
+    if (type == CDVDMsg::DEMUXER_PACKET || type == CDVDMsg::NONE)
+      m_ringPackets = 0;
+  }
 
   if (type == CDVDMsg::DEMUXER_PACKET ||  type == CDVDMsg::NONE)
   {
@@ -79,18 +129,76 @@ void CDVDMessageQueue::Abort()
 
 void CDVDMessageQueue::End()
 {
+  CSingleLock producer(m_producerSection);
   CSingleLock lock(m_section);
 
   Flush(CDVDMsg::NONE);
 
+  // consumer thread is gone at this point, release what is left in the ring
+  DrainRing();
+
   m_bInitialized = false;
   m_iDataSize = 0;
   m_bAbortRequest = false;
 }
 
+void CDVDMessageQueue::DrainRing()
+{
+  CSingleLock flush(m_flushSection);
+  DVDMessageRingItem item;
+  while (m_ring.Pop(item))
+    item.message->Release();
+  m_ringPackets = 0;
+  m_ringFlushes.clear();
+  m_ringFlushPending = false;
+}
+
+void CDVDMessageQueue::PutAccounting(CDVDMsg* pMsg)
+{
+  if (pMsg->IsType(CDVDMsg::DEMUXER_PACKET))
+  {
+    DemuxPacket* packet = ((CDVDMsgDemuxerPacket*)pMsg)->GetPacket();
+    if (packet)
+    {
+      m_iDataSize += packet->iSize;
+      if (packet->dts != DVD_NOPTS_VALUE)
+        m_TimeFront = packet->dts;
+      else if (packet->pts != DVD_NOPTS_VALUE)
+        m_TimeFront = packet->pts;
+
+      if (m_TimeBack == DVD_NOPTS_VALUE)
+        m_TimeBack = m_TimeFront.load();
+    }
+  }
+}
+
+void CDVDMessageQueue::GetAccounting(CDVDMsg* pMsg)
+{
+  if (pMsg->IsType(CDVDMsg::DEMUXER_PACKET))
+  {
+    DemuxPacket* packet = ((CDVDMsgDemuxerPacket*)pMsg)->GetPacket();
+    if (packet)
+    {
+      m_iDataSize -= packet->iSize;
+      if (packet->dts != DVD_NOPTS_VALUE)
+        m_TimeBack = packet->dts;
+      else if (packet->pts != DVD_NOPTS_VALUE)
+        m_TimeBack = packet->pts;
+    }
+  }
+}
 
 MsgQueueReturnCode CDVDMessageQueue::Put(CDVDMsg* pMsg, int priority)
 {
+  if (!pMsg)
+  {
+    CLog::Log(LOGFATAL, "CDVDMessageQueue(%s)::Put MSGQ_INVALID_MSG", m_owner.c_str());
+    return MSGQ_INVALID_MSG;
+  }
+
+  if (priority == 0 && IsPacketRing())
+    return PutRing(pMsg);
+
   CSingleLock lock(m_section);
 
   if (!m_bInitialized)
@@ -99,48 +207,134 @@ MsgQueueReturnCode CDVDMessageQueue::Put(CDVDMsg* pMsg, int priority)
     pMsg->Release();
     return MSGQ_NOT_INITIALIZED;
   }
-  if (!pMsg)
-  {
-    CLog::Log(LOGFATAL, "CDVDMessageQueue(%s)::Put MSGQ_INVALID_MSG", m_owner.c_str());
-    return MSGQ_INVALID_MSG;
-  }
 
   auto it = std::find_if(m_list.begin(), m_list.end(),
                          [priority](const DVDMessageListItem &item){
                            return priority <= item.priority;
                          });
   m_list.emplace(it, pMsg, priority);
+  m_listSize++;
+
+  if (priority == 0)
+    PutAccounting(pMsg);
+
+  pMsg->Release();
+
+  m_hEvent.Set(); // inform waiter for new packet
+
+  return MSGQ_OK;
+}
+
+MsgQueueReturnCode CDVDMessageQueue::PutRing(CDVDMsg* pMsg)
+{
+  CSingleLock producer(m_producerSection);
 
-  if (pMsg->IsType(CDVDMsg::DEMUXER_PACKET) && priority == 0)
+  if (!m_bInitialized)
   {
-    DemuxPacket* packet = ((CDVDMsgDemuxerPacket*)pMsg)->GetPacket();
-    if (packet)
-    {
-      m_iDataSize += packet->iSize;
-      if (packet->dts != DVD_NOPTS_VALUE)
-        m_TimeFront = packet->dts;
-      else if (packet->pts != DVD_NOPTS_VALUE)
-        m_TimeFront = packet->pts;
+    CLog::Log(LOGWARNING, "CDVDMessageQueue(%s)::Put MSGQ_NOT_INITIALIZED", m_owner.c_str());
+    pMsg->Release();
+    return MSGQ_NOT_INITIALIZED;
+  }
 
-      if (m_TimeBack == DVD_NOPTS_VALUE)
-        m_TimeBack = m_TimeFront;
-    }
+  // once the ring overflowed, everything goes to the list until the consumer
+  // caught up, otherwise messages would overtake each other. we are the
+  // only producer, so a ring that is not full now can't be full on Push()
+  if (m_overflowSize > 0 || m_ring.Size() >= m_ring.Capacity())
+  {
+    CSingleLock lock(m_section);
+    m_list.emplace_front(pMsg, 0);
+    m_listSize++;
+    m_overflowSize++;
+    PutAccounting(pMsg);
+    pMsg->Release();
+    m_hEvent.Set();
+    return MSGQ_OK;
   }
 
-  pMsg->Release();
+  DVDMessageRingItem item;
+  item.message = pMsg;
+  item.generation = m_generation;
 
-  m_hEvent.Set(); // inform waiter for new packet
+  // account before pushing, the consumer may pick it up right away
+  if (pMsg->IsType(CDVDMsg::DEMUXER_PACKET))
+    m_ringPackets++;
+  PutAccounting(pMsg);
+  m_ring.Push(item);
+
+  // the ring took over our reference. only touch the event if the consumer
+  // is about to sleep, that's what keeps the steady state lock free
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (m_consumerWaiting)
+    m_hEvent.Set();
 
   return MSGQ_OK;
 }
 
-MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutInMilliSeconds, int &priority)
+bool CDVDMessageQueue::IsStale(const DVDMessageRingItem &item) const
 {
-  CSingleLock lock(m_section);
+  for (const auto &flush : m_ringFlushes)
+  {
+    if (item.generation < flush.first &&
+        (flush.second == CDVDMsg::NONE || item.message->IsType(flush.second)))
+      return true;
+  }
+  return false;
+}
 
-  *pMsg = NULL;
+bool CDVDMessageQueue::PopRing(CDVDMsg** pMsg)
+{
+  DVDMessageRingItem item;
 
-  int ret = 0;
+  // without a pending flush nothing in the ring is stale and no lock is
+  // needed. Flush() waits for m_consumerPopping before it resets anything.
+  m_consumerPopping = true;
+  if (!m_ringFlushPending)
+  {
+    bool popped = m_ring.Pop(item);
+    if (popped)
+    {
+      if (item.message->IsType(CDVDMsg::DEMUXER_PACKET))
+        m_ringPackets--;
+      GetAccounting(item.message);
+      *pMsg = item.message;
+    }
+    m_consumerPopping = false;
+    return popped;
+  }
+  m_consumerPopping = false;
+
+  while (m_ring.Pop(item))
+  {
+    CSingleLock flush(m_flushSection);
+    if (IsStale(item))
+    {
+      flush.Leave();
+      item.message->Release();
+      continue;
+    }
+
+    if (item.message->IsType(CDVDMsg::DEMUXER_PACKET))
+      m_ringPackets--;
+    GetAccounting(item.message);
+
+    *pMsg = item.message;
+    return true;
+  }
+
+  // anything pushed from now on is newer than every flush, the producer
+  // can't push while a flush is going on
+  CSingleLock flush(m_flushSection);
+  if (m_ring.Empty())
+  {
+    m_ringFlushes.clear();
+    m_ringFlushPending = false;
+  }
+  return false;
+}
+
+MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutInMilliSeconds, int &priority)
+{
+  *pMsg = NULL;
 
   if (!m_bInitialized)
   {
@@ -148,6 +342,13 @@ MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutIn
     return MSGQ_NOT_INITIALIZED;
   }
 
+  if (IsPacketRing())
+    return GetRing(pMsg, iTimeoutInMilliSeconds, priority);
+
+  CSingleLock lock(m_section);
+
+  int ret = 0;
+
   while (!m_bAbortRequest)
   {
     if (!m_list.empty() && m_list.back().priority >= priority)
@@ -155,21 +356,12 @@ MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutIn
       DVDMessageListItem& item(m_list.back());
       priority = item.priority;
 
-      if (item.message->IsType(CDVDMsg::DEMUXER_PACKET) && item.priority == 0)
-      {
-        DemuxPacket* packet = ((CDVDMsgDemuxerPacket*)item.message)->GetPacket();
-        if (packet)
-        {
-          m_iDataSize -= packet->iSize;
-          if (packet->dts != DVD_NOPTS_VALUE)
-            m_TimeBack = packet->dts;
-          else if (packet->pts != DVD_NOPTS_VALUE)
-            m_TimeBack = packet->pts;
-        }
-      }
+      if (item.priority == 0)
+        GetAccounting(item.message);
 
       *pMsg = item.message->Acquire();
       m_list.pop_back();
+      m_listSize--;
 
       ret = MSGQ_OK;
       break;
@@ -198,6 +390,75 @@ MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutIn
   return (MsgQueueReturnCode)ret;
 }
 
+MsgQueueReturnCode CDVDMessageQueue::GetRing(CDVDMsg** pMsg, unsigned int iTimeoutInMilliSeconds, int &priority)
+{
+  while (!m_bAbortRequest)
+  {
+    // prio messages first, they never go into the ring
+    if (m_listSize > 0)
+    {
+      CSingleLock lock(m_section);
+      if (!m_list.empty() && m_list.back().priority > 0 && m_list.back().priority >= priority)
+      {
+        DVDMessageListItem& item(m_list.back());
+        priority = item.priority;
+        *pMsg = item.message->Acquire();
+        m_list.pop_back();
+        m_listSize--;
+        return MSGQ_OK;
+      }
+    }
+
+    if (priority <= 0)
+    {
+      if (PopRing(pMsg))
+      {
+        priority = 0;
+        return MSGQ_OK;
+      }
+
+      // ring is empty, continue with whatever overflowed into the list
+      if (m_overflowSize > 0)
+      {
+        CSingleLock lock(m_section);
+        if (m_ring.Empty() && !m_list.empty() && m_list.back().priority == 0)
+        {
+          DVDMessageListItem& item(m_list.back());
+          GetAccounting(item.message);
+          *pMsg = item.message->Acquire();
+          m_list.pop_back();
+          m_listSize--;
+          m_overflowSize--;
+          priority = 0;
+          return MSGQ_OK;
+        }
+      }
+    }
+
+    if (!iTimeoutInMilliSeconds)
+      return MSGQ_TIMEOUT;
+
+    m_hEvent.Reset();
+    m_consumerWaiting = true;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    // re-check after announcing that we are going to sleep, the producer
+    // may have pushed in between
+    bool pending = m_listSize > 0 || (priority <= 0 && !m_ring.Empty());
+    if (!pending && !m_bAbortRequest)
+    {
+      if (!m_hEvent.WaitMSec(iTimeoutInMilliSeconds))
+      {
+        m_consumerWaiting = false;
+        return MSGQ_TIMEOUT;
+      }
+    }
+    m_consumerWaiting = false;
+  }
+
+  return MSGQ_ABORT;
+}
+
 unsigned CDVDMessageQueue::GetPacketCount(CDVDMsg::Message type)
 {
   CSingleLock lock(m_section);
@@ -206,6 +467,11 @@ unsigned CDVDMessageQueue::GetPacketCount(CDVDMsg::Message type)
     return 0;
 
   unsigned count = 0;
+
+  // only packets are counted while they sit in the ring
+  if (type == CDVDMsg::DEMUXER_PACKET && IsPacketRing())
+    count += m_ringPackets;
+
   for (const auto &item : m_list)
   {
     if(item.message->IsType(type))
@@ -228,18 +494,19 @@ int CDVDMessageQueue::GetLevel() const
 {
   CSingleLock lock(m_section);
 
-  if (m_iDataSize > m_iMaxDataSize)
+  int dataSize = GetDataSize();
+  if (dataSize > m_iMaxDataSize)
     return 100;
-  if (m_iDataSize == 0)
+  if (dataSize == 0)
     return 0;
 
   if (IsDataBased())
-    return std::min(100, 100 * m_iDataSize / m_iMaxDataSize);
+    return std::min(100, 100 * dataSize / m_iMaxDataSize);
 
   int level = std::min(100, MathUtils::round_int(100.0 * m_TimeSize * (m_TimeFront - m_TimeBack) / DVD_TIME_BASE ));
 
   // if we added lots of packets with NOPTS, make sure that the queue is not signalled empty
-  if (level == 0 && m_iDataSize != 0)
+  if (level == 0 && dataSize != 0)
   {
     CLog::Log(LOGNOTICE, "CDVDMessageQueue::GetLevel() - can't determine level");
     return 1;
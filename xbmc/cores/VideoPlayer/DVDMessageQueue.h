@@ -24,8 +24,12 @@
 #include <string>
 #include <list>
 #include <algorithm>
+#include <atomic>
+#include <utility>
+#include <vector>
 #include "threads/CriticalSection.h"
 #include "threads/Event.h"
+#include "threads/SPSCRing.h"
 
 struct DVDMessageListItem
 {
@@ -52,6 +56,12 @@ struct DVDMessageListItem
   int priority;
 };
 
+struct DVDMessageRingItem
+{
+  CDVDMsg* message = nullptr;
+  unsigned int generation = 0;
+};
+
 enum MsgQueueReturnCode
 {
   MSGQ_OK = 1,
@@ -71,6 +81,16 @@ public:
   virtual ~CDVDMessageQueue();
 
   void Init();
+
+  /**
+   * Route priority 0 messages (the demux packet path) through a lock free
+   * single producer / single consumer ring of the given capacity instead of
+   * the locked list. Must be called before Init(). Passing 0 disables it.
+   * Producers are serialized by a lock the consumer never takes, so the
+   * steady state demuxer -> decoder hand-off does not contend.
+   */
+  void SetPacketRing(size_t capacity);
+  bool IsPacketRing() const { return m_ring.Capacity() > 0; }
   void Flush(CDVDMsg::Message message = CDVDMsg::DEMUXER_PACKET);
   void Abort();
   void End();
@@ -108,15 +128,25 @@ public:
 
 private:
 
+  void PutAccounting(CDVDMsg* pMsg);
+  void GetAccounting(CDVDMsg* pMsg);
+  MsgQueueReturnCode PutRing(CDVDMsg* pMsg);
+  MsgQueueReturnCode GetRing(CDVDMsg** pMsg, unsigned int iTimeoutInMilliSeconds, int &priority);
+  bool PopRing(CDVDMsg** pMsg);
+  bool IsStale(const DVDMessageRingItem &item) const;
+  void DrainRing();
+
   CEvent m_hEvent;
   mutable CCriticalSection m_section;
+  CCriticalSection m_producerSection;
+  CCriticalSection m_flushSection;   // guards m_ringFlushes, taken by the consumer only while a flush is pending
 
   bool m_bAbortRequest;
   bool m_bInitialized;
 
-  int m_iDataSize;
-  double m_TimeFront;
-  double m_TimeBack;
+  std::atomic<int> m_iDataSize;
+  std::atomic<double> m_TimeFront;
+  std::atomic<double> m_TimeBack;
   double m_TimeSize;
 
   int m_iMaxDataSize;
@@ -124,5 +154,16 @@ private:
 
   typedef std::list<DVDMessageListItem> SList;
   SList m_list;
+
+  // ring mode state, see SetPacketRing()
+  CSPSCRing<DVDMessageRingItem> m_ring;
+  std::atomic<unsigned int> m_generation;
+  std::vector<std::pair<unsigned int, CDVDMsg::Message> > m_ringFlushes; // generation and type of flushes still affecting the ring
+  std::atomic<bool> m_ringFlushPending; // m_ringFlushes is not empty
+  std::atomic<bool> m_consumerPopping;  // the consumer pops without m_flushSection
+  std::atomic<int> m_ringPackets;
+  std::atomic<int> m_listSize;
+  std::atomic<int> m_overflowSize;
+  std::atomic<bool> m_consumerWaiting;
 };
 
@@ -19,16 +19,17 @@
  */
 
 #include "DVDSubtitleLineCollection.h"
+
+#include <algorithm>
+#include <limits>
 #include <stddef.h>
 
 
 CDVDSubtitleLineCollection::CDVDSubtitleLineCollection()
 {
-  m_pHead = NULL;
-  m_pCurrent = NULL;
-  m_pTail = NULL;
-
-  m_iSize = 0;
+  m_leaves = 0;
+  m_indexed = true;
+  m_current = 0;
 }
 
 CDVDSubtitleLineCollection::~CDVDSubtitleLineCollection()
@@ -38,85 +39,124 @@ CDVDSubtitleLineCollection::~CDVDSubtitleLineCollection()
 
 void CDVDSubtitleLineCollection::Add(CDVDOverlay* pOverlay)
 {
-  ListElement* pElement = new ListElement;
-  pElement->pOverlay = pOverlay;
-  pElement->pNext = NULL;
-
-  if (!m_pHead)
-  {
-    m_pHead = m_pTail = pElement;
-    m_pCurrent = m_pHead;
-  }
-  else
-  {
-    m_pTail->pNext = pElement;
-    m_pTail = pElement;
-  }
+  Entry entry;
+  entry.startTime = pOverlay->iPTSStartTime;
+  entry.stopTime = pOverlay->iPTSStopTime;
+  entry.position = -1;
+  entry.overlay = pOverlay;
+  m_entries.push_back(entry);
+  m_indexed = false;
+}
 
-  m_iSize++;
+void CDVDSubtitleLineCollection::Add(double startTime, double stopTime, int64_t position)
+{
+  Entry entry;
+  entry.startTime = startTime;
+  entry.stopTime = stopTime;
+  entry.position = position;
+  entry.overlay = NULL;
+  m_entries.push_back(entry);
+  m_indexed = false;
 }
 
 void CDVDSubtitleLineCollection::Sort()
 {
-  if (!m_pHead || !m_pHead->pNext)
-    return;
-  
-  for (ListElement* p1 = m_pHead; p1->pNext != NULL; p1 = p1->pNext)
+  BuildIndex();
+  std::stable_sort(m_entries.begin(), m_entries.end(), [](const Entry& a, const Entry& b)
+  {
+    return a.startTime < b.startTime;
+  });
+  m_indexed = false;
+}
+
+void CDVDSubtitleLineCollection::BuildIndex()
+{
+  m_leaves = 1;
+  while (m_leaves < m_entries.size())
+    m_leaves *= 2;
+
+  // the padding leaves are never showing
+  m_stopTimeTree.assign(2 * m_leaves, std::numeric_limits<double>::lowest());
+  for (size_t i = 0; i < m_entries.size(); i++)
   {
-    for (ListElement* p2 = p1->pNext; p2 != NULL; p2 = p2->pNext)
+    // overlays parsed up front may have been changed after they were added
+    if (m_entries[i].overlay)
     {
-      if (p1->pOverlay->iPTSStartTime > p2->pOverlay->iPTSStartTime)
-      {
-        CDVDOverlay* temp = p1->pOverlay;
-        p1->pOverlay = p2->pOverlay;
-        p2->pOverlay = temp;
-      }
+      m_entries[i].startTime = m_entries[i].overlay->iPTSStartTime;
+      m_entries[i].stopTime = m_entries[i].overlay->iPTSStopTime;
     }
+    m_stopTimeTree[m_leaves + i] = m_entries[i].stopTime;
   }
+  for (size_t node = m_leaves - 1; node > 0; node--)
+    m_stopTimeTree[node] = std::max(m_stopTimeTree[2 * node], m_stopTimeTree[2 * node + 1]);
+  m_indexed = true;
+}
+
+// first entry in [from, end) of the subtree with a stop time >= pts, end if
+// there is none. Only the path along from is split, every other subtree is
+// either skipped by its maximum or holds the result.
+size_t CDVDSubtitleLineCollection::FindShowing(size_t node, size_t begin, size_t end, size_t from, double pts) const
+{
+  if (end <= from || m_stopTimeTree[node] < pts)
+    return end;
+  if (end - begin == 1)
+    return begin;
+
+  size_t middle = begin + (end - begin) / 2;
+  size_t found = FindShowing(2 * node, begin, middle, from, pts);
+  if (found < middle)
+    return found;
+  return FindShowing(2 * node + 1, middle, end, from, pts);
 }
 
 CDVDOverlay* CDVDSubtitleLineCollection::Get(double iPts)
 {
-  CDVDOverlay* pOverlay = NULL;
+  if (!m_indexed)
+    BuildIndex();
 
-  if (m_pCurrent)
+  while (m_current < m_entries.size())
   {
-    while (m_pCurrent && m_pCurrent->pOverlay->iPTSStopTime < iPts)
-    {
-      m_pCurrent = m_pCurrent->pNext;
-    }
+    // skip the entries that stopped before iPts
+    m_current = FindShowing(1, 0, m_leaves, m_current, iPts);
+    if (m_current >= m_entries.size())
+      break;
 
-    if (m_pCurrent)
-    {
-      pOverlay = m_pCurrent->pOverlay;
+    Entry& entry = m_entries[m_current];
+
+    // advance to the next overlay
+    m_current++;
 
-      // advance to the next overlay
-      m_pCurrent = m_pCurrent->pNext;
+    if (!entry.overlay && m_parser)
+    {
+      entry.overlay = m_parser(entry.position);
+      if (entry.overlay)
+      {
+        entry.overlay->iPTSStartTime = entry.startTime;
+        entry.overlay->iPTSStopTime = entry.stopTime;
+      }
     }
+    if (entry.overlay)
+      return entry.overlay;
   }
-  return pOverlay;
+  return NULL;
 }
 
 void CDVDSubtitleLineCollection::Reset()
 {
-  m_pCurrent = m_pHead;
+  m_current = 0;
 }
 
 void CDVDSubtitleLineCollection::Clear()
 {
-  ListElement* pElement = NULL;
-
-  while (m_pHead)
+  for (std::vector<Entry>::iterator it = m_entries.begin(); it != m_entries.end(); ++it)
   {
-    pElement = m_pHead;
-    m_pHead = pElement->pNext;
-
-    pElement->pOverlay->Release();
-    delete pElement;
+    if (it->overlay)
+      it->overlay->Release();
   }
 
-  m_pTail    = NULL;
-  m_pHead    = NULL;
-  m_pCurrent = NULL;
-  m_iSize    = 0;
+  m_entries.clear();
+  m_stopTimeTree.clear();
+  m_leaves = 0;
+  m_indexed = true;
+  m_current = 0;
 }
@@ -22,39 +22,61 @@
 
 #include "../DVDCodecs/Overlay/DVDOverlay.h"
 
-typedef struct stListElement
-{
-  CDVDOverlay* pOverlay;
-  struct stListElement* pNext;
-
-} ListElement;
+#include <functional>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
 
+/*!
+ * \brief Subtitles of a file sorted by start time.
+ *
+ * Subtitles may be added with just their times and their position in the
+ * source. Those are parsed by the function set with SetParser() the first
+ * time Get() returns them. A max tree over the stop times is kept next to
+ * the list, so Get() finds the next subtitle still showing at a pts in
+ * O(log n), also past short subtitles overlapped by a long one.
+ */
 class CDVDSubtitleLineCollection
 {
 public:
   CDVDSubtitleLineCollection();
   virtual ~CDVDSubtitleLineCollection();
 
-  //void Lock()   { EnterCriticalSection(&m_critSection); }
-  //void Unlock() { LeaveCriticalSection(&m_critSection); }
+  /*!
+   * \brief Creates the overlay of a subtitle from its position in the source.
+   * The collection takes over the reference, times are set by the collection.
+   * \return NULL if there is nothing to show
+   */
+  typedef std::function<CDVDOverlay*(int64_t position)> ParseFunc;
+  void SetParser(const ParseFunc& parser) { m_parser = parser; }
 
   void Add(CDVDOverlay* pSubtitle);
+  void Add(double startTime, double stopTime, int64_t position);
   void Sort();
 
   CDVDOverlay* Get(double iPts = 0LL); // get the first overlay in this fifo
 
   void Reset();
 
-  void Remove();
   void Clear();
-  int GetSize() { return m_iSize; }
+  int GetSize() { return (int)m_entries.size(); }
 
 private:
-  ListElement* m_pHead;
-  ListElement* m_pCurrent;
-  ListElement* m_pTail;
+  struct Entry
+  {
+    double startTime;
+    double stopTime;
+    int64_t position;
+    CDVDOverlay* overlay;
+  };
 
-  int m_iSize;
-  //CRITICAL_SECTION m_critSection;
-};
+  void BuildIndex();
+  size_t FindShowing(size_t node, size_t begin, size_t end, size_t from, double pts) const;
 
+  std::vector<Entry> m_entries;
+  std::vector<double> m_stopTimeTree; // max of the stop times, node n has children 2n and 2n+1
+  size_t m_leaves;
+  bool m_indexed;
+  size_t m_current;
+  ParseFunc m_parser;
+};
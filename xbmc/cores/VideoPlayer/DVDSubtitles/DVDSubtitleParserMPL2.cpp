@@ -49,8 +49,8 @@ bool CDVDSubtitleParserMPL2::Open(CDVDStreamInfo &hints)
   CRegExp reg;
   if (!reg.RegComp("\\[([0-9]+)\\]\\[([0-9]+)\\]"))
     return false;
-  CDVDSubtitleTagMicroDVD TagConv;
 
+  long lineStart = m_pStream->Seek(0, SEEK_CUR);
   while (m_pStream->ReadLine(line, sizeof(line)))
   {
     if ((strlen(line) > 0) && (line[strlen(line) - 1] == '\r'))
@@ -59,20 +59,34 @@ bool CDVDSubtitleParserMPL2::Open(CDVDStreamInfo &hints)
     int pos = reg.RegFind(line);
     if (pos > -1)
     {
-      const char* text = line + pos + reg.GetFindLen();
       std::string startFrame(reg.GetMatch(1));
       std::string endFrame  (reg.GetMatch(2));
-      CDVDOverlayText* pOverlay = new CDVDOverlayText();
-      pOverlay->Acquire(); // increase ref count with one so that we can hold a handle to this overlay
 
-      pOverlay->iPTSStartTime = m_framerate * atoi(startFrame.c_str());
-      pOverlay->iPTSStopTime  = m_framerate * atoi(endFrame.c_str());
-
-      TagConv.ConvertLine(pOverlay, text, strlen(text));
-      m_collection.Add(pOverlay);
+      // the text is converted when the subtitle is shown
+      m_collection.Add(m_framerate * atoi(startFrame.c_str()),
+                       m_framerate * atoi(endFrame.c_str()),
+                       lineStart + pos + reg.GetFindLen());
     }
+    lineStart = m_pStream->Seek(0, SEEK_CUR);
   }
 
+  m_collection.SetParser(std::bind(&CDVDSubtitleParserMPL2::ParseText, this, std::placeholders::_1));
   return true;
 }
 
+CDVDOverlay* CDVDSubtitleParserMPL2::ParseText(int64_t position)
+{
+  if (m_pStream->Seek((long)position, SEEK_SET) != position)
+    return NULL;
+
+  char line[1024];
+  if (!m_pStream->ReadLine(line, sizeof(line)))
+    return NULL;
+  if ((strlen(line) > 0) && (line[strlen(line) - 1] == '\r'))
+    line[strlen(line) - 1] = 0;
+
+  CDVDOverlayText* pOverlay = new CDVDOverlayText();
+  m_tagConv.ConvertLine(pOverlay, line, strlen(line));
+  return pOverlay;
+}
+
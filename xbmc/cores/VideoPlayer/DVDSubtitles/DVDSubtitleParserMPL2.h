@@ -21,6 +21,7 @@
  */
 
 #include "DVDSubtitleParser.h"
+#include "DVDSubtitleTagMicroDVD.h"
 
 class CDVDSubtitleParserMPL2 : public CDVDSubtitleParserText
 {
@@ -30,5 +31,8 @@ public:
 
   virtual bool Open(CDVDStreamInfo &hints);
 private:
+  CDVDOverlay* ParseText(int64_t position);
+
   double m_framerate;
+  CDVDSubtitleTagMicroDVD m_tagConv;
 };
@@ -39,8 +39,7 @@ bool CDVDSubtitleParserSubrip::Open(CDVDStreamInfo &hints)
   if (!CDVDSubtitleParserText::Open())
     return false;
 
-  CDVDSubtitleTagSami TagConv;
-  if (!TagConv.Init())
+  if (!m_tagConv.Init())
     return false;
 
   char line[1024];
@@ -65,11 +64,11 @@ bool CDVDSubtitleParserSubrip::Open(CDVDStreamInfo &hints)
       }
       else if (c == 14) // time info
       {
-        CDVDOverlayText* pOverlay = new CDVDOverlayText();
-        pOverlay->Acquire(); // increase ref count with one so that we can hold a handle to this overlay
+        double startTime = ((double)(((hh1 * 60 + mm1) * 60) + ss1) * 1000 + ms1) * (DVD_TIME_BASE / 1000);
+        double stopTime  = ((double)(((hh2 * 60 + mm2) * 60) + ss2) * 1000 + ms2) * (DVD_TIME_BASE / 1000);
 
-        pOverlay->iPTSStartTime = ((double)(((hh1 * 60 + mm1) * 60) + ss1) * 1000 + ms1) * (DVD_TIME_BASE / 1000);
-        pOverlay->iPTSStopTime  = ((double)(((hh2 * 60 + mm2) * 60) + ss2) * 1000 + ms2) * (DVD_TIME_BASE / 1000);
+        // only remember where the text is, it's converted when the subtitle is shown
+        m_collection.Add(startTime, stopTime, m_pStream->Seek(0, SEEK_CUR));
 
         while (m_pStream->ReadLine(line, sizeof(line)))
         {
@@ -78,15 +77,35 @@ bool CDVDSubtitleParserSubrip::Open(CDVDStreamInfo &hints)
 
           // empty line, next subtitle is about to start
           if (strLine.length() <= 0) break;
-
-          TagConv.ConvertLine(pOverlay, strLine.c_str(), strLine.length());
         }
-        TagConv.CloseTag(pOverlay);
-        m_collection.Add(pOverlay);
       }
     }
   }
   m_collection.Sort();
+  m_collection.SetParser(std::bind(&CDVDSubtitleParserSubrip::ParseText, this, std::placeholders::_1));
   return true;
 }
 
+CDVDOverlay* CDVDSubtitleParserSubrip::ParseText(int64_t position)
+{
+  if (m_pStream->Seek((long)position, SEEK_SET) != position)
+    return NULL;
+
+  CDVDOverlayText* pOverlay = new CDVDOverlayText();
+
+  char line[1024];
+  std::string strLine;
+  while (m_pStream->ReadLine(line, sizeof(line)))
+  {
+    strLine = line;
+    StringUtils::Trim(strLine);
+
+    // empty line, next subtitle starts
+    if (strLine.length() <= 0) break;
+
+    m_tagConv.ConvertLine(pOverlay, strLine.c_str(), strLine.length());
+  }
+  m_tagConv.CloseTag(pOverlay);
+  return pOverlay;
+}
+
@@ -21,6 +21,7 @@
  */
 
 #include "DVDSubtitleParser.h"
+#include "DVDSubtitleTagSami.h"
 
 class CDVDSubtitleParserSubrip : public CDVDSubtitleParserText
 {
@@ -30,4 +31,7 @@ public:
 
   virtual bool Open(CDVDStreamInfo &hints);
 private:
+  CDVDOverlay* ParseText(int64_t position);
+
+  CDVDSubtitleTagSami m_tagConv;
 };
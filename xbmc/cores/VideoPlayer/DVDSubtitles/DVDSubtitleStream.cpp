@@ -140,6 +140,8 @@ int CDVDSubtitleStream::Read(char* buf, int buf_size)
 
 long CDVDSubtitleStream::Seek(long offset, int whence)
 {
+  // reading up to the end sets eof and fail, which makes seekg fail as well
+  m_stringstream.clear();
   switch (whence)
   {
     case SEEK_CUR:
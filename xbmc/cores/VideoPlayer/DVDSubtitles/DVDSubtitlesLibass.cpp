@@ -44,6 +44,7 @@ CDVDSubtitlesLibass::CDVDSubtitlesLibass()
   m_library = NULL;
   m_renderer = NULL;
   m_references = 1;
+  m_generation = 0;
 
   if(!m_dll.Load())
   {
@@ -117,6 +118,7 @@ bool CDVDSubtitlesLibass::DecodeHeader(char* data, int size)
   }
 
   m_dll.ass_process_codec_private(m_track, data, size);
+  m_generation++;
   return true;
 }
 
@@ -130,6 +132,7 @@ bool CDVDSubtitlesLibass::DecodeDemuxPkt(char* data, int size, double start, dou
   }
 
   m_dll.ass_process_chunk(m_track, data, size, DVD_TIME_TO_MSEC(start), DVD_TIME_TO_MSEC(duration));
+  m_generation++;
   return true;
 }
 
@@ -148,6 +151,7 @@ bool CDVDSubtitlesLibass::CreateTrack(char* buf, size_t size)
   if(m_track == NULL)
     return false;
 
+  m_generation++;
   return true;
 }
 
@@ -182,6 +186,12 @@ ASS_Event* CDVDSubtitlesLibass::GetEvents()
   return m_track->events;
 }
 
+unsigned int CDVDSubtitlesLibass::GetGeneration()
+{
+  CSingleLock lock(m_section);
+  return m_generation;
+}
+
 int CDVDSubtitlesLibass::GetNrOfEvents()
 {
   CSingleLock lock(m_section);
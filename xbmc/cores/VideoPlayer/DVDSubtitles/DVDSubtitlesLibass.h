@@ -37,6 +37,12 @@ public:
 
   int GetNrOfEvents();
 
+  /*!
+   \brief Changes whenever events are added to the track, frames rendered
+   before may be missing them.
+   */
+  unsigned int GetGeneration();
+
   bool DecodeHeader(char* data, int size);
   bool DecodeDemuxPkt(char* data, int size, double start, double duration);
   bool CreateTrack(char* buf, size_t size);
@@ -47,6 +53,7 @@ private:
   ASS_Library* m_library;
   ASS_Track* m_track;
   ASS_Renderer* m_renderer;
+  unsigned int m_generation;
   CCriticalSection m_section;
 };
 
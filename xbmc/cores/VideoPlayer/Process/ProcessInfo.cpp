@@ -19,6 +19,11 @@
  */
 
 #include "ProcessInfo.h"
+#include "cores/DataCacheCore.h"
+#include "cores/VideoPlayer/DVDDemuxers/DemuxPacketPool.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/Variant.h"
 
 // Override for platform ports
 #if !defined(PLATFORM_OVERRIDE)
@@ -32,9 +37,19 @@ CProcessInfo* CProcessInfo::CreateInstance()
 
 
 // base class definitions
-CProcessInfo::CProcessInfo()
+CProcessInfo::CProcessInfo() :
+  m_audioSyncError(-100.0, 100.0, 100),
+  // same layout as the histograms of the render manager and the reference
+  // clock, UpdateAVSyncStats() copies their buckets without reallocating
+  m_presentError(-50.0, 50.0, 100),
+  m_vblankJitter(-4.0, 4.0, 80)
 {
-
+  m_dataCache = nullptr;
+  ResetDemuxPacketStats();
+  m_videoDecoderThreads = 0;
+  ResetVideoDecodeTime();
+  ResetAVSyncStats();
+  ResetCacheStatus();
 }
 
 CProcessInfo::~CProcessInfo()
@@ -51,3 +66,229 @@ bool CProcessInfo::AllowDTSHDDecode()
 {
   return true;
 }
+
+void CProcessInfo::SetDataCache(CDataCacheCore *cache)
+{
+  m_dataCache = cache;
+  if (!m_dataCache)
+    return;
+
+  {
+    CSingleLock lock(m_videoCodecSection);
+    m_dataCache->SetVideoDecoderThreading(m_videoDecoderThreads, m_videoDecoderThreadType);
+    m_dataCache->SetVideoDecodeTime(m_videoDecodeTime);
+  }
+
+  {
+    CVariant stats(CVariant::VariantTypeObject);
+    GetAVSyncStats(stats);
+    m_dataCache->SetAVSyncStats(stats);
+  }
+
+  {
+    CSingleLock lock(m_cacheSection);
+    m_dataCache->SetCacheStatus(m_cacheStatus);
+  }
+}
+
+// demux
+void CProcessInfo::ResetDemuxPacketStats()
+{
+  CSingleLock lock(m_demuxSection);
+
+  m_demuxStatsTime = 0;
+  m_demuxAllocs = 0;
+  m_demuxMisses = 0;
+  m_demuxBytesCopied = 0;
+  m_demuxAllocsPerSecond = 0;
+  m_demuxMissesPerSecond = 0;
+  m_demuxBytesCopiedPerSecond = 0;
+}
+
+void CProcessInfo::UpdateDemuxPacketStats(const DemuxPacketStats &stats)
+{
+  CSingleLock lock(m_demuxSection);
+
+  unsigned int now = XbmcThreads::SystemClockMillis();
+  if (m_demuxStatsTime)
+  {
+    unsigned int elapsed = now - m_demuxStatsTime;
+    if (elapsed < 1000)
+      return;
+
+    double seconds = elapsed / 1000.0;
+    m_demuxAllocsPerSecond = (stats.allocations - m_demuxAllocs) / seconds;
+    m_demuxMissesPerSecond = (stats.poolMisses - m_demuxMisses) / seconds;
+    m_demuxBytesCopiedPerSecond = (stats.bytesCopied - m_demuxBytesCopied) / seconds;
+  }
+
+  m_demuxStatsTime = now;
+  m_demuxAllocs = stats.allocations;
+  m_demuxMisses = stats.poolMisses;
+  m_demuxBytesCopied = stats.bytesCopied;
+}
+
+double CProcessInfo::GetDemuxPacketAllocsPerSecond()
+{
+  CSingleLock lock(m_demuxSection);
+  return m_demuxAllocsPerSecond;
+}
+
+double CProcessInfo::GetDemuxPacketMissesPerSecond()
+{
+  CSingleLock lock(m_demuxSection);
+  return m_demuxMissesPerSecond;
+}
+
+double CProcessInfo::GetDemuxBytesCopiedPerSecond()
+{
+  CSingleLock lock(m_demuxSection);
+  return m_demuxBytesCopiedPerSecond;
+}
+
+uint64_t CProcessInfo::GetDemuxPacketAllocs()
+{
+  CSingleLock lock(m_demuxSection);
+  return m_demuxAllocs;
+}
+
+uint64_t CProcessInfo::GetDemuxPacketMisses()
+{
+  CSingleLock lock(m_demuxSection);
+  return m_demuxMisses;
+}
+
+// video codec
+void CProcessInfo::SetVideoDecoderThreading(int threads, const std::string &type)
+{
+  CSingleLock lock(m_videoCodecSection);
+
+  m_videoDecoderThreads = threads;
+  m_videoDecoderThreadType = type;
+
+  if (m_dataCache)
+    m_dataCache->SetVideoDecoderThreading(threads, type);
+}
+
+int CProcessInfo::GetVideoDecoderThreads()
+{
+  CSingleLock lock(m_videoCodecSection);
+  return m_videoDecoderThreads;
+}
+
+std::string CProcessInfo::GetVideoDecoderThreadType()
+{
+  CSingleLock lock(m_videoCodecSection);
+  return m_videoDecoderThreadType;
+}
+
+void CProcessInfo::ResetVideoDecodeTime()
+{
+  CSingleLock lock(m_videoCodecSection);
+
+  m_videoDecodeTime = 0;
+  if (m_dataCache)
+    m_dataCache->SetVideoDecodeTime(0);
+}
+
+void CProcessInfo::UpdateVideoDecodeTime(double ms)
+{
+  CSingleLock lock(m_videoCodecSection);
+
+  // smooth over roughly the last 16 frames
+  if (m_videoDecodeTime == 0)
+    m_videoDecodeTime = ms;
+  else
+    m_videoDecodeTime += (ms - m_videoDecodeTime) / 16;
+
+  if (m_dataCache)
+    m_dataCache->SetVideoDecodeTime(m_videoDecodeTime);
+}
+
+double CProcessInfo::GetVideoDecodeTime()
+{
+  CSingleLock lock(m_videoCodecSection);
+  return m_videoDecodeTime;
+}
+
+// a/v sync
+void CProcessInfo::ResetAVSyncStats()
+{
+  CSingleLock lock(m_syncSection);
+
+  m_syncStatsTime = 0;
+  m_audioSyncError.Reset();
+  m_presentError.Reset();
+  m_vblankJitter.Reset();
+  m_presentedFrames = 0;
+  m_droppedFrames = 0;
+  m_lateFrames = 0;
+
+  if (m_dataCache)
+    m_dataCache->SetAVSyncStats(CVariant(CVariant::VariantTypeObject));
+}
+
+void CProcessInfo::AddAudioSyncError(double ms)
+{
+  CSingleLock lock(m_syncSection);
+  m_audioSyncError.Add(ms);
+}
+
+void CProcessInfo::UpdateAVSyncStats(const CHistogram &presentError, const CHistogram &vblankJitter,
+                                     uint64_t presented, uint64_t dropped, uint64_t late)
+{
+  CSingleLock lock(m_syncSection);
+
+  m_presentError = presentError;
+  m_vblankJitter = vblankJitter;
+  m_presentedFrames = presented;
+  m_droppedFrames = dropped;
+  m_lateFrames = late;
+
+  if (!m_dataCache)
+    return;
+
+  // consumers poll, a snapshot per second is plenty
+  unsigned int now = XbmcThreads::SystemClockMillis();
+  if (m_syncStatsTime && now - m_syncStatsTime < 1000)
+    return;
+  m_syncStatsTime = now;
+
+  CVariant stats;
+  GetAVSyncStats(stats);
+  m_dataCache->SetAVSyncStats(stats);
+}
+
+void CProcessInfo::GetAVSyncStats(CVariant &stats)
+{
+  CSingleLock lock(m_syncSection);
+
+  stats["presentedframes"] = m_presentedFrames;
+  stats["droppedframes"] = m_droppedFrames;
+  stats["lateframes"] = m_lateFrames;
+  m_presentError.Serialize(stats["presentationerror"]);
+  m_audioSyncError.Serialize(stats["audioerror"]);
+  m_vblankJitter.Serialize(stats["vblankjitter"]);
+}
+
+// input cache
+void CProcessInfo::ResetCacheStatus()
+{
+  XFILE::SCacheStatus status = {};
+  SetCacheStatus(status);
+}
+
+void CProcessInfo::SetCacheStatus(const XFILE::SCacheStatus &status)
+{
+  CSingleLock lock(m_cacheSection);
+  m_cacheStatus = status;
+
+  if (m_dataCache)
+    m_dataCache->SetCacheStatus(status);
+}
+
+XFILE::SCacheStatus CProcessInfo::GetCacheStatus()
+{
+  CSingleLock lock(m_cacheSection);
+  return m_cacheStatus;
+}
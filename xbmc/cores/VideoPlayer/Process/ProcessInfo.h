@@ -20,6 +20,16 @@
 #pragma once
 
 #include "cores/IPlayer.h"
+#include "filesystem/IFileTypes.h"
+#include "threads/CriticalSection.h"
+#include "utils/Histogram.h"
+
+#include <stdint.h>
+#include <string>
+
+class CDataCacheCore;
+class CVariant;
+struct DemuxPacketStats;
 
 class CProcessInfo
 {
@@ -29,6 +39,67 @@ public:
   virtual EINTERLACEMETHOD GetFallbackDeintMethod();
   virtual bool AllowDTSHDDecode();
 
+  // only the instance of the player publishes its state, others (thumb
+  // extraction) must not overwrite what the gui shows
+  void SetDataCache(CDataCacheCore *cache);
+
+  // demux
+  void ResetDemuxPacketStats();
+  void UpdateDemuxPacketStats(const DemuxPacketStats &stats);
+  double GetDemuxPacketAllocsPerSecond();
+  double GetDemuxPacketMissesPerSecond();
+  double GetDemuxBytesCopiedPerSecond();
+  uint64_t GetDemuxPacketAllocs();
+  uint64_t GetDemuxPacketMisses();
+
+  // video codec
+  void SetVideoDecoderThreading(int threads, const std::string &type);
+  int GetVideoDecoderThreads();
+  std::string GetVideoDecoderThreadType();
+  void ResetVideoDecodeTime();
+  void UpdateVideoDecodeTime(double ms);
+  double GetVideoDecodeTime();
+
+  // a/v sync, errors in ms
+  void ResetAVSyncStats();
+  void AddAudioSyncError(double ms);
+  void UpdateAVSyncStats(const CHistogram &presentError, const CHistogram &vblankJitter,
+                         uint64_t presented, uint64_t dropped, uint64_t late);
+  void GetAVSyncStats(CVariant &stats);
+
+  // input cache
+  void ResetCacheStatus();
+  void SetCacheStatus(const XFILE::SCacheStatus &status);
+  XFILE::SCacheStatus GetCacheStatus();
+
 protected:
   CProcessInfo();
+
+  CDataCacheCore *m_dataCache;
+
+  CCriticalSection m_demuxSection;
+  unsigned int m_demuxStatsTime;
+  uint64_t m_demuxAllocs;
+  uint64_t m_demuxMisses;
+  uint64_t m_demuxBytesCopied;
+  double m_demuxAllocsPerSecond;
+  double m_demuxMissesPerSecond;
+  double m_demuxBytesCopiedPerSecond;
+
+  CCriticalSection m_videoCodecSection;
+  int m_videoDecoderThreads;
+  std::string m_videoDecoderThreadType;
+  double m_videoDecodeTime;
+
+  CCriticalSection m_syncSection;
+  unsigned int m_syncStatsTime;
+  CHistogram m_audioSyncError;
+  CHistogram m_presentError;
+  CHistogram m_vblankJitter;
+  uint64_t m_presentedFrames;
+  uint64_t m_droppedFrames;
+  uint64_t m_lateFrames;
+
+  CCriticalSection m_cacheSection;
+  XFILE::SCacheStatus m_cacheStatus;
 };
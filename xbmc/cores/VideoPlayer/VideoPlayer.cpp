@@ -32,6 +32,7 @@
 #include "DVDDemuxers/DVDDemuxVobsub.h"
 #include "DVDDemuxers/DVDFactoryDemuxer.h"
 #include "DVDDemuxers/DVDDemuxFFmpeg.h"
+#include "DVDDemuxers/DemuxPacketPool.h"
 
 #include "DVDFileInfo.h"
 
@@ -59,6 +60,7 @@
 #endif
 #include "settings/AdvancedSettings.h"
 #include "FileItem.h"
+#include "filesystem/File.h"
 #include "GUIUserMessages.h"
 #include "settings/Settings.h"
 #include "settings/MediaSettings.h"
@@ -67,6 +69,7 @@
 #include "pvr/PVRManager.h"
 #include "utils/StreamUtils.h"
 #include "utils/Variant.h"
+#include "utils/JSONVariantWriter.h"
 #include "storage/MediaManager.h"
 #include "dialogs/GUIDialogBusy.h"
 #include "dialogs/GUIDialogKaiToast.h"
@@ -74,6 +77,7 @@
 #include "Util.h"
 #include "LangInfo.h"
 #include "URL.h"
+#include "XBDateTime.h"
 
 #ifdef HAS_OMXPLAYER
 #include "cores/omxplayer/OMXPlayerAudio.h"
@@ -661,6 +665,7 @@ CVideoPlayer::CVideoPlayer(IPlayerCallback& callback)
   m_SkipCommercials = true;
 
   m_processInfo = CProcessInfo::CreateInstance();
+  m_processInfo->SetDataCache(&g_dataCacheCore);
   CreatePlayers();
 
   m_displayLost = false;
@@ -701,6 +706,7 @@ bool CVideoPlayer::OpenFile(const CFileItem& file, const CPlayerOptions &options
 
   m_ready.Reset();
 
+  m_processInfo->ResetAVSyncStats();
   m_renderManager.PreInit();
 
   Create();
@@ -2412,6 +2418,9 @@ void CVideoPlayer::OnExit()
     CloseStream(m_CurrentAudio,    !m_bAbortRequest);
     CloseStream(m_CurrentVideo,    !m_bAbortRequest);
 
+    if (g_advancedSettings.m_videoDumpAVSyncStats)
+      DumpAVSyncStats();
+
     // the generalization principle was abused for subtitle player. actually it is not a stream player like
     // video and audio. subtitle player does not run on its own thread, hence waitForBuffers makes
     // no sense here. waitForBuffers is abused to clear overlay container (false clears container)
@@ -2432,6 +2441,9 @@ void CVideoPlayer::OnExit()
 
     m_messenger.End();
 
+    // packets of this session are back in the pool, don't keep them around
+    CDemuxPacketPool::GetInstance().Trim();
+
     if (m_omxplayer_mode)
     {
       m_OmxPlayerState.av_clock.OMXStop();
@@ -2455,6 +2467,33 @@ void CVideoPlayer::OnExit()
   CFFmpegLog::ClearLogLevel();
 }
 
+void CVideoPlayer::UpdateAVSyncStats()
+{
+  uint64_t presented, dropped, late;
+  m_renderManager.GetSyncStats(m_presentError, presented, dropped, late);
+  m_clock.GetVblankJitter(m_vblankJitter);
+  m_processInfo->UpdateAVSyncStats(m_presentError, m_vblankJitter, presented, dropped, late);
+}
+
+void CVideoPlayer::DumpAVSyncStats()
+{
+  UpdateAVSyncStats();
+
+  CVariant stats;
+  m_processInfo->GetAVSyncStats(stats);
+  stats["file"] = CURL::GetRedacted(m_item.GetPath());
+  std::string json = CJSONVariantWriter::Write(stats, false);
+
+  std::string path = "special://logpath/avsyncstats-" + CDateTime::GetCurrentDateTime().GetAsSaveString() + ".json";
+  XFILE::CFile file;
+  if (!file.OpenForWrite(path, true) || file.Write(json.c_str(), json.size()) != (ssize_t)json.size())
+  {
+    CLog::Log(LOGERROR, "CVideoPlayer::%s - failed to write %s", __FUNCTION__, path.c_str());
+    return;
+  }
+  CLog::Log(LOGNOTICE, "CVideoPlayer::%s - a/v sync statistics written to %s", __FUNCTION__, path.c_str());
+}
+
 void CVideoPlayer::HandleMessages()
 {
   CDVDMsg* pMsg;
@@ -4679,6 +4718,9 @@ void CVideoPlayer::UpdatePlayState(double timeout)
      m_State.timestamp + DVD_MSEC_TO_TIME(timeout) > m_clock.GetAbsoluteClock())
     return;
 
+  m_processInfo->UpdateDemuxPacketStats(CDemuxPacketPool::GetInstance().GetStats());
+  UpdateAVSyncStats();
+
   SPlayerState state(m_State);
 
   state.dts = DVD_NOPTS_VALUE;
@@ -4802,6 +4844,7 @@ void CVideoPlayer::UpdatePlayState(double timeout)
     state.cache_bytes = status.forward;
     if(state.time_total)
       state.cache_bytes += m_pInputStream->GetLength() * (int64_t) (GetQueueTime() / state.time_total);
+    m_processInfo->SetCacheStatus(status);
   }
   else
     state.cache_bytes = 0;
@@ -435,6 +435,8 @@ protected:
 
   void UpdateApplication(double timeout);
   void UpdatePlayState(double timeout);
+  void UpdateAVSyncStats();
+  void DumpAVSyncStats();
   void UpdateStreamInfos();
   void GetGeneralInfo(std::string& strVideoInfo);
 
@@ -448,6 +450,9 @@ protected:
   CFileItem    m_item;
   XbmcThreads::EndTime m_ChannelEntryTimeOut;
   CProcessInfo *m_processInfo;
+  // snapshots for UpdateAVSyncStats(), the buckets are allocated by the first one
+  CHistogram m_presentError;
+  CHistogram m_vblankJitter;
 
   CCurrentStream m_CurrentAudio;
   CCurrentStream m_CurrentVideo;
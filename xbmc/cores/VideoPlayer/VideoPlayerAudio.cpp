@@ -77,6 +77,7 @@ CVideoPlayerAudio::CVideoPlayerAudio(CDVDClock* pClock, CDVDMessageQueue& parent
 
   m_messageQueue.SetMaxDataSize(6 * 1024 * 1024);
   m_messageQueue.SetMaxTimeSize(8.0);
+  m_messageQueue.SetPacketRing(4096);
 }
 
 CVideoPlayerAudio::~CVideoPlayerAudio()
@@ -215,6 +216,16 @@ void CVideoPlayerAudio::UpdatePlayerInfo()
 
   s << ", att:" << std::fixed << std::setprecision(1) << log(GetCurrentAttenuation()) * 20.0f << " dB";
 
+  // sample buffers the engine had to allocate, constant during steady playback
+  AEBufferStats bufferStats;
+  if (CAEFactory::GetBufferStats(bufferStats))
+    s << ", ab:" << bufferStats.allocations;
+
+  // frames per second the engine renders while it is not paced by a device
+  AERenderStats renderStats;
+  if (CAEFactory::GetRenderStats(renderStats) && renderStats.elapsed > 0.0)
+    s << ", fw:" << std::fixed << std::setprecision(0) << renderStats.samples[AE_STAGE_SINK] / renderStats.elapsed << " f/s";
+
   SInfo info;
   info.info        = s.str();
   info.pts         = m_dvdAudio.GetPlayingPts();
@@ -526,6 +537,7 @@ void CVideoPlayerAudio::SetSyncType(bool passthrough)
 bool CVideoPlayerAudio::OutputPacket(DVDAudioFrame &audioframe)
 {
   double syncerror = m_dvdAudio.GetSyncError();
+  m_processInfo.AddAudioSyncError(syncerror * 1000.0 / DVD_TIME_BASE);
 
   if (m_synctype == SYNC_DISCON)
   {
@@ -0,0 +1,234 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "AssCompositor.h"
+#include "OverlayRendererUtil.h"
+#include "cores/VideoPlayer/DVDClock.h"
+#include "cores/VideoPlayer/DVDSubtitles/DVDSubtitlesLibass.h"
+#include "threads/SingleLock.h"
+#include "utils/Job.h"
+#include "utils/JobManager.h"
+#include "utils/log.h"
+
+using namespace OVERLAY;
+
+namespace
+{
+
+class CAssComposeJob : public CJob
+{
+public:
+  CAssComposeJob(const std::shared_ptr<CAssCompositor> &compositor) : m_compositor(compositor) {}
+  virtual bool DoWork()
+  {
+    m_compositor->Process();
+    return true;
+  }
+  virtual const char *GetType() const { return "asscompose"; }
+
+private:
+  std::shared_ptr<CAssCompositor> m_compositor;
+};
+
+// libass renders with millisecond precision
+const double tolerance = DVD_MSEC_TO_TIME(1);
+
+}
+
+bool CAssCompositor::SParams::operator==(const SParams &right) const
+{
+  return frameWidth     == right.frameWidth
+      && frameHeight    == right.frameHeight
+      && videoWidth     == right.videoWidth
+      && videoHeight    == right.videoHeight
+      && useMargin      == right.useMargin
+      && position       == right.position
+      && maxTextureSize == right.maxTextureSize;
+}
+
+CAssCompositor::CAssCompositor(CDVDSubtitlesLibass *libass, int ahead)
+{
+  m_libass = libass;
+  m_libass->Acquire();
+  m_ahead = ahead;
+  m_hasParams = false;
+  m_generation = 0;
+  m_lastPts = DVD_NOPTS_VALUE;
+  m_interval = 0.0;
+  m_running = false;
+  m_cancelled = false;
+  m_hits = 0;
+  m_misses = 0;
+  m_hasLast = false;
+  m_frameId = 0;
+}
+
+CAssCompositor::~CAssCompositor()
+{
+  Cancel();
+  m_libass->Release();
+}
+
+CAssCompositor::SFrame CAssCompositor::Render(double pts, const SParams &params)
+{
+  SFrame frame;
+  bool found;
+  unsigned int generation = m_libass->GetGeneration();
+  {
+    CSingleLock lock(m_section);
+    if (!m_hasParams || params != m_params || generation != m_generation)
+    {
+      m_params = params;
+      m_hasParams = true;
+      m_generation = generation;
+      m_ready.clear();
+      m_queue.clear();
+    }
+
+    if (m_lastPts != DVD_NOPTS_VALUE && pts > m_lastPts && pts - m_lastPts < DVD_TIME_BASE)
+      m_interval = pts - m_lastPts;
+    m_lastPts = pts;
+
+    found = FindReady(pts, frame);
+    if (found)
+      m_hits++;
+    else
+      m_misses++;
+  }
+
+  if (!found)
+  {
+    CSingleLock renderLock(m_renderSection);
+    // the worker may just have finished it
+    CSingleLock lock(m_section);
+    if (!FindReady(pts, frame))
+    {
+      lock.Leave();
+      frame = Compose(pts, params);
+    }
+  }
+
+  Schedule(pts);
+  return frame;
+}
+
+bool CAssCompositor::FindReady(double pts, SFrame &frame)
+{
+  // frames before pts are of no use anymore
+  m_ready.erase(m_ready.begin(), m_ready.lower_bound(pts - tolerance));
+
+  std::map<double, SFrame>::iterator it = m_ready.begin();
+  if (it == m_ready.end() || it->first > pts + tolerance)
+    return false;
+
+  frame = it->second;
+  return true;
+}
+
+void CAssCompositor::Schedule(double pts)
+{
+  CSingleLock lock(m_section);
+  if (m_cancelled || m_ahead <= 0 || m_interval <= 0.0)
+    return;
+
+  double last = pts + m_ahead * m_interval;
+
+  // anything further out was rendered before a seek back
+  m_ready.erase(m_ready.upper_bound(last + tolerance), m_ready.end());
+
+  m_queue.clear();
+  for (int i = 1; i <= m_ahead; i++)
+  {
+    double next = pts + i * m_interval;
+    std::map<double, SFrame>::const_iterator it = m_ready.lower_bound(next - tolerance);
+    if (it == m_ready.end() || it->first > next + tolerance)
+      m_queue.insert(next);
+  }
+
+  if (!m_queue.empty() && !m_running)
+  {
+    m_running = true;
+    CJobManager::GetInstance().AddJob(new CAssComposeJob(shared_from_this()), NULL, CJob::PRIORITY_NORMAL);
+  }
+}
+
+void CAssCompositor::Cancel()
+{
+  {
+    CSingleLock lock(m_section);
+    m_cancelled = true;
+    m_queue.clear();
+    m_ready.clear();
+  }
+  // wait for a frame being composed right now
+  CSingleLock renderLock(m_renderSection);
+}
+
+void CAssCompositor::Process()
+{
+  CSingleLock lock(m_section);
+  while (!m_cancelled && !m_queue.empty())
+  {
+    double pts = *m_queue.begin();
+    m_queue.erase(m_queue.begin());
+    SParams params = m_params;
+    unsigned int generation = m_generation;
+    lock.Leave();
+
+    SFrame frame;
+    bool current;
+    {
+      CSingleLock renderLock(m_renderSection);
+      frame = Compose(pts, params);
+      // events that came in while rendering may be missing
+      current = m_libass->GetGeneration() == generation;
+    }
+
+    lock.Enter();
+    // drop it if the output or the events changed in the meantime
+    if (!m_cancelled && current && params == m_params && generation == m_generation)
+      m_ready[pts] = frame;
+  }
+  m_running = false;
+}
+
+CAssCompositor::SFrame CAssCompositor::Compose(double pts, const SParams &params)
+{
+  int changes = 0;
+  ASS_Image* images = m_libass->RenderImage(params.frameWidth, params.frameHeight,
+                                            params.videoWidth, params.videoHeight,
+                                            pts, params.useMargin, params.position, &changes);
+
+  // libass compares with the frame it rendered last, no matter for whom
+  if (changes == 0 && m_hasLast && params == m_lastParams)
+    return m_last;
+
+  SFrame frame;
+  frame.id = ++m_frameId;
+  std::shared_ptr<SQuads> quads = std::make_shared<SQuads>();
+  if (convert_quad(images, *quads, params.maxTextureSize))
+    frame.quads = quads;
+
+  m_last = frame;
+  m_lastParams = params;
+  m_hasLast = true;
+  return frame;
+}
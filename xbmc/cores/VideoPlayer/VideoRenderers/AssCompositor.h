@@ -0,0 +1,127 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <map>
+#include <memory>
+#include <set>
+
+#include "threads/CriticalSection.h"
+
+class CDVDSubtitlesLibass;
+
+namespace OVERLAY {
+
+  struct SQuads;
+
+  /*!
+   * \brief Renders the frames of a libass track and packs them into a single
+   * texture each (see convert_quad), ahead of time on a worker thread.
+   *
+   * Every call to Render() returns the frame for the given pts. If a frame
+   * rendered ahead is available for it, that one is used, otherwise libass is
+   * run right away. Afterwards the frames for the next few pts are queued,
+   * predicted from the interval between the last two calls. A frame keeps
+   * the id of the previous one as long as libass reports no change, so the
+   * caller only needs to upload a new texture when the id changes. Frames
+   * rendered ahead are dropped once new events reach the track (see
+   * CDVDSubtitlesLibass::GetGeneration()).
+   */
+  class CAssCompositor : public std::enable_shared_from_this<CAssCompositor>
+  {
+  public:
+    struct SParams
+    {
+      int frameWidth;
+      int frameHeight;
+      int videoWidth;
+      int videoHeight;
+      int useMargin;
+      double position;
+      int maxTextureSize;
+
+      bool operator==(const SParams &right) const;
+      bool operator!=(const SParams &right) const { return !(*this == right); }
+    };
+
+    struct SFrame
+    {
+      SFrame() : id(0) {}
+      unsigned int id;                //!< changes whenever the content changes
+      std::shared_ptr<SQuads> quads;  //!< empty if nothing is visible
+    };
+
+    /*!
+     * \param ahead number of frames to render in advance, 0 to render on demand only
+     */
+    CAssCompositor(CDVDSubtitlesLibass *libass, int ahead = 8);
+    ~CAssCompositor();
+
+    SFrame Render(double pts, const SParams &params);
+
+    /*!
+     * \brief Drop all queued frames and wait for a frame being rendered in the
+     * background. Nothing is rendered ahead after this.
+     */
+    void Cancel();
+
+    /*!
+     * \brief Called on the worker thread, renders the queued frames.
+     */
+    void Process();
+
+    unsigned int GetHits() const { return m_hits; }
+    unsigned int GetMisses() const { return m_misses; }
+
+  private:
+    CAssCompositor(const CAssCompositor&) = delete;
+    CAssCompositor& operator=(const CAssCompositor&) = delete;
+
+    bool FindReady(double pts, SFrame &frame);
+    void Schedule(double pts);
+    SFrame Compose(double pts, const SParams &params);
+
+    CDVDSubtitlesLibass *m_libass;
+    int m_ahead;
+
+    CCriticalSection m_section;
+    SParams m_params;
+    bool m_hasParams;
+    unsigned int m_generation;          //!< of the track the ready frames were rendered from
+    double m_lastPts;
+    double m_interval;
+    std::map<double, SFrame> m_ready;   //!< frames rendered ahead by pts
+    std::set<double> m_queue;           //!< pts to render ahead
+    bool m_running;
+    bool m_cancelled;
+    unsigned int m_hits;
+    unsigned int m_misses;
+
+    // libass keeps a single renderer per track, so only one frame is composed at a time
+    CCriticalSection m_renderSection;
+    SFrame m_last;
+    SParams m_lastParams;
+    bool m_hasLast;
+    unsigned int m_frameId;
+  };
+
+}
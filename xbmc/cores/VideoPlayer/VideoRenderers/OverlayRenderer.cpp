@@ -36,6 +36,8 @@
 #include "utils/MathUtils.h"
 #include "OverlayRendererUtil.h"
 #include "OverlayRendererGUI.h"
+#include "AssCompositor.h"
+#include "windowing/WindowingFactory.h"
 #if defined(HAS_GL) || defined(HAS_GLES)
 #include "OverlayRendererGL.h"
 #elif defined(HAS_DX)
@@ -121,6 +123,10 @@ void CRenderer::ReleaseCache()
   }
   m_textureCache.clear();
   m_textureid++;
+
+  for (auto& track : m_assTracks)
+    track.second.compositor->Cancel();
+  m_assTracks.clear();
 }
 
 void CRenderer::ReleaseUnused()
@@ -149,6 +155,32 @@ void CRenderer::ReleaseUnused()
     else
       ++it;
   }
+
+  for (auto it = m_assTracks.begin(); it != m_assTracks.end(); )
+  {
+    bool found = false;
+    for (auto& buffer : m_buffers)
+    {
+      for (auto& dvdoverlay : buffer)
+      {
+        if (dvdoverlay.overlay_dvd && dvdoverlay.overlay_dvd->IsOverlayType(DVDOVERLAY_TYPE_SSA)
+        && ((CDVDOverlaySSA*)dvdoverlay.overlay_dvd)->m_libass == it->first)
+        {
+          found = true;
+          break;
+        }
+      }
+      if (found)
+        break;
+    }
+    if (!found)
+    {
+      it->second.compositor->Cancel();
+      it = m_assTracks.erase(it);
+    }
+    else
+      ++it;
+  }
 }
 
 void CRenderer::Render(int idx)
@@ -355,24 +387,40 @@ COverlay* CRenderer::Convert(CDVDOverlaySSA* o, double pts)
   }
   else
     position = 0.0;
-  int changes = 0;
-  ASS_Image* images = o->m_libass->RenderImage(targetWidth, targetHeight, videoWidth, videoHeight, pts, useMargin, position, &changes);
 
-  if(o->m_textureid)
+  CAssCompositor::SParams params;
+  params.frameWidth = targetWidth;
+  params.frameHeight = targetHeight;
+  params.videoWidth = videoWidth;
+  params.videoHeight = videoHeight;
+  params.useMargin = useMargin;
+  params.position = position;
+  params.maxTextureSize = g_Windowing.GetMaxTextureSize();
+
+  SAssTrack& track = m_assTracks[o->m_libass];
+  if (!track.compositor)
+    track.compositor = std::make_shared<CAssCompositor>(o->m_libass);
+  CAssCompositor::SFrame frame = track.compositor->Render(pts, params);
+
+  // one texture per change, whichever overlay of the track shows it
+  if (track.textureid && frame.id == track.frame)
   {
-    if(changes == 0)
+    std::map<unsigned int, COverlay*>::iterator it = m_textureCache.find(track.textureid);
+    if (it != m_textureCache.end())
     {
-      std::map<unsigned int, COverlay*>::iterator it = m_textureCache.find(o->m_textureid);
-      if (it != m_textureCache.end())
-        return it->second;
+      o->m_textureid = track.textureid;
+      return it->second;
     }
   }
 
+  SQuads empty;
+  const SQuads& quads = frame.quads ? *frame.quads : empty;
+
   COverlay *overlay = NULL;
 #if defined(HAS_GL) || defined(HAS_GLES)
-  overlay = new COverlayGlyphGL(images, targetWidth, targetHeight);
+  overlay = new COverlayGlyphGL(quads, targetWidth, targetHeight);
 #elif defined(HAS_DX)
-  overlay = new COverlayQuadsDX(images, targetWidth, targetHeight);
+  overlay = new COverlayQuadsDX(quads, targetWidth, targetHeight);
 #endif
   // scale to video dimensions
   if (overlay)
@@ -384,6 +432,8 @@ COverlay* CRenderer::Convert(CDVDOverlaySSA* o, double pts)
   }
   m_textureCache[m_textureid] = overlay;
   o->m_textureid = m_textureid;
+  track.frame = frame.id;
+  track.textureid = m_textureid;
   m_textureid++;
   return overlay;
 }
@@ -26,14 +26,18 @@
 
 #include <vector>
 #include <map>
+#include <memory>
 
 class CDVDOverlay;
 class CDVDOverlayImage;
 class CDVDOverlaySpu;
 class CDVDOverlaySSA;
+class CDVDSubtitlesLibass;
 
 namespace OVERLAY {
 
+  class CAssCompositor;
+
   struct SRenderState
   {
     float x;
@@ -112,6 +116,15 @@ namespace OVERLAY {
     CCriticalSection m_section;
     std::vector<SElement> m_buffers[NUM_BUFFERS];
     std::map<unsigned int, COverlay*> m_textureCache;
+
+    struct SAssTrack
+    {
+      SAssTrack() : frame(0), textureid(0) {}
+      std::shared_ptr<CAssCompositor> compositor;
+      unsigned int frame;     //!< compositor frame the texture was created from
+      unsigned int textureid;
+    };
+    std::map<CDVDSubtitlesLibass*, SAssTrack> m_assTracks;
     static unsigned int m_textureid;
     CRect m_rv, m_rs, m_rd;
     std::string m_font, m_fontBorder;
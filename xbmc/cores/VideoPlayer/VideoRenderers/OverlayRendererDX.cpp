@@ -69,7 +69,7 @@ static bool LoadTexture(int width, int height, int stride
   return true;
 }
 
-COverlayQuadsDX::COverlayQuadsDX(ASS_Image* images, int width, int height)
+COverlayQuadsDX::COverlayQuadsDX(const SQuads& quads, int width, int height)
 {
   m_width  = 1.0;
   m_height = 1.0;
@@ -79,8 +79,7 @@ COverlayQuadsDX::COverlayQuadsDX(ASS_Image* images, int width, int height)
   m_y      = 0.0f;
   m_count  = 0;
 
-  SQuads quads;
-  if(!convert_quad(images, quads))
+  if(quads.count == 0)
     return;
   
   float u, v;
@@ -23,10 +23,11 @@
 #include "cores/VideoPlayer/DVDCodecs/Overlay/DVDOverlayImage.h"
 #include "cores/VideoPlayer/DVDCodecs/Overlay/DVDOverlaySpu.h"
 #include "cores/VideoPlayer/DVDCodecs/Overlay/DVDOverlaySSA.h"
-#include "windowing/WindowingFactory.h"
 #include "guilib/GraphicContext.h"
 #include "settings/Settings.h"
 
+#include <map>
+
 namespace OVERLAY {
 
 static uint32_t build_rgba(int a, int r, int g, int b, bool mergealpha)
@@ -182,9 +183,41 @@ uint32_t* convert_rgba(CDVDOverlaySpu* o, bool mergealpha
   return rgba;
 }
 
-bool convert_quad(ASS_Image* images, SQuads& quads)
+struct SPacked
+{
+  int w, h, stride;
+  int u, v;
+};
+
+typedef std::map<const unsigned char*, SPacked> PackedMap;
+
+// libass hands out the same bitmap for every repetition of a glyph, outline or
+// shadow within a frame, those are packed into the texture only once
+static const SPacked* find_packed(const PackedMap& packed, const ASS_Image* img)
+{
+  PackedMap::const_iterator it = packed.find(img->bitmap);
+  if (it == packed.end()
+  ||  it->second.w != img->w
+  ||  it->second.h != img->h
+  ||  it->second.stride != img->stride)
+    return NULL;
+  return &it->second;
+}
+
+static void add_packed(PackedMap& packed, const ASS_Image* img, int u, int v)
+{
+  SPacked& p = packed[img->bitmap];
+  p.w      = img->w;
+  p.h      = img->h;
+  p.stride = img->stride;
+  p.u      = u;
+  p.v      = v;
+}
+
+bool convert_quad(ASS_Image* images, SQuads& quads, int max_x)
 {
   ASS_Image* img;
+  PackedMap  packed;
 
   if (!images)
     return false;
@@ -197,26 +230,35 @@ bool convert_quad(ASS_Image* images, SQuads& quads)
     if((img->color & 0xff) == 0xff || img->w == 0 || img->h == 0)
       continue;
 
-    quads.size_x += img->w + 1;
     quads.count++;
+    if (find_packed(packed, img))
+      continue;
+
+    add_packed(packed, img, 0, 0);
+    quads.size_x += img->w + 1;
   }
 
   if (quads.count == 0)
     return false;
 
-  if (quads.size_x > (int)g_Windowing.GetMaxTextureSize())
-    quads.size_x = g_Windowing.GetMaxTextureSize();
+  if (quads.size_x > max_x)
+    quads.size_x = max_x;
 
   int curr_x = 0;
   int curr_y = 0;
 
   // calculate the y size of the texture
 
+  packed.clear();
   for(img = images; img; img = img->next)
   {
     if((img->color & 0xff) == 0xff || img->w == 0 || img->h == 0)
       continue;
 
+    if (find_packed(packed, img))
+      continue;
+    add_packed(packed, img, 0, 0);
+
     // check if we need to split to new line
     if (curr_x + img->w >= quads.size_x)
     {
@@ -246,6 +288,7 @@ bool convert_quad(ASS_Image* images, SQuads& quads)
   curr_x = 0;
   curr_y = 0;
 
+  packed.clear();
   for(img = images; img; img = img->next)
   {
     if((img->color & 0xff) == 0xff || img->w == 0 || img->h == 0)
@@ -254,14 +297,6 @@ bool convert_quad(ASS_Image* images, SQuads& quads)
     unsigned int color = img->color;
     unsigned int alpha = (color & 0xff);
 
-    if (curr_x + img->w >= quads.size_x)
-    {
-      curr_y += y + 1;
-      curr_x  = 0;
-      y       = 0;
-      data    = quads.data + curr_y * quads.size_x;
-    }
-
     unsigned int r = ((color >> 24) & 0xff);
     unsigned int g = ((color >> 16) & 0xff);
     unsigned int b = ((color >> 8 ) & 0xff);
@@ -271,15 +306,34 @@ bool convert_quad(ASS_Image* images, SQuads& quads)
     v->g = g;
     v->b = b;
 
-    v->u = curr_x;
-    v->v = curr_y;
-
     v->x = img->dst_x;
     v->y = img->dst_y;
 
     v->w = img->w;
     v->h = img->h;
 
+    const SPacked* p = find_packed(packed, img);
+    if (p)
+    {
+      v->u = p->u;
+      v->v = p->v;
+      v++;
+      continue;
+    }
+
+    if (curr_x + img->w >= quads.size_x)
+    {
+      curr_y += y + 1;
+      curr_x  = 0;
+      y       = 0;
+      data    = quads.data + curr_y * quads.size_x;
+    }
+
+    v->u = curr_x;
+    v->v = curr_y;
+
+    add_packed(packed, img, v->u, v->v);
+
     v++;
 
     for(int i=0; i<img->h; i++)
@@ -63,7 +63,11 @@ namespace OVERLAY {
   uint32_t* convert_rgba(CDVDOverlaySpu*   o, bool mergealpha
                        , int& min_x, int& max_x
                        , int& min_y, int& max_y);
-  bool      convert_quad(ASS_Image* images, SQuads& quads);
+  /*!
+   \brief Pack the visible fragments of a libass frame into a single alpha texture.
+   \param max_x maximum texture width, usually the maximum texture size
+   */
+  bool      convert_quad(ASS_Image* images, SQuads& quads, int max_x);
   int       GetStereoscopicDepth();
 
 }
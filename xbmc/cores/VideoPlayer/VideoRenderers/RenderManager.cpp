@@ -22,6 +22,7 @@
 #include "RenderManager.h"
 #include "RenderFlags.h"
 #include "guilib/GraphicContext.h"
+#include "guilib/Texture.h"
 #include "utils/MathUtils.h"
 #include "threads/SingleLock.h"
 #include "utils/log.h"
@@ -125,7 +126,9 @@ void CRenderManager::CClockSync::Reset()
 
 unsigned int CRenderManager::m_nextCaptureId = 0;
 
-CRenderManager::CRenderManager(CDVDClock &clock, IRenderMsg *player) : m_dvdClock(clock)
+CRenderManager::CRenderManager(CDVDClock &clock, IRenderMsg *player) :
+  m_presentError(-50.0, 50.0, 100),
+  m_dvdClock(clock)
 {
   m_pRenderer = nullptr;
   m_renderState = STATE_UNCONFIGURED;
@@ -139,6 +142,9 @@ CRenderManager::CRenderManager(CDVDClock &clock, IRenderMsg *player) : m_dvdCloc
   m_QueueSize   = 2;
   m_QueueSkip   = 0;
   m_format      = RENDER_FMT_NONE;
+  m_presentedFrames = 0;
+  m_droppedFrames = 0;
+  m_lateFrames = 0;
   m_renderedOverlay = false;
   m_captureWaitCounter = 0;
   m_playerPort = player;
@@ -436,6 +442,12 @@ void CRenderManager::PreInit()
   m_QueueSkip   = 0;
   m_presentstep = PRESENT_IDLE;
   m_format = RENDER_FMT_NONE;
+
+  CSingleLock lock2(m_presentlock);
+  m_presentError.Reset();
+  m_presentedFrames = 0;
+  m_droppedFrames = 0;
+  m_lateFrames = 0;
 }
 
 void CRenderManager::UnInit()
@@ -947,6 +959,11 @@ void CRenderManager::Render(bool clear, DWORD flags, DWORD alpha, bool gui)
     }
   }
 
+#if defined(HAS_GL) || defined(HAS_GLES)
+  // the video and overlay renderers bind their own textures
+  CGLTexture::ResetBindings();
+#endif
+
 
   SPresent& m = m_Queue[m_presentsource];
 
@@ -1349,13 +1366,20 @@ void CRenderManager::PrepareNextRender()
     {
       requeue(m_discard, m_queued);
       m_QueueSkip++;
+      m_droppedFrames++;
     }
 
     int lateframes = (renderPts - m_Queue[idx].pts) / frametime;
     if (lateframes)
+    {
       m_lateframes += lateframes;
+      m_lateFrames++;
+    }
     else
       m_lateframes = 0;
+
+    m_presentError.Add((renderPts - m_Queue[idx].pts) * 1000.0 / DVD_TIME_BASE);
+    m_presentedFrames++;
     
     m_presentstep = PRESENT_FLIP;
     m_discard.push_back(m_presentsource);
@@ -1388,6 +1412,15 @@ bool CRenderManager::GetStats(int &lateframes, double &pts, int &queued, int &di
   return true;
 }
 
+void CRenderManager::GetSyncStats(CHistogram &presentError, uint64_t &presented, uint64_t &dropped, uint64_t &late)
+{
+  CSingleLock lock(m_presentlock);
+  presentError = m_presentError;
+  presented = m_presentedFrames;
+  dropped = m_droppedFrames;
+  late = m_lateFrames;
+}
+
 void CRenderManager::CheckEnableClockSync()
 {
   if (fabs(m_fps - g_graphicsContext.GetFPS()) < 0.01)
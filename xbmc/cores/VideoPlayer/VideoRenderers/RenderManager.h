@@ -35,6 +35,7 @@
 #include <atomic>
 #include "PlatformDefs.h"
 #include "threads/Event.h"
+#include "utils/Histogram.h"
 #include "DVDClock.h"
 
 class CRenderCapture;
@@ -149,6 +150,12 @@ public:
    */
   bool GetStats(int &lateframes, double &pts, int &queued, int &discard);
 
+  /**
+   * Presentation telemetry since PreInit: error of every presented frame
+   * against the clock in ms (positive is late) and frame counters.
+   */
+  void GetSyncStats(CHistogram &presentError, uint64_t &presented, uint64_t &dropped, uint64_t &late);
+
   /**
    * Video player call this on flush in oder to discard any queued frames
    */
@@ -242,6 +249,10 @@ protected:
 
   int m_lateframes;
   double m_presentpts;
+  CHistogram m_presentError;
+  uint64_t m_presentedFrames;
+  uint64_t m_droppedFrames;
+  uint64_t m_lateFrames;
   EPRESENTSTEP m_presentstep;
   int m_presentsource;
   XbmcThreads::ConditionVariable  m_presentevent;
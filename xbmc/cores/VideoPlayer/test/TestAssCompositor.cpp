@@ -0,0 +1,236 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "DVDClock.h"
+#include "DVDSubtitles/DVDSubtitlesLibass.h"
+#include "VideoRenderers/AssCompositor.h"
+#include "VideoRenderers/OverlayRendererUtil.h"
+#include "filesystem/File.h"
+#include "test/TestUtils.h"
+#include "threads/Thread.h"
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <cstring>
+#include <set>
+#include <string>
+
+using namespace OVERLAY;
+
+namespace
+{
+// 24p frame interval
+const double interval = DVD_TIME_BASE / 23.976;
+
+CDVDSubtitlesLibass* LoadTrack()
+{
+  XFILE::CFile file;
+  XUTILS::auto_buffer buffer;
+  if (file.LoadFile(XBMC_REF_FILE_PATH("xbmc/cores/VideoPlayer/test/typeset.ass"), buffer) <= 0)
+    return NULL;
+
+  CDVDSubtitlesLibass* libass = new CDVDSubtitlesLibass();
+  if (!libass->CreateTrack(buffer.get(), buffer.size()))
+  {
+    libass->Release();
+    return NULL;
+  }
+  return libass;
+}
+
+CAssCompositor::SParams Params()
+{
+  CAssCompositor::SParams params;
+  params.frameWidth = 1920;
+  params.frameHeight = 1080;
+  params.videoWidth = 1920;
+  params.videoHeight = 800;
+  params.useMargin = 0;
+  params.position = 0.0;
+  params.maxTextureSize = 4096;
+  return params;
+}
+
+bool SameQuads(const CAssCompositor::SFrame& a, const CAssCompositor::SFrame& b)
+{
+  if (!a.quads || !b.quads)
+    return !a.quads && !b.quads;
+  return a.quads->count == b.quads->count
+      && a.quads->size_x == b.quads->size_x
+      && a.quads->size_y == b.quads->size_y
+      && memcmp(a.quads->data, b.quads->data, a.quads->size_x * a.quads->size_y) == 0;
+}
+}
+
+TEST(TestAssCompositor, KeepsFrameWhileUnchanged)
+{
+  CDVDSubtitlesLibass* libass = LoadTrack();
+  ASSERT_TRUE(libass != NULL);
+  std::shared_ptr<CAssCompositor> compositor = std::make_shared<CAssCompositor>(libass, 0);
+
+  // nothing animates between 8.15s and 9s
+  CAssCompositor::SFrame a = compositor->Render(DVD_MSEC_TO_TIME(8400), Params());
+  CAssCompositor::SFrame b = compositor->Render(DVD_MSEC_TO_TIME(8600), Params());
+  ASSERT_TRUE(a.quads != NULL);
+  EXPECT_EQ(a.id, b.id);
+
+  // a sign moves across the screen
+  a = compositor->Render(DVD_MSEC_TO_TIME(2500), Params());
+  b = compositor->Render(DVD_MSEC_TO_TIME(2600), Params());
+  EXPECT_NE(a.id, b.id);
+
+  // different output size
+  CAssCompositor::SParams params = Params();
+  params.frameWidth = 1280;
+  params.frameHeight = 720;
+  params.videoWidth = 1280;
+  params.videoHeight = 534;
+  EXPECT_NE(b.id, compositor->Render(DVD_MSEC_TO_TIME(2600), params).id);
+
+  // past the last event
+  EXPECT_TRUE(compositor->Render(DVD_MSEC_TO_TIME(10500), Params()).quads == NULL);
+
+  compositor->Cancel();
+  libass->Release();
+}
+
+TEST(TestAssCompositor, PacksRepeatedBitmapsOnce)
+{
+  CDVDSubtitlesLibass* libass = LoadTrack();
+  ASSERT_TRUE(libass != NULL);
+
+  CAssCompositor::SParams params = Params();
+  ASS_Image* images = libass->RenderImage(params.frameWidth, params.frameHeight,
+                                          params.videoWidth, params.videoHeight,
+                                          DVD_MSEC_TO_TIME(3000));
+  SQuads quads;
+  ASSERT_TRUE(convert_quad(images, quads, params.maxTextureSize));
+
+  int count = 0;
+  std::set<const unsigned char*> bitmaps;
+  for (ASS_Image* img = images; img; img = img->next)
+  {
+    if ((img->color & 0xff) == 0xff || img->w == 0 || img->h == 0)
+      continue;
+    count++;
+    bitmaps.insert(img->bitmap);
+  }
+  EXPECT_EQ(count, quads.count);
+
+  // every bitmap is packed once, quads drawing the same one share its texture coordinates
+  std::set<std::pair<int, int> > texels;
+  for (int i = 0; i < quads.count; i++)
+  {
+    EXPECT_LE(quads.quad[i].u + quads.quad[i].w, quads.size_x);
+    EXPECT_LE(quads.quad[i].v + quads.quad[i].h, quads.size_y);
+    texels.insert(std::make_pair(quads.quad[i].u, quads.quad[i].v));
+  }
+  EXPECT_EQ(bitmaps.size(), texels.size());
+
+  libass->Release();
+}
+
+TEST(TestAssCompositor, RendersAhead)
+{
+  CDVDSubtitlesLibass* libass = LoadTrack();
+  CDVDSubtitlesLibass* reference = LoadTrack();
+  ASSERT_TRUE(libass != NULL);
+  ASSERT_TRUE(reference != NULL);
+  std::shared_ptr<CAssCompositor> compositor = std::make_shared<CAssCompositor>(libass);
+  std::shared_ptr<CAssCompositor> synchronous = std::make_shared<CAssCompositor>(reference, 0);
+
+  double pts = DVD_MSEC_TO_TIME(2000);
+  for (int i = 0; i < 24; i++, pts += interval)
+  {
+    CAssCompositor::SFrame frame = compositor->Render(pts, Params());
+    EXPECT_TRUE(SameQuads(synchronous->Render(pts, Params()), frame)) << "frame " << i;
+    // leave the worker some time, as the rest of a frame would
+    XbmcThreads::ThreadSleep(20);
+  }
+  EXPECT_GT(compositor->GetHits(), 0U);
+
+  compositor->Cancel();
+  libass->Release();
+  reference->Release();
+}
+
+TEST(TestAssCompositor, DropsFramesMissingNewEvents)
+{
+  CDVDSubtitlesLibass* libass = LoadTrack();
+  ASSERT_TRUE(libass != NULL);
+  std::shared_ptr<CAssCompositor> compositor = std::make_shared<CAssCompositor>(libass);
+
+  // past the last event, the frames rendered ahead are empty
+  double pts = DVD_MSEC_TO_TIME(11000);
+  for (int i = 0; i < 4; i++, pts += interval)
+  {
+    EXPECT_TRUE(compositor->Render(pts, Params()).quads == NULL);
+    XbmcThreads::ThreadSleep(20);
+  }
+
+  // an embedded event arrives, as from a matroska block
+  char chunk[] = "1000,0,Default,,0,0,0,,New event";
+  ASSERT_TRUE(libass->DecodeDemuxPkt(chunk, strlen(chunk), pts, DVD_MSEC_TO_TIME(2000)));
+  EXPECT_TRUE(compositor->Render(pts, Params()).quads != NULL);
+
+  compositor->Cancel();
+  libass->Release();
+}
+
+TEST(TestAssCompositor, DISABLED_RenderThreadTime)
+{
+  CDVDSubtitlesLibass* libass = LoadTrack();
+  CDVDSubtitlesLibass* reference = LoadTrack();
+  ASSERT_TRUE(libass != NULL);
+  ASSERT_TRUE(reference != NULL);
+  std::shared_ptr<CAssCompositor> compositor = std::make_shared<CAssCompositor>(libass);
+  std::shared_ptr<CAssCompositor> synchronous = std::make_shared<CAssCompositor>(reference, 0);
+
+  // time spent in Render(), which is what the render thread waits for
+  const int frames = 96;
+  std::chrono::steady_clock::duration aheadTime(0), synchronousTime(0);
+  std::set<unsigned int> textures;
+  double pts = DVD_MSEC_TO_TIME(1000);
+  for (int i = 0; i < frames; i++, pts += interval)
+  {
+    auto start = std::chrono::steady_clock::now();
+    CAssCompositor::SFrame expected = synchronous->Render(pts, Params());
+    auto mid = std::chrono::steady_clock::now();
+    CAssCompositor::SFrame frame = compositor->Render(pts, Params());
+    auto end = std::chrono::steady_clock::now();
+    synchronousTime += mid - start;
+    aheadTime += end - mid;
+
+    EXPECT_TRUE(SameQuads(expected, frame)) << "frame " << i;
+    textures.insert(frame.id);
+    XbmcThreads::ThreadSleep(10);
+  }
+
+  RecordProperty("synchronous_us_per_frame", static_cast<int>(std::chrono::duration_cast<std::chrono::microseconds>(synchronousTime).count() / frames));
+  RecordProperty("ahead_us_per_frame", static_cast<int>(std::chrono::duration_cast<std::chrono::microseconds>(aheadTime).count() / frames));
+  RecordProperty("hits", static_cast<int>(compositor->GetHits()));
+  RecordProperty("textures", static_cast<int>(textures.size()));
+
+  compositor->Cancel();
+  libass->Release();
+  reference->Release();
+}
@@ -0,0 +1,302 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DVDMessageQueue.h"
+#include "DVDDemuxers/DVDDemuxUtils.h"
+#include "DVDClock.h"
+#include "threads/Thread.h"
+
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <chrono>
+
+using namespace ::testing;
+
+static CDVDMsgDemuxerPacket* MakePacket(int size, double dts)
+{
+  DemuxPacket* packet = CDVDDemuxUtils::AllocateDemuxPacket(size);
+  packet->iSize = size;
+  packet->dts = dts;
+  packet->pts = dts;
+  return new CDVDMsgDemuxerPacket(packet);
+}
+
+class TestDVDMessageQueue : public TestWithParam<size_t>
+{
+protected:
+  TestDVDMessageQueue() : m_queue("test")
+  {
+    m_queue.SetPacketRing(GetParam());
+    m_queue.SetMaxDataSize(1024 * 1024);
+    m_queue.SetMaxTimeSize(8.0);
+    m_queue.Init();
+  }
+
+  CDVDMessageQueue m_queue;
+};
+
+TEST_P(TestDVDMessageQueue, Fifo)
+{
+  for (int i = 0; i < 32; i++)
+    EXPECT_EQ(MSGQ_OK, m_queue.Put(MakePacket(100, i * DVD_TIME_BASE)));
+
+  EXPECT_EQ(32u, m_queue.GetPacketCount(CDVDMsg::DEMUXER_PACKET));
+  EXPECT_EQ(3200, m_queue.GetDataSize());
+
+  for (int i = 0; i < 32; i++)
+  {
+    CDVDMsg* msg;
+    ASSERT_EQ(MSGQ_OK, m_queue.Get(&msg, 0));
+    ASSERT_TRUE(msg->IsType(CDVDMsg::DEMUXER_PACKET));
+    EXPECT_EQ(i * DVD_TIME_BASE, static_cast<CDVDMsgDemuxerPacket*>(msg)->GetPacket()->dts);
+    msg->Release();
+  }
+
+  CDVDMsg* msg;
+  EXPECT_EQ(MSGQ_TIMEOUT, m_queue.Get(&msg, 0));
+  EXPECT_EQ(0, m_queue.GetDataSize());
+}
+
+TEST_P(TestDVDMessageQueue, Priority)
+{
+  m_queue.Put(MakePacket(100, 0));
+  m_queue.Put(new CDVDMsg(CDVDMsg::GENERAL_RESYNC), 1);
+
+  CDVDMsg* msg;
+  int priority = 0;
+  ASSERT_EQ(MSGQ_OK, m_queue.Get(&msg, 0, priority));
+  EXPECT_TRUE(msg->IsType(CDVDMsg::GENERAL_RESYNC));
+  EXPECT_EQ(1, priority);
+  msg->Release();
+
+  // packets are not returned when asking for prio messages only
+  priority = 1;
+  EXPECT_EQ(MSGQ_TIMEOUT, m_queue.Get(&msg, 0, priority));
+
+  priority = 0;
+  ASSERT_EQ(MSGQ_OK, m_queue.Get(&msg, 0, priority));
+  EXPECT_TRUE(msg->IsType(CDVDMsg::DEMUXER_PACKET));
+  msg->Release();
+}
+
+TEST_P(TestDVDMessageQueue, Flush)
+{
+  m_queue.Put(MakePacket(100, 0));
+  m_queue.Put(new CDVDMsg(CDVDMsg::GENERAL_RESYNC));
+  m_queue.Put(MakePacket(100, DVD_TIME_BASE));
+
+  m_queue.Flush();
+  EXPECT_EQ(0u, m_queue.GetPacketCount(CDVDMsg::DEMUXER_PACKET));
+  EXPECT_EQ(0, m_queue.GetDataSize());
+  EXPECT_EQ(0, m_queue.GetLevel());
+
+  // non packet messages survive a packet flush
+  CDVDMsg* msg;
+  ASSERT_EQ(MSGQ_OK, m_queue.Get(&msg, 0));
+  EXPECT_TRUE(msg->IsType(CDVDMsg::GENERAL_RESYNC));
+  msg->Release();
+  EXPECT_EQ(MSGQ_TIMEOUT, m_queue.Get(&msg, 0));
+
+  m_queue.Put(MakePacket(100, 0));
+  m_queue.Flush(CDVDMsg::NONE);
+  EXPECT_EQ(MSGQ_TIMEOUT, m_queue.Get(&msg, 0));
+}
+
+TEST_P(TestDVDMessageQueue, FlushOtherType)
+{
+  m_queue.Put(MakePacket(100, 0));
+  m_queue.Put(new CDVDMsg(CDVDMsg::GENERAL_RESYNC));
+  m_queue.Put(new CDVDMsg(CDVDMsg::GENERAL_RESET));
+  m_queue.Put(MakePacket(100, DVD_TIME_BASE));
+
+  // only the resync goes, packets and their accounting are kept
+  m_queue.Flush(CDVDMsg::GENERAL_RESYNC);
+  EXPECT_EQ(2u, m_queue.GetPacketCount(CDVDMsg::DEMUXER_PACKET));
+  EXPECT_EQ(200, m_queue.GetDataSize());
+
+  CDVDMsg* msg;
+  ASSERT_EQ(MSGQ_OK, m_queue.Get(&msg, 0));
+  EXPECT_TRUE(msg->IsType(CDVDMsg::DEMUXER_PACKET));
+  msg->Release();
+  ASSERT_EQ(MSGQ_OK, m_queue.Get(&msg, 0));
+  EXPECT_TRUE(msg->IsType(CDVDMsg::GENERAL_RESET));
+  msg->Release();
+  ASSERT_EQ(MSGQ_OK, m_queue.Get(&msg, 0));
+  EXPECT_TRUE(msg->IsType(CDVDMsg::DEMUXER_PACKET));
+  msg->Release();
+  EXPECT_EQ(MSGQ_TIMEOUT, m_queue.Get(&msg, 0));
+  EXPECT_EQ(0, m_queue.GetDataSize());
+}
+
+TEST_P(TestDVDMessageQueue, Level)
+{
+  for (int i = 0; i <= 4; i++)
+    m_queue.Put(MakePacket(100, i * DVD_TIME_BASE));
+
+  EXPECT_EQ(4, m_queue.GetTimeSize());
+  EXPECT_EQ(50, m_queue.GetLevel());
+
+  CDVDMsg* msg;
+  ASSERT_EQ(MSGQ_OK, m_queue.Get(&msg, 0));
+  msg->Release();
+  ASSERT_EQ(MSGQ_OK, m_queue.Get(&msg, 0));
+  msg->Release();
+
+  EXPECT_EQ(3, m_queue.GetTimeSize());
+}
+
+TEST_P(TestDVDMessageQueue, Overflow)
+{
+  // more messages than the ring holds, order has to be kept
+  const int count = 100;
+  for (int i = 0; i < count; i++)
+    m_queue.Put(MakePacket(10, i * DVD_TIME_BASE));
+
+  for (int i = 0; i < count; i++)
+  {
+    CDVDMsg* msg;
+    ASSERT_EQ(MSGQ_OK, m_queue.Get(&msg, 0));
+    EXPECT_EQ(i * DVD_TIME_BASE, static_cast<CDVDMsgDemuxerPacket*>(msg)->GetPacket()->dts);
+    msg->Release();
+  }
+}
+
+INSTANTIATE_TEST_CASE_P(ListAndRing, TestDVDMessageQueue, Values(0, 16, 4096));
+
+namespace
+{
+class CPacketProducer : public IRunnable
+{
+public:
+  CPacketProducer(CDVDMessageQueue& queue, int count) : m_queue(queue), m_count(count) {}
+
+  virtual void Run()
+  {
+    for (int i = 0; i < m_count; i++)
+    {
+      // throttle on the level like VideoPlayer does
+      while (m_queue.GetPacketCount(CDVDMsg::DEMUXER_PACKET) > 1024)
+        XbmcThreads::ThreadSleep(0);
+      m_queue.Put(MakePacket(188, i * 1000.0));
+    }
+  }
+
+private:
+  CDVDMessageQueue& m_queue;
+  int m_count;
+};
+
+class CPacketConsumer : public IRunnable
+{
+public:
+  CPacketConsumer(CDVDMessageQueue& queue) : m_queue(queue), m_stop(false), m_negative(false) {}
+
+  virtual void Run()
+  {
+    while (!m_stop)
+    {
+      CDVDMsg* msg;
+      if (m_queue.Get(&msg, 10) == MSGQ_OK)
+        msg->Release();
+      if (m_queue.GetDataSize() < 0)
+        m_negative = true;
+    }
+  }
+
+  CDVDMessageQueue& m_queue;
+  std::atomic<bool> m_stop;
+  std::atomic<bool> m_negative;
+};
+
+double RunProducerConsumer(size_t ringCapacity, int count)
+{
+  CDVDMessageQueue queue("benchmark");
+  queue.SetPacketRing(ringCapacity);
+  queue.SetMaxDataSize(40 * 1024 * 1024);
+  queue.Init();
+
+  CPacketProducer producer(queue, count);
+  CThread thread(&producer, "PacketProducer");
+
+  auto start = std::chrono::steady_clock::now();
+  thread.Create();
+
+  int received = 0;
+  while (received < count)
+  {
+    CDVDMsg* msg;
+    if (queue.Get(&msg, 1000) != MSGQ_OK)
+      break;
+    msg->Release();
+    received++;
+  }
+  auto end = std::chrono::steady_clock::now();
+
+  thread.WaitForThreadExit(1000);
+  queue.End();
+
+  EXPECT_EQ(count, received);
+  return std::chrono::duration<double, std::nano>(end - start).count() / count;
+}
+}
+
+TEST(TestDVDMessageQueueRing, FlushWhileConsuming)
+{
+  // flushes come from a third thread, the consumer must not account for
+  // packets the flush already took off the books
+  CDVDMessageQueue queue("flush");
+  queue.SetPacketRing(256);
+  queue.SetMaxDataSize(40 * 1024 * 1024);
+  queue.Init();
+
+  CPacketProducer producer(queue, 100000);
+  CPacketConsumer consumer(queue);
+  CThread producerThread(&producer, "PacketProducer");
+  CThread consumerThread(&consumer, "PacketConsumer");
+  producerThread.Create();
+  consumerThread.Create();
+
+  for (int i = 0; i < 2000; i++)
+  {
+    queue.Flush();
+    EXPECT_LE(0, queue.GetDataSize());
+  }
+
+  producerThread.WaitForThreadExit(10000);
+  consumer.m_stop = true;
+  consumerThread.WaitForThreadExit(1000);
+
+  CDVDMsg* msg;
+  while (queue.Get(&msg, 0) == MSGQ_OK)
+    msg->Release();
+
+  EXPECT_FALSE(consumer.m_negative);
+  EXPECT_EQ(0, queue.GetDataSize());
+  EXPECT_EQ(0u, queue.GetPacketCount(CDVDMsg::DEMUXER_PACKET));
+  queue.End();
+}
+
+TEST_P(TestDVDMessageQueue, DISABLED_Throughput)
+{
+  // the producer runs on its own queue with a lot more room than m_queue
+  double ns = RunProducerConsumer(GetParam(), 200000);
+  RecordProperty("ns_per_packet", static_cast<int>(ns));
+}
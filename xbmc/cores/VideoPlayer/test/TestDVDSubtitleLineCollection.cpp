@@ -0,0 +1,124 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "DVDClock.h"
+#include "DVDCodecs/Overlay/DVDOverlayText.h"
+#include "DVDSubtitles/DVDSubtitleLineCollection.h"
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+namespace
+{
+double Sec(double sec)
+{
+  return sec * DVD_TIME_BASE;
+}
+}
+
+TEST(TestDVDSubtitleLineCollection, SortsAndSkipsEnded)
+{
+  CDVDSubtitleLineCollection collection;
+  CDVDOverlayText* overlays[3];
+  for (int i = 0; i < 3; i++)
+    overlays[i] = new CDVDOverlayText();
+
+  overlays[0]->iPTSStartTime = Sec(10);
+  overlays[0]->iPTSStopTime = Sec(12);
+  overlays[1]->iPTSStartTime = Sec(1);
+  overlays[1]->iPTSStopTime = Sec(3);
+  overlays[2]->iPTSStartTime = Sec(5);
+  overlays[2]->iPTSStopTime = Sec(7);
+  for (int i = 0; i < 3; i++)
+    collection.Add(overlays[i]);
+  collection.Sort();
+  EXPECT_EQ(3, collection.GetSize());
+
+  EXPECT_EQ(overlays[1], collection.Get(Sec(0)));
+  EXPECT_EQ(overlays[2], collection.Get(Sec(0)));
+  EXPECT_EQ(overlays[0], collection.Get(Sec(0)));
+  EXPECT_TRUE(collection.Get(Sec(0)) == NULL);
+
+  // seek
+  collection.Reset();
+  EXPECT_EQ(overlays[2], collection.Get(Sec(6)));
+  collection.Reset();
+  EXPECT_EQ(overlays[0], collection.Get(Sec(7.5)));
+  EXPECT_TRUE(collection.Get(Sec(20)) == NULL);
+}
+
+TEST(TestDVDSubtitleLineCollection, LongSubtitleSurvivesSeek)
+{
+  CDVDSubtitleLineCollection collection;
+  // shown for the whole minute, overlapping all others
+  collection.Add(Sec(0), Sec(60), 0);
+  for (int i = 1; i <= 50; i++)
+    collection.Add(Sec(i), Sec(i + 0.5), i);
+
+  std::vector<int64_t> parsed;
+  collection.SetParser([&parsed](int64_t position) -> CDVDOverlay*
+  {
+    parsed.push_back(position);
+    return new CDVDOverlayText();
+  });
+
+  collection.Reset();
+  CDVDOverlay* overlay = collection.Get(Sec(30.2));
+  ASSERT_TRUE(overlay != NULL);
+  EXPECT_EQ(Sec(0), overlay->iPTSStartTime);
+  EXPECT_EQ(Sec(60), overlay->iPTSStopTime);
+
+  // past the ended ones overlapped by the first
+  overlay = collection.Get(Sec(30.2));
+  ASSERT_TRUE(overlay != NULL);
+  EXPECT_EQ(Sec(30), overlay->iPTSStartTime);
+
+  overlay = collection.Get(Sec(31.7));
+  ASSERT_TRUE(overlay != NULL);
+  EXPECT_EQ(Sec(32), overlay->iPTSStartTime);
+
+  // only the subtitles that were returned have been parsed
+  ASSERT_EQ(3U, parsed.size());
+  EXPECT_EQ(0, parsed[0]);
+  EXPECT_EQ(30, parsed[1]);
+  EXPECT_EQ(32, parsed[2]);
+
+  // parsed overlays are kept
+  collection.Reset();
+  collection.Get(Sec(30.2));
+  EXPECT_EQ(3U, parsed.size());
+}
+
+TEST(TestDVDSubtitleLineCollection, SkipsUnparsable)
+{
+  CDVDSubtitleLineCollection collection;
+  collection.Add(Sec(1), Sec(2), 1);
+  collection.Add(Sec(3), Sec(4), 3);
+  collection.SetParser([](int64_t position) -> CDVDOverlay*
+  {
+    return position == 1 ? NULL : new CDVDOverlayText();
+  });
+
+  CDVDOverlay* overlay = collection.Get(Sec(0));
+  ASSERT_TRUE(overlay != NULL);
+  EXPECT_EQ(Sec(3), overlay->iPTSStartTime);
+}
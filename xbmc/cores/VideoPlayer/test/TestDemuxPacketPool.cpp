@@ -0,0 +1,88 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "DVDDemuxers/DemuxPacketPool.h"
+#include "DVDClock.h"
+
+#include "gtest/gtest.h"
+
+TEST(TestDemuxPacketPool, Recycle)
+{
+  CDemuxPacketPool &pool = CDemuxPacketPool::GetInstance();
+  pool.Trim();
+
+  DemuxPacketStats before = pool.GetStats();
+
+  DemuxPacket* packet = pool.Allocate(1500);
+  ASSERT_TRUE(packet);
+  EXPECT_TRUE(packet->pData);
+  EXPECT_EQ(DVD_NOPTS_VALUE, packet->dts);
+  EXPECT_EQ(DVD_NOPTS_VALUE, packet->pts);
+  EXPECT_EQ(-1, packet->iStreamId);
+  unsigned char* data = packet->pData;
+  pool.Free(packet);
+
+  // same size class, has to come from the pool
+  packet = pool.Allocate(2000);
+  ASSERT_TRUE(packet);
+  EXPECT_EQ(data, packet->pData);
+  EXPECT_EQ(0, packet->iSize);
+  pool.Free(packet);
+
+  DemuxPacketStats after = pool.GetStats();
+  EXPECT_EQ(2u, after.allocations - before.allocations);
+  EXPECT_EQ(1u, after.poolMisses - before.poolMisses);
+  EXPECT_EQ(2048u, after.cachedBytes);
+
+  pool.Trim();
+  EXPECT_EQ(0u, pool.GetStats().cachedBytes);
+}
+
+TEST(TestDemuxPacketPool, Padding)
+{
+  CDemuxPacketPool &pool = CDemuxPacketPool::GetInstance();
+
+  DemuxPacket* packet = pool.Allocate(1024);
+  memset(packet->pData, 0xff, 1024);
+  pool.Free(packet);
+
+  // recycled packets must have their padding cleared again
+  packet = pool.Allocate(100);
+  for (int i = 100; i < 132; i++)
+    EXPECT_EQ(0, packet->pData[i]);
+  pool.Free(packet);
+}
+
+TEST(TestDemuxPacketPool, Unpooled)
+{
+  CDemuxPacketPool &pool = CDemuxPacketPool::GetInstance();
+  pool.Trim();
+
+  DemuxPacket* packet = pool.Allocate(16 * 1024 * 1024);
+  ASSERT_TRUE(packet);
+  pool.Free(packet);
+  EXPECT_EQ(0u, pool.GetStats().cachedBytes);
+
+  packet = pool.Allocate(0);
+  ASSERT_TRUE(packet);
+  EXPECT_FALSE(packet->pData);
+  pool.Free(packet);
+}
@@ -0,0 +1,74 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "DVDDemuxers/DemuxSeekIndex.h"
+
+#include "gtest/gtest.h"
+
+TEST(TestDemuxSeekIndex, Add)
+{
+  CDemuxSeekIndex index;
+  index.SetMinDistance(1000);
+
+  // out of order as after a backwards seek
+  index.Add(4000, 40000);
+  index.Add(0, 100);
+  index.Add(2000, 20000);
+  // too close to an existing entry
+  index.Add(2500, 25000);
+  index.Add(1500, 15000);
+  // no byte position
+  index.Add(6000, -1);
+
+  // sorted by timestamp, as lavf wants them
+  const std::vector<CDemuxSeekIndex::Entry>& entries = index.GetEntries();
+  ASSERT_EQ(3U, entries.size());
+  EXPECT_EQ(0, entries[0].ts);
+  EXPECT_EQ(100, entries[0].pos);
+  EXPECT_EQ(2000, entries[1].ts);
+  EXPECT_EQ(20000, entries[1].pos);
+  EXPECT_EQ(4000, entries[2].ts);
+  EXPECT_EQ(40000, entries[2].pos);
+}
+
+TEST(TestDemuxSeekIndex, Serialize)
+{
+  CDemuxSeekIndex index;
+  for (int64_t i = 0; i < 100; i++)
+    index.Add(i * 90000, i * 1000000 + 188);
+
+  std::string data;
+  ASSERT_TRUE(index.Serialize(data));
+
+  CDemuxSeekIndex restored;
+  ASSERT_TRUE(restored.Deserialize(data));
+  ASSERT_EQ(index.GetEntries().size(), restored.GetEntries().size());
+  for (size_t i = 0; i < index.GetEntries().size(); i++)
+  {
+    EXPECT_EQ(index.GetEntries()[i].ts, restored.GetEntries()[i].ts);
+    EXPECT_EQ(index.GetEntries()[i].pos, restored.GetEntries()[i].pos);
+  }
+
+  // truncated
+  EXPECT_FALSE(restored.Deserialize(data.substr(0, data.size() - 1)));
+  // garbage
+  EXPECT_FALSE(restored.Deserialize(std::string(data.size(), 'x')));
+}
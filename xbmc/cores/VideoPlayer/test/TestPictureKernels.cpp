@@ -0,0 +1,157 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "DVDCodecs/PictureKernels.h"
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace
+{
+// odd width so the scalar tails are exercised too
+const int width = 1921;
+
+std::vector<uint8_t> Pattern8(int size)
+{
+  std::vector<uint8_t> data(size);
+  for (int i = 0; i < size; i++)
+    data[i] = (uint8_t)(i * 7 + 3);
+  return data;
+}
+
+std::vector<uint16_t> Pattern10(int size)
+{
+  std::vector<uint16_t> data(size);
+  for (int i = 0; i < size; i++)
+    data[i] = (uint16_t)((i * 13 + 5) & 0x3ff);
+  return data;
+}
+
+typedef std::chrono::steady_clock Clock;
+
+std::string GBps(size_t bytes, Clock::time_point start)
+{
+  return std::to_string(bytes / std::chrono::duration<double>(Clock::now() - start).count() / 1e9);
+}
+}
+
+TEST(TestPictureKernels, MatchC)
+{
+  const CPictureKernels::Kernels& ref = *CPictureKernels::GetAvailable().front();
+
+  std::vector<uint8_t> u = Pattern8(width);
+  std::vector<uint8_t> v = Pattern8(width + 1);
+  v.erase(v.begin());
+  std::vector<uint16_t> src10 = Pattern10(width);
+
+  for (auto kernels : CPictureKernels::GetAvailable())
+  {
+    SCOPED_TRACE(kernels->name);
+
+    std::vector<uint8_t> a(width), b(width);
+    kernels->copyRow(a.data(), u.data(), width);
+    EXPECT_EQ(u, a);
+
+    std::vector<uint8_t> uv(2 * width), uvRef(2 * width);
+    kernels->interleaveRow(uv.data(), u.data(), v.data(), width);
+    ref.interleaveRow(uvRef.data(), u.data(), v.data(), width);
+    EXPECT_EQ(uvRef, uv);
+
+    kernels->deinterleaveRow(a.data(), b.data(), uv.data(), width);
+    EXPECT_EQ(u, a);
+    EXPECT_EQ(v, b);
+
+    std::vector<uint8_t> p8(width), p8Ref(width);
+    kernels->pack10To8Row(p8.data(), src10.data(), width);
+    ref.pack10To8Row(p8Ref.data(), src10.data(), width);
+    EXPECT_EQ(p8Ref, p8);
+
+    std::vector<uint16_t> p16(width), p16Ref(width);
+    kernels->pack10To16Row(p16.data(), src10.data(), width);
+    ref.pack10To16Row(p16Ref.data(), src10.data(), width);
+    EXPECT_EQ(p16Ref, p16);
+  }
+
+  uint16_t white = 1023;
+  uint16_t full;
+  ref.pack10To16Row(&full, &white, 1);
+  EXPECT_EQ(65535, full);
+}
+
+TEST(TestPictureKernels, CopyPlane)
+{
+  std::vector<uint8_t> src = Pattern8(64 * 10);
+  std::vector<uint8_t> dst(80 * 10, 0);
+
+  CPictureKernels::CopyPlane(dst.data(), 80, src.data(), 64, 50, 10);
+  for (int y = 0; y < 10; y++)
+  {
+    EXPECT_EQ(0, memcmp(&dst[y * 80], &src[y * 64], 50));
+    EXPECT_EQ(0, dst[y * 80 + 50]);
+  }
+}
+
+TEST(TestPictureKernels, DISABLED_Throughput4K)
+{
+  // a full frame so we don't just measure the cache, GB/s of source data
+  const int w = 3840;
+  const int h = 2160;
+  std::vector<uint8_t> src8 = Pattern8(w * h);
+  std::vector<uint16_t> src10 = Pattern10(w * h);
+  std::vector<uint8_t> dst8(w * h);
+  std::vector<uint16_t> dst16(w * h);
+
+  for (auto kernels : CPictureKernels::GetAvailable())
+  {
+    SCOPED_TRACE(kernels->name);
+    std::string name(kernels->name);
+
+    Clock::time_point start = Clock::now();
+    for (int y = 0; y < h; y++)
+      kernels->copyRow(&dst8[y * w], &src8[y * w], w);
+    RecordProperty(name + "_copy", GBps(w * h, start));
+    EXPECT_EQ(src8, dst8);
+
+    start = Clock::now();
+    for (int y = 0; y < h; y++)
+      kernels->interleaveRow(&dst8[y * w], &src8[y * w], &src8[y * w + w / 2], w / 2);
+    RecordProperty(name + "_interleave", GBps(w * h, start));
+
+    start = Clock::now();
+    for (int y = 0; y < h; y++)
+      kernels->deinterleaveRow(&src8[y * w], &src8[y * w + w / 2], &dst8[y * w], w / 2);
+    RecordProperty(name + "_deinterleave", GBps(w * h, start));
+
+    start = Clock::now();
+    for (int y = 0; y < h; y++)
+      kernels->pack10To8Row(&dst8[y * w], &src10[y * w], w);
+    RecordProperty(name + "_10to8", GBps(w * h * 2, start));
+
+    start = Clock::now();
+    for (int y = 0; y < h; y++)
+      kernels->pack10To16Row(&dst16[y * w], &src10[y * w], w);
+    RecordProperty(name + "_10to16", GBps(w * h * 2, start));
+  }
+}
@@ -0,0 +1,73 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "cores/DataCacheCore.h"
+#include "Process/ProcessInfo.h"
+
+#include "gtest/gtest.h"
+
+#include <memory>
+
+TEST(TestProcessInfo, PublishesThroughDataCache)
+{
+  CDataCacheCore cache;
+  std::unique_ptr<CProcessInfo> processInfo(CProcessInfo::CreateInstance());
+  processInfo->SetDataCache(&cache);
+
+  processInfo->SetVideoDecoderThreading(4, "frame");
+  processInfo->UpdateVideoDecodeTime(8.0);
+  XFILE::SCacheStatus status = {};
+  status.forward = 1000;
+  processInfo->SetCacheStatus(status);
+
+  EXPECT_EQ(4, cache.GetVideoDecoderThreads());
+  EXPECT_EQ("frame", cache.GetVideoDecoderThreadType());
+  EXPECT_EQ(8.0, cache.GetVideoDecodeTime());
+  EXPECT_EQ(1000U, cache.GetCacheStatus().forward);
+}
+
+TEST(TestProcessInfo, OthersDontPublish)
+{
+  // the state the player left in the global cache
+  g_dataCacheCore.SetVideoDecoderThreading(4, "frame");
+  g_dataCacheCore.SetVideoDecodeTime(8.0);
+  XFILE::SCacheStatus status = {};
+  status.forward = 1000;
+  g_dataCacheCore.SetCacheStatus(status);
+  CVariant stats(CVariant::VariantTypeObject);
+  stats["presentedframes"] = 100;
+  g_dataCacheCore.SetAVSyncStats(stats);
+
+  // as created by the thumb extractors
+  std::unique_ptr<CProcessInfo> processInfo(CProcessInfo::CreateInstance());
+  processInfo->SetVideoDecoderThreading(1, "none");
+  processInfo->UpdateVideoDecodeTime(2.0);
+  processInfo->SetCacheStatus(XFILE::SCacheStatus());
+  processInfo->ResetAVSyncStats();
+
+  EXPECT_EQ(4, g_dataCacheCore.GetVideoDecoderThreads());
+  EXPECT_EQ("frame", g_dataCacheCore.GetVideoDecoderThreadType());
+  EXPECT_EQ(8.0, g_dataCacheCore.GetVideoDecodeTime());
+  EXPECT_EQ(1000U, g_dataCacheCore.GetCacheStatus().forward);
+  CVariant published;
+  g_dataCacheCore.GetAVSyncStats(published);
+  EXPECT_EQ(100, published["presentedframes"].asInteger());
+}
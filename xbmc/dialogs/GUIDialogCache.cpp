@@ -20,11 +20,13 @@
  
 #include "threads/SystemClock.h"
 #include "GUIDialogCache.h"
+#include "cores/DataCacheCore.h"
 #include "messaging/ApplicationMessenger.h"
 #include "guilib/GUIWindowManager.h"
 #include "dialogs/GUIDialogProgress.h"
 #include "guilib/LocalizeStrings.h"
 #include "utils/log.h"
+#include "utils/StringUtils.h"
 #include "threads/SingleLock.h"
 #include "utils/Variant.h"
 
@@ -153,6 +155,11 @@ void CGUIDialogCache::Process()
         else if( !m_pDlg->IsDialogRunning() && m_endtime.IsTimePast() 
               && !g_windowManager.IsWindowActive(WINDOW_DIALOG_YES_NO) )
           OpenDialog();
+        else if( m_pDlg->IsDialogRunning() && m_statusTime.IsTimePast() )
+        {
+          SetCacheStatus(g_dataCacheCore.GetCacheStatus());
+          m_statusTime.Set(500);
+        }
       }
       catch(...)
       {
@@ -176,6 +183,18 @@ void CGUIDialogCache::SetPercentage(int iPercentage)
     m_pDlg->SetPercentage(iPercentage);
 }
 
+void CGUIDialogCache::SetCacheStatus(const XFILE::SCacheStatus& status)
+{
+  // nothing to tell before the player's cache got going
+  if (!m_pDlg || (status.read == 0 && status.refill == 0))
+    return;
+
+  m_pDlg->SetLine(0, CVariant{StringUtils::Format(g_localizeStrings.Get(471).c_str(),
+                                                  StringUtils::SizeToString(status.cached).c_str(),
+                                                  StringUtils::SizeToString(status.read).c_str(),
+                                                  StringUtils::SizeToString(status.refill).c_str())});
+}
+
 bool CGUIDialogCache::IsCanceled() const
 {
   if (m_pDlg && m_pDlg->IsDialogRunning())
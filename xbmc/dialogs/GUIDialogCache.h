@@ -38,6 +38,7 @@ public:
   bool IsCanceled() const;
   void ShowProgressBar(bool bOnOff);
   void SetPercentage(int iPercentage);
+  void SetCacheStatus(const XFILE::SCacheStatus& status);
 
   void Close(bool bForceClose = false);
 
@@ -49,6 +50,7 @@ protected:
   void OpenDialog();
 
   XbmcThreads::EndTime m_endtime;
+  XbmcThreads::EndTime m_statusTime;
   CGUIDialogProgress* m_pDlg;
   std::string m_strHeader;
   std::string m_strLinePrev;
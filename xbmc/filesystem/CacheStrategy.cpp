@@ -277,6 +277,11 @@ bool CSimpleFileCache::IsCachedPosition(int64_t iFilePosition)
   return iFilePosition >= m_nStartPosition && iFilePosition <= m_nStartPosition + m_nWritePosition;
 }
 
+int64_t CSimpleFileCache::GetCachedBytes()
+{
+  return m_nWritePosition;
+}
+
 CCacheStrategy *CSimpleFileCache::CreateNew()
 {
   return new CSimpleFileCache();
@@ -407,6 +412,31 @@ bool CDoubleCache::IsCachedPosition(int64_t iFilePosition)
   return m_pCache->IsCachedPosition(iFilePosition) || (m_pCacheOld && m_pCacheOld->IsCachedPosition(iFilePosition));
 }
 
+bool CDoubleCache::IsWriteRange(int64_t iFilePosition)
+{
+  return m_pCache->IsWriteRange(iFilePosition);
+}
+
+int64_t CDoubleCache::GetCachedBytes()
+{
+  int64_t ret = m_pCache->GetCachedBytes();
+  if (m_pCacheOld)
+    ret += m_pCacheOld->GetCachedBytes();
+  return ret;
+}
+
+void CDoubleCache::SetReadRate(unsigned rate)
+{
+  m_pCache->SetReadRate(rate);
+  if (m_pCacheOld)
+    m_pCacheOld->SetReadRate(rate);
+}
+
+size_t CDoubleCache::GetForwardLimit()
+{
+  return m_pCache->GetForwardLimit();
+}
+
 CCacheStrategy *CDoubleCache::CreateNew()
 {
   return new CDoubleCache(m_pCache->CreateNew());
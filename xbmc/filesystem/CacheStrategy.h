@@ -67,6 +67,30 @@ public:
   virtual int64_t CachedDataEndPos() = 0;
   virtual bool IsCachedPosition(int64_t iFilePosition) = 0;
 
+  /*!
+   \brief Check if data written next continues the cached range holding a position
+   Caches keeping several ranges return false for the other ranges, the source has to be moved
+   to the end of that range then (see Reset).
+   \param iFilePosition a cached position
+   */
+  virtual bool IsWriteRange(int64_t iFilePosition) { return true; }
+
+  /*!
+   \brief Number of bytes held in the cache, back and forward
+   */
+  virtual int64_t GetCachedBytes() { return 0; }
+
+  /*!
+   \brief Hint the rate the reader consumes data at, in bytes per second
+   */
+  virtual void SetReadRate(unsigned rate) {}
+
+  /*!
+   \brief Maximum number of bytes cached ahead of the read position, 0 if not limited
+   May change while the cache is in use.
+   */
+  virtual size_t GetForwardLimit() { return 0; }
+
   virtual CCacheStrategy *CreateNew() = 0;
 
   CEvent m_space;
@@ -97,6 +121,8 @@ public:
   virtual int64_t CachedDataEndPos();
   virtual bool IsCachedPosition(int64_t iFilePosition);
 
+  virtual int64_t GetCachedBytes();
+
   virtual CCacheStrategy *CreateNew();
 
   int64_t  GetAvailableRead();
@@ -133,6 +159,10 @@ public:
   virtual int64_t CachedDataEndPosIfSeekTo(int64_t iFilePosition);
   virtual int64_t CachedDataEndPos();
   virtual bool IsCachedPosition(int64_t iFilePosition);
+  virtual bool IsWriteRange(int64_t iFilePosition);
+  virtual int64_t GetCachedBytes();
+  virtual void SetReadRate(unsigned rate);
+  virtual size_t GetForwardLimit();
 
   virtual CCacheStrategy *CreateNew();
 
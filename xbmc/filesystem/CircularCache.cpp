@@ -19,6 +19,7 @@
  */
 
 #include <algorithm>
+#include <cstring>
 #include "threads/SystemClock.h"
 #include "system.h"
 #include "threads/SingleLock.h"
@@ -28,16 +29,20 @@ using namespace XFILE;
 
 CCircularCache::CCircularCache(size_t front, size_t back)
  : CCacheStrategy()
- , m_beg(0)
- , m_end(0)
  , m_cur(0)
+ , m_write(0)
  , m_buf(NULL)
- , m_size(front + back)
+ , m_size(0)
+ , m_size_front(front)
  , m_size_back(back)
+ , m_blockSize(GetBlockSize(front + back))
+ , m_useCounter(0)
 #ifdef TARGET_WINDOWS
  , m_handle(INVALID_HANDLE_VALUE)
 #endif
 {
+  // the blocks the reader and writer are in are only partially used
+  m_size = ((front + back + m_blockSize - 1) / m_blockSize + 2) * m_blockSize;
 }
 
 CCircularCache::~CCircularCache()
@@ -45,6 +50,14 @@ CCircularCache::~CCircularCache()
   Close();
 }
 
+size_t CCircularCache::GetBlockSize(size_t size)
+{
+  size_t blockSize = 4 * 1024;
+  while (blockSize < 1024 * 1024 && blockSize * 2 * 64 <= size)
+    blockSize *= 2;
+  return blockSize;
+}
+
 int CCircularCache::Open()
 {
 #ifdef TARGET_WINDOWS
@@ -57,52 +70,159 @@ int CCircularCache::Open()
 #endif
   if(m_buf == 0)
     return CACHE_RC_ERROR;
-  m_beg = 0;
-  m_end = 0;
+  ClearBlocks();
   m_cur = 0;
+  m_write = 0;
   return CACHE_RC_OK;
 }
 
 void CCircularCache::Close()
 {
 #ifdef TARGET_WINDOWS
-  UnmapViewOfFile(m_buf);
-  CloseHandle(m_handle);
+  if (m_buf)
+    UnmapViewOfFile(m_buf);
+  if (m_handle != NULL && m_handle != INVALID_HANDLE_VALUE)
+    CloseHandle(m_handle);
   m_handle = INVALID_HANDLE_VALUE;
 #else
   delete[] m_buf;
 #endif
   m_buf = NULL;
+  m_blocks.clear();
+  m_chunks.clear();
+}
+
+void CCircularCache::ClearBlocks()
+{
+  Block free = { -1, 0, 0, 0 };
+  m_blocks.assign(m_size / m_blockSize, free);
+  m_chunks.clear();
+  m_useCounter = 0;
+}
+
+CCircularCache::Block* CCircularCache::FindBlock(int64_t chunk)
+{
+  std::map<int64_t, size_t>::iterator it = m_chunks.find(chunk);
+  if (it == m_chunks.end())
+    return NULL;
+  return &m_blocks[it->second];
+}
+
+/**
+ * End of the contiguous cached range holding pos, -1 if pos isn't cached.
+ * The end of a range counts as cached, that's where writing continues.
+ */
+int64_t CCircularCache::RangeEnd(int64_t pos)
+{
+  if (pos == m_write)
+    return m_write;
+
+  int64_t chunk = pos / m_blockSize;
+  size_t off = (size_t)(pos % m_blockSize);
+
+  Block* block = FindBlock(chunk);
+  if (!block || block->beg == block->end || off < block->beg || off > block->end)
+  {
+    // right behind a full block
+    Block* prev = off == 0 ? FindBlock(chunk - 1) : NULL;
+    if (prev && prev->end == m_blockSize)
+      return pos;
+    return -1;
+  }
+
+  int64_t end = chunk * m_blockSize + block->end;
+  while (block->end == m_blockSize)
+  {
+    block = FindBlock(++chunk);
+    if (!block || block->beg != 0 || block->end == 0)
+      break;
+    end = chunk * m_blockSize + block->end;
+  }
+  return end;
+}
+
+size_t CCircularCache::GetForwardLimit()
+{
+  return m_size_front;
+}
+
+/**
+ * Block to write chunk into. Blocks holding unread data of the range the
+ * reader is in are never recycled, everything else goes least recently used
+ * first. After a seek into an older range that range isn't the one being
+ * filled until the cache thread calls Reset(), so it is protected up to its
+ * end rather than up to m_write.
+ */
+CCircularCache::Block* CCircularCache::GetWriteBlock(int64_t chunk)
+{
+  Block* block = FindBlock(chunk);
+  if (block)
+    return block;
+
+  int64_t first = m_cur / m_blockSize;
+  int64_t last = first;
+  if (IsWriteRange(m_cur))
+    last = chunk;
+  else
+  {
+    int64_t end = RangeEnd(m_cur);
+    if (end > m_cur)
+      last = (end - 1) / m_blockSize;
+  }
+
+  size_t victim = m_blocks.size();
+  for (size_t i = 0; i < m_blocks.size(); i++)
+  {
+    const Block& b = m_blocks[i];
+    if (b.chunk < 0)
+    {
+      victim = i;
+      break;
+    }
+
+    if (b.chunk >= first && b.chunk <= last)
+      continue;
+
+    if (victim == m_blocks.size() || b.lastUse < m_blocks[victim].lastUse)
+      victim = i;
+  }
+
+  if (victim == m_blocks.size())
+    return NULL;
+
+  block = &m_blocks[victim];
+  if (block->chunk >= 0)
+    m_chunks.erase(block->chunk);
+
+  block->chunk = chunk;
+  block->beg = 0;
+  block->end = 0;
+  m_chunks[chunk] = victim;
+  return block;
 }
 
 size_t CCircularCache::GetMaxWriteSize(const size_t& iRequestSize)
 {
   CSingleLock lock(m_sync);
 
-  size_t back  = (size_t)(m_cur - m_beg); // Backbuffer size
-  size_t front = (size_t)(m_end - m_cur); // Frontbuffer size
-  size_t limit = m_size - std::min(back, m_size_back) - front;
+  size_t front = IsWriteRange(m_cur) ? (size_t)(m_write - m_cur) : 0;
+  size_t limit = GetForwardLimit();
+  if (front >= limit)
+    return 0;
 
   // Never return more than limit and size requested by caller
-  return std::min(iRequestSize, limit);
+  return std::min(iRequestSize, limit - front);
 }
 
 /**
- * Function will write to m_buf at m_end % m_size location
- * it will write at maximum m_size, but it will only write
- * as much it can without wrapping around in the buffer
+ * Function will write to the block holding m_write, it will
+ * only write as much as fits up to the end of that block.
  *
- * It will always leave m_size_back of the backbuffer intact
- * but if the back buffer is less than that, that space is
- * usable to write.
+ * Writing stops once the forward limit is reached. Blocks of
+ * other ranges are recycled, least recently used first.
  *
- * If back buffer is filled to an larger extent than
- * m_size_back, it will allow it to be overwritten
- * until only m_size_back data remains.
- *
- * The following always apply:
- *  * m_end <= m_cur <= m_end
- *  * m_end - m_beg <= m_size
+ * If the write joins data of an older range, the block is merged
+ * and the part already there isn't copied again.
  *
  * Multiple calls may be needed to fill buffer completely.
  */
@@ -110,32 +230,50 @@ int CCircularCache::WriteToCache(const char *buf, size_t len)
 {
   CSingleLock lock(m_sync);
 
-  // where are we in the buffer
-  size_t pos   = m_end % m_size;
-  size_t back  = (size_t)(m_cur - m_beg);
-  size_t front = (size_t)(m_end - m_cur);
-
-  size_t limit = m_size - std::min(back, m_size_back) - front;
-  size_t wrap  = m_size - pos;
+  size_t front = IsWriteRange(m_cur) ? (size_t)(m_write - m_cur) : 0;
+  size_t limit = GetForwardLimit();
+  if (front >= limit)
+    return 0;
 
-  // limit by max forward size
-  if(len > limit)
-    len = limit;
+  int64_t chunk = m_write / m_blockSize;
+  size_t off = (size_t)(m_write % m_blockSize);
 
-  // limit to wrap point
-  if(len > wrap)
-    len = wrap;
+  // limit by max forward size and block end
+  len = std::min(len, limit - front);
+  len = std::min(len, m_blockSize - off);
+  if (len == 0)
+    return 0;
 
-  if(len == 0)
+  Block* block = GetWriteBlock(chunk);
+  if (!block)
     return 0;
 
-  // write the data
-  memcpy(m_buf + pos, buf, len);
-  m_end += len;
+  uint8_t* dst = GetBlockData(*block);
+  if (block->beg == block->end || off > block->end || off + len < block->beg)
+  {
+    // nothing usable left in the block, a single range per block
+    memcpy(dst + off, buf, len);
+    block->beg = off;
+    block->end = off + len;
+  }
+  else
+  {
+    // joins data of an older range, skip what is already there
+    size_t skipBeg = std::max(off, block->beg);
+    size_t skipEnd = std::min(off + len, block->end);
+    if (skipBeg > off)
+      memcpy(dst + off, buf, skipBeg - off);
+    if (off + len > skipEnd)
+      memcpy(dst + skipEnd, buf + (skipEnd - off), off + len - skipEnd);
+    block->beg = std::min(block->beg, off);
+    block->end = std::max(block->end, off + len);
+  }
+
+  block->lastUse = ++m_useCounter;
+  m_write += len;
 
-  // drop history that was overwritten
-  if(m_end - m_beg > (int64_t)m_size)
-    m_beg = m_end - m_size;
+  if (block->end == m_blockSize)
+    OnBlockFilled(*block);
 
   m_written.Set();
 
@@ -144,16 +282,20 @@ int CCircularCache::WriteToCache(const char *buf, size_t len)
 
 /**
  * Reads data from cache. Will only read up till
- * the buffer wrap point. So multiple calls
+ * the end of a block. So multiple calls
  * may be needed to empty the whole cache
  */
 int CCircularCache::ReadFromCache(char *buf, size_t len)
 {
   CSingleLock lock(m_sync);
 
-  size_t pos   = m_cur % m_size;
-  size_t front = (size_t)(m_end - m_cur);
-  size_t avail = std::min(m_size - pos, front);
+  int64_t chunk = m_cur / m_blockSize;
+  size_t off = (size_t)(m_cur % m_blockSize);
+
+  Block* block = FindBlock(chunk);
+  size_t avail = 0;
+  if (block && off >= block->beg && off < block->end)
+    avail = block->end - off;
 
   if(avail == 0)
   {
@@ -169,9 +311,12 @@ int CCircularCache::ReadFromCache(char *buf, size_t len)
   if(len == 0)
     return 0;
 
-  memcpy(buf, m_buf + pos, len);
+  memcpy(buf, GetBlockData(*block) + off, len);
+  block->lastUse = ++m_useCounter;
   m_cur += len;
 
+  OnReadPosition();
+
   m_space.Set();
 
   return len;
@@ -184,13 +329,13 @@ int CCircularCache::ReadFromCache(char *buf, size_t len)
 int64_t CCircularCache::WaitForData(unsigned int minimum, unsigned int millis)
 {
   CSingleLock lock(m_sync);
-  int64_t avail = m_end - m_cur;
+  int64_t avail = std::max(RangeEnd(m_cur), m_cur) - m_cur;
 
   if(millis == 0 || IsEndOfInput())
     return avail;
 
-  if(minimum > m_size - m_size_back)
-    minimum = m_size - m_size_back;
+  if(minimum > GetForwardLimit())
+    minimum = GetForwardLimit();
 
   XbmcThreads::EndTime endtime(millis);
   while (!IsEndOfInput() && avail < minimum && !endtime.IsTimePast() )
@@ -198,7 +343,7 @@ int64_t CCircularCache::WaitForData(unsigned int minimum, unsigned int millis)
     lock.Leave();
     m_written.WaitMSec(50); // may miss the deadline. shouldn't be a problem.
     lock.Enter();
-    avail = m_end - m_cur;
+    avail = std::max(RangeEnd(m_cur), m_cur) - m_cur;
   }
 
   return avail;
@@ -210,21 +355,22 @@ int64_t CCircularCache::Seek(int64_t pos)
 
   // if seek is a bit over what we have, try to wait a few seconds for the data to be available.
   // we try to avoid a (heavy) seek on the source
-  if (pos >= m_end && pos < m_end + 100000)
+  if (pos >= m_write && pos < m_write + 100000 && IsWriteRange(m_cur))
   {
     /* Make everything in the cache (back & forward) back-cache, to make sure
      * there's sufficient forward space. Increasing it with only 100000 may not be
      * sufficient due to variable filesystem chunksize
      */
-    m_cur = m_end;
+    m_cur = m_write;
     lock.Leave();
     WaitForData((size_t)(pos - m_cur), 5000);
     lock.Enter();
   }
 
-  if(pos >= m_beg && pos <= m_end)
+  if (RangeEnd(pos) >= 0)
   {
     m_cur = pos;
+    OnReadPosition();
     return pos;
   }
 
@@ -234,37 +380,69 @@ int64_t CCircularCache::Seek(int64_t pos)
 bool CCircularCache::Reset(int64_t pos, bool clearAnyway)
 {
   CSingleLock lock(m_sync);
-  if (!clearAnyway && IsCachedPosition(pos))
+
+  if (clearAnyway)
+    ClearBlocks();
+  else
   {
-    m_cur = pos;
-    return false;
+    // continue filling the range pos is in, other ranges are kept
+    int64_t end = RangeEnd(pos);
+    if (end >= 0)
+    {
+      m_cur = pos;
+      m_write = end;
+      OnReadPosition();
+      return false;
+    }
   }
-  m_end = pos;
-  m_beg = pos;
+
   m_cur = pos;
+  m_write = pos;
+  OnReadPosition();
 
   return true;
 }
 
 int64_t CCircularCache::CachedDataEndPosIfSeekTo(int64_t iFilePosition)
 {
-  if (IsCachedPosition(iFilePosition))
-    return m_end;
-  return iFilePosition;
+  CSingleLock lock(m_sync);
+  int64_t end = RangeEnd(iFilePosition);
+  return end >= 0 ? end : iFilePosition;
 }
 
 int64_t CCircularCache::CachedDataEndPos()
 {
-  return m_end;
+  CSingleLock lock(m_sync);
+  return std::max(RangeEnd(m_cur), m_cur);
 }
 
 bool CCircularCache::IsCachedPosition(int64_t iFilePosition)
 {
-  return iFilePosition >= m_beg && iFilePosition <= m_end;
+  CSingleLock lock(m_sync);
+  return RangeEnd(iFilePosition) >= 0;
 }
 
-CCacheStrategy *CCircularCache::CreateNew()
+bool CCircularCache::IsWriteRange(int64_t iFilePosition)
 {
-  return new CCircularCache(m_size - m_size_back, m_size_back);
+  CSingleLock lock(m_sync);
+  if (iFilePosition > m_write)
+    return false;
+  return RangeEnd(iFilePosition) >= m_write;
 }
 
+int64_t CCircularCache::GetCachedBytes()
+{
+  CSingleLock lock(m_sync);
+  int64_t bytes = 0;
+  for (std::vector<Block>::const_iterator it = m_blocks.begin(); it != m_blocks.end(); ++it)
+  {
+    if (it->chunk >= 0)
+      bytes += it->end - it->beg;
+  }
+  return bytes;
+}
+
+CCacheStrategy *CCircularCache::CreateNew()
+{
+  return new CCircularCache(m_size_front, m_size_back);
+}
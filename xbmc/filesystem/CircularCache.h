@@ -25,8 +25,21 @@
 #include "threads/CriticalSection.h"
 #include "threads/Event.h"
 
+#include <map>
+#include <vector>
+
 namespace XFILE {
 
+/**
+ * Memory cache split into fixed size blocks, each holding one aligned chunk
+ * of the source. Blocks aren't bound to a single contiguous window, so data
+ * from before a seek stays cached as a separate range until its blocks are
+ * recycled, least recently used first.
+ *
+ * The range the reader is in is the only one written to, from its end
+ * (m_write). Blocks from the read position to the end of its range are never
+ * recycled.
+ */
 class CCircularCache : public CCacheStrategy
 {
 public:
@@ -47,15 +60,55 @@ public:
     virtual int64_t CachedDataEndPosIfSeekTo(int64_t iFilePosition);
     virtual int64_t CachedDataEndPos(); 
     virtual bool IsCachedPosition(int64_t iFilePosition);
+    virtual bool IsWriteRange(int64_t iFilePosition);
+    virtual int64_t GetCachedBytes();
+    virtual size_t GetForwardLimit();
 
     virtual CCacheStrategy *CreateNew();
+
+    size_t GetBlockSize() const { return m_blockSize; }
+
 protected:
-    int64_t           m_beg;       /**< index in file (not buffer) of beginning of valid data */
-    int64_t           m_end;       /**< index in file (not buffer) of end of valid data */
+    struct Block
+    {
+      int64_t  chunk;   /**< chunk of the source held, -1 if free */
+      size_t   beg;     /**< start of valid data within the block */
+      size_t   end;     /**< end of valid data within the block */
+      uint64_t lastUse; /**< for LRU recycling */
+    };
+
+    /**
+     * Block size for a cache of the given size, a power of two between 4 KiB
+     * and 1 MiB giving at least 64 blocks where possible
+     */
+    static size_t GetBlockSize(size_t size);
+
+    void    ClearBlocks();
+    Block*  FindBlock(int64_t chunk);
+    uint8_t* GetBlockData(const Block& block) { return m_buf + (&block - &m_blocks[0]) * m_blockSize; }
+    int64_t RangeEnd(int64_t pos);
+    Block*  GetWriteBlock(int64_t chunk);
+
+    /**
+     * Called with the lock held after the read position moved
+     */
+    virtual void OnReadPosition() {}
+
+    /**
+     * Called with the lock held when the last byte of a block was written
+     */
+    virtual void OnBlockFilled(Block& block) {}
+
     int64_t           m_cur;       /**< current reading index in file */
+    int64_t           m_write;     /**< index in file where writing continues, end of the range being filled */
     uint8_t          *m_buf;       /**< buffer holding data */
-    size_t            m_size;      /**< size of data buffer used (m_buf) */
-    size_t            m_size_back; /**< guaranteed size of back buffer (actual size can be smaller, or larger if front buffer doesn't need it) */
+    size_t            m_size;      /**< size of data buffer used (m_buf), multiple of m_blockSize */
+    size_t            m_size_front;/**< maximum forward size */
+    size_t            m_size_back; /**< back buffer size asked for, the rest of the blocks keep history */
+    size_t            m_blockSize;
+    uint64_t          m_useCounter;
+    std::vector<Block> m_blocks;
+    std::map<int64_t, size_t> m_chunks; /**< chunk -> index in m_blocks */
     CCriticalSection  m_sync;
     CEvent            m_written;
 #ifdef TARGET_WINDOWS
@@ -19,6 +19,7 @@
  */
 
 #include "CurlFile.h"
+#include "CurlRangeReader.h"
 #include "utils/URIUtils.h"
 #include "Util.h"
 #include "URL.h"
@@ -65,6 +66,9 @@ curl_proxytype proxyType2CUrlProxyType[] = {
 #define FILLBUFFER_NO_DATA    1
 #define FILLBUFFER_FAIL       2
 
+// smaller files don't benefit from parallel range requests
+#define RANGES_MIN_FILESIZE   (8 * 1024 * 1024)
+
 // curl calls this routine to debug
 extern "C" int debug_callback(CURL_HANDLE *handle, curl_infotype info, char *output, size_t size, void *data)
 {
@@ -439,6 +443,7 @@ CCurlFile::CCurlFile()
   m_cipherlist = "";
   m_state = new CReadState();
   m_oldState = NULL;
+  m_ranges = NULL;
   m_skipshout = false;
   m_httpresponse = -1;
   m_acceptCharset = "UTF-8,*;q=0.8"; /* prefer UTF-8 if available */
@@ -456,6 +461,10 @@ void CCurlFile::Close()
   if (m_opened && m_forWrite && !m_inError)
       Write(NULL, 0);
 
+  // the range reader shares the header lists of m_state
+  delete m_ranges;
+  m_ranges = NULL;
+
   m_state->Disconnect();
   delete m_oldState;
   m_oldState = NULL;
@@ -475,6 +484,9 @@ void CCurlFile::SetCommonOptions(CReadState* state)
 
   g_curlInterface.easy_reset(h);
 
+  // share dns lookups, ssl sessions and connections with all other handles
+  g_curlInterface.easy_share(h);
+
   g_curlInterface.easy_setopt(h, CURLOPT_DEBUGFUNCTION, debug_callback);
 
   if( g_advancedSettings.m_logLevel >= LOG_LEVEL_DEBUG )
@@ -986,6 +998,7 @@ bool CCurlFile::Open(const CURL& url)
   if( m_state->m_easyHandle == NULL )
     g_curlInterface.easy_aquire(url2.GetProtocol().c_str(),
                                 url2.GetHostName().c_str(),
+                                url2.GetPort(),
                                 &m_state->m_easyHandle,
                                 &m_state->m_multiHandle);
 
@@ -1058,6 +1071,58 @@ bool CCurlFile::Open(const CURL& url)
     m_url = efurl;
   }
 
+  if (m_seekable && m_multisession && g_advancedSettings.m_curlParallelConnections > 1
+   && m_state->m_fileSize >= RANGES_MIN_FILESIZE
+   && m_postdata.empty() && m_customrequest.empty() && m_acceptencoding.empty())
+    return OpenRanges();
+
+  return true;
+}
+
+bool CCurlFile::OpenRanges()
+{
+  // stop the single transfer but keep m_state connected, the duplicated
+  // handles refer to its header lists
+  g_curlInterface.multi_remove_handle(m_state->m_multiHandle, m_state->m_easyHandle);
+  m_state->m_buffer.Clear();
+  m_state->m_stillRunning = 0;
+
+  CURL url(m_url);
+  m_ranges = new CCurlRangeReader(m_state->m_easyHandle, m_url, url.GetHostName(),
+                                  m_state->m_fileSize, g_advancedSettings.m_curlParallelConnections,
+                                  m_state->m_cancelled);
+  if (m_ranges->Open(m_state->m_filePos))
+  {
+    CLog::Log(LOGDEBUG, "CCurlFile::Open - reading with %d parallel connections", m_ranges->GetConnections());
+    return true;
+  }
+
+  CLog::Log(LOGDEBUG, "CCurlFile::Open - range requests failed, reading with a single connection");
+  int64_t pos = m_state->m_filePos;
+  delete m_ranges;
+  m_ranges = NULL;
+  return ReconnectSingle(pos);
+}
+
+bool CCurlFile::ReconnectSingle(int64_t pos)
+{
+  int64_t fileSize = m_state->m_fileSize;
+  m_state->Disconnect();
+
+  SetCommonOptions(m_state);
+  SetRequestHeaders(m_state);
+  m_state->m_fileSize = fileSize;
+  m_state->m_filePos = pos;
+  m_state->m_sendRange = true;
+
+  long response = m_state->Connect(m_bufferSize);
+  if (response <= 0 || response >= 400)
+  {
+    CLog::Log(LOGERROR, "CCurlFile::ReconnectSingle failed with code %li for %s", response, CURL::GetRedacted(m_url).c_str());
+    return false;
+  }
+
+  SetCorrectHeaders(m_state);
   return true;
 }
 
@@ -1077,6 +1142,7 @@ bool CCurlFile::OpenForWrite(const CURL& url, bool bOverWrite)
   assert(m_state->m_easyHandle == NULL);
   g_curlInterface.easy_aquire(url2.GetProtocol().c_str(),
                               url2.GetHostName().c_str(),
+                              url2.GetPort(),
                               &m_state->m_easyHandle,
                               &m_state->m_multiHandle);
 
@@ -1140,6 +1206,33 @@ ssize_t CCurlFile::Write(const void* lpBuf, size_t uiBufSize)
   return m_state->m_filePos;
 }
 
+bool CCurlFile::ReadString(char *szLine, int iLineLength)
+{
+  if (m_ranges)
+    return IFile::ReadString(szLine, iLineLength);
+
+  return m_state->ReadString(szLine, iLineLength);
+}
+
+ssize_t CCurlFile::Read(void* lpBuf, size_t uiBufSize)
+{
+  if (m_ranges)
+  {
+    ssize_t read = m_ranges->Read(lpBuf, uiBufSize);
+    if (read >= 0 || !m_ranges->RangesRefused())
+      return read;
+
+    CLog::Log(LOGWARNING, "CCurlFile::Read - server stopped accepting range requests, reading with a single connection");
+    int64_t pos = m_ranges->GetPosition();
+    delete m_ranges;
+    m_ranges = NULL;
+    if (!ReconnectSingle(pos))
+      return -1;
+  }
+
+  return m_state->Read(lpBuf, uiBufSize);
+}
+
 bool CCurlFile::CReadState::ReadString(char *szLine, int iLineLength)
 {
   unsigned int want = (unsigned int)iLineLength;
@@ -1187,6 +1280,7 @@ bool CCurlFile::Exists(const CURL& url)
   assert(m_state->m_easyHandle == NULL);
   g_curlInterface.easy_aquire(url2.GetProtocol().c_str(),
                               url2.GetHostName().c_str(),
+                              url2.GetPort(),
                               &m_state->m_easyHandle, NULL);
 
   SetCommonOptions(m_state);
@@ -1228,7 +1322,7 @@ bool CCurlFile::Exists(const CURL& url)
 
 int64_t CCurlFile::Seek(int64_t iFilePosition, int iWhence)
 {
-  int64_t nextPos = m_state->m_filePos;
+  int64_t nextPos = m_ranges ? m_ranges->GetPosition() : m_state->m_filePos;
   
   if(!m_seekable)
     return -1;
@@ -1254,6 +1348,9 @@ int64_t CCurlFile::Seek(int64_t iFilePosition, int iWhence)
   // We can't seek beyond EOF
   if (m_state->m_fileSize && nextPos > m_state->m_fileSize) return -1;
 
+  if (m_ranges)
+    return m_ranges->Seek(nextPos) ? nextPos : -1;
+
   if(m_state->Seek(nextPos))
     return nextPos;
 
@@ -1267,6 +1364,7 @@ int64_t CCurlFile::Seek(int64_t iFilePosition, int iWhence)
       m_state->m_fileSize = m_oldState->m_fileSize;
       g_curlInterface.easy_aquire(url.GetProtocol().c_str(),
                                   url.GetHostName().c_str(),
+                                  url.GetPort(),
                                   &m_state->m_easyHandle,
                                   &m_state->m_multiHandle );
     }
@@ -1332,9 +1430,16 @@ int64_t CCurlFile::GetLength()
 int64_t CCurlFile::GetPosition()
 {
   if (!m_opened) return 0;
+  if (m_ranges) return m_ranges->GetPosition();
   return m_state->m_filePos;
 }
 
+int CCurlFile::GetConnections() const
+{
+  if (!m_opened) return 0;
+  return m_ranges ? m_ranges->GetConnections() : 1;
+}
+
 int CCurlFile::Stat(const CURL& url, struct __stat64* buffer)
 {
   // if file is already running, get info from it
@@ -1356,6 +1461,7 @@ int CCurlFile::Stat(const CURL& url, struct __stat64* buffer)
   assert(m_state->m_easyHandle == NULL);
   g_curlInterface.easy_aquire(url2.GetProtocol().c_str(),
                               url2.GetHostName().c_str(),
+                              url2.GetPort(),
                               &m_state->m_easyHandle, NULL);
 
   SetCommonOptions(m_state);
@@ -1826,6 +1932,7 @@ bool CCurlFile::GetCookies(const CURL &url, std::string &cookies)
   // get the cookies list
   g_curlInterface.easy_aquire(url.GetProtocol().c_str(),
                               url.GetHostName().c_str(),
+                              url.GetPort(),
                               &easyHandle, &multiHandle);
   if (CURLE_OK == g_curlInterface.easy_getinfo(easyHandle, CURLINFO_COOKIELIST, &curlCookies))
   {
@@ -1893,6 +2000,9 @@ int CCurlFile::IoControl(EIoControl request, void* param)
 
 double CCurlFile::GetDownloadSpeed()
 {
+  if (m_ranges)
+    return m_ranges->GetDownloadSpeed();
+
   double res = 0.0f;
   g_curlInterface.easy_getinfo(m_state->m_easyHandle, CURLINFO_SPEED_DOWNLOAD, &res);
   return res;
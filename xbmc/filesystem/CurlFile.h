@@ -34,6 +34,8 @@ namespace XCURL
 
 namespace XFILE
 {
+  class CCurlRangeReader;
+
   class CCurlFile : public IFile
   {
     private:
@@ -57,8 +59,8 @@ namespace XFILE
       virtual int64_t  GetLength();
       virtual int  Stat(const CURL& url, struct __stat64* buffer);
       virtual void Close();
-      virtual bool ReadString(char *szLine, int iLineLength)     { return m_state->ReadString(szLine, iLineLength); }
-      virtual ssize_t Read(void* lpBuf, size_t uiBufSize)        { return m_state->Read(lpBuf, uiBufSize); }
+      virtual bool ReadString(char *szLine, int iLineLength);
+      virtual ssize_t Read(void* lpBuf, size_t uiBufSize);
       virtual ssize_t Write(const void* lpBuf, size_t uiBufSize);
       virtual std::string GetMimeType()                          { return m_state->m_httpheader.GetMimeType(); }
       virtual std::string GetContent()                           { return m_state->m_httpheader.GetValue("content-type"); }
@@ -94,6 +96,8 @@ namespace XFILE
 
       const CHttpHeader& GetHttpHeader() const { return m_state->m_httpheader; }
       std::string GetServerReportedCharset(void);
+      /* the number of connections the open file is read with, more than one with parallel range requests */
+      int GetConnections() const;
 
       /* static function that will get content type of a file */
       static bool GetHttpHeader(const CURL &url, CHttpHeader &headers);
@@ -157,10 +161,13 @@ namespace XFILE
       void SetRequestHeaders(CReadState* state);
       void SetCorrectHeaders(CReadState* state);
       bool Service(const std::string& strURL, std::string& strHTML);
+      bool OpenRanges();
+      bool ReconnectSingle(int64_t pos);
 
     protected:
       CReadState*     m_state;
       CReadState*     m_oldState;
+      CCurlRangeReader* m_ranges;         // parallel range requests, replaces m_state reads when set
       unsigned int    m_bufferSize;
       int64_t         m_writeOffset;
 
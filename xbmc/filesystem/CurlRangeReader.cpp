@@ -0,0 +1,511 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "CurlRangeReader.h"
+#include "DllLibCurl.h"
+#include "settings/AdvancedSettings.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/log.h"
+#include "utils/StringUtils.h"
+
+#include <algorithm>
+#include <string.h>
+
+#ifdef TARGET_POSIX
+#include <errno.h>
+#include <inttypes.h>
+#include "../linux/XTimeUtils.h"
+#endif
+
+using namespace XFILE;
+using namespace XCURL;
+
+#define RANGE_MIN_CHUNK     (256 * 1024)
+#define RANGE_MAX_CHUNK     (4 * 1024 * 1024)
+#define RANGE_START_CHUNK   (1024 * 1024)
+#define RANGE_TARGET_TIME   2000 // ms one range should take
+
+extern "C" size_t range_write_callback(char *buffer,
+                                       size_t size,
+                                       size_t nitems,
+                                       void *userp)
+{
+  if (userp == NULL)
+    return 0;
+
+  CCurlRangeReader::Segment* segment = (CCurlRangeReader::Segment*)userp;
+  return segment->owner->OnData(segment, buffer, size * nitems);
+}
+
+extern "C" size_t range_header_callback(void *ptr, size_t size, size_t nmemb, void *stream)
+{
+  // headers were parsed on the initial request, only the response code matters here
+  return size * nmemb;
+}
+
+CCriticalSection CCurlRangeReader::m_hostSection;
+std::map<std::string, int> CCurlRangeReader::m_hostConnections;
+
+CCurlRangeReader::CCurlRangeReader(CURL_HANDLE* easy, const std::string& url, const std::string& host,
+                                   int64_t fileSize, int connections, const bool& cancelled)
+  : m_multiHandle(NULL)
+  , m_url(url)
+  , m_host(host)
+  , m_fileSize(fileSize)
+  , m_pos(0)
+  , m_next(0)
+  , m_chunkSize(RANGE_START_CHUNK)
+  , m_cancelled(cancelled)
+  , m_refused(false)
+  , m_bytes(0)
+  , m_busyTime(0)
+  , m_lastPerform(0)
+  , m_ranges(0)
+  , m_retries(0)
+  , m_restarts(0)
+{
+  int count = AcquireHostConnections(m_host, connections);
+
+  m_multiHandle = g_curlInterface.multi_init();
+  for (int i = 0; i < count && m_multiHandle; i++)
+  {
+    // duplicates are registered as sessions for the host, so their
+    // connections can be reused by later requests once we release them
+    CURL_HANDLE* handle = NULL;
+    g_curlInterface.easy_duplicate(easy, NULL, &handle, NULL);
+    if (!handle)
+      break;
+
+    m_handles.push_back(handle);
+  }
+
+  if ((int)m_handles.size() < count)
+    ReleaseHostConnections(m_host, count - (int)m_handles.size());
+
+  m_idle = m_handles;
+
+  CLog::Log(LOGDEBUG, "CCurlRangeReader - using %d of %d connections to %s",
+            (int)m_handles.size(), connections, m_host.c_str());
+}
+
+CCurlRangeReader::~CCurlRangeReader()
+{
+  Clear();
+
+  // clean up multi before the easy handles, the cleanup accesses their state
+  if (m_multiHandle)
+    g_curlInterface.multi_cleanup(m_multiHandle);
+
+  for (std::vector<CURL_HANDLE*>::iterator it = m_handles.begin(); it != m_handles.end(); ++it)
+  {
+    CURL_HANDLE* handle = *it;
+    g_curlInterface.easy_release(&handle, NULL);
+  }
+  ReleaseHostConnections(m_host, (int)m_handles.size());
+
+  CLog::Log(LOGDEBUG, "CCurlRangeReader - %s: %" PRId64" bytes in %u ranges over %d connections, "
+            "%.0f KiB/s, %u retries, %u restarts, chunk %u KiB",
+            m_host.c_str(), m_bytes, m_ranges, (int)m_handles.size(),
+            GetDownloadSpeed() / 1024, m_retries, m_restarts, m_chunkSize / 1024);
+}
+
+bool CCurlRangeReader::Open(int64_t pos)
+{
+  if (m_handles.empty())
+    return false;
+
+  Clear();
+  m_pos = m_next = pos;
+  Schedule();
+
+  while (!m_cancelled && !m_refused && !m_segments.empty())
+  {
+    Segment* segment = m_segments.front();
+    if (segment->failed)
+      return false;
+
+    if (!segment->data.empty() || segment->done)
+      return true;
+
+    if (!Perform(true))
+      return false;
+  }
+  return false;
+}
+
+ssize_t CCurlRangeReader::Read(void* lpBuf, size_t uiBufSize)
+{
+  if (m_pos >= m_fileSize)
+    return 0;
+
+  // keep all connections busy, even if the data we need is already here
+  Schedule();
+  if (!Perform(false))
+    return -1;
+
+  Segment* segment = NULL;
+  size_t available = 0;
+  while (true)
+  {
+    if (m_cancelled)
+      return 0;
+
+    if (m_refused || m_segments.empty())
+      return -1;
+
+    segment = m_segments.front();
+    if (segment->data.size() > segment->readPos)
+    {
+      available = segment->data.size() - segment->readPos;
+      break;
+    }
+
+    if (segment->failed || segment->done)
+      return -1;
+
+    if (!Perform(true))
+      return -1;
+  }
+
+  size_t amount = std::min(available, uiBufSize);
+  memcpy(lpBuf, &segment->data[segment->readPos], amount);
+  segment->readPos += amount;
+  m_pos += amount;
+
+  if ((int64_t)segment->readPos == segment->end - segment->start)
+  {
+    StopTransfer(segment);
+    m_segments.pop_front();
+    delete segment;
+    Schedule();
+  }
+  return amount;
+}
+
+bool CCurlRangeReader::Seek(int64_t pos)
+{
+  if (pos == m_pos)
+    return true;
+
+  // drop what lies before pos, as long as the transfer that will deliver pos
+  // is already close to it
+  while (!m_segments.empty() && pos >= m_pos)
+  {
+    Segment* segment = m_segments.front();
+    if (pos >= segment->end)
+    {
+      StopTransfer(segment);
+      m_segments.pop_front();
+      delete segment;
+      continue;
+    }
+
+    if (pos >= segment->start && !segment->failed &&
+        pos < segment->start + (int64_t)segment->data.size() + RANGE_MIN_CHUNK)
+    {
+      segment->readPos = (size_t)(pos - segment->start);
+      m_pos = pos;
+      Schedule();
+      return true;
+    }
+    break;
+  }
+
+  // a backward seek within the segment being read needs no new request either
+  if (!m_segments.empty() && pos < m_pos)
+  {
+    Segment* segment = m_segments.front();
+    if (pos >= segment->start)
+    {
+      segment->readPos = (size_t)(pos - segment->start);
+      m_pos = pos;
+      return true;
+    }
+  }
+
+  Clear();
+  m_pos = m_next = pos;
+  m_restarts++;
+  Schedule();
+  return true;
+}
+
+double CCurlRangeReader::GetDownloadSpeed() const
+{
+  if (m_busyTime == 0)
+    return 0.0;
+
+  return m_bytes * 1000.0 / m_busyTime;
+}
+
+size_t CCurlRangeReader::OnData(Segment* segment, char* buffer, size_t size)
+{
+  if (!segment->verified)
+  {
+    long code = 0;
+    g_curlInterface.easy_getinfo(segment->easy, CURLINFO_RESPONSE_CODE, &code);
+    if (code != 206)
+    {
+      if (!m_refused)
+        CLog::Log(LOGWARNING, "CCurlRangeReader - %s answered a range request with %ld", m_host.c_str(), code);
+      m_refused = true;
+      return 0; // aborts the transfer
+    }
+    segment->verified = true;
+  }
+
+  size_t wanted = (size_t)(segment->end - segment->start) - segment->data.size();
+  size_t amount = std::min(size, wanted);
+  segment->data.insert(segment->data.end(), buffer, buffer + amount);
+  m_bytes += amount;
+  return size;
+}
+
+void CCurlRangeReader::OnDone(Segment* segment, int result)
+{
+  StopTransfer(segment);
+
+  int64_t length = segment->end - segment->start;
+  if (result == CURLE_OK && (int64_t)segment->data.size() == length)
+  {
+    segment->done = true;
+
+    // only full chunks say something about the link
+    if (length == m_chunkSize)
+    {
+      unsigned int elapsed = XbmcThreads::SystemClockMillis() - segment->startTime;
+      if (elapsed < RANGE_TARGET_TIME / 2 && m_chunkSize < RANGE_MAX_CHUNK)
+        m_chunkSize *= 2;
+      else if (elapsed > RANGE_TARGET_TIME * 2 && m_chunkSize > RANGE_MIN_CHUNK)
+        m_chunkSize /= 2;
+    }
+    return;
+  }
+
+  if (!m_refused && segment->retries < g_advancedSettings.m_curlretries)
+  {
+    segment->retries++;
+    m_retries++;
+    CLog::Log(LOGWARNING, "CCurlRangeReader - range %" PRId64"-%" PRId64" of %s failed: %s(%d), retry %d",
+              segment->start, segment->end - 1, m_host.c_str(),
+              g_curlInterface.easy_strerror((CURLcode)result), result, segment->retries);
+
+    // resume where the failed transfer stopped
+    CURL_HANDLE* easy = m_idle.back();
+    m_idle.pop_back();
+    StartTransfer(segment, easy);
+    return;
+  }
+
+  if (!m_refused)
+    CLog::Log(LOGERROR, "CCurlRangeReader - range %" PRId64"-%" PRId64" of %s failed: %s(%d)",
+              segment->start, segment->end - 1, m_host.c_str(),
+              g_curlInterface.easy_strerror((CURLcode)result), result);
+  segment->failed = true;
+}
+
+void CCurlRangeReader::Schedule()
+{
+  while (!m_idle.empty() && m_next < m_fileSize && m_next - m_pos < GetWindow())
+  {
+    Segment* segment = new Segment();
+    segment->owner = this;
+    segment->easy = NULL;
+    segment->start = m_next;
+    segment->end = std::min(m_next + (int64_t)m_chunkSize, m_fileSize);
+    segment->data.reserve((size_t)(segment->end - segment->start));
+    segment->readPos = 0;
+    segment->startTime = XbmcThreads::SystemClockMillis();
+    segment->retries = 0;
+    segment->verified = false;
+    segment->done = false;
+    segment->failed = false;
+
+    m_next = segment->end;
+    m_segments.push_back(segment);
+    m_ranges++;
+
+    CURL_HANDLE* easy = m_idle.back();
+    m_idle.pop_back();
+    StartTransfer(segment, easy);
+  }
+}
+
+void CCurlRangeReader::StartTransfer(Segment* segment, CURL_HANDLE* easy)
+{
+  int64_t from = segment->start + segment->data.size();
+  std::string range = StringUtils::Format("%" PRId64"-%" PRId64, from, segment->end - 1);
+
+  g_curlInterface.easy_setopt(easy, CURLOPT_URL, m_url.c_str());
+  g_curlInterface.easy_setopt(easy, CURLOPT_RANGE, range.c_str());
+  g_curlInterface.easy_setopt(easy, CURLOPT_RESUME_FROM_LARGE, (curl_off_t)0);
+  g_curlInterface.easy_setopt(easy, CURLOPT_WRITEFUNCTION, range_write_callback);
+  g_curlInterface.easy_setopt(easy, CURLOPT_WRITEDATA, segment);
+  g_curlInterface.easy_setopt(easy, CURLOPT_HEADERFUNCTION, range_header_callback);
+  g_curlInterface.easy_setopt(easy, CURLOPT_WRITEHEADER, NULL);
+
+  if (m_idle.size() + 1 == m_handles.size())
+    m_lastPerform = XbmcThreads::SystemClockMillis();
+
+  segment->easy = easy;
+  segment->verified = false;
+  g_curlInterface.multi_add_handle(m_multiHandle, easy);
+}
+
+void CCurlRangeReader::StopTransfer(Segment* segment)
+{
+  if (!segment->easy)
+    return;
+
+  g_curlInterface.multi_remove_handle(m_multiHandle, segment->easy);
+  m_idle.push_back(segment->easy);
+  segment->easy = NULL;
+}
+
+void CCurlRangeReader::Clear()
+{
+  for (std::deque<Segment*>::iterator it = m_segments.begin(); it != m_segments.end(); ++it)
+  {
+    StopTransfer(*it);
+    delete *it;
+  }
+  m_segments.clear();
+}
+
+bool CCurlRangeReader::Perform(bool wait)
+{
+  bool active = m_idle.size() < m_handles.size();
+  if (!active)
+    return !wait;
+
+  if (wait)
+  {
+    fd_set fdread;
+    fd_set fdwrite;
+    fd_set fdexcep;
+    int maxfd = -1;
+    FD_ZERO(&fdread);
+    FD_ZERO(&fdwrite);
+    FD_ZERO(&fdexcep);
+    g_curlInterface.multi_fdset(m_multiHandle, &fdread, &fdwrite, &fdexcep, &maxfd);
+
+    long timeout = 0;
+    if (CURLM_OK != g_curlInterface.multi_timeout(m_multiHandle, &timeout) || timeout < 0 || timeout > 200)
+      timeout = 200;
+
+    int rc;
+    if (maxfd == -1)
+    {
+      // no sockets yet, sleep the minimum suggested by the curl_multi_fdset() doc
+#ifdef TARGET_WINDOWS
+      Sleep(100);
+#else
+      struct timeval tv = { 0, 100 * 1000 };
+      select(0, NULL, NULL, NULL, &tv);
+#endif
+      rc = 0;
+    }
+    else
+    {
+      struct timeval tv = { (int)timeout / 1000, ((int)timeout % 1000) * 1000 };
+      rc = select(maxfd + 1, &fdread, &fdwrite, &fdexcep, &tv);
+    }
+
+#ifdef TARGET_WINDOWS
+    if (rc == SOCKET_ERROR && WSAGetLastError() != WSAEINTR)
+#else
+    if (rc == SOCKET_ERROR && errno != EINTR)
+#endif
+    {
+      CLog::Log(LOGERROR, "CCurlRangeReader - select failed");
+      return false;
+    }
+  }
+
+  int running = 0;
+  CURLMcode result;
+  do
+  {
+    result = g_curlInterface.multi_perform(m_multiHandle, &running);
+  } while (result == CURLM_CALL_MULTI_PERFORM);
+
+  if (result != CURLM_OK)
+  {
+    CLog::Log(LOGERROR, "CCurlRangeReader - multi perform failed with code %d", result);
+    return false;
+  }
+
+  int msgs;
+  CURLMsg* msg;
+  while ((msg = g_curlInterface.multi_info_read(m_multiHandle, &msgs)))
+  {
+    if (msg->msg != CURLMSG_DONE)
+      continue;
+
+    // msg is invalidated by removing the handle
+    CURL_HANDLE* easy = msg->easy_handle;
+    int code = msg->data.result;
+    for (std::deque<Segment*>::iterator it = m_segments.begin(); it != m_segments.end(); ++it)
+    {
+      if ((*it)->easy == easy)
+      {
+        OnDone(*it, code);
+        break;
+      }
+    }
+  }
+
+  // data only flows while transfers are running, long pauses mean the
+  // consumer stopped reading and shouldn't count against the speed
+  unsigned int now = XbmcThreads::SystemClockMillis();
+  m_busyTime += std::min(now - m_lastPerform, 500u);
+  m_lastPerform = now;
+  return true;
+}
+
+int64_t CCurlRangeReader::GetWindow() const
+{
+  return (int64_t)m_chunkSize * m_handles.size() * 2;
+}
+
+int CCurlRangeReader::AcquireHostConnections(const std::string& host, int wanted)
+{
+  CSingleLock lock(m_hostSection);
+
+  // every reader gets at least one connection, same as a plain CCurlFile
+  int& used = m_hostConnections[host];
+  int count = std::max(1, std::min(wanted, g_advancedSettings.m_curlMaxHostConnections - used));
+  used += count;
+  return count;
+}
+
+void CCurlRangeReader::ReleaseHostConnections(const std::string& host, int count)
+{
+  CSingleLock lock(m_hostSection);
+
+  std::map<std::string, int>::iterator it = m_hostConnections.find(host);
+  if (it == m_hostConnections.end())
+    return;
+
+  it->second -= count;
+  if (it->second <= 0)
+    m_hostConnections.erase(it);
+}
@@ -0,0 +1,150 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <deque>
+#include <map>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "PlatformDefs.h" // for ssize_t
+#include "threads/CriticalSection.h"
+
+namespace XCURL
+{
+  typedef void CURL_HANDLE;
+  typedef void CURLM;
+}
+
+namespace XFILE
+{
+  /*!
+   * \brief Fetches a http resource as a sequence of byte ranges over several
+   * connections and hands the data back in file order.
+   *
+   * The easy handle of an already connected CCurlFile is duplicated once per
+   * connection, so all request options (headers, auth, proxy, ssl) carry
+   * over. Ranges are scheduled ahead of the read position up to a window of
+   * two chunks per connection. The chunk size adapts to the measured time per
+   * range: fast ranges double it, slow ones halve it. The number of
+   * connections opened to a single host is limited across all readers by
+   * advancedsettings <curlmaxhostconnections>.
+   */
+  class CCurlRangeReader
+  {
+  public:
+    /*!
+     * \param easy connected handle to duplicate, must not be part of a multi handle
+     * \param url effective url of the resource
+     * \param host host name used for the per host connection limit
+     * \param fileSize size of the resource in bytes
+     * \param connections wanted number of parallel connections
+     * \param cancelled flag polled while waiting for data
+     */
+    CCurlRangeReader(XCURL::CURL_HANDLE* easy, const std::string& url, const std::string& host,
+                     int64_t fileSize, int connections, const bool& cancelled);
+    ~CCurlRangeReader();
+
+    /*!
+     * \brief Start fetching at pos and wait for the first data.
+     * \return false if the server refused ranges or the request failed
+     */
+    bool Open(int64_t pos);
+    ssize_t Read(void* lpBuf, size_t uiBufSize);
+    /*!
+     * \brief Move the read position. Data already received for the new position
+     * is kept, otherwise all transfers are restarted there.
+     */
+    bool Seek(int64_t pos);
+    int64_t GetPosition() const { return m_pos; }
+
+    /*!
+     * \brief True once the server answered a range request with anything other
+     * than 206 Partial Content. The caller should fall back to a single stream.
+     */
+    bool RangesRefused() const { return m_refused; }
+    double GetDownloadSpeed() const;
+    int GetConnections() const { return (int)m_handles.size(); }
+    unsigned int GetChunkSize() const { return m_chunkSize; }
+
+    struct Segment
+    {
+      CCurlRangeReader* owner;
+      XCURL::CURL_HANDLE* easy; //!< handle while the transfer is running
+      int64_t start;
+      int64_t end;              //!< exclusive
+      std::vector<char> data;
+      size_t readPos;
+      unsigned int startTime;
+      int retries;
+      bool verified;            //!< response of the current transfer is 206
+      bool done;
+      bool failed;
+    };
+
+    /*!
+     * \brief Called by curl with data received for a segment.
+     */
+    size_t OnData(Segment* segment, char* buffer, size_t size);
+
+  private:
+    CCurlRangeReader(const CCurlRangeReader&) = delete;
+    CCurlRangeReader& operator=(const CCurlRangeReader&) = delete;
+
+    void OnDone(Segment* segment, int result);
+
+    void Schedule();
+    void StartTransfer(Segment* segment, XCURL::CURL_HANDLE* easy);
+    void StopTransfer(Segment* segment);
+    void Clear();
+    bool Perform(bool wait);
+    int64_t GetWindow() const;
+
+    static int AcquireHostConnections(const std::string& host, int wanted);
+    static void ReleaseHostConnections(const std::string& host, int count);
+
+    XCURL::CURLM* m_multiHandle;
+    std::vector<XCURL::CURL_HANDLE*> m_handles;
+    std::vector<XCURL::CURL_HANDLE*> m_idle;
+    std::deque<Segment*> m_segments;
+
+    std::string m_url;
+    std::string m_host;
+    int64_t m_fileSize;
+    int64_t m_pos;
+    int64_t m_next;           //!< first byte not yet scheduled
+    unsigned int m_chunkSize;
+    const bool& m_cancelled;
+    bool m_refused;
+
+    // statistics
+    int64_t m_bytes;
+    unsigned int m_busyTime;
+    unsigned int m_lastPerform;
+    unsigned int m_ranges;
+    unsigned int m_retries;
+    unsigned int m_restarts;
+
+    static CCriticalSection m_hostSection;
+    static std::map<std::string, int> m_hostConnections;
+  };
+}
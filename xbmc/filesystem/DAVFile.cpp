@@ -53,6 +53,7 @@ bool CDAVFile::Execute(const CURL& url)
   if( m_state->m_easyHandle == NULL )
     g_curlInterface.easy_aquire(url2.GetProtocol().c_str(),
                                 url2.GetHostName().c_str(),
+                                url2.GetPort(),
                                 &m_state->m_easyHandle,
                                 &m_state->m_multiHandle);
 
@@ -0,0 +1,220 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DiskRingCache.h"
+
+#include <algorithm>
+
+#include "SpecialProtocol.h"
+#include "threads/SingleLock.h"
+#include "Util.h"
+#include "utils/log.h"
+
+#ifdef TARGET_WINDOWS
+#include "win32/WIN32Util.h"
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+using namespace XFILE;
+
+CDiskRingCache::CDiskRingCache(size_t size, size_t hotWindow)
+ : CCircularCache(size / 2, size - size / 2)
+ , m_ringSize(size)
+ , m_hotWindow(hotWindow)
+ , m_readRate(0)
+ , m_hotChunk(-1)
+#ifdef TARGET_WINDOWS
+ , m_file(INVALID_HANDLE_VALUE)
+#else
+ , m_fd(-1)
+#endif
+{
+}
+
+CDiskRingCache::~CDiskRingCache()
+{
+  Close();
+}
+
+int CDiskRingCache::Open()
+{
+  Close();
+
+  m_filename = CSpecialProtocol::TranslatePath(CUtil::GetNextFilename("special://temp/filecache%03d.ring", 999));
+  if (m_filename.empty())
+  {
+    CLog::Log(LOGERROR, "%s - Unable to generate a new filename", __FUNCTION__);
+    return CACHE_RC_ERROR;
+  }
+
+#ifdef TARGET_WINDOWS
+  m_file = CreateFileW(CWIN32Util::ConvertPathToWin32Form(m_filename).c_str(), GENERIC_READ | GENERIC_WRITE, 0, NULL,
+                       CREATE_ALWAYS, FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE, NULL);
+  if (m_file == INVALID_HANDLE_VALUE)
+  {
+    CLog::LogF(LOGERROR, "failed to create file \"%s\"", m_filename.c_str());
+    Close();
+    return CACHE_RC_ERROR;
+  }
+
+  // don't allocate what was never written
+  DWORD bytes;
+  DeviceIoControl(m_file, FSCTL_SET_SPARSE, NULL, 0, NULL, 0, &bytes, NULL);
+
+  m_handle = CreateFileMapping(m_file, NULL, PAGE_READWRITE, (DWORD)((uint64_t)m_size >> 32), (DWORD)m_size, NULL);
+  if (m_handle == NULL)
+  {
+    Close();
+    return CACHE_RC_ERROR;
+  }
+  m_buf = (uint8_t*)MapViewOfFile(m_handle, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+#else
+  m_fd = open(m_filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+  if (m_fd < 0)
+  {
+    CLog::LogF(LOGERROR, "failed to create file \"%s\"", m_filename.c_str());
+    Close();
+    return CACHE_RC_ERROR;
+  }
+
+  // the mapping stays valid, this way nothing is left behind on a crash
+  unlink(m_filename.c_str());
+
+  // sparse, blocks only hit the disk once written
+  if (ftruncate(m_fd, m_size) != 0)
+  {
+    CLog::LogF(LOGERROR, "failed to size file \"%s\"", m_filename.c_str());
+    Close();
+    return CACHE_RC_ERROR;
+  }
+
+  m_buf = (uint8_t*)mmap(NULL, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+  if (m_buf == MAP_FAILED)
+    m_buf = NULL;
+#endif
+  if (m_buf == NULL)
+  {
+    CLog::LogF(LOGERROR, "failed to map %zu bytes of \"%s\"", m_size, m_filename.c_str());
+    Close();
+    return CACHE_RC_ERROR;
+  }
+
+  ClearBlocks();
+  m_cur = 0;
+  m_write = 0;
+  m_hotChunk = -1;
+  return CACHE_RC_OK;
+}
+
+void CDiskRingCache::Close()
+{
+#ifdef TARGET_WINDOWS
+  if (m_buf)
+    UnmapViewOfFile(m_buf);
+  if (m_handle != NULL && m_handle != INVALID_HANDLE_VALUE)
+    CloseHandle(m_handle);
+  if (m_file != INVALID_HANDLE_VALUE)
+    CloseHandle(m_file);
+  m_handle = INVALID_HANDLE_VALUE;
+  m_file = INVALID_HANDLE_VALUE;
+#else
+  if (m_buf)
+    munmap(m_buf, m_size);
+  if (m_fd >= 0)
+    close(m_fd);
+  m_fd = -1;
+#endif
+  m_buf = NULL;
+  m_blocks.clear();
+  m_chunks.clear();
+  m_filename.clear();
+}
+
+size_t CDiskRingCache::GetForwardLimit()
+{
+  if (m_readRate == 0)
+    return m_size_front;
+
+  // keep a quarter of the ring for history at least
+  uint64_t wanted = (uint64_t)m_readRate * READAHEAD_SECONDS;
+  uint64_t limit = m_ringSize - m_ringSize / 4;
+  return (size_t)std::max<uint64_t>(std::min(wanted, limit), 4 * m_blockSize);
+}
+
+void CDiskRingCache::Advise(const Block& block, bool hot)
+{
+#ifndef TARGET_WINDOWS
+  uint8_t* addr = GetBlockData(block);
+  if (hot)
+    madvise(addr, m_blockSize, MADV_WILLNEED);
+  else
+  {
+    // start writeback now, pages can be dropped without stalling later
+    msync(addr, m_blockSize, MS_ASYNC);
+    madvise(addr, m_blockSize, MADV_DONTNEED);
+  }
+#endif
+}
+
+/**
+ * Keep the blocks from the read position up to the hot window resident and
+ * release the one the reader just left.
+ */
+void CDiskRingCache::OnReadPosition()
+{
+  int64_t chunk = m_cur / m_blockSize;
+  if (chunk == m_hotChunk)
+    return;
+
+  int64_t window = (int64_t)(m_hotWindow / m_blockSize);
+  Block* left = m_hotChunk >= 0 ? FindBlock(m_hotChunk) : NULL;
+  if (left && (m_hotChunk < chunk || m_hotChunk - chunk > window))
+    Advise(*left, false);
+
+  m_hotChunk = chunk;
+  for (int64_t i = 0; i <= window; i++)
+  {
+    Block* block = FindBlock(chunk + i);
+    if (block)
+      Advise(*block, true);
+  }
+}
+
+void CDiskRingCache::OnBlockFilled(Block& block)
+{
+  // a block filled outside of the hot window doesn't need to stay in RAM
+  int64_t chunk = m_cur / m_blockSize;
+  if (block.chunk < chunk || block.chunk > chunk + (int64_t)(m_hotWindow / m_blockSize))
+    Advise(block, false);
+}
+
+void CDiskRingCache::SetReadRate(unsigned rate)
+{
+  CSingleLock lock(m_sync);
+  m_readRate = rate;
+}
+
+CCacheStrategy *CDiskRingCache::CreateNew()
+{
+  return new CDiskRingCache(m_ringSize, m_hotWindow);
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "CircularCache.h"
+
+#include <string>
+
+namespace XFILE {
+
+/**
+ * Cache strategy for long network streams on boxes that can't spare the
+ * RAM for a big CCircularCache. Same block index as CCircularCache, but
+ * the blocks live in a sparse temp file that is memory mapped.
+ *
+ * The forward part is sized from the rate the reader consumes data at, the
+ * rest of the ring keeps history. Only a window around the read position is
+ * kept resident, everything else is left to the kernel to write back and
+ * drop.
+ */
+class CDiskRingCache : public CCircularCache
+{
+public:
+  CDiskRingCache(size_t size, size_t hotWindow);
+  virtual ~CDiskRingCache();
+
+  virtual int Open();
+  virtual void Close();
+
+  virtual void SetReadRate(unsigned rate);
+  virtual size_t GetForwardLimit();
+
+  virtual CCacheStrategy *CreateNew();
+
+  static const unsigned int READAHEAD_SECONDS = 120;
+
+protected:
+  virtual void OnReadPosition();
+  virtual void OnBlockFilled(Block& block);
+
+  void Advise(const Block& block, bool hot);
+
+  size_t            m_ringSize;   /**< size asked for */
+  size_t            m_hotWindow;  /**< bytes ahead of the reader kept resident */
+  unsigned          m_readRate;
+  int64_t           m_hotChunk;   /**< chunk the hot window was last set up for */
+  std::string       m_filename;
+#ifdef TARGET_WINDOWS
+  HANDLE            m_file;
+#else
+  int               m_fd;
+#endif
+};
+
+} // namespace XFILE
@@ -21,10 +21,12 @@
 #include "threads/SystemClock.h"
 #include "system.h"
 #include "DllLibCurl.h"
+#include "settings/AdvancedSettings.h"
 #include "threads/SingleLock.h"
 #include "utils/log.h"
 
 #include <assert.h>
+#include <string.h>
 
 #ifdef HAVE_OPENSSL
 #include "threads/Thread.h"
@@ -61,12 +63,32 @@ unsigned long ssl_thread_id(void)
 
 using namespace XCURL;
 
+extern "C" void share_lock_callback(CURL_HANDLE *handle, curl_lock_data data, curl_lock_access access, void *userptr)
+{
+  DllLibCurlGlobal* global = (DllLibCurlGlobal*)userptr;
+  if (data >= 0 && data < CURL_LOCK_DATA_LAST)
+    global->m_shareLocks[data].lock();
+}
+
+extern "C" void share_unlock_callback(CURL_HANDLE *handle, curl_lock_data data, void *userptr)
+{
+  DllLibCurlGlobal* global = (DllLibCurlGlobal*)userptr;
+  if (data >= 0 && data < CURL_LOCK_DATA_LAST)
+    global->m_shareLocks[data].unlock();
+}
+
 /* okey this is damn ugly. our dll loader doesn't allow for postload, preunload functions */
 static long g_curlReferences = 0;
 #if(0)
 static unsigned int g_curlTimeout = 0;
 #endif
 
+DllLibCurlGlobal::DllLibCurlGlobal()
+  : m_share(NULL)
+{
+  memset(&m_stats, 0, sizeof(m_stats));
+}
+
 bool DllLibCurlGlobal::Load()
 {
   CSingleLock lock(m_critSection);
@@ -91,6 +113,21 @@ bool DllLibCurlGlobal::Load()
   /* check idle will clean up the last one */
   g_curlReferences = 2;
 
+  /* one dns, ssl session and connection cache for all handles, so requests to
+   * a host can skip the lookup and handshakes made by an earlier request */
+  m_share = share_init();
+  if (m_share)
+  {
+    share_setopt(m_share, CURLSHOPT_LOCKFUNC, share_lock_callback);
+    share_setopt(m_share, CURLSHOPT_UNLOCKFUNC, share_unlock_callback);
+    share_setopt(m_share, CURLSHOPT_USERDATA, this);
+    share_setopt(m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    share_setopt(m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+#if LIBCURL_VERSION_NUM >= 0x073900 // 7.57.0
+    share_setopt(m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+#endif
+  }
+
 #if defined(HAS_CURL_STATIC)
   // Initialize ssl locking array
   m_sslLockArray = new CCriticalSection*[CRYPTO_num_locks()];
@@ -112,6 +149,10 @@ void DllLibCurlGlobal::Unload()
     if (!IsLoaded())
       return;
 
+    if (m_share)
+      share_cleanup(m_share);
+    m_share = NULL;
+
     // close libcurl
     global_cleanup();
 
@@ -142,26 +183,15 @@ void DllLibCurlGlobal::CheckIdle()
     return;
 
   CSingleLock lock(m_critSection);
-  /* 20 seconds idle time before closing handle */
-  const unsigned int idletime = 30000;
+  /* keep idle sessions and their connections open this long */
+  const unsigned int idletime = g_advancedSettings.m_curlKeepAliveTime * 1000;
 
   VEC_CURLSESSIONS::iterator it = m_sessions.begin();
   while(it != m_sessions.end())
   {
     if( !it->m_busy && (XbmcThreads::SystemClockMillis() - it->m_idletimestamp) > idletime )
     {
-      CLog::Log(LOGINFO, "%s - Closing session to %s://%s (easy=%p, multi=%p)\n", __FUNCTION__, it->m_protocol.c_str(), it->m_hostname.c_str(), (void*)it->m_easy, (void*)it->m_multi);
-
-      // It's important to clean up multi *before* cleaning up easy, because the multi cleanup
-      // code accesses stuff in the easy's structure.
-      if(it->m_multi)
-        multi_cleanup(it->m_multi);
-      if(it->m_easy)
-        easy_cleanup(it->m_easy);
-
-      Unload();
-
-      it = m_sessions.erase(it);
+      it = CloseSession(it);
       continue;
     }
     ++it;
@@ -174,47 +204,57 @@ void DllLibCurlGlobal::CheckIdle()
 #endif
 }
 
-void DllLibCurlGlobal::easy_aquire(const char *protocol, const char *hostname, CURL_HANDLE** easy_handle, CURLM** multi_handle)
+void DllLibCurlGlobal::easy_aquire(const char *protocol, const char *hostname, int port, CURL_HANDLE** easy_handle, CURLM** multi_handle)
 {
   assert(easy_handle != NULL);
 
   CSingleLock lock(m_critSection);
 
+  m_stats.m_requests++;
+
+  /* allow reuse of requester is trying to connect to same host */
+  /* curl will take care of any differences in username/password */
+  /* prefer the session released last, its connection is the least likely to be closed */
+  VEC_CURLSESSIONS::iterator best = m_sessions.end();
   VEC_CURLSESSIONS::iterator it;
   for(it = m_sessions.begin(); it != m_sessions.end(); ++it)
   {
-    if( !it->m_busy )
+    if( !it->m_busy && it->m_port == port
+     && it->m_protocol.compare(protocol) == 0 && it->m_hostname.compare(hostname) == 0 )
     {
-      /* allow reuse of requester is trying to connect to same host */
-      /* curl will take care of any differences in username/password */
-      if( it->m_protocol.compare(protocol) == 0 && it->m_hostname.compare(hostname) == 0)
-      {
-        it->m_busy = true;
-        if(easy_handle)
-        {
-          if(!it->m_easy)
-            it->m_easy = easy_init();
+      if (best == m_sessions.end() || (int)(it->m_idletimestamp - best->m_idletimestamp) > 0)
+        best = it;
+    }
+  }
 
-          *easy_handle = it->m_easy;
-        }
+  if (best != m_sessions.end())
+  {
+    m_stats.m_hits++;
+    best->m_busy = true;
+    if(easy_handle)
+    {
+      if(!best->m_easy)
+        best->m_easy = easy_init();
 
-        if(multi_handle)
-        {
-          if(!it->m_multi)
-            it->m_multi = multi_init();
+      *easy_handle = best->m_easy;
+    }
 
-          *multi_handle = it->m_multi;
-        }
+    if(multi_handle)
+    {
+      if(!best->m_multi)
+        best->m_multi = multi_init();
 
-        return;
-      }
+      *multi_handle = best->m_multi;
     }
+
+    return;
   }
 
   SSession session = {};
   session.m_busy = true;
   session.m_protocol = protocol;
   session.m_hostname = hostname;
+  session.m_port = port;
 
   /* count up global interface counter */
   Load();
@@ -234,7 +274,7 @@ void DllLibCurlGlobal::easy_aquire(const char *protocol, const char *hostname, C
   m_sessions.push_back(session);
 
 
-  CLog::Log(LOGINFO, "%s - Created session to %s://%s\n", __FUNCTION__, protocol, hostname);
+  CLog::Log(LOGINFO, "%s - Created session to %s://%s:%d\n", __FUNCTION__, protocol, hostname, port);
 
   return;
 
@@ -264,14 +304,45 @@ void DllLibCurlGlobal::easy_release(CURL_HANDLE** easy_handle, CURLM** multi_han
   {
     if( it->m_easy == easy && (multi == NULL || it->m_multi == multi) )
     {
+      /* count the last transfer and whether it could use an open connection */
+      long response = 0;
+      long connects = 0;
+      if (easy && easy_getinfo(easy, CURLINFO_RESPONSE_CODE, &response) == CURLE_OK && response > 0)
+      {
+        m_stats.m_transfers++;
+        if (easy_getinfo(easy, CURLINFO_NUM_CONNECTS, &connects) == CURLE_OK && connects == 0)
+          m_stats.m_reused++;
+      }
+
       /* reset session so next caller doesn't reuse options, only connections */
       /* will reset verbose too so it won't print that it closed connections on cleanup*/
       easy_reset(easy);
       it->m_busy = false;
       it->m_idletimestamp = XbmcThreads::SystemClockMillis();
-      return;
+      break;
     }
   }
+
+  /* keep the number of idle sessions bounded, dropping the oldest */
+  while (true)
+  {
+    VEC_CURLSESSIONS::iterator oldest = m_sessions.end();
+    int idle = 0;
+    for(it = m_sessions.begin(); it != m_sessions.end(); ++it)
+    {
+      if (it->m_busy)
+        continue;
+
+      idle++;
+      if (oldest == m_sessions.end() || (int)(it->m_idletimestamp - oldest->m_idletimestamp) < 0)
+        oldest = it;
+    }
+
+    if (idle <= g_advancedSettings.m_curlMaxIdleSessions)
+      break;
+
+    CloseSession(oldest);
+  }
 }
 
 CURL_HANDLE* DllLibCurlGlobal::easy_duphandle(CURL_HANDLE* easy_handle)
@@ -301,7 +372,7 @@ void DllLibCurlGlobal::easy_duplicate(CURL_HANDLE* easy, CURLM* multi, CURL_HAND
     *easy_out = DllLibCurl::easy_duphandle(easy);
 
   if(multi_out && multi)
-    *multi_out = DllLibCurl::multi_init();
+    *multi_out = multi_init();
 
   VEC_CURLSESSIONS::iterator it;
   for(it = m_sessions.begin(); it != m_sessions.end(); ++it)
@@ -326,3 +397,49 @@ void DllLibCurlGlobal::easy_duplicate(CURL_HANDLE* easy, CURLM* multi, CURL_HAND
   }
   return;
 }
+
+void DllLibCurlGlobal::easy_share(CURL_HANDLE* easy_handle)
+{
+  if (m_share)
+    easy_setopt(easy_handle, CURLOPT_SHARE, m_share);
+}
+
+CURLM* DllLibCurlGlobal::multi_init(void)
+{
+  CURLM* multi = DllLibCurl::multi_init();
+  if (multi && g_advancedSettings.m_curlPipelining)
+  {
+#ifdef CURLPIPE_MULTIPLEX
+    multi_setopt(multi, CURLMOPT_PIPELINING, CURLPIPE_HTTP1 | CURLPIPE_MULTIPLEX);
+#else
+    multi_setopt(multi, CURLMOPT_PIPELINING, 1L);
+#endif
+  }
+  return multi;
+}
+
+DllLibCurlGlobal::SPoolStats DllLibCurlGlobal::GetPoolStats()
+{
+  CSingleLock lock(m_critSection);
+  return m_stats;
+}
+
+DllLibCurlGlobal::VEC_CURLSESSIONS::iterator DllLibCurlGlobal::CloseSession(VEC_CURLSESSIONS::iterator it)
+{
+  CLog::Log(LOGINFO, "%s - Closing session to %s://%s:%d (easy=%p, multi=%p)\n", __FUNCTION__, it->m_protocol.c_str(), it->m_hostname.c_str(), it->m_port, (void*)it->m_easy, (void*)it->m_multi);
+
+  // It's important to clean up multi *before* cleaning up easy, because the multi cleanup
+  // code accesses stuff in the easy's structure.
+  if(it->m_multi)
+    multi_cleanup(it->m_multi);
+  if(it->m_easy)
+    easy_cleanup(it->m_easy);
+
+  Unload();
+
+  m_stats.m_closed++;
+  CLog::Log(LOGDEBUG, "%s - pool: %u of %u sessions reused, %u of %u transfers on open connections, %u closed",
+            __FUNCTION__, m_stats.m_hits, m_stats.m_requests, m_stats.m_reused, m_stats.m_transfers, m_stats.m_closed);
+
+  return m_sessions.erase(it);
+}
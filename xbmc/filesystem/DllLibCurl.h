@@ -53,6 +53,10 @@ namespace XCURL
     virtual CURLMcode multi_timeout(CURLM *multi_handle, long *timeout)=0;
     virtual CURLMsg*  multi_info_read(CURLM *multi_handle, int *msgs_in_queue)=0;
     virtual void multi_cleanup(CURL_HANDLE * handle )=0;
+    //virtual CURLMcode multi_setopt(CURLM *multi_handle, CURLMoption option, ...)=0;
+    virtual CURLSH * share_init(void)=0;
+    //virtual CURLSHcode share_setopt(CURLSH *share, CURLSHoption option, ...)=0;
+    virtual CURLSHcode share_cleanup(CURLSH *share)=0;
     virtual struct curl_slist* slist_append(struct curl_slist *, const char *)=0;
     virtual void  slist_free_all(struct curl_slist *)=0;
   };
@@ -78,6 +82,10 @@ namespace XCURL
     DEFINE_METHOD2(CURLMcode, multi_timeout, (CURLM *p1, long *p2))
     DEFINE_METHOD2(CURLMsg*,  multi_info_read, (CURLM *p1, int *p2))
     DEFINE_METHOD1(void, multi_cleanup, (CURLM *p1))
+    DEFINE_METHOD_FP(CURLMcode, multi_setopt, (CURLM *p1, CURLMoption p2, ...))
+    DEFINE_METHOD0(CURLSH *, share_init)
+    DEFINE_METHOD_FP(CURLSHcode, share_setopt, (CURLSH *p1, CURLSHoption p2, ...))
+    DEFINE_METHOD1(CURLSHcode, share_cleanup, (CURLSH *p1))
     DEFINE_METHOD2(struct curl_slist*, slist_append, (struct curl_slist * p1, const char * p2))
     DEFINE_METHOD1(void, slist_free_all, (struct curl_slist * p1))
     DEFINE_METHOD1(const char *, easy_strerror, (CURLcode p1))
@@ -105,6 +113,10 @@ namespace XCURL
       RESOLVE_METHOD_RENAME(curl_multi_timeout, multi_timeout)
       RESOLVE_METHOD_RENAME(curl_multi_info_read, multi_info_read)
       RESOLVE_METHOD_RENAME(curl_multi_cleanup, multi_cleanup)
+      RESOLVE_METHOD_RENAME_FP(curl_multi_setopt, multi_setopt)
+      RESOLVE_METHOD_RENAME(curl_share_init, share_init)
+      RESOLVE_METHOD_RENAME_FP(curl_share_setopt, share_setopt)
+      RESOLVE_METHOD_RENAME(curl_share_cleanup, share_cleanup)
       RESOLVE_METHOD_RENAME(curl_slist_append, slist_append)
       RESOLVE_METHOD_RENAME(curl_slist_free_all, slist_free_all)
 #if defined(HAS_CURL_STATIC)
@@ -118,13 +130,30 @@ namespace XCURL
   class DllLibCurlGlobal : public DllLibCurl
   {
   public:
+    DllLibCurlGlobal();
+
     /* extend interface with buffered functions */
-    void easy_aquire(const char *protocol, const char *hostname, CURL_HANDLE** easy_handle, CURLM** multi_handle);
+    void easy_aquire(const char *protocol, const char *hostname, int port, CURL_HANDLE** easy_handle, CURLM** multi_handle);
     void easy_release(CURL_HANDLE** easy_handle, CURLM** multi_handle);
     void easy_duplicate(CURL_HANDLE* easy, CURLM* multi, CURL_HANDLE** easy_out, CURLM** multi_out);
     CURL_HANDLE* easy_duphandle(CURL_HANDLE* easy_handle);
+    /* attach the shared dns, ssl session and connection cache, needed after every easy_reset */
+    void easy_share(CURL_HANDLE* easy_handle);
+    /* new multi handles get pipelining enabled if configured */
+    virtual CURLM* multi_init(void);
     void CheckIdle();
 
+    /* statistics of the session pool */
+    typedef struct SPoolStats
+    {
+      unsigned int  m_requests;       // sessions handed out by easy_aquire
+      unsigned int  m_hits;           // ... which reused an idle session
+      unsigned int  m_transfers;      // finished transfers seen on release
+      unsigned int  m_reused;         // ... which didn't need a new connection
+      unsigned int  m_closed;         // idle sessions closed
+    } SPoolStats;
+    SPoolStats GetPoolStats();
+
     /* overloaded load and unload with reference counter */
     virtual bool Load();
     virtual void Unload();
@@ -135,6 +164,7 @@ namespace XCURL
       unsigned int  m_idletimestamp;  // timestamp of when this object when idle
       std::string   m_protocol;
       std::string   m_hostname;
+      int           m_port;
       bool          m_busy;
       CURL_HANDLE*  m_easy;
       CURLM*        m_multi;
@@ -144,6 +174,13 @@ namespace XCURL
 
     VEC_CURLSESSIONS m_sessions;
     CCriticalSection m_critSection;
+
+    CURLSH*          m_share;
+    CCriticalSection m_shareLocks[CURL_LOCK_DATA_LAST];
+    SPoolStats       m_stats;
+
+  private:
+    VEC_CURLSESSIONS::iterator CloseSession(VEC_CURLSESSIONS::iterator it);
   };
 }
 
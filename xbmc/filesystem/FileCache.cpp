@@ -25,6 +25,7 @@
 #include "URL.h"
 
 #include "CircularCache.h"
+#include "DiskRingCache.h"
 #include "threads/SingleLock.h"
 #include "utils/log.h"
 #include "settings/AdvancedSettings.h"
@@ -103,7 +104,8 @@ CFileCache::CFileCache(const unsigned int flags)
   , m_chunkSize(0)
   , m_writeRate(0)
   , m_writeRateActual(0)
-  , m_forwardCacheSize(0)
+  , m_readBytes(0)
+  , m_refillBytes(0)
   , m_fileSize(0)
   , m_flags(flags)
 {
@@ -115,7 +117,8 @@ CFileCache::CFileCache(CCacheStrategy *pCache, bool bDeleteCache /* = true */)
   , m_chunkSize(0)
   , m_writeRate(0)
   , m_writeRateActual(0)
-  , m_forwardCacheSize(0)
+  , m_readBytes(0)
+  , m_refillBytes(0)
 {
   m_pCache = pCache;
   m_bDeleteCache = bDeleteCache;
@@ -179,11 +182,19 @@ bool CFileCache::Open(const CURL& url)
 
   if (!m_pCache)
   {
-    if (g_advancedSettings.m_cacheMemBufferSize == 0)
+    if (g_advancedSettings.m_cacheDiskRingSize > 0 && (m_flags & READ_AUDIO_VIDEO))
+    {
+      // long a/v streams go to a mapped ring on disk, only the part around
+      // the read position is kept in RAM
+      size_t ringSize = g_advancedSettings.m_cacheDiskRingSize;
+      if (m_flags & READ_MULTI_STREAM)
+        ringSize /= 2;
+      m_pCache = new CDiskRingCache(ringSize, g_advancedSettings.m_cacheRamWindow);
+    }
+    else if (g_advancedSettings.m_cacheMemBufferSize == 0)
     {
       // Use cache on disk
       m_pCache = new CSimpleFileCache();
-      m_forwardCacheSize = 0;
     }
     else
     {
@@ -208,7 +219,6 @@ bool CFileCache::Open(const CURL& url)
         back /= 2;
       }
       m_pCache = new CCircularCache(front, back);
-      m_forwardCacheSize = front;
     }
 
     if (m_flags & READ_MULTI_STREAM)
@@ -230,6 +240,8 @@ bool CFileCache::Open(const CURL& url)
   m_writePos = 0;
   m_writeRate = 1024 * 1024;
   m_writeRateActual = 0;
+  m_readBytes = 0;
+  m_refillBytes = 0;
   m_seekEvent.Reset();
   m_seekEnded.Reset();
 
@@ -407,6 +419,7 @@ void CFileCache::Process()
     }
 
     m_writePos += iTotalWrite;
+    m_refillBytes += iTotalWrite;
 
     // under estimate write rate by a second, to
     // avoid uncertainty at start of caching
@@ -455,6 +468,7 @@ retry:
   if (iRc > 0)
   {
     m_readPos += iRc;
+    m_readBytes += iRc;
     return (int)iRc;
   }
 
@@ -532,8 +546,22 @@ int64_t CFileCache::Seek(int64_t iFilePosition, int iWhence)
     m_seekEvent.Reset();
   }
   else
+  {
     m_readPos = iTarget;
 
+    /* landed in a range cached earlier, move the source to its end so
+     * filling continues there instead of after the range we left */
+    if (m_seekPossible != 0 && !m_pCache->IsWriteRange(iTarget))
+    {
+      m_seekPos = iTarget;
+      m_seekEvent.Set();
+      if (!m_seekEnded.Wait())
+        CLog::Log(LOGWARNING,"%s - moving source to end of range at %" PRId64" failed.", __FUNCTION__, iTarget);
+      m_seekEvent.Reset();
+      m_nSeekResult = iTarget;
+    }
+  }
+
   return m_nSeekResult;
 }
 
@@ -589,15 +617,22 @@ int CFileCache::IoControl(EIoControl request, void* param)
   {
     SCacheStatus* status = (SCacheStatus*)param;
     status->forward = m_pCache->WaitForData(0, 0);
-    status->level   = (m_forwardCacheSize == 0) ? 0.0 : (float) status->forward / m_forwardCacheSize;
+    // the disk ring sizes its forward part from the read rate, a lower rate
+    // can leave more than the current limit cached
+    size_t forwardLimit = m_pCache->GetForwardLimit();
+    status->level   = (forwardLimit == 0) ? 0.0 : std::min(1.0f, (float) status->forward / forwardLimit);
     status->maxrate = m_writeRate;
     status->currate = m_writeRateActual;
+    status->cached  = m_pCache->GetCachedBytes();
+    status->read    = m_readBytes;
+    status->refill  = m_refillBytes;
     return 0;
   }
 
   if (request == IOCTRL_CACHE_SETRATE)
   {
     m_writeRate = *(unsigned*)param;
+    m_pCache->SetReadRate(m_writeRate);
     return 0;
   }
 
@@ -77,7 +77,8 @@ namespace XFILE
     unsigned     m_chunkSize;
     unsigned     m_writeRate;
     unsigned     m_writeRateActual;
-    int64_t      m_forwardCacheSize;
+    std::atomic<uint64_t> m_readBytes;   /**< bytes handed to the reader */
+    std::atomic<uint64_t> m_refillBytes; /**< bytes fetched from the source */
     std::atomic<int64_t> m_fileSize;
     unsigned int m_flags;
     CCriticalSection m_sync;
@@ -61,6 +61,9 @@ struct SCacheStatus
   unsigned maxrate;  /**< maximum number of bytes per second cache is allowed to fill */
   unsigned currate;  /**< average read rate from source file since last position change */
   float    level;    /**< cache level (0.0 - 1.0) */
+  uint64_t cached;   /**< number of bytes held by the cache, all ranges */
+  uint64_t read;     /**< number of bytes read from the cache since open */
+  uint64_t refill;   /**< number of bytes fetched from source since open */
 };
 
 typedef enum {
@@ -0,0 +1,319 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "filesystem/CircularCache.h"
+#include "test/TestUtils.h"
+
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace XFILE;
+
+namespace
+{
+
+char Pattern(int64_t pos)
+{
+  return (char)(pos % 251);
+}
+
+void Fill(CCircularCache &cache, int64_t pos, size_t len)
+{
+  std::vector<char> data(len);
+  for (size_t i = 0; i < len; i++)
+    data[i] = Pattern(pos + i);
+
+  size_t done = 0;
+  while (done < len)
+  {
+    int written = cache.WriteToCache(data.data() + done, len - done);
+    ASSERT_GT(written, 0);
+    done += written;
+  }
+}
+
+bool Verify(CCircularCache &cache, int64_t pos, size_t len)
+{
+  std::vector<char> data(len);
+  size_t done = 0;
+  while (done < len)
+  {
+    int read = cache.ReadFromCache(data.data() + done, len - done);
+    if (read <= 0)
+      return false;
+    done += read;
+  }
+
+  for (size_t i = 0; i < len; i++)
+  {
+    if (data[i] != Pattern(pos + i))
+      return false;
+  }
+  return true;
+}
+
+/*
+ * Plays a seek trace against a cache the way CFileCache drives it. The
+ * source is throttled to four times the rate data is read at, like the
+ * default <readbufferfactor>.
+ *
+ * Trace lines are "seek <position>" or "read <bytes>", # starts a comment.
+ */
+class CTraceReplay
+{
+public:
+  CTraceReplay(CCircularCache &cache, bool keepRanges)
+    : m_cache(cache), m_keepRanges(keepRanges) {}
+
+  bool Run(std::istream &trace)
+  {
+    std::string line;
+    while (std::getline(trace, line))
+    {
+      std::istringstream in(line);
+      std::string op;
+      int64_t value;
+      if (!(in >> op) || op[0] == '#')
+        continue;
+      if (!(in >> value))
+        return false;
+
+      if (op == "seek")
+        Seek(value);
+      else if (op == "read")
+      {
+        if (!Read(value))
+          return false;
+      }
+      else
+        return false;
+    }
+    return true;
+  }
+
+  uint64_t fetched = 0;
+  unsigned sourceSeeks = 0;
+  unsigned hits = 0;
+  unsigned misses = 0;
+
+private:
+  void Seek(int64_t pos)
+  {
+    if (m_cache.Seek(pos) == pos)
+    {
+      hits++;
+      if (m_cache.IsWriteRange(pos))
+        return;
+    }
+    else
+      misses++;
+
+    // the old single range behaviour drops everything
+    int64_t end = m_keepRanges ? m_cache.CachedDataEndPosIfSeekTo(pos) : pos;
+    if (end != m_source)
+      sourceSeeks++;
+    m_source = end;
+    m_cache.Reset(pos, !m_keepRanges);
+  }
+
+  bool Read(int64_t len)
+  {
+    std::vector<char> buf(64 * 1024);
+    while (len > 0)
+    {
+      int read = m_cache.ReadFromCache(buf.data(), std::min<int64_t>(len, buf.size()));
+      if (read == CACHE_RC_WOULD_BLOCK)
+      {
+        if (Refill(buf.size()) == 0)
+          return false;
+        continue;
+      }
+      if (read <= 0)
+        return false;
+      len -= read;
+      Refill(read * 4);
+    }
+    return true;
+  }
+
+  size_t Refill(size_t budget)
+  {
+    std::vector<char> buf(64 * 1024);
+    size_t done = 0;
+    size_t size;
+    while (done < budget && (size = m_cache.GetMaxWriteSize(std::min(buf.size(), budget - done))) > 0)
+    {
+      int written = m_cache.WriteToCache(buf.data(), size);
+      if (written <= 0)
+        break;
+      m_source += written;
+      fetched += written;
+      done += written;
+    }
+    return done;
+  }
+
+  CCircularCache &m_cache;
+  bool m_keepRanges;
+  int64_t m_source = 0;
+};
+
+}
+
+TEST(TestCircularCache, ReadWrite)
+{
+  CCircularCache cache(3 * 1024 * 1024, 1024 * 1024);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  Fill(cache, 0, 2 * 1024 * 1024 + 100);
+  EXPECT_EQ(2 * 1024 * 1024 + 100, cache.CachedDataEndPos());
+  EXPECT_TRUE(Verify(cache, 0, 1024 * 1024 + 50));
+  EXPECT_EQ(1024 * 1024 + 50, cache.WaitForData(0, 0));
+
+  EXPECT_EQ(100, cache.Seek(100));
+  EXPECT_TRUE(Verify(cache, 100, 2 * 1024 * 1024));
+  EXPECT_EQ(CACHE_RC_WOULD_BLOCK, cache.ReadFromCache(NULL, 1));
+
+  // forward limit
+  EXPECT_EQ(3U * 1024 * 1024, cache.GetMaxWriteSize(8 * 1024 * 1024));
+  Fill(cache, 2 * 1024 * 1024 + 100, 3 * 1024 * 1024);
+  EXPECT_EQ(0U, cache.GetMaxWriteSize(1024));
+}
+
+TEST(TestCircularCache, MultipleRanges)
+{
+  CCircularCache cache(4 * 1024 * 1024, 4 * 1024 * 1024);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  Fill(cache, 0, 200000);
+
+  // jump ahead, the first range is kept
+  EXPECT_TRUE(cache.Reset(1000000, false));
+  Fill(cache, 1000000, 100000);
+  EXPECT_EQ(300000, cache.GetCachedBytes());
+
+  EXPECT_TRUE(cache.IsCachedPosition(1000));
+  EXPECT_TRUE(cache.IsCachedPosition(200000));
+  EXPECT_FALSE(cache.IsCachedPosition(500000));
+  EXPECT_FALSE(cache.IsWriteRange(1000));
+  EXPECT_TRUE(cache.IsWriteRange(1000010));
+  EXPECT_EQ(200000, cache.CachedDataEndPosIfSeekTo(1000));
+  EXPECT_EQ(1100000, cache.CachedDataEndPosIfSeekTo(1050000));
+  EXPECT_EQ(500000, cache.CachedDataEndPosIfSeekTo(500000));
+
+  // seek back, no data lost
+  EXPECT_EQ(1000, cache.Seek(1000));
+  EXPECT_TRUE(Verify(cache, 1000, 100000));
+  EXPECT_EQ(CACHE_RC_ERROR, cache.Seek(500000));
+
+  // continue filling the first range up into the second one
+  EXPECT_FALSE(cache.Reset(101000, false));
+  EXPECT_EQ(200000, cache.CachedDataEndPos());
+  Fill(cache, 200000, 850000);
+  EXPECT_TRUE(cache.IsWriteRange(101000));
+  EXPECT_EQ(1100000, cache.CachedDataEndPosIfSeekTo(101000));
+  EXPECT_TRUE(Verify(cache, 101000, 999000));
+
+  EXPECT_TRUE(cache.Reset(0, true));
+  EXPECT_EQ(0, cache.GetCachedBytes());
+  EXPECT_FALSE(cache.IsCachedPosition(1000));
+}
+
+TEST(TestCircularCache, EvictLeastRecentlyUsed)
+{
+  // 4 KiB blocks
+  CCircularCache cache(64 * 1024, 64 * 1024);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+  ASSERT_EQ(4096U, cache.GetBlockSize());
+
+  Fill(cache, 0, 32 * 1024);
+  EXPECT_TRUE(cache.Reset(1024 * 1024, false));
+  Fill(cache, 1024 * 1024, 32 * 1024);
+
+  // touch the first range again
+  EXPECT_EQ(0, cache.Seek(0));
+  EXPECT_TRUE(Verify(cache, 0, 32 * 1024));
+
+  // the third range needs more blocks than are free
+  EXPECT_TRUE(cache.Reset(2 * 1024 * 1024, false));
+  Fill(cache, 2 * 1024 * 1024, 64 * 1024);
+  EXPECT_TRUE(Verify(cache, 2 * 1024 * 1024, 64 * 1024));
+  Fill(cache, 2 * 1024 * 1024 + 64 * 1024, 32 * 1024);
+
+  EXPECT_FALSE(cache.IsCachedPosition(1024 * 1024));
+  EXPECT_TRUE(cache.IsCachedPosition(0));
+  EXPECT_EQ(32 * 1024, cache.CachedDataEndPosIfSeekTo(0));
+  EXPECT_EQ(2 * 1024 * 1024 + 96 * 1024, cache.CachedDataEndPosIfSeekTo(2 * 1024 * 1024));
+}
+
+TEST(TestCircularCache, KeepReaderRangeAfterSeek)
+{
+  // 4 KiB blocks
+  CCircularCache cache(64 * 1024, 64 * 1024);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+  ASSERT_EQ(4096U, cache.GetBlockSize());
+
+  Fill(cache, 0, 64 * 1024);
+  EXPECT_TRUE(cache.Reset(1024 * 1024, false));
+  Fill(cache, 1024 * 1024, 64 * 1024);
+
+  // the reader goes back while the writer still fills the other range,
+  // the range being read must not be recycled for it
+  EXPECT_EQ(0, cache.Seek(0));
+  Fill(cache, 1024 * 1024 + 64 * 1024, 64 * 1024);
+  EXPECT_EQ(64 * 1024, cache.CachedDataEndPosIfSeekTo(0));
+  EXPECT_TRUE(Verify(cache, 0, 64 * 1024));
+}
+
+TEST(TestCircularCache, DISABLED_ReplaySeekTrace)
+{
+  std::ifstream file(XBMC_REF_FILE_PATH("xbmc/filesystem/test/seektrace.txt").c_str());
+  ASSERT_TRUE(file.is_open());
+  std::stringstream trace;
+  trace << file.rdbuf();
+
+  CCircularCache single(48 * 1024 * 1024, 16 * 1024 * 1024);
+  CCircularCache multi(48 * 1024 * 1024, 16 * 1024 * 1024);
+  ASSERT_EQ(CACHE_RC_OK, single.Open());
+  ASSERT_EQ(CACHE_RC_OK, multi.Open());
+  CTraceReplay dropRanges(single, false);
+  CTraceReplay keepRanges(multi, true);
+
+  EXPECT_TRUE(dropRanges.Run(trace));
+  trace.clear();
+  trace.seekg(0);
+  auto start = std::chrono::steady_clock::now();
+  EXPECT_TRUE(keepRanges.Run(trace));
+  auto end = std::chrono::steady_clock::now();
+
+  // going back to a range that is still cached must not refetch it
+  ASSERT_LE(keepRanges.fetched, dropRanges.fetched);
+  ASSERT_LE(keepRanges.sourceSeeks, dropRanges.sourceSeeks);
+
+  RecordProperty("refetched_mib", static_cast<int>((dropRanges.fetched - keepRanges.fetched) / (1024 * 1024)));
+  RecordProperty("saved_source_seeks", static_cast<int>(dropRanges.sourceSeeks - keepRanges.sourceSeeks));
+  RecordProperty("seeks_into_cache", static_cast<int>(keepRanges.hits));
+  RecordProperty("replay_ms", static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()));
+}
@@ -0,0 +1,139 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "filesystem/DiskRingCache.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace XFILE;
+
+namespace
+{
+
+const size_t MB = 1024 * 1024;
+
+void Fill(CDiskRingCache &cache, int64_t pos, size_t len)
+{
+  std::vector<char> data(len);
+  for (size_t i = 0; i < len; i++)
+    data[i] = (char)((pos + i) % 251);
+
+  size_t done = 0;
+  while (done < len)
+  {
+    int written = cache.WriteToCache(data.data() + done, len - done);
+    ASSERT_GT(written, 0);
+    done += written;
+  }
+}
+
+bool Verify(CDiskRingCache &cache, int64_t pos, size_t len)
+{
+  std::vector<char> data(len);
+  size_t done = 0;
+  while (done < len)
+  {
+    int read = cache.ReadFromCache(data.data() + done, len - done);
+    if (read <= 0)
+      return false;
+    done += read;
+  }
+
+  for (size_t i = 0; i < len; i++)
+  {
+    if (data[i] != (char)((pos + i) % 251))
+      return false;
+  }
+  return true;
+}
+
+}
+
+TEST(TestDiskRingCache, ReadWrite)
+{
+  CDiskRingCache cache(8 * MB, 2 * MB);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  Fill(cache, 0, 3 * MB + 100);
+  EXPECT_EQ((int64_t)(3 * MB + 100), cache.CachedDataEndPos());
+  EXPECT_EQ((int64_t)(3 * MB + 100), cache.WaitForData(0, 0));
+  EXPECT_TRUE(Verify(cache, 0, MB + 50));
+  EXPECT_EQ((int64_t)(2 * MB + 50), cache.WaitForData(0, 0));
+
+  EXPECT_EQ(100, cache.Seek(100));
+  EXPECT_TRUE(Verify(cache, 100, 3 * MB));
+  EXPECT_EQ(CACHE_RC_WOULD_BLOCK, cache.ReadFromCache(NULL, 1));
+
+  cache.Close();
+}
+
+TEST(TestDiskRingCache, ForwardLimit)
+{
+  CDiskRingCache cache(8 * MB, 2 * MB);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  // unknown rate, half the ring
+  EXPECT_EQ(4 * MB, cache.GetMaxWriteSize(8 * MB));
+  Fill(cache, 0, 4 * MB);
+  EXPECT_EQ(0U, cache.GetMaxWriteSize(MB));
+
+  // rate is known, capped at three quarters
+  cache.SetReadRate(MB);
+  EXPECT_EQ(2 * MB, cache.GetMaxWriteSize(8 * MB));
+}
+
+TEST(TestDiskRingCache, MultipleRanges)
+{
+  CDiskRingCache cache(16 * MB, 2 * MB);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  Fill(cache, 0, 2 * MB);
+
+  // jump ahead, the first range is kept
+  EXPECT_TRUE(cache.Reset(5 * MB + 10, false));
+  Fill(cache, 5 * MB + 10, MB);
+  EXPECT_EQ((int64_t)(3 * MB), cache.GetCachedBytes());
+
+  EXPECT_TRUE(cache.IsCachedPosition(1000));
+  EXPECT_FALSE(cache.IsCachedPosition(3 * MB));
+  EXPECT_FALSE(cache.IsWriteRange(1000));
+  EXPECT_TRUE(cache.IsWriteRange(5 * MB + 20));
+  EXPECT_EQ((int64_t)(2 * MB), cache.CachedDataEndPosIfSeekTo(1000));
+  EXPECT_EQ((int64_t)(3 * MB), cache.CachedDataEndPosIfSeekTo(3 * MB));
+
+  // seek back, no data lost
+  EXPECT_EQ(1000, cache.Seek(1000));
+  EXPECT_TRUE(Verify(cache, 1000, MB));
+  EXPECT_EQ(CACHE_RC_ERROR, cache.Seek(3 * MB));
+
+  // continue filling the first range up to the second one
+  EXPECT_FALSE(cache.Reset(MB + 1000, false));
+  EXPECT_EQ((int64_t)(2 * MB), cache.CachedDataEndPos());
+  Fill(cache, 2 * MB, 3 * MB + 10);
+  EXPECT_TRUE(cache.IsWriteRange(MB + 1000));
+  EXPECT_EQ((int64_t)(6 * MB + 10), cache.CachedDataEndPosIfSeekTo(MB + 1000));
+  EXPECT_TRUE(Verify(cache, MB + 1000, 5 * MB - 990));
+
+  EXPECT_TRUE(cache.Reset(0, true));
+  EXPECT_EQ(0, cache.GetCachedBytes());
+  EXPECT_FALSE(cache.IsCachedPosition(1000));
+}
@@ -21,6 +21,7 @@
 #include "GUIBaseContainer.h"
 #include "utils/CharsetConverter.h"
 #include "GUIInfoManager.h"
+#include "GUITextLayout.h"
 #include "utils/TimeUtils.h"
 #include "utils/log.h"
 #include "utils/SortUtils.h"
@@ -60,6 +61,7 @@ CGUIBaseContainer::CGUIBaseContainer(int parentID, int controlID, float posX, fl
   m_autoScrollDelayTime = 0;
   m_autoScrollIsReversed = false;
   m_lastRenderTime = 0;
+  m_prefetchOffset = -1;
 }
 
 CGUIBaseContainer::~CGUIBaseContainer(void)
@@ -98,6 +100,9 @@ void CGUIBaseContainer::Process(unsigned int currentTime, CDirtyRegionList &dirt
 
   int offset = (int)floorf(m_scroller.GetValue() / m_layout->Size(m_orientation));
 
+  if (offset != m_prefetchOffset || m_bInvalidated)
+    PrefetchGlyphs(offset);
+
   int cacheBefore, cacheAfter;
   GetCacheOffsets(cacheBefore, cacheAfter);
 
@@ -147,6 +152,26 @@ void CGUIBaseContainer::Process(unsigned int currentTime, CDirtyRegionList &dirt
   CGUIControl::Process(currentTime, dirtyregions);
 }
 
+void CGUIBaseContainer::PrefetchGlyphs(int offset)
+{
+  m_prefetchOffset = offset;
+
+  std::vector<CGUIFont*> fonts;
+  m_layout->GetFonts(fonts);
+  m_focusedLayout->GetFonts(fonts);
+  if (fonts.empty())
+    return;
+
+  std::vector<std::string> labels;
+  for (int i = std::max(offset, 0); i < offset + 2 * m_itemsPerPage && i < (int)m_items.size(); i++)
+  {
+    labels.push_back(m_items[i]->GetLabel());
+    labels.push_back(m_items[i]->GetLabel2());
+  }
+  for (std::vector<CGUIFont*>::const_iterator font = fonts.begin(); font != fonts.end(); ++font)
+    CGUITextLayout::Prefetch(*font, labels);
+}
+
 void CGUIBaseContainer::ProcessItem(float posX, float posY, CGUIListItemPtr& item, bool focused, unsigned int currentTime, CDirtyRegionList &dirtyregions)
 {
   if (!m_focusedLayout || !m_layout) return;
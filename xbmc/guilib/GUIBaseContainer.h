@@ -172,6 +172,11 @@ protected:
                     // changing around)
 
   void UpdateScrollByLetter();
+  /*! \brief Queue the characters of the labels on the page starting at offset and the page after it
+   for rendering in the background, so scrolling there doesn't stall on rendering glyphs.
+   */
+  void PrefetchGlyphs(int offset);
+  int m_prefetchOffset;
   void GetCacheOffsets(int &cacheBefore, int &cacheAfter) const;
   int GetCacheCount() const { return m_cacheItems; };
   bool ScrollingDown() const { return m_scroller.IsScrollingDown(); };
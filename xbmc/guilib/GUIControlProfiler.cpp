@@ -23,10 +23,13 @@
 #include "utils/TimeUtils.h"
 #include "utils/StringUtils.h"
 
+#include <algorithm>
+
 bool CGUIControlProfiler::m_bIsRunning = false;
 
 CGUIControlProfilerItem::CGUIControlProfilerItem(CGUIControlProfiler *pProfiler, CGUIControlProfilerItem *pParent, CGUIControl *pControl)
 : m_pProfiler(pProfiler), m_pParent(pParent), m_pControl(pControl), m_visTime(0), m_renderTime(0), m_i64VisStart(0), m_i64RenderStart(0)
+, m_textureBinds(0), m_textureChanges(0), m_drawCalls(0), m_bindsStart(0), m_changesStart(0), m_drawsStart(0)
 {
   if (m_pControl)
   {
@@ -54,6 +57,9 @@ void CGUIControlProfilerItem::Reset(CGUIControlProfiler *pProfiler)
 
   m_visTime = 0;
   m_renderTime = 0;
+  m_textureBinds = 0;
+  m_textureChanges = 0;
+  m_drawCalls = 0;
   const unsigned int dwSize = m_vecChildren.size();
   for (unsigned int i=0; i<dwSize; ++i)
     delete m_vecChildren[i];
@@ -75,11 +81,18 @@ void CGUIControlProfilerItem::EndVisibility(void)
 void CGUIControlProfilerItem::BeginRender(void)
 {
   m_i64RenderStart = CurrentHostCounter();
+  m_bindsStart = m_pProfiler->GetTextureBinds();
+  m_changesStart = m_pProfiler->GetTextureChanges();
+  m_drawsStart = m_pProfiler->GetDrawCalls();
 }
 
 void CGUIControlProfilerItem::EndRender(void)
 {
   m_renderTime += (unsigned int)(m_pProfiler->m_fPerfScale * (CurrentHostCounter() - m_i64RenderStart));
+  // like the times, the counts of a control include those of its children
+  m_textureBinds += m_pProfiler->GetTextureBinds() - m_bindsStart;
+  m_textureChanges += m_pProfiler->GetTextureChanges() - m_changesStart;
+  m_drawCalls += m_pProfiler->GetDrawCalls() - m_drawsStart;
 }
 
 void CGUIControlProfilerItem::SaveToXML(TiXmlElement *parent)
@@ -202,6 +215,26 @@ void CGUIControlProfilerItem::SaveToXML(TiXmlElement *parent)
     elem->LinkEndChild(text);
   }
 
+  // counts are reported per frame
+  int frames = std::max(m_pProfiler->GetFrameCount(), 1);
+  if (m_drawCalls)
+  {
+    TiXmlElement *elem = new TiXmlElement("drawcalls");
+    xmlControl->LinkEndChild(elem);
+    std::string val = StringUtils::Format("%.1f", (float)m_drawCalls / frames);
+    elem->LinkEndChild(new TiXmlText(val.c_str()));
+
+    elem = new TiXmlElement("texturebinds");
+    xmlControl->LinkEndChild(elem);
+    val = StringUtils::Format("%.1f", (float)m_textureBinds / frames);
+    elem->LinkEndChild(new TiXmlText(val.c_str()));
+
+    elem = new TiXmlElement("texturechanges");
+    xmlControl->LinkEndChild(elem);
+    val = StringUtils::Format("%.1f", (float)m_textureChanges / frames);
+    elem->LinkEndChild(new TiXmlText(val.c_str()));
+  }
+
   if (m_vecChildren.size())
   {
     TiXmlElement *xmlChilds = new TiXmlElement("children");
@@ -238,6 +271,7 @@ CGUIControlProfilerItem *CGUIControlProfilerItem::FindOrAddControl(CGUIControl *
 
 CGUIControlProfiler::CGUIControlProfiler(void)
 : m_ItemHead(NULL, NULL, NULL), m_pLastItem(NULL), m_iMaxFrameCount(200), m_iFrameCount(0)
+, m_textureBinds(0), m_textureChanges(0), m_drawCalls(0), m_lastTexture(NULL)
 // m_bIsRunning(false), no isRunning because it is static
 {
   m_fPerfScale = 100000.0f / CurrentHostFrequency();
@@ -259,6 +293,10 @@ void CGUIControlProfiler::Start(void)
   m_iFrameCount = 0;
   m_bIsRunning = true;
   m_pLastItem = NULL;
+  m_textureBinds = 0;
+  m_textureChanges = 0;
+  m_drawCalls = 0;
+  m_lastTexture = NULL;
   m_ItemHead.Reset(this);
 }
 
@@ -326,6 +364,9 @@ void CGUIControlProfiler::EndFrame(void)
       m_ItemHead.m_visTime += p->m_visTime;
       m_ItemHead.m_renderTime += p->m_renderTime;
     }
+    m_ItemHead.m_textureBinds = m_textureBinds;
+    m_ItemHead.m_textureChanges = m_textureChanges;
+    m_ItemHead.m_drawCalls = m_drawCalls;
 
     m_bIsRunning = false;
     if (SaveResults())
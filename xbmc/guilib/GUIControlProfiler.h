@@ -24,6 +24,7 @@
 
 #include "GUIControl.h"
 
+class CBaseTexture;
 class CGUIControlProfiler;
 class TiXmlElement;
 
@@ -41,6 +42,12 @@ public:
   unsigned int m_renderTime;
   int64_t m_i64VisStart;
   int64_t m_i64RenderStart;
+  unsigned int m_textureBinds;   // texture units bound while rendering
+  unsigned int m_textureChanges; // binds of a different texture than the one before
+  unsigned int m_drawCalls;
+  unsigned int m_bindsStart;
+  unsigned int m_changesStart;
+  unsigned int m_drawsStart;
 
   CGUIControlProfilerItem(CGUIControlProfiler *pProfiler, CGUIControlProfilerItem *pParent, CGUIControl *pControl);
   ~CGUIControlProfilerItem(void);
@@ -69,7 +76,19 @@ public:
   void EndVisibility(CGUIControl *pControl);
   void BeginRender(CGUIControl *pControl);
   void EndRender(CGUIControl *pControl);
+  void AddTextureBind(const CBaseTexture *texture)
+  {
+    m_textureBinds++;
+    if (texture != m_lastTexture)
+      m_textureChanges++;
+    m_lastTexture = texture;
+  }
+  void AddDrawCall(void) { m_drawCalls++; }
+  unsigned int GetTextureBinds(void) const { return m_textureBinds; }
+  unsigned int GetTextureChanges(void) const { return m_textureChanges; }
+  unsigned int GetDrawCalls(void) const { return m_drawCalls; }
   int GetMaxFrameCount(void) const { return m_iMaxFrameCount; };
+  int GetFrameCount(void) const { return m_iFrameCount; };
   void SetMaxFrameCount(int iMaxFrameCount) { m_iMaxFrameCount = iMaxFrameCount; };
   void SetOutputFile(const std::string &strOutputFile) { m_strOutputFile = strOutputFile; };
   const std::string &GetOutputFile(void) const { return m_strOutputFile; };
@@ -91,11 +110,19 @@ private:
   std::string m_strOutputFile;
   int m_iMaxFrameCount;
   int m_iFrameCount;
+
+  // render statistics of the gui textures since Start()
+  unsigned int m_textureBinds;
+  unsigned int m_textureChanges;
+  unsigned int m_drawCalls;
+  const CBaseTexture *m_lastTexture;
 };
 
 #define GUIPROFILER_VISIBILITY_BEGIN(x) { if (CGUIControlProfiler::IsRunning()) CGUIControlProfiler::Instance().BeginVisibility(x); }
 #define GUIPROFILER_VISIBILITY_END(x) { if (CGUIControlProfiler::IsRunning()) CGUIControlProfiler::Instance().EndVisibility(x); }
 #define GUIPROFILER_RENDER_BEGIN(x) { if (CGUIControlProfiler::IsRunning()) CGUIControlProfiler::Instance().BeginRender(x); }
 #define GUIPROFILER_RENDER_END(x) { if (CGUIControlProfiler::IsRunning()) CGUIControlProfiler::Instance().EndRender(x); }
+#define GUIPROFILER_TEXTURE_BIND(x) { if (CGUIControlProfiler::IsRunning()) CGUIControlProfiler::Instance().AddTextureBind(x); }
+#define GUIPROFILER_DRAW_CALL() { if (CGUIControlProfiler::IsRunning()) CGUIControlProfiler::Instance().AddDrawCall(); }
 
 #endif
@@ -284,6 +284,12 @@ void CGUIFont::End()
   m_font->End();
 }
 
+void CGUIFont::Prefetch(const vecText &text)
+{
+  if (!m_font) return;
+  m_font->Prefetch(text);
+}
+
 void CGUIFont::SetFont(CGUIFontTTFBase *font)
 {
   if (m_font == font)
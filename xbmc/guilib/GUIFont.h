@@ -149,6 +149,10 @@ public:
   void Begin();
   void End();
 
+  /*! \brief Render the characters of text in the background, see CGUIFontTTFBase::Prefetch
+   */
+  void Prefetch(const vecText &text);
+
   uint32_t GetStyle() const { return m_style; };
 
   static wchar_t RemapGlyph(wchar_t letter);
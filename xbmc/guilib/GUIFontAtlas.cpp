@@ -0,0 +1,131 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "GUIFontAtlas.h"
+
+#include <algorithm>
+
+CGUIFontAtlas::CGUIFontAtlas()
+{
+  m_current = NO_PAGE;
+  m_width = 0;
+  m_lineHeight = 0;
+  m_maxPages = 0;
+  m_run = 0;
+  m_uploads = 0;
+  m_evictions = 0;
+}
+
+void CGUIFontAtlas::Reset(unsigned int width, unsigned int lineHeight, unsigned int maxHeight, unsigned int memoryLimit)
+{
+  m_width = width;
+  m_lineHeight = lineHeight;
+  m_maxPages = 0;
+  if (width && lineHeight)
+  {
+    unsigned int pageHeight = GetPageHeight();
+    m_maxPages = std::min(maxHeight / pageHeight, memoryLimit / (width * pageHeight));
+    // a single page must always be possible, even if it goes over the budget
+    m_maxPages = std::min(std::max(m_maxPages, 1U), NO_PAGE);
+  }
+  Clear();
+}
+
+void CGUIFontAtlas::Clear()
+{
+  m_pages.clear();
+  m_current = NO_PAGE;
+}
+
+const unsigned int CGUIFontAtlas::NO_PAGE;
+
+bool CGUIFontAtlas::Fit(Page &page, unsigned int cellWidth)
+{
+  if (page.x + cellWidth > m_width)
+  {
+    if (page.line + 1 >= FONT_ATLAS_PAGE_LINES)
+      return false;
+    page.line++;
+    page.x = 0;
+  }
+  return true;
+}
+
+unsigned int CGUIFontAtlas::Recycle()
+{
+  // recycle the least recently used page that isn't part of this run
+  unsigned int oldest = NO_PAGE;
+  for (unsigned int i = 0; i < m_pages.size(); i++)
+  {
+    if (m_pages[i].lastUsed != m_run &&
+        (oldest == NO_PAGE || m_run - m_pages[i].lastUsed > m_run - m_pages[oldest].lastUsed))
+      oldest = i;
+  }
+  if (oldest == NO_PAGE)
+    return NO_PAGE;
+
+  Page fresh = { m_run, 0, 0 };
+  m_current = oldest;
+  m_pages[oldest] = fresh;
+  m_evictions++;
+  return oldest;
+}
+
+unsigned int CGUIFontAtlas::EvictOldest()
+{
+  if (m_pages.size() < m_maxPages)
+    return NO_PAGE;
+  return Recycle();
+}
+
+bool CGUIFontAtlas::Allocate(unsigned int cellWidth, unsigned int &x, unsigned int &y, unsigned int &page, unsigned int &evicted, bool mayEvict)
+{
+  evicted = NO_PAGE;
+  if (cellWidth > m_width || m_maxPages == 0)
+    return false;
+
+  if (m_current == NO_PAGE || !Fit(m_pages[m_current], cellWidth))
+  {
+    if (m_pages.size() < m_maxPages)
+    {
+      Page fresh = { m_run, 0, 0 };
+      m_current = m_pages.size();
+      m_pages.push_back(fresh);
+    }
+    else
+    {
+      if (!mayEvict)
+        return false;
+      evicted = Recycle();
+      if (evicted == NO_PAGE)
+        return false;
+    }
+  }
+
+  Page &current = m_pages[m_current];
+  x = current.x;
+  y = GetPageTop(m_current) + current.line * m_lineHeight;
+  page = m_current;
+  current.x += cellWidth;
+  current.lastUsed = m_run;
+  m_uploads++;
+  return true;
+}
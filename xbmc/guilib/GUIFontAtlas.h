@@ -0,0 +1,133 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <vector>
+
+#define FONT_ATLAS_PAGE_LINES   8                 // texture lines per atlas page
+#define FONT_ATLAS_MEMORY_LIMIT (4 * 1024 * 1024) // bytes of glyph texture per font
+
+/*!
+ \ingroup textures
+ \brief Places glyph cells in a font texture that is split into pages.
+
+ A page is a horizontal band of FONT_ATLAS_PAGE_LINES texture lines. Pages are
+ filled line by line and the texture grows by one page at a time. Once the
+ maximum number of pages is reached, the least recently used page is handed
+ back to the caller for eviction instead of dropping every cached glyph.
+ Pages used during the current run (see NextRun()) are never evicted, so
+ glyphs collected for the string being laid out stay valid. While vertices
+ are being batched the font must not evict at all, it allocates with
+ mayEvict set to false and calls EvictOldest() once the batch is done.
+
+ The class only does the bookkeeping, the pixels are owned by the font.
+ */
+class CGUIFontAtlas
+{
+public:
+  static const unsigned int NO_PAGE = 0xffff;
+
+  CGUIFontAtlas();
+
+  /*!
+   \brief Set the geometry and drop all pages.
+   \param width width of the texture in pixels
+   \param lineHeight height of a texture line in pixels, including spacing
+   \param maxHeight largest texture height allowed
+   \param memoryLimit largest texture size allowed in bytes (8bit alpha)
+   */
+  void Reset(unsigned int width, unsigned int lineHeight, unsigned int maxHeight, unsigned int memoryLimit = FONT_ATLAS_MEMORY_LIMIT);
+
+  /*!
+   \brief Drop all pages, keeping the geometry.
+   */
+  void Clear();
+
+  /*!
+   \brief Find room for a glyph cell.
+   \param cellWidth width of the cell in pixels, including spacing
+   \param x [out] left edge of the cell in the texture
+   \param y [out] top edge of the cell in the texture
+   \param page [out] page the cell was placed in
+   \param evicted [out] page that was recycled to make room, or NO_PAGE. All
+   glyphs cached in it must be dropped by the caller.
+   \param mayEvict whether a page may be recycled if all pages are in use
+   \return false if the cell doesn't fit in any page that may be evicted
+   */
+  bool Allocate(unsigned int cellWidth, unsigned int &x, unsigned int &y, unsigned int &page, unsigned int &evicted, bool mayEvict = true);
+
+  /*!
+   \brief Recycle the least recently used page, new cells go there next.
+   \return the page that was recycled, or NO_PAGE. All glyphs cached in it
+   must be dropped by the caller.
+   */
+  unsigned int EvictOldest();
+
+  /*!
+   \brief Mark a page as used by the current run.
+   */
+  void Touch(unsigned int page)
+  {
+    if (page < m_pages.size())
+      m_pages[page].lastUsed = m_run;
+  }
+
+  /*!
+   \brief Start a new run, i.e. the layout of another string.
+   */
+  void NextRun() { m_run++; }
+
+  unsigned int GetPageCount() const { return m_pages.size(); }
+  unsigned int GetMaxPages() const { return m_maxPages; }
+  unsigned int GetPageHeight() const { return m_lineHeight * FONT_ATLAS_PAGE_LINES; }
+  unsigned int GetPageTop(unsigned int page) const { return page * GetPageHeight(); }
+
+  /*!
+   \brief Texture height needed to hold all pages in use.
+   */
+  unsigned int GetRequiredHeight() const { return m_pages.size() * GetPageHeight(); }
+
+  unsigned int GetUploads() const { return m_uploads; }
+  unsigned int GetEvictions() const { return m_evictions; }
+
+private:
+  struct Page
+  {
+    unsigned int lastUsed;
+    unsigned int line;
+    unsigned int x;
+  };
+
+  bool Fit(Page &page, unsigned int cellWidth);
+  unsigned int Recycle();
+
+  std::vector<Page> m_pages;
+  unsigned int m_current;            // page new cells go to
+  unsigned int m_width;
+  unsigned int m_lineHeight;
+  unsigned int m_maxPages;
+  unsigned int m_run;
+
+  // statistics
+  unsigned int m_uploads;
+  unsigned int m_evictions;
+};
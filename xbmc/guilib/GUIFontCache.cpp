@@ -32,19 +32,41 @@ class CGUIFontCacheImpl
     using HashIter = typename HashMap::iterator;
     using AgeMap = std::multimap<size_t, HashIter>;
 
+    EntryList() : memory(0) {}
+
+    /* Rough size of an entry, assuming each character becomes one quad */
+    static size_t EntrySize(const CGUIFontCacheEntry<Position, Value> *v)
+    {
+      return sizeof(*v) +
+             v->m_key.m_colors.size() * sizeof(color_t) +
+             v->m_key.m_text.size() * (sizeof(character_t) + 4 * sizeof(SVertex));
+    }
     HashIter Insert(size_t hash, CGUIFontCacheEntry<Position, Value> *v)
     {
       auto r (hashMap.insert(typename HashMap::value_type(hash, v)));
       if (r->second)
+      {
         ageMap.insert(typename AgeMap::value_type(r->second->m_lastUsedMillis, r));
+        memory += EntrySize(r->second);
+      }
       return r;
     }
+    /* Unlink the least recently used entry and hand it to the caller */
+    CGUIFontCacheEntry<Position, Value> *TakeOldest()
+    {
+      CGUIFontCacheEntry<Position, Value> *entry = ageMap.begin()->second->second;
+      memory -= EntrySize(entry);
+      hashMap.erase(ageMap.begin()->second);
+      ageMap.erase(ageMap.begin());
+      return entry;
+    }
     void Flush()
     {
       ageMap.clear();
       for (auto it = hashMap.begin(); it != hashMap.end(); ++it)
         delete(it->second);
       hashMap.clear();
+      memory = 0;
     }
     typename HashMap::iterator FindKey(CGUIFontCacheKey<Position> key)
     {
@@ -77,6 +99,7 @@ class CGUIFontCacheImpl
 
     HashMap hashMap;
     AgeMap ageMap;
+    size_t memory;
   };
 
   EntryList m_list;
@@ -163,11 +186,13 @@ Value &CGUIFontCacheImpl<Position, Value>::Lookup(Position &pos,
     dirtyCache = true;
     CGUIFontCacheEntry<Position, Value> *entry = nullptr;
     if (!m_list.ageMap.empty() && (nowMillis - m_list.ageMap.begin()->first) > FONT_CACHE_TIME_LIMIT)
-    {
-      entry = m_list.ageMap.begin()->second->second;
-      m_list.hashMap.erase(m_list.ageMap.begin()->second);
-      m_list.ageMap.erase(m_list.ageMap.begin());
-    }
+      entry = m_list.TakeOldest();
+
+    // Stay within the memory budget. Entries used recently are kept even when
+    // over budget, as their vertices may still be queued for rendering
+    while (m_list.memory > FONT_CACHE_MEMORY_LIMIT &&
+           !m_list.ageMap.empty() && (nowMillis - m_list.ageMap.begin()->first) > FONT_CACHE_TIME_LIMIT)
+      delete m_list.TakeOldest();
 
     // add new entry
     CGUIFontCacheHash<Position> hashgen;
@@ -41,6 +41,7 @@
 
 #define FONT_CACHE_TIME_LIMIT (1000)
 #define FONT_CACHE_DIST_LIMIT (0.01f)
+#define FONT_CACHE_MEMORY_LIMIT (2 * 1024 * 1024)
 
 template<class Position, class Value> class CGUIFontCache;
 class CGUIFontTTFBase;
@@ -107,14 +108,16 @@ struct CGUIFontCacheHash
 {
   size_t operator()(const CGUIFontCacheKey<Position> &key) const
   {
-    /* Not much effort has gone into choosing this hash function */
-    size_t hash = 0, i;
-    for (i = 0; i < 3 && i < key.m_text.size(); ++i)
-      hash += key.m_text[i];
-    if (key.m_colors.size())
-      hash += key.m_colors[0];
-    hash += MatrixHashContribution(key);
-    return hash;
+    /* FNV-1a over the whole string, as list labels often share long prefixes */
+    uint32_t hash = 2166136261U;
+    for (vecText::const_iterator it = key.m_text.begin(); it != key.m_text.end(); ++it)
+      hash = (hash ^ *it) * 16777619U;
+    for (vecColors::const_iterator it = key.m_colors.begin(); it != key.m_colors.end(); ++it)
+      hash = (hash ^ *it) * 16777619U;
+    hash = (hash ^ key.m_alignment) * 16777619U;
+    hash = (hash ^ (uint32_t)(int)key.m_maxPixelWidth) * 16777619U;
+    hash = (hash ^ (uint32_t)key.m_scrolling) * 16777619U;
+    return hash + (size_t)MatrixHashContribution(key);
   }
 };
 
@@ -251,6 +251,12 @@ void GUIFontManager::Unload(const std::string& strFontName)
   }
 }
 
+void GUIFontManager::UploadGlyphs()
+{
+  for (std::vector<CGUIFontTTFBase*>::iterator it = m_vecFontFiles.begin(); it != m_vecFontFiles.end(); ++it)
+    (*it)->UploadGlyphs();
+}
+
 void GUIFontManager::FreeFontFile(CGUIFontTTFBase *pFont)
 {
   for (std::vector<CGUIFontTTFBase*>::iterator it = m_vecFontFiles.begin(); it != m_vecFontFiles.end(); ++it)
@@ -78,6 +78,10 @@ public:
   void Clear();
   void FreeFontFile(CGUIFontTTFBase *pFont);
 
+  /*! \brief Place characters rendered in the background in the font textures. Called once per frame.
+   */
+  void UploadGlyphs();
+
   static void SettingOptionsFontsFiller(const CSetting *setting, std::vector< std::pair<std::string, std::string> > &list, std::string &current, void *data);
 
 protected:
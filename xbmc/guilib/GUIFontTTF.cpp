@@ -30,6 +30,7 @@
 #include "URL.h"
 #include "filesystem/File.h"
 #include "threads/SystemClock.h"
+#include "settings/AdvancedSettings.h"
 
 #include <math.h>
 #include <memory>
@@ -41,6 +42,7 @@
 #include FT_GLYPH_H
 #include FT_OUTLINE_H
 #include FT_STROKER_H
+#include FT_ADVANCES_H
 
 #define USE_RELEASE_LIBS
 
@@ -50,8 +52,7 @@
 
 #define CHARS_PER_TEXTURE_LINE 20 // number of characters to cache per texture line
 #define CHAR_CHUNK    64      // 64 chars allocated at a time (1024 bytes)
-#define GLYPH_STRENGTH_BOLD 24
-#define GLYPH_STRENGTH_LIGHT -48
+#define GLYPH_UPLOAD_LIMIT 64    // characters rendered in the background placed per frame
 
 
 class CFreeTypeLibrary
@@ -158,18 +159,22 @@ CGUIFontTTFBase::CGUIFontTTFBase(const std::string& strFileName) : m_staticCache
   m_char = NULL;
   m_maxChars = 0;
   m_nestedBeginCount = 0;
+  m_evictionPending = false;
 
   m_vertex.reserve(4*1024);
 
   m_face = NULL;
   m_stroker = NULL;
+  m_aspect = 1.0f;
+  m_borderStrength = 0;
+  memset(&m_placeholder, 0, sizeof(m_placeholder));
+  m_placeholdersUsed = false;
   memset(m_charquick, 0, sizeof(m_charquick));
   m_strFileName = strFileName;
   m_referenceCount = 0;
   m_originX = m_originY = 0.0f;
   m_cellBaseLine = m_cellHeight = 0;
   m_numChars = 0;
-  m_posX = m_posY = 0;
   m_textureHeight = m_textureWidth = 0;
   m_textureScaleX = m_textureScaleY = 0.0;
   m_ellipsesWidth = m_height = 0.0f;
@@ -208,12 +213,48 @@ void CGUIFontTTFBase::ClearCharacterCache()
   memset(m_charquick, 0, sizeof(m_charquick));
   m_numChars = 0;
   m_maxChars = CHAR_CHUNK;
-  // set the posX and posY so that our texture will be created on first character write.
-  m_posX = m_textureWidth;
-  m_posY = -(int)GetTextureLineHeight();
+  // drop all pages so that our texture will be created on first character write.
+  m_atlas.Clear();
+  m_evictionPending = false;
   m_textureHeight = 0;
 }
 
+void CGUIFontTTFBase::EvictPage(unsigned int page)
+{
+  // drop the characters living in the page, keeping the table sorted
+  int numChars = 0;
+  for (int i = 0; i < m_numChars; i++)
+  {
+    if (m_char[i].page != page)
+      m_char[numChars++] = m_char[i];
+  }
+  CLog::Log(LOGDEBUG, "%s: Evicted atlas page %u with %i characters", __FUNCTION__, page, m_numChars - numChars);
+  m_numChars = numChars;
+
+  memset(m_charquick, 0, sizeof(m_charquick));
+  for (int i = 0; i < m_numChars; i++)
+  {
+    if ((m_char[i].letterAndStyle & 0xffff) < 255)
+    {
+      character_t ch = ((m_char[i].letterAndStyle & 0xffff0000) >> 8) | (m_char[i].letterAndStyle & 0xff);
+      m_charquick[ch] = m_char + i;
+    }
+  }
+
+  // cached vertices may refer to the evicted characters
+  m_staticCache.Flush();
+  m_dynamicCache.Flush();
+
+  unsigned int top = m_atlas.GetPageTop(page);
+  ClearTextureRows(top, std::min(top + m_atlas.GetPageHeight(), m_textureHeight));
+}
+
+void CGUIFontTTFBase::ClearTextureRows(unsigned int y1, unsigned int y2)
+{
+  if (m_texture && y1 < y2)
+    memset(m_texture->GetPixels() + y1 * m_texture->GetPitch(), 0, (y2 - y1) * m_texture->GetPitch());
+}
+
 void CGUIFontTTFBase::Clear()
 {
   delete(m_texture);
@@ -223,10 +264,16 @@ void CGUIFontTTFBase::Clear()
   m_char = NULL;
   m_maxChars = 0;
   m_numChars = 0;
-  m_posX = 0;
-  m_posY = 0;
+  m_atlas.Clear();
+  m_evictionPending = false;
   m_nestedBeginCount = 0;
 
+  // the background renderer may use the font file in memory
+  if (m_rasterizer)
+    m_rasterizer->Cancel();
+  m_rasterizer.reset();
+  m_placeholdersUsed = false;
+
   if (m_face)
     g_freeTypeLibrary.ReleaseFont(m_face);
   m_face = NULL;
@@ -268,6 +315,9 @@ bool CGUIFontTTFBase::Load(const std::string& strFilename, float height, float a
      m_cellHeight  _ _ _ _ _ p _ _ _ _ _ _/_ _ _ _ _  bbox.yMin, descender
 
    */
+  m_aspect = aspect;
+  m_borderStrength = 0;
+
   int cellDescender = std::min<int>(m_face->bbox.yMin, m_face->descender);
   int cellAscender  = std::max<int>(m_face->bbox.yMax, m_face->ascender);
 
@@ -287,6 +337,7 @@ bool CGUIFontTTFBase::Load(const std::string& strFilename, float height, float a
     m_stroker = g_freeTypeLibrary.GetStroker();
     if (m_stroker)
       FT_Stroker_Set(m_stroker, strength, FT_STROKER_LINECAP_ROUND, FT_STROKER_LINEJOIN_ROUND, 0);
+    m_borderStrength = strength;
   }
 
   // scale to pixel sizing, rounding so that maximal extent is obtained
@@ -318,9 +369,8 @@ bool CGUIFontTTFBase::Load(const std::string& strFilename, float height, float a
     m_textureWidth = g_Windowing.GetMaxTextureSize();
   m_textureScaleX = 1.0f / m_textureWidth;
 
-  // set the posX and posY so that our texture will be created on first character write.
-  m_posX = m_textureWidth;
-  m_posY = -(int)GetTextureLineHeight();
+  // no pages yet, so our texture will be created on first character write.
+  m_atlas.Reset(m_textureWidth, GetTextureLineHeight(), g_Windowing.GetMaxTextureSize());
 
   // cache the ellipses width
   Character *ellipse = GetCharacter(L'.');
@@ -354,6 +404,8 @@ void CGUIFontTTFBase::End()
 void CGUIFontTTFBase::DrawTextInternal(float x, float y, const vecColors &colors, const vecText &text, uint32_t alignment, float maxPixelWidth, bool scrolling)
 {
   Begin();
+  // characters collected for this string must not be evicted while laying it out
+  m_atlas.NextRun();
 
   uint32_t rawAlignment = alignment;
   bool dirtyCache(false);
@@ -609,30 +661,90 @@ CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
   if (letter == L'\r')
     return NULL;
 
+  // letters are stored based on style and letter
+  Character *ch = FindCharacter((style << 16) | letter);
+  if (ch)
+  {
+    m_atlas.Touch(ch->page);
+    return ch;
+  }
+
+  // don't wait for characters that are being rendered in the background
+  if (m_rasterizer && m_rasterizer->IsPending((style << 16) | letter))
+    return GetPlaceholder(letter, style);
+
+  // render the character to our texture
+  // must End() as we can't render text to our texture during a Begin(), End() block
+  unsigned int nestedBeginCount = m_nestedBeginCount;
+  m_nestedBeginCount = 1;
+  if (nestedBeginCount) End();
+  // vertices batched so far point into the cached text, so no page may be
+  // evicted before the batch is done. The character is drawn as a gap until
+  // UploadGlyphs() has made room.
+  bool mayEvict = (nestedBeginCount == 0);
+  Character newChar;
+  if (!CacheCharacter(letter, style, &newChar, mayEvict))
+  {
+    if (m_evictionPending)
+    {
+      if (nestedBeginCount) Begin();
+      m_nestedBeginCount = nestedBeginCount;
+      return GetPlaceholder(letter, style);
+    }
+    // unable to cache character - try clearing them all out and starting over
+    CLog::Log(LOGDEBUG, "%s: Unable to cache character.  Clearing character cache of %i characters", __FUNCTION__, m_numChars);
+    ClearCharacterCache();
+    if (!CacheCharacter(letter, style, &newChar, mayEvict))
+    {
+      CLog::Log(LOGERROR, "%s: Unable to cache character (out of memory?)", __FUNCTION__);
+      if (nestedBeginCount) Begin();
+      m_nestedBeginCount = nestedBeginCount;
+      return NULL;
+    }
+  }
+  if (nestedBeginCount) Begin();
+  m_nestedBeginCount = nestedBeginCount;
+
+  return InsertCharacter(newChar);
+}
+
+CGUIFontTTFBase::Character* CGUIFontTTFBase::FindCharacter(character_t letterAndStyle)
+{
   // quick access to ascii chars
-  if (letter < 255)
+  if ((letterAndStyle & 0xffff) < 255)
   {
-    character_t ch = (style << 8) | letter;
+    character_t ch = ((letterAndStyle & 0xffff0000) >> 8) | (letterAndStyle & 0xff);
     if (m_charquick[ch])
       return m_charquick[ch];
   }
 
-  // letters are stored based on style and letter
-  character_t ch = (style << 16) | letter;
-
   int low = 0;
   int high = m_numChars - 1;
   while (low <= high)
   {
     int mid = (low + high) >> 1;
-    if (ch > m_char[mid].letterAndStyle)
+    if (letterAndStyle > m_char[mid].letterAndStyle)
       low = mid + 1;
-    else if (ch < m_char[mid].letterAndStyle)
+    else if (letterAndStyle < m_char[mid].letterAndStyle)
       high = mid - 1;
     else
       return &m_char[mid];
   }
-  // if we get to here, then low is where we should insert the new character
+  return NULL;
+}
+
+CGUIFontTTFBase::Character* CGUIFontTTFBase::InsertCharacter(const Character &newChar)
+{
+  int low = 0;
+  int high = m_numChars - 1;
+  while (low <= high)
+  {
+    int mid = (low + high) >> 1;
+    if (newChar.letterAndStyle > m_char[mid].letterAndStyle)
+      low = mid + 1;
+    else
+      high = mid - 1;
+  }
 
   // increase the size of the buffer if we need it
   if (m_numChars >= m_maxChars)
@@ -652,26 +764,8 @@ CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
   { // just move the data along as necessary
     memmove(m_char + low + 1, m_char + low, (m_numChars - low) * sizeof(Character));
   }
-  // render the character to our texture
-  // must End() as we can't render text to our texture during a Begin(), End() block
-  unsigned int nestedBeginCount = m_nestedBeginCount;
-  m_nestedBeginCount = 1;
-  if (nestedBeginCount) End();
-  if (!CacheCharacter(letter, style, m_char + low))
-  { // unable to cache character - try clearing them all out and starting over
-    CLog::Log(LOGDEBUG, "%s: Unable to cache character.  Clearing character cache of %i characters", __FUNCTION__, m_numChars);
-    ClearCharacterCache();
-    low = 0;
-    if (!CacheCharacter(letter, style, m_char + low))
-    {
-      CLog::Log(LOGERROR, "%s: Unable to cache character (out of memory?)", __FUNCTION__);
-      if (nestedBeginCount) Begin();
-      m_nestedBeginCount = nestedBeginCount;
-      return NULL;
-    }
-  }
-  if (nestedBeginCount) Begin();
-  m_nestedBeginCount = nestedBeginCount;
+  m_char[low] = newChar;
+  m_numChars++;
 
   // fixup quick access
   memset(m_charquick, 0, sizeof(m_charquick));
@@ -687,113 +781,170 @@ CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
   return m_char + low;
 }
 
-bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *ch)
+CGUIFontTTFBase::Character* CGUIFontTTFBase::GetPlaceholder(wchar_t letter, uint32_t style)
 {
-  int glyph_index = FT_Get_Char_Index( m_face, letter );
+  // nothing to draw, but advance as far as the real character will so the
+  // layout doesn't change once it arrives. Embolding may add a pixel later.
+  FT_Fixed advance = 0;
+  FT_Get_Advance(m_face, FT_Get_Char_Index(m_face, letter), FT_LOAD_TARGET_LIGHT, &advance);
+
+  memset(&m_placeholder, 0, sizeof(m_placeholder));
+  m_placeholder.letterAndStyle = (style << 16) | letter;
+  m_placeholder.advance = (float)MathUtils::round_int((float)advance / 65536);
+  m_placeholder.page = CGUIFontAtlas::NO_PAGE;
+  m_placeholdersUsed = true;
+  return &m_placeholder;
+}
+
+void CGUIFontTTFBase::Prefetch(const vecText &text)
+{
+  if (!m_face || !g_advancedSettings.m_guiAsyncGlyphs)
+    return;
 
-  FT_Glyph glyph = NULL;
-  if (FT_Load_Glyph( m_face, glyph_index, FT_LOAD_TARGET_LIGHT ))
+  std::vector<character_t> missing;
+  for (vecText::const_iterator it = text.begin(); it != text.end(); ++it)
   {
-    CLog::Log(LOGDEBUG, "%s Failed to load glyph %x", __FUNCTION__, letter);
-    return false;
+    wchar_t letter = (wchar_t)(*it & 0xffff);
+    character_t style = (*it & 0x7000000) >> 24;
+    if (letter != L'\r' && !FindCharacter((style << 16) | letter))
+      missing.push_back((style << 16) | letter);
   }
-  // make bold if applicable
-  if (style & FONT_STYLE_BOLD)
-    SetGlyphStrength(m_face->glyph, GLYPH_STRENGTH_BOLD);
-  // and italics if applicable
-  if (style & FONT_STYLE_ITALICS)
-    ObliqueGlyph(m_face->glyph);
-  // and light if applicable
-  if (style & FONT_STYLE_LIGHT)
-    SetGlyphStrength(m_face->glyph, GLYPH_STRENGTH_LIGHT);
-  // grab the glyph
-  if (FT_Get_Glyph(m_face->glyph, &glyph))
+  if (missing.empty())
+    return;
+
+  if (!m_rasterizer)
   {
-    CLog::Log(LOGDEBUG, "%s Failed to get glyph %x", __FUNCTION__, letter);
-    return false;
+    CURL realFile(CSpecialProtocol::TranslatePath(m_strFilename));
+    m_rasterizer = std::make_shared<CGUIGlyphRasterizer>(realFile.GetFileName(), m_fontFileInMemory,
+                                                         m_height, m_aspect, m_borderStrength);
   }
-  if (m_stroker)
-    FT_Glyph_StrokeBorder(&glyph, m_stroker, 0, 1);
-  // render the glyph
-  if (FT_Glyph_To_Bitmap(&glyph, FT_RENDER_MODE_NORMAL, NULL, 1))
+  m_rasterizer->Request(missing);
+}
+
+void CGUIFontTTFBase::UploadGlyphs()
+{
+  if (m_nestedBeginCount)
+    return;
+
+  if (m_evictionPending)
   {
-    CLog::Log(LOGDEBUG, "%s Failed to render glyph %x to a bitmap", __FUNCTION__, letter);
-    return false;
+    m_evictionPending = false;
+    m_atlas.NextRun();
+    unsigned int page = m_atlas.EvictOldest();
+    if (page != CGUIFontAtlas::NO_PAGE)
+      EvictPage(page);
+    // text drawn with gaps is laid out again by now
+    m_placeholdersUsed = false;
+  }
+
+  if (!m_rasterizer)
+    return;
+
+  std::vector<CGUIGlyphRasterizer::Glyph> glyphs;
+  m_rasterizer->Collect(glyphs, GLYPH_UPLOAD_LIMIT);
+  if (glyphs.empty())
+    return;
+
+  m_atlas.NextRun();
+  for (std::vector<CGUIGlyphRasterizer::Glyph>::const_iterator it = glyphs.begin(); it != glyphs.end(); ++it)
+  {
+    // may have been rendered on demand in the meantime
+    if (FindCharacter(it->letterAndStyle))
+      continue;
+
+    // if there's no room, it gets rendered on demand once it's drawn
+    Character ch;
+    if (!PlaceCharacter(*it, &ch, true))
+      break;
+    InsertCharacter(ch);
   }
-  FT_BitmapGlyph bitGlyph = (FT_BitmapGlyph)glyph;
-  FT_Bitmap bitmap = bitGlyph->bitmap;
-  bool isEmptyGlyph = (bitmap.width == 0 || bitmap.rows == 0);
 
+  // text drawn with placeholders has to be laid out again
+  if (m_placeholdersUsed)
+  {
+    m_staticCache.Flush();
+    m_dynamicCache.Flush();
+    m_placeholdersUsed = false;
+  }
+}
+
+bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *ch, bool mayEvict)
+{
+  CGUIGlyphRasterizer::Glyph glyph;
+  if (!CGUIGlyphRasterizer::Render(m_face, m_stroker, letter, style, glyph))
+    return false;
+
+  return PlaceCharacter(glyph, ch, mayEvict);
+}
+
+bool CGUIFontTTFBase::PlaceCharacter(const CGUIGlyphRasterizer::Glyph &glyph, Character *ch, bool mayEvict)
+{
+  bool isEmptyGlyph = (glyph.width == 0 || glyph.rows == 0);
+
+  unsigned int posX = 0;
+  unsigned int posY = 0;
+  unsigned int page = CGUIFontAtlas::NO_PAGE;
   if (!isEmptyGlyph)
   {
-    if (bitGlyph->left < 0)
-      m_posX += -bitGlyph->left;
-
-    // check we have enough room for the character
-    if ((m_posX + bitGlyph->left + bitmap.width) > static_cast<int>(m_textureWidth))
-    { // no space - gotta drop to the next line (which means creating a new texture and copying it across)
-      m_posX = 0;
-      m_posY += GetTextureLineHeight();
-      if (bitGlyph->left < 0)
-        m_posX += -bitGlyph->left;
-
-      if(m_posY + GetTextureLineHeight() >= m_textureHeight)
-      {
-        // create the new larger texture
-        unsigned int newHeight = m_posY + GetTextureLineHeight();
-        // check for max height
-        if (newHeight > g_Windowing.GetMaxTextureSize())
-        {
-          CLog::Log(LOGDEBUG, "%s: New cache texture is too large (%u > %u pixels long)", __FUNCTION__, newHeight, g_Windowing.GetMaxTextureSize());
-          FT_Done_Glyph(glyph);
-          return false;
-        }
+    // the cell starts left of the origin for glyphs with a negative bearing
+    unsigned int bearing = glyph.left < 0 ? -glyph.left : 0;
+    unsigned int cellWidth = bearing + spacing_between_characters_in_texture +
+                             std::max(std::max((int)glyph.width + glyph.left, (int)glyph.advance), 0);
 
-        CBaseTexture* newTexture = NULL;
-        newTexture = ReallocTexture(newHeight);
-        if(newTexture == NULL)
-        {
-          FT_Done_Glyph(glyph);
-          CLog::Log(LOGDEBUG, "%s: Failed to allocate new texture of height %u", __FUNCTION__, newHeight);
-          return false;
-        }
-        m_texture = newTexture;
+    unsigned int evicted;
+    if (!m_atlas.Allocate(cellWidth, posX, posY, page, evicted, mayEvict))
+    {
+      if (!mayEvict && m_atlas.GetPageCount() == m_atlas.GetMaxPages())
+        m_evictionPending = true;
+      else
+        CLog::Log(LOGDEBUG, "%s: No atlas page left to cache character to", __FUNCTION__);
+      return false;
+    }
+    posX += bearing;
+
+    if (evicted != CGUIFontAtlas::NO_PAGE)
+      EvictPage(evicted);
+
+    if (m_atlas.GetRequiredHeight() > m_textureHeight)
+    {
+      // a new page was opened - create the new larger texture
+      unsigned int newHeight = m_atlas.GetRequiredHeight();
+      CBaseTexture* newTexture = ReallocTexture(newHeight);
+      if(newTexture == NULL)
+      {
+        CLog::Log(LOGDEBUG, "%s: Failed to allocate new texture of height %u", __FUNCTION__, newHeight);
+        return false;
       }
+      m_texture = newTexture;
     }
 
     if(m_texture == NULL)
     {
-      FT_Done_Glyph(glyph);
       CLog::Log(LOGDEBUG, "%s: no texture to cache character to", __FUNCTION__);
       return false;
     }
   }
   // set the character in our table
-  ch->letterAndStyle = (style << 16) | letter;
-  ch->offsetX = (short)bitGlyph->left;
-  ch->offsetY = (short)m_cellBaseLine - bitGlyph->top;
-  ch->left = isEmptyGlyph ? 0 : ((float)m_posX + ch->offsetX);
-  ch->top = isEmptyGlyph ? 0 : ((float)m_posY + ch->offsetY);
-  ch->right = ch->left + bitmap.width;
-  ch->bottom = ch->top + bitmap.rows;
-  ch->advance = (float)MathUtils::round_int( (float)m_face->glyph->advance.x / 64 );
+  ch->letterAndStyle = glyph.letterAndStyle;
+  ch->offsetX = (short)glyph.left;
+  ch->offsetY = (short)m_cellBaseLine - glyph.top;
+  ch->left = isEmptyGlyph ? 0 : ((float)posX + ch->offsetX);
+  ch->top = isEmptyGlyph ? 0 : ((float)posY + ch->offsetY);
+  ch->right = ch->left + glyph.width;
+  ch->bottom = ch->top + glyph.rows;
+  ch->advance = glyph.advance;
+  ch->page = page;
 
   // we need only render if we actually have some pixels
   if (!isEmptyGlyph)
   {
     // ensure our rect will stay inside the texture (it *should* but we need to be certain)
-    unsigned int x1 = std::max(m_posX + ch->offsetX, 0);
-    unsigned int y1 = std::max(m_posY + ch->offsetY, 0);
-    unsigned int x2 = std::min(x1 + bitmap.width, m_textureWidth);
-    unsigned int y2 = std::min(y1 + bitmap.rows, m_textureHeight);
-    CopyCharToTexture(bitGlyph, x1, y1, x2, y2);
-  
-    m_posX += spacing_between_characters_in_texture + (unsigned short)std::max(ch->right - ch->left + ch->offsetX, ch->advance);
+    unsigned int x1 = std::max((int)posX + ch->offsetX, 0);
+    unsigned int y1 = std::max((int)posY + ch->offsetY, 0);
+    unsigned int x2 = std::min(x1 + glyph.width, m_textureWidth);
+    unsigned int y2 = std::min(y1 + glyph.rows, m_textureHeight);
+    CopyCharToTexture(glyph, x1, y1, x2, y2);
   }
-  m_numChars++;
-
-  // free the glyph
-  FT_Done_Glyph(glyph);
 
   return true;
 }
@@ -945,59 +1096,3 @@ void CGUIFontTTFBase::RenderCharacter(float posX, float posY, const Character *c
   v[3].z = z[2];
 #endif
 }
-
-// Oblique code - original taken from freetype2 (ftsynth.c)
-void CGUIFontTTFBase::ObliqueGlyph(FT_GlyphSlot slot)
-{
-  /* only oblique outline glyphs */
-  if ( slot->format != FT_GLYPH_FORMAT_OUTLINE )
-    return;
-
-  /* we don't touch the advance width */
-
-  /* For italic, simply apply a shear transform, with an angle */
-  /* of about 12 degrees.                                      */
-
-  FT_Matrix    transform;
-  transform.xx = 0x10000L;
-  transform.yx = 0x00000L;
-
-  transform.xy = 0x06000L;
-  transform.yy = 0x10000L;
-
-  FT_Outline_Transform( &slot->outline, &transform );
-}
-
-
-// Embolden code - original taken from freetype2 (ftsynth.c)
-void CGUIFontTTFBase::SetGlyphStrength(FT_GlyphSlot slot, int glyphStrength)
-{
-  if ( slot->format != FT_GLYPH_FORMAT_OUTLINE )
-    return;
-
-  /* some reasonable strength */
-  FT_Pos strength = FT_MulFix( m_face->units_per_EM,
-                    m_face->size->metrics.y_scale ) / glyphStrength;
-
-  FT_BBox bbox_before, bbox_after;
-  FT_Outline_Get_CBox( &slot->outline, &bbox_before );
-  FT_Outline_Embolden( &slot->outline, strength );  // ignore error
-  FT_Outline_Get_CBox( &slot->outline, &bbox_after );
-
-  FT_Pos dx = bbox_after.xMax - bbox_before.xMax;
-  FT_Pos dy = bbox_after.yMax - bbox_before.yMax;
-
-  if ( slot->advance.x )
-    slot->advance.x += dx;
-
-  if ( slot->advance.y )
-    slot->advance.y += dy;
-
-  slot->metrics.width        += dx;
-  slot->metrics.height       += dy;
-  slot->metrics.horiBearingY += dy;
-  slot->metrics.horiAdvance  += dx;
-  slot->metrics.vertBearingX -= dx / 2;
-  slot->metrics.vertBearingY += dy;
-  slot->metrics.vertAdvance  += dy;
-}
@@ -27,6 +27,7 @@
  *
  */
 
+#include <memory>
 #include <string>
 #include <stdint.h>
 #include <vector>
@@ -79,7 +80,9 @@ struct SVertex
 };
 
 
+#include "GUIFontAtlas.h"
 #include "GUIFontCache.h"
+#include "GUIGlyphRasterizer.h"
 
 
 class CGUIFontTTFBase
@@ -103,6 +106,19 @@ public:
 
   const std::string& GetFileName() const { return m_strFileName; };
 
+  /*!
+   \brief Render the characters of text that aren't cached yet in the background.
+   Until they are uploaded, drawing them leaves a gap of the right width.
+   */
+  void Prefetch(const vecText &text);
+
+  /*!
+   \brief Place characters rendered in the background in our texture.
+   Also evicts the atlas page that was needed while text was drawn.
+   Called once per frame, outside of any Begin()/End() block.
+   */
+  void UploadGlyphs();
+
 protected:
   struct Character
   {
@@ -110,6 +126,7 @@ protected:
     float left, top, right, bottom;
     float advance;
     character_t letterAndStyle;
+    unsigned short page;            // atlas page holding the pixels
   };
   void AddReference();
   void RemoveReference();
@@ -129,24 +146,26 @@ protected:
 
   // Stuff for pre-rendering for speed
   inline Character *GetCharacter(character_t letter);
-  bool CacheCharacter(wchar_t letter, uint32_t style, Character *ch);
+  Character *FindCharacter(character_t letterAndStyle);
+  Character *InsertCharacter(const Character &ch);
+  Character *GetPlaceholder(wchar_t letter, uint32_t style);
+  bool CacheCharacter(wchar_t letter, uint32_t style, Character *ch, bool mayEvict);
+  bool PlaceCharacter(const CGUIGlyphRasterizer::Glyph &glyph, Character *ch, bool mayEvict);
   void RenderCharacter(float posX, float posY, const Character *ch, color_t color, bool roundX, std::vector<SVertex> &vertices);
   void ClearCharacterCache();
+  void EvictPage(unsigned int page);
 
   virtual CBaseTexture* ReallocTexture(unsigned int& newHeight) = 0;
-  virtual bool CopyCharToTexture(FT_BitmapGlyph bitGlyph, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2) = 0;
+  virtual bool CopyCharToTexture(const CGUIGlyphRasterizer::Glyph &glyph, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2) = 0;
+  virtual void ClearTextureRows(unsigned int y1, unsigned int y2);
   virtual void DeleteHardwareTexture() = 0;
 
-  // modifying glyphs
-  void SetGlyphStrength(FT_GlyphSlot slot, int glyphStrength);
-  static void ObliqueGlyph(FT_GlyphSlot slot);
-
   CBaseTexture* m_texture;        // texture that holds our rendered characters (8bit alpha only)
 
   unsigned int m_textureWidth;       // width of our texture
   unsigned int m_textureHeight;      // heigth of our texture
-  int m_posX;                        // current position in the texture
-  int m_posY;
+  CGUIFontAtlas m_atlas;             // placement of the characters in the texture
+  bool m_evictionPending;            // atlas ran full during a Begin()/End() block
 
   /*! \brief the height of each line in the texture.
    Accounts for spacing between lines to avoid characters overlapping.
@@ -171,6 +190,13 @@ protected:
   // freetype stuff
   FT_Face    m_face;
   FT_Stroker m_stroker;
+  float      m_aspect;
+  long       m_borderStrength;            // stroker radius, 0 if not bordered
+
+  // background rendering
+  std::shared_ptr<CGUIGlyphRasterizer> m_rasterizer;
+  Character m_placeholder;                // returned for characters still being rendered
+  bool m_placeholdersUsed;
 
   float m_originX;
   float m_originY;
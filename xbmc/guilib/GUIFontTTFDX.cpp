@@ -258,15 +258,13 @@ CBaseTexture* CGUIFontTTFDX::ReallocTexture(unsigned int& newHeight)
   return pNewTexture;
 }
 
-bool CGUIFontTTFDX::CopyCharToTexture(FT_BitmapGlyph bitGlyph, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2)
+bool CGUIFontTTFDX::CopyCharToTexture(const CGUIGlyphRasterizer::Glyph &glyph, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2)
 {
-  FT_Bitmap bitmap = bitGlyph->bitmap;
-
   ID3D11DeviceContext* pContext = g_Windowing.GetImmediateContext();
   if (m_speedupTexture && pContext)
   {
     CD3D11_BOX dstBox(x1, y1, 0, x2, y2, 1);
-    pContext->UpdateSubresource(m_speedupTexture->Get(), 0, &dstBox, bitmap.buffer, bitmap.pitch, 0);
+    pContext->UpdateSubresource(m_speedupTexture->Get(), 0, &dstBox, &glyph.pixels[0], glyph.width, 0);
   }
   else
     return false;
@@ -274,6 +272,17 @@ bool CGUIFontTTFDX::CopyCharToTexture(FT_BitmapGlyph bitGlyph, unsigned int x1,
   return TRUE;
 }
 
+void CGUIFontTTFDX::ClearTextureRows(unsigned int y1, unsigned int y2)
+{
+  ID3D11DeviceContext* pContext = g_Windowing.GetImmediateContext();
+  if (!m_speedupTexture || !pContext || y1 >= y2)
+    return;
+
+  std::vector<unsigned char> zero(m_textureWidth * (y2 - y1), 0);
+  CD3D11_BOX dstBox(0, y1, 0, m_textureWidth, y2, 1);
+  pContext->UpdateSubresource(m_speedupTexture->Get(), 0, &dstBox, &zero[0], m_textureWidth, 0);
+}
+
 void CGUIFontTTFDX::DeleteHardwareTexture()
 {
 }
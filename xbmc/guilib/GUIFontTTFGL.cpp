@@ -57,6 +57,9 @@ CGUIFontTTFGL::~CGUIFontTTFGL(void)
 
 bool CGUIFontTTFGL::FirstBegin()
 {
+  // the glyph texture is bound directly below
+  CGLTexture::ResetBindings();
+
   if (m_textureStatus == TEXTURE_REALLOCATED)
   {
     if (glIsTexture(m_nTexture))
@@ -342,20 +345,32 @@ CBaseTexture* CGUIFontTTFGL::ReallocTexture(unsigned int& newHeight)
   return newTexture;
 }
 
-bool CGUIFontTTFGL::CopyCharToTexture(FT_BitmapGlyph bitGlyph, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2)
+bool CGUIFontTTFGL::CopyCharToTexture(const CGUIGlyphRasterizer::Glyph &glyph, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2)
 {
-  FT_Bitmap bitmap = bitGlyph->bitmap;
-
-  unsigned char* source = (unsigned char*) bitmap.buffer;
+  const unsigned char* source = &glyph.pixels[0];
   unsigned char* target = (unsigned char*) m_texture->GetPixels() + y1 * m_texture->GetPitch() + x1;
 
   for (unsigned int y = y1; y < y2; y++)
   {
     memcpy(target, source, x2-x1);
-    source += bitmap.width;
+    source += glyph.width;
     target += m_texture->GetPitch();
   }
-  
+
+  UpdateRows(y1, y2);
+
+  return TRUE;
+}
+
+void CGUIFontTTFGL::ClearTextureRows(unsigned int y1, unsigned int y2)
+{
+  CGUIFontTTFBase::ClearTextureRows(y1, y2);
+  if (y1 < y2)
+    UpdateRows(y1, y2);
+}
+
+void CGUIFontTTFGL::UpdateRows(unsigned int y1, unsigned int y2)
+{
   switch (m_textureStatus)
   {
   case TEXTURE_UPDATED:
@@ -383,8 +398,6 @@ bool CGUIFontTTFGL::CopyCharToTexture(FT_BitmapGlyph bitGlyph, unsigned int x1,
   default:
     break;
   }
-  
-  return TRUE;
 }
 
 
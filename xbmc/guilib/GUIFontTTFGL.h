@@ -54,7 +54,8 @@ public:
 
 protected:
   virtual CBaseTexture* ReallocTexture(unsigned int& newHeight);
-  virtual bool CopyCharToTexture(FT_BitmapGlyph bitGlyph, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2);
+  virtual bool CopyCharToTexture(const CGUIGlyphRasterizer::Glyph &glyph, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2);
+  virtual void ClearTextureRows(unsigned int y1, unsigned int y2);
   virtual void DeleteHardwareTexture();
 
 #if HAS_GLES
@@ -64,6 +65,8 @@ protected:
 #endif
 
 private:
+  void UpdateRows(unsigned int y1, unsigned int y2);
+
   unsigned int m_updateY1;
   unsigned int m_updateY2;
   
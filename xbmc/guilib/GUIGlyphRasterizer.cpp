@@ -0,0 +1,336 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "GUIGlyphRasterizer.h"
+#include "GUIFont.h"
+#include "threads/SingleLock.h"
+#include "utils/Job.h"
+#include "utils/JobManager.h"
+#include "utils/MathUtils.h"
+#include "utils/log.h"
+
+#include <algorithm>
+
+// stuff for freetype
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#include FT_GLYPH_H
+#include FT_OUTLINE_H
+#include FT_STROKER_H
+
+#define GLYPH_STRENGTH_BOLD 24
+#define GLYPH_STRENGTH_LIGHT -48
+
+namespace
+{
+
+class CGlyphRasterizeJob : public CJob
+{
+public:
+  CGlyphRasterizeJob(const std::shared_ptr<CGUIGlyphRasterizer> &rasterizer) : m_rasterizer(rasterizer) {}
+  virtual bool DoWork()
+  {
+    m_rasterizer->Process();
+    return true;
+  }
+  virtual const char *GetType() const { return "glyphrasterize"; }
+
+private:
+  std::shared_ptr<CGUIGlyphRasterizer> m_rasterizer;
+};
+
+void SetGlyphStrength(FT_GlyphSlot slot, int glyphStrength)
+{
+  if ( slot->format != FT_GLYPH_FORMAT_OUTLINE )
+    return;
+
+  /* some reasonable strength */
+  FT_Pos strength = FT_MulFix( slot->face->units_per_EM,
+                    slot->face->size->metrics.y_scale ) / glyphStrength;
+
+  FT_BBox bbox_before, bbox_after;
+  FT_Outline_Get_CBox( &slot->outline, &bbox_before );
+  FT_Outline_Embolden( &slot->outline, strength );  // ignore error
+  FT_Outline_Get_CBox( &slot->outline, &bbox_after );
+
+  FT_Pos dx = bbox_after.xMax - bbox_before.xMax;
+  FT_Pos dy = bbox_after.yMax - bbox_before.yMax;
+
+  if ( slot->advance.x )
+    slot->advance.x += dx;
+
+  if ( slot->advance.y )
+    slot->advance.y += dy;
+
+  slot->metrics.width        += dx;
+  slot->metrics.height       += dy;
+  slot->metrics.horiBearingY += dy;
+  slot->metrics.horiAdvance  += dx;
+  slot->metrics.vertBearingX -= dx / 2;
+  slot->metrics.vertBearingY += dy;
+  slot->metrics.vertAdvance  += dy;
+}
+
+// Oblique code - original taken from freetype2 (ftsynth.c)
+void ObliqueGlyph(FT_GlyphSlot slot)
+{
+  /* only oblique outline glyphs */
+  if ( slot->format != FT_GLYPH_FORMAT_OUTLINE )
+    return;
+
+  /* we don't touch the advance width */
+
+  /* For italic, simply apply a shear transform, with an angle */
+  /* of about 12 degrees.                                      */
+
+  FT_Matrix    transform;
+  transform.xx = 0x10000L;
+  transform.yx = 0x00000L;
+
+  transform.xy = 0x06000L;
+  transform.yy = 0x10000L;
+
+  FT_Outline_Transform( &slot->outline, &transform );
+}
+
+}
+
+bool CGUIGlyphRasterizer::Render(FT_Face face, FT_Stroker stroker, wchar_t letter, uint32_t style, Glyph &glyph)
+{
+  int glyph_index = FT_Get_Char_Index( face, letter );
+
+  FT_Glyph ftGlyph = NULL;
+  if (FT_Load_Glyph( face, glyph_index, FT_LOAD_TARGET_LIGHT ))
+  {
+    CLog::Log(LOGDEBUG, "%s Failed to load glyph %x", __FUNCTION__, letter);
+    return false;
+  }
+  // make bold if applicable
+  if (style & FONT_STYLE_BOLD)
+    SetGlyphStrength(face->glyph, GLYPH_STRENGTH_BOLD);
+  // and italics if applicable
+  if (style & FONT_STYLE_ITALICS)
+    ObliqueGlyph(face->glyph);
+  // and light if applicable
+  if (style & FONT_STYLE_LIGHT)
+    SetGlyphStrength(face->glyph, GLYPH_STRENGTH_LIGHT);
+  // grab the glyph
+  if (FT_Get_Glyph(face->glyph, &ftGlyph))
+  {
+    CLog::Log(LOGDEBUG, "%s Failed to get glyph %x", __FUNCTION__, letter);
+    return false;
+  }
+  if (stroker)
+    FT_Glyph_StrokeBorder(&ftGlyph, stroker, 0, 1);
+  // render the glyph
+  if (FT_Glyph_To_Bitmap(&ftGlyph, FT_RENDER_MODE_NORMAL, NULL, 1))
+  {
+    CLog::Log(LOGDEBUG, "%s Failed to render glyph %x to a bitmap", __FUNCTION__, letter);
+    FT_Done_Glyph(ftGlyph);
+    return false;
+  }
+  FT_BitmapGlyph bitGlyph = (FT_BitmapGlyph)ftGlyph;
+  const FT_Bitmap &bitmap = bitGlyph->bitmap;
+
+  glyph.letterAndStyle = (style << 16) | letter;
+  glyph.left = bitGlyph->left;
+  glyph.top = bitGlyph->top;
+  glyph.width = bitmap.width;
+  glyph.rows = bitmap.rows;
+  glyph.advance = (float)MathUtils::round_int( (float)face->glyph->advance.x / 64 );
+
+  // copy the pixels out, tightly packed
+  glyph.pixels.resize(bitmap.width * bitmap.rows);
+  for (unsigned int y = 0; y < (unsigned int)bitmap.rows; y++)
+    memcpy(&glyph.pixels[y * bitmap.width], bitmap.buffer + y * bitmap.pitch, bitmap.width);
+
+  // free the glyph
+  FT_Done_Glyph(ftGlyph);
+
+  return true;
+}
+
+CGUIGlyphRasterizer::CGUIGlyphRasterizer(const std::string &path, const XUTILS::auto_buffer &memory,
+                                         float height, float aspect, long borderStrength)
+  : m_idle(true, true)
+  , m_path(path)
+  , m_memory(memory)
+{
+  m_running = false;
+  m_rendering = false;
+  m_cancelled = false;
+  m_height = height;
+  m_aspect = aspect;
+  m_borderStrength = borderStrength;
+  m_library = NULL;
+  m_face = NULL;
+  m_stroker = NULL;
+  m_faceFailed = false;
+  m_rendered = 0;
+}
+
+CGUIGlyphRasterizer::~CGUIGlyphRasterizer()
+{
+  Cancel();
+}
+
+void CGUIGlyphRasterizer::Request(const std::vector<uint32_t> &letterAndStyles)
+{
+  CSingleLock lock(m_section);
+  if (m_cancelled || m_faceFailed)
+    return;
+
+  for (std::vector<uint32_t>::const_iterator it = letterAndStyles.begin(); it != letterAndStyles.end(); ++it)
+  {
+    if (m_pending.insert(*it).second)
+      m_queue.push_back(*it);
+  }
+
+  if (!m_queue.empty() && !m_running)
+  {
+    m_running = true;
+    m_idle.Reset();
+    CJobManager::GetInstance().AddJob(new CGlyphRasterizeJob(shared_from_this()), NULL, CJob::PRIORITY_NORMAL);
+  }
+}
+
+bool CGUIGlyphRasterizer::IsPending(uint32_t letterAndStyle) const
+{
+  CSingleLock lock(m_section);
+  return m_pending.find(letterAndStyle) != m_pending.end();
+}
+
+void CGUIGlyphRasterizer::Collect(std::vector<Glyph> &glyphs, size_t max)
+{
+  CSingleLock lock(m_section);
+  size_t count = std::min(max, m_ready.size());
+  for (size_t i = 0; i < count; i++)
+  {
+    m_pending.erase(m_ready[i].letterAndStyle);
+    glyphs.push_back(std::move(m_ready[i]));
+  }
+  m_ready.erase(m_ready.begin(), m_ready.begin() + count);
+}
+
+void CGUIGlyphRasterizer::Cancel()
+{
+  CSingleLock lock(m_section);
+  m_cancelled = true;
+  m_queue.clear();
+  m_pending.clear();
+  m_ready.clear();
+  // a job that hasn't started yet sees the flag and leaves the face alone,
+  // only a glyph being rendered right now has to be waited for
+  while (m_rendering)
+  {
+    lock.Leave();
+    m_idle.Wait();
+    lock.Enter();
+  }
+  CloseFace();
+}
+
+void CGUIGlyphRasterizer::Process()
+{
+  CSingleLock lock(m_section);
+  while (!m_cancelled && !m_queue.empty())
+  {
+    uint32_t letterAndStyle = m_queue.front();
+    m_queue.pop_front();
+    m_rendering = true;
+    m_idle.Reset();
+    lock.Leave();
+
+    Glyph glyph;
+    bool opened = m_face || OpenFace();
+    bool rendered = opened && Render(m_face, m_stroker, (wchar_t)(letterAndStyle & 0xffff), letterAndStyle >> 16, glyph);
+
+    lock.Enter();
+    m_rendering = false;
+    m_idle.Set();
+    if (!opened)
+    {
+      CLog::Log(LOGERROR, "%s: Unable to open %s for background rendering", __FUNCTION__, m_path.c_str());
+      m_faceFailed = true;
+      m_queue.clear();
+      m_pending.clear();
+    }
+    else if (rendered)
+    {
+      m_ready.push_back(std::move(glyph));
+      m_rendered++;
+    }
+    else // leave it to the render thread
+      m_pending.erase(letterAndStyle);
+  }
+  m_running = false;
+}
+
+bool CGUIGlyphRasterizer::OpenFace()
+{
+  if (FT_Init_FreeType(&m_library))
+  {
+    m_library = NULL;
+    return false;
+  }
+
+  if (m_memory.size() > 0)
+  {
+    if (FT_New_Memory_Face(m_library, (const FT_Byte*)m_memory.get(), m_memory.size(), 0, &m_face) != 0)
+      m_face = NULL;
+  }
+  else if (FT_New_Face(m_library, m_path.c_str(), 0, &m_face))
+    m_face = NULL;
+
+  // same sizing as CFreeTypeLibrary::GetFont()
+  unsigned int ydpi = 72;
+  unsigned int xdpi = (unsigned int)MathUtils::round_int(ydpi * m_aspect);
+  if (!m_face || FT_Set_Char_Size(m_face, 0, (int)(m_height*64 + 0.5f), xdpi, ydpi))
+  {
+    CloseFace();
+    return false;
+  }
+
+  if (m_borderStrength)
+  {
+    if (FT_Stroker_New(m_library, &m_stroker))
+      m_stroker = NULL;
+    else
+      FT_Stroker_Set(m_stroker, m_borderStrength, FT_STROKER_LINECAP_ROUND, FT_STROKER_LINEJOIN_ROUND, 0);
+  }
+  return true;
+}
+
+void CGUIGlyphRasterizer::CloseFace()
+{
+  if (m_face)
+    CLog::Log(LOGDEBUG, "%s: Rendered %u glyphs in the background for %s", __FUNCTION__, m_rendered, m_path.c_str());
+
+  if (m_stroker)
+    FT_Stroker_Done(m_stroker);
+  m_stroker = NULL;
+  if (m_face)
+    FT_Done_Face(m_face);
+  m_face = NULL;
+  if (m_library)
+    FT_Done_FreeType(m_library);
+  m_library = NULL;
+}
@@ -0,0 +1,146 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <deque>
+#include <memory>
+#include <set>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "utils/auto_buffer.h"
+
+struct FT_FaceRec_;
+struct FT_LibraryRec_;
+struct FT_StrokerRec_;
+
+typedef struct FT_FaceRec_ *FT_Face;
+typedef struct FT_LibraryRec_ *FT_Library;
+typedef struct FT_StrokerRec_ *FT_Stroker;
+
+/*!
+ \ingroup textures
+ \brief Renders glyphs of a font with FreeType, either directly or on a job thread.
+
+ FreeType faces can't be shared between threads, so the background side opens
+ its own library and face for the font file the first time it runs. Glyphs
+ are requested with Request(), rendered by a CJob and handed back with
+ Collect(), which the font calls once per frame to place them in its texture.
+ Instances must be owned by a std::shared_ptr, as the job keeps a reference.
+ */
+class CGUIGlyphRasterizer : public std::enable_shared_from_this<CGUIGlyphRasterizer>
+{
+public:
+  struct Glyph
+  {
+    uint32_t letterAndStyle;           // (style << 16) | letter, as CGUIFontTTFBase stores them
+    int left;                          // bitmap offset from the pen position
+    int top;
+    unsigned int width;
+    unsigned int rows;
+    float advance;
+    std::vector<unsigned char> pixels; // width * rows, 8bit alpha
+  };
+
+  /*!
+   \brief Render a single glyph.
+   \param face face to render with, must not be used by another thread meanwhile
+   \param stroker stroker for bordered fonts, may be NULL
+   \param letter the character
+   \param style FONT_STYLE_* flags
+   \param glyph [out] the rendered glyph
+   \return false if FreeType couldn't render the character
+   */
+  static bool Render(FT_Face face, FT_Stroker stroker, wchar_t letter, uint32_t style, Glyph &glyph);
+
+  /*!
+   \param path local path of the font file, used if memory is empty
+   \param memory font file contents, must stay valid until Cancel() returns
+   \param height font height as passed to CGUIFontTTFBase::Load()
+   \param aspect aspect as passed to CGUIFontTTFBase::Load()
+   \param borderStrength stroker radius for bordered fonts, 0 otherwise
+   */
+  CGUIGlyphRasterizer(const std::string &path, const XUTILS::auto_buffer &memory,
+                      float height, float aspect, long borderStrength);
+  ~CGUIGlyphRasterizer();
+
+  /*!
+   \brief Queue characters (as stored by CGUIFontTTFBase) for background rendering.
+   Characters already queued or waiting for collection are skipped.
+   */
+  void Request(const std::vector<uint32_t> &letterAndStyles);
+
+  /*!
+   \brief True if the character is queued, being rendered or ready for collection.
+   */
+  bool IsPending(uint32_t letterAndStyle) const;
+
+  /*!
+   \brief Take up to max rendered glyphs.
+   */
+  void Collect(std::vector<Glyph> &glyphs, size_t max);
+
+  /*!
+   \brief Drop all requests and wait for the glyph being rendered, if any.
+   The font file memory may be released once this returns.
+   */
+  void Cancel();
+
+  /*!
+   \brief Called by the job: render queued glyphs until the queue is empty.
+   */
+  void Process();
+
+private:
+  CGUIGlyphRasterizer(const CGUIGlyphRasterizer&) = delete;
+  CGUIGlyphRasterizer& operator=(const CGUIGlyphRasterizer&) = delete;
+
+  bool OpenFace();
+  void CloseFace();
+
+  mutable CCriticalSection m_section;
+  std::deque<uint32_t> m_queue;
+  std::set<uint32_t> m_pending;
+  std::vector<Glyph> m_ready;
+  bool m_running;                    // a job is queued or running
+  bool m_rendering;                  // the job is using the face
+  bool m_cancelled;
+  CEvent m_idle;
+
+  std::string m_path;
+  const XUTILS::auto_buffer &m_memory;
+  float m_height;
+  float m_aspect;
+  long m_borderStrength;
+
+  // only touched by the job thread while running
+  FT_Library m_library;
+  FT_Face m_face;
+  FT_Stroker m_stroker;
+  bool m_faceFailed;
+
+  // statistics
+  unsigned int m_rendered;
+};
@@ -53,6 +53,10 @@ public:
   void ResolveIncludes(TiXmlElement *node, std::map<INFO::InfoPtr, bool>* xmlIncludeConditions = NULL);
   const INFO::CSkinVariableString* CreateSkinVariable(const std::string& name, int context);
 
+  /*! \brief The include files loaded so far, in the order they were loaded
+   */
+  const std::vector<std::string>& GetFiles() const { return m_files; }
+
 private:
   enum ResolveParamsResult
   {
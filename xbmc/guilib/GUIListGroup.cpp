@@ -23,6 +23,8 @@
 #include "GUIMultiSelectText.h"
 #include "utils/log.h"
 
+#include <algorithm>
+
 CGUIListGroup::CGUIListGroup(int parentID, int controlID, float posX, float posY, float width, float height)
 : CGUIControlGroup(parentID, controlID, posX, posY, width, height)
 {
@@ -233,6 +235,21 @@ void CGUIListGroup::SetState(bool selected, bool focused)
   }
 }
 
+void CGUIListGroup::GetFonts(std::vector<CGUIFont*> &fonts) const
+{
+  for (ciControls it = m_children.begin(); it != m_children.end(); ++it)
+  {
+    if ((*it)->GetControlType() == CGUIControl::GUICONTROL_LISTLABEL)
+    {
+      CGUIFont *font = ((const CGUIListLabel *)(*it))->GetFont();
+      if (font && std::find(fonts.begin(), fonts.end(), font) == fonts.end())
+        fonts.push_back(font);
+    }
+    else if ((*it)->GetControlType() == CGUIControl::GUICONTROL_LISTGROUP)
+      ((const CGUIListGroup *)(*it))->GetFonts(fonts);
+  }
+}
+
 void CGUIListGroup::SelectItemFromPoint(const CPoint &point)
 {
   CPoint controlCoords(point);
@@ -27,6 +27,8 @@
 
 #include "GUIControlGroup.h"
 
+class CGUIFont;
+
 /*!
  \ingroup controls
  \brief a group of controls within a list/panel container
@@ -56,6 +58,11 @@ public:
   void SetState(bool selected, bool focused);
   void SelectItemFromPoint(const CPoint &point);
 
+  /*! \brief Collect the fonts of all labels in this group and its subgroups
+   \param fonts [in,out] fonts are added if not present already
+   */
+  void GetFonts(std::vector<CGUIFont*> &fonts) const;
+
 protected:
   const CGUIListItem *m_item;
 };
@@ -52,6 +52,7 @@ public:
   void SetWidth(float width);
   void SetHeight(float height);
   void SelectItemFromPoint(const CPoint &point);
+  void GetFonts(std::vector<CGUIFont*> &fonts) const { m_group.GetFonts(fonts); };
   bool MoveLeft();
   bool MoveRight();
 
@@ -51,6 +51,7 @@ public:
   void SetLabel(const std::string &label);
   void SetSelected(bool selected);
   void SetScrolling(bool scrolling);
+  CGUIFont *GetFont() const { return m_label.GetLabelInfo().font; };
 
   static void CheckAndCorrectOverlap(CGUIListLabel &label1, CGUIListLabel &label2)
   {
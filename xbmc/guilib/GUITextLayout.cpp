@@ -663,6 +663,22 @@ void CGUITextLayout::DrawText(CGUIFont *font, float x, float y, color_t color, c
   font->DrawText(x, y, color, shadowColor, utf32, align, 0);
 }
 
+void CGUITextLayout::Prefetch(CGUIFont *font, const std::vector<std::string> &labels)
+{
+  if (!font) return;
+  vecText utf32;
+  for (std::vector<std::string>::const_iterator it = labels.begin(); it != labels.end(); ++it)
+  {
+    std::wstring utf16;
+    g_charsetConverter.utf8ToW(*it, utf16, false);
+    vecText parsedText;
+    vecColors colors;
+    ParseText(utf16, font->GetStyle(), 0, colors, parsedText);
+    utf32.insert(utf32.end(), parsedText.begin(), parsedText.end());
+  }
+  font->Prefetch(utf32);
+}
+
 void CGUITextLayout::AppendToUTF32(const std::wstring &utf16, character_t colStyle, vecText &utf32)
 {
   // NOTE: Assumes a single line of text
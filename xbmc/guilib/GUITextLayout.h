@@ -110,6 +110,11 @@ public:
 
   static void DrawText(CGUIFont *font, float x, float y, color_t color, color_t shadowColor, const std::string &text, uint32_t align);
   static void Filter(std::string &text);
+  /*! \brief Queue the characters of labels for rendering in the background.
+   \param font the font the labels will be drawn with.
+   \param labels utf8 text, may contain formatting tags.
+   */
+  static void Prefetch(CGUIFont *font, const std::vector<std::string> &labels);
 
 protected:
   void LineBreakText(const vecText &text, std::vector<CGUIString> &lines);
@@ -246,6 +246,7 @@ void CGUITextureBase::Render(float left, float top, float right, float bottom, f
 
   int orientation = GetOrientation();
   OrientateTexture(texture, u3, v3, orientation);
+  texture += m_texOffset;
 
   if (m_diffuse.size())
   {
@@ -255,6 +256,7 @@ void CGUITextureBase::Render(float left, float top, float right, float bottom, f
     diffuse.y1 *= m_diffuseScaleV / v3; diffuse.y2 *= m_diffuseScaleV / v3;
     diffuse += m_diffuseOffset;
     OrientateTexture(diffuse, m_diffuseU, m_diffuseV, m_info.orientation);
+    diffuse += m_diffuseAtlasOffset;
   }
 
   float x[4], y[4], z[4];
@@ -360,6 +362,10 @@ bool CGUITextureBase::CalculateSize()
 
   m_texCoordsScaleU = 1.0f / m_texture.m_texWidth;
   m_texCoordsScaleV = 1.0f / m_texture.m_texHeight;
+  if (m_texture.m_texCoordsArePixels)
+    m_texOffset = CPoint((float)m_texture.m_texOffsetX, (float)m_texture.m_texOffsetY);
+  else
+    m_texOffset = CPoint(m_texture.m_texOffsetX * m_texCoordsScaleU, m_texture.m_texOffsetY * m_texCoordsScaleV);
 
   if (m_width == 0)
     m_width = m_frameWidth;
@@ -419,11 +425,13 @@ bool CGUITextureBase::CalculateSize()
     {
       m_diffuseU = float(m_diffuse.m_width);
       m_diffuseV = float(m_diffuse.m_height);
+      m_diffuseAtlasOffset = CPoint(float(m_diffuse.m_texOffsetX), float(m_diffuse.m_texOffsetY));
     }
     else
     {
       m_diffuseU = float(m_diffuse.m_width) / float(m_diffuse.m_texWidth);
       m_diffuseV = float(m_diffuse.m_height) / float(m_diffuse.m_texHeight);
+      m_diffuseAtlasOffset = CPoint(float(m_diffuse.m_texOffsetX) / float(m_diffuse.m_texWidth), float(m_diffuse.m_texOffsetY) / float(m_diffuse.m_texHeight));
     }
 
     if (m_aspect.scaleDiffuse)
@@ -465,6 +473,8 @@ void CGUITextureBase::FreeResources(bool immediately /* = false */)
 
   m_texCoordsScaleU = 1.0f;
   m_texCoordsScaleV = 1.0f;
+  m_texOffset = CPoint(0, 0);
+  m_diffuseAtlasOffset = CPoint(0, 0);
 
   // call our implementation
   Free();
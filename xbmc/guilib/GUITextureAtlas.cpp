@@ -0,0 +1,197 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "GUITextureAtlas.h"
+
+CGUITextureAtlas::CGUITextureAtlas()
+{
+  m_pageSize = 0;
+  m_maxPages = 0;
+}
+
+const unsigned int CGUITextureAtlas::NO_PAGE;
+
+void CGUITextureAtlas::Reset(unsigned int pageSize, unsigned int maxPages)
+{
+  m_pageSize = pageSize;
+  m_maxPages = maxPages < NO_PAGE ? maxPages : NO_PAGE;
+  Clear();
+}
+
+void CGUITextureAtlas::Clear()
+{
+  m_pages.clear();
+}
+
+bool CGUITextureAtlas::HasRoom(const Shelf &shelf, unsigned int width) const
+{
+  if (shelf.x + width <= m_pageSize)
+    return true;
+  for (std::vector<Span>::const_iterator i = shelf.free.begin(); i != shelf.free.end(); ++i)
+  {
+    if (i->width >= width)
+      return true;
+  }
+  return false;
+}
+
+bool CGUITextureAtlas::TakeSpan(Shelf &shelf, unsigned int width, unsigned int &x) const
+{
+  for (std::vector<Span>::iterator i = shelf.free.begin(); i != shelf.free.end(); ++i)
+  {
+    if (i->width >= width)
+    {
+      x = i->x;
+      i->x += width;
+      i->width -= width;
+      if (!i->width)
+        shelf.free.erase(i);
+      return true;
+    }
+  }
+  if (shelf.x + width > m_pageSize)
+    return false;
+  x = shelf.x;
+  shelf.x += width;
+  return true;
+}
+
+bool CGUITextureAtlas::Fit(Page &page, unsigned int width, unsigned int height, unsigned int &x, unsigned int &y)
+{
+  // use the lowest shelf that doesn't waste more than a third of its height
+  Shelf *best = nullptr;
+  for (std::vector<Shelf>::iterator i = page.shelves.begin(); i != page.shelves.end(); ++i)
+  {
+    if (i->height < height || i->height * 2 > height * 3)
+      continue;
+    if (best && best->height <= i->height)
+      continue;
+    if (HasRoom(*i, width))
+      best = &*i;
+  }
+
+  if (!best)
+  {
+    unsigned int shelfHeight = (height + TEXTURE_ATLAS_SHELF_ALIGN - 1) / TEXTURE_ATLAS_SHELF_ALIGN * TEXTURE_ATLAS_SHELF_ALIGN;
+    if (shelfHeight > m_pageSize)
+      shelfHeight = m_pageSize;
+    if (page.top + shelfHeight > m_pageSize)
+      return false;
+    Shelf shelf = { page.top, shelfHeight, 0, 0 };
+    page.shelves.push_back(shelf);
+    page.top += shelfHeight;
+    best = &page.shelves.back();
+  }
+
+  TakeSpan(*best, width, x);
+  y = best->y;
+  best->images++;
+  page.images++;
+  page.area += width * height;
+  return true;
+}
+
+bool CGUITextureAtlas::Allocate(unsigned int width, unsigned int height, unsigned int &page, unsigned int &x, unsigned int &y)
+{
+  if (!width || !height || width > m_pageSize || height > m_pageSize)
+    return false;
+
+  // fill the pages in use before starting another one
+  for (unsigned int i = 0; i < m_pages.size(); i++)
+  {
+    if (m_pages[i].images && Fit(m_pages[i], width, height, x, y))
+    {
+      page = i;
+      return true;
+    }
+  }
+
+  for (page = 0; page < m_pages.size(); page++)
+  {
+    if (!m_pages[page].images)
+      break;
+  }
+  if (page == m_pages.size())
+  {
+    if (m_pages.size() >= m_maxPages)
+      return false;
+    Page fresh = { std::vector<Shelf>(), 0, 0, 0 };
+    m_pages.push_back(fresh);
+  }
+  return Fit(m_pages[page], width, height, x, y);
+}
+
+bool CGUITextureAtlas::Release(unsigned int page, unsigned int x, unsigned int y, unsigned int width, unsigned int height)
+{
+  if (page >= m_pages.size())
+    return false;
+
+  Page &p = m_pages[page];
+  std::vector<Shelf>::iterator shelf = p.shelves.begin();
+  while (shelf != p.shelves.end() && shelf->y != y)
+    ++shelf;
+  if (shelf == p.shelves.end() || !shelf->images)
+    return false;
+
+  // keep the free spans sorted and merged with their neighbours
+  std::vector<Span>::iterator next = shelf->free.begin();
+  while (next != shelf->free.end() && next->x < x)
+    ++next;
+  Span span = { x, width };
+  if (next != shelf->free.end() && span.x + span.width == next->x)
+  {
+    span.width += next->width;
+    next = shelf->free.erase(next);
+  }
+  if (next != shelf->free.begin() && (next - 1)->x + (next - 1)->width == span.x)
+  {
+    (next - 1)->width += span.width;
+    span = *(next - 1);
+    next = shelf->free.erase(next - 1);
+  }
+  if (span.x + span.width == shelf->x)
+    shelf->x = span.x;
+  else
+    shelf->free.insert(next, span);
+
+  shelf->images--;
+  if (!shelf->images)
+  {
+    shelf->x = 0;
+    shelf->free.clear();
+  }
+
+  // drop empty shelves at the end so the room can go to other heights
+  while (!p.shelves.empty() && !p.shelves.back().images)
+  {
+    p.top = p.shelves.back().y;
+    p.shelves.pop_back();
+  }
+
+  p.images--;
+  p.area -= width * height;
+  if (p.images)
+    return false;
+
+  p.shelves.clear();
+  p.top = 0;
+  p.area = 0;
+  return true;
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <vector>
+
+#define TEXTURE_ATLAS_PAGE_SIZE 1024 // width and height of an atlas page in pixels
+#define TEXTURE_ATLAS_MAX_PAGES 4
+#define TEXTURE_ATLAS_MAX_IMAGE 256  // images larger than this in either direction get their own texture
+#define TEXTURE_ATLAS_SHELF_ALIGN 4  // shelf heights are a multiple of this
+
+/*!
+ \ingroup textures
+ \brief Places small images in a set of square texture pages.
+
+ Each page is split into shelves, horizontal bands as high as the first image
+ placed in them (rounded up to TEXTURE_ATLAS_SHELF_ALIGN). Images go into the
+ lowest shelf they fit in without wasting more than a third of its height.
+ Space given back is kept as free spans per shelf and handed out again, so
+ skins that keep loading and releasing textures as windows open and close
+ don't run out of room. A shelf that becomes empty is reset, and a page that
+ becomes empty is reported back to the caller so its texture can be freed.
+
+ The class only does the bookkeeping, the pixels are owned by the caller.
+ */
+class CGUITextureAtlas
+{
+public:
+  static const unsigned int NO_PAGE = 0xffff;
+
+  CGUITextureAtlas();
+
+  /*!
+   \brief Set the geometry and drop all pages.
+   \param pageSize width and height of a page in pixels
+   \param maxPages largest number of pages in use at the same time
+   */
+  void Reset(unsigned int pageSize, unsigned int maxPages);
+
+  /*!
+   \brief Drop all pages, keeping the geometry.
+   */
+  void Clear();
+
+  /*!
+   \brief Find room for an image.
+   \param width width of the image in pixels, including any padding
+   \param height height of the image in pixels, including any padding
+   \param page [out] page the image was placed in
+   \param x [out] left edge of the image in the page
+   \param y [out] top edge of the image in the page
+   \return false if the image doesn't fit in any page
+   */
+  bool Allocate(unsigned int width, unsigned int height, unsigned int &page, unsigned int &x, unsigned int &y);
+
+  /*!
+   \brief Give back the room of an image placed by Allocate().
+   \return true if the page is empty afterwards
+   */
+  bool Release(unsigned int page, unsigned int x, unsigned int y, unsigned int width, unsigned int height);
+
+  unsigned int GetPageSize() const { return m_pageSize; }
+  unsigned int GetMaxPages() const { return m_maxPages; }
+
+  /*!
+   \brief Number of page slots, used or not. Slots of empty pages are reused.
+   */
+  unsigned int GetPageCount() const { return m_pages.size(); }
+  bool IsPageUsed(unsigned int page) const { return page < m_pages.size() && m_pages[page].images > 0; }
+
+  /*!
+   \brief Pixels covered by images in a page, for statistics.
+   */
+  unsigned int GetUsedArea(unsigned int page) const { return page < m_pages.size() ? m_pages[page].area : 0; }
+
+private:
+  struct Span
+  {
+    unsigned int x;
+    unsigned int width;
+  };
+
+  struct Shelf
+  {
+    unsigned int y;
+    unsigned int height;
+    unsigned int x;          // end of the used part
+    unsigned int images;
+    std::vector<Span> free;  // released spans before x, sorted by position
+  };
+
+  struct Page
+  {
+    std::vector<Shelf> shelves;
+    unsigned int top;        // end of the last shelf
+    unsigned int images;
+    unsigned int area;
+  };
+
+  bool Fit(Page &page, unsigned int width, unsigned int height, unsigned int &x, unsigned int &y);
+  bool HasRoom(const Shelf &shelf, unsigned int width) const;
+  bool TakeSpan(Shelf &shelf, unsigned int width, unsigned int &x) const;
+
+  std::vector<Page> m_pages;
+  unsigned int m_pageSize;
+  unsigned int m_maxPages;
+};
@@ -21,6 +21,7 @@
 #ifdef HAS_DX
 
 #include "D3DResource.h"
+#include "GUIControlProfiler.h"
 #include "GUIShaderDX.h"
 #include "GUITextureD3D.h"
 #include "Texture.h"
@@ -124,13 +125,17 @@ void CGUITextureD3D::Draw(float *x, float *y, float *z, const CRect &texture, co
     CDXTexture* diff = (CDXTexture *)m_diffuse.m_textures[0];
     ID3D11ShaderResourceView* resource[] = { tex->GetShaderResource(), diff->GetShaderResource() };
     pGUIShader->SetShaderViews(ARRAYSIZE(resource), resource);
+    GUIPROFILER_TEXTURE_BIND(tex);
+    GUIPROFILER_TEXTURE_BIND(diff);
   }
   else
   {
     ID3D11ShaderResourceView* resource = tex->GetShaderResource();
     pGUIShader->SetShaderViews(1, &resource);
+    GUIPROFILER_TEXTURE_BIND(tex);
   }
   pGUIShader->DrawQuad(verts[0], verts[1], verts[2], verts[3]);
+  GUIPROFILER_DRAW_CALL();
 }
 
 void CGUITextureD3D::DrawQuad(const CRect &rect, color_t color, CBaseTexture *texture, const CRect *texCoords)
@@ -145,7 +150,10 @@ void CGUITextureD3D::DrawQuad(const CRect &rect, color_t color, CBaseTexture *te
     views = ((CDXTexture *)texture)->GetShaderResource();
   }
 
+  if (texture)
+    GUIPROFILER_TEXTURE_BIND(texture);
   CD3DTexture::DrawQuad(rect, color, numViews, &views, texCoords, texture ? SHADER_METHOD_RENDER_TEXTURE_BLEND : SHADER_METHOD_RENDER_DEFAULT);
+  GUIPROFILER_DRAW_CALL();
 }
 
 #endif
\ No newline at end of file
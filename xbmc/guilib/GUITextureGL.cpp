@@ -22,6 +22,7 @@
 #if defined(HAS_GL)
 #include "GUITextureGL.h"
 #endif
+#include "GUIControlProfiler.h"
 #include "Texture.h"
 #include "utils/log.h"
 #include "utils/GLUtils.h"
@@ -55,6 +56,7 @@ void CGUITextureGL::Begin(color_t color)
     m_diffuse.m_textures[0]->LoadToGPU();
 
   texture->BindToUnit(unit++);
+  GUIPROFILER_TEXTURE_BIND(texture);
 
   glBlendFunc(GL_SRC_ALPHA,GL_ONE_MINUS_SRC_ALPHA);
   glEnable(GL_BLEND);          // Turn Blending On
@@ -78,6 +80,7 @@ void CGUITextureGL::Begin(color_t color)
   if (m_diffuse.size())
   {
     m_diffuse.m_textures[0]->BindToUnit(unit++);
+    GUIPROFILER_TEXTURE_BIND(m_diffuse.m_textures[0]);
     glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_COMBINE);
     glTexEnvf(GL_TEXTURE_ENV, GL_COMBINE_RGB, GL_MODULATE);
     glTexEnvf(GL_TEXTURE_ENV, GL_SOURCE0_RGB, GL_TEXTURE);
@@ -96,6 +99,7 @@ void CGUITextureGL::Begin(color_t color)
   if(g_Windowing.UseLimitedColor())
   {
     texture->BindToUnit(unit++); // dummy bind
+    GUIPROFILER_TEXTURE_BIND(texture);
     const GLfloat rgba[4] = {16.0f / 255.0f, 16.0f / 255.0f, 16.0f / 255.0f, 0.0f};
     glTexEnvi (GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE , GL_COMBINE);
     glTexEnvfv(GL_TEXTURE_ENV, GL_TEXTURE_ENV_COLOR, rgba);
@@ -118,14 +122,14 @@ void CGUITextureGL::Begin(color_t color)
 void CGUITextureGL::End()
 {
   glEnd();
+  GUIPROFILER_DRAW_CALL();
+  // leave the textures bound so the next texture drawn from the same page
+  // can skip its bind, disabling the units is enough
   glActiveTexture(GL_TEXTURE2_ARB);
-  glBindTexture(GL_TEXTURE_2D, 0);
   glDisable(GL_TEXTURE_2D);
   glActiveTexture(GL_TEXTURE1_ARB);
-  glBindTexture(GL_TEXTURE_2D, 0);
   glDisable(GL_TEXTURE_2D);
   glActiveTexture(GL_TEXTURE0_ARB);
-  glBindTexture(GL_TEXTURE_2D, 0);
   glDisable(GL_TEXTURE_2D);
 }
 
@@ -182,6 +186,7 @@ void CGUITextureGL::DrawQuad(const CRect &rect, color_t color, CBaseTexture *tex
   {
     texture->LoadToGPU();
     texture->BindToUnit(0);
+    GUIPROFILER_TEXTURE_BIND(texture);
     glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_COMBINE);
     glTexEnvf(GL_TEXTURE_ENV, GL_COMBINE_RGB, GL_MODULATE);
     glTexEnvf(GL_TEXTURE_ENV, GL_SOURCE0_RGB, GL_TEXTURE1);
@@ -220,6 +225,7 @@ void CGUITextureGL::DrawQuad(const CRect &rect, color_t color, CBaseTexture *tex
   glVertex3f(rect.x1, rect.y2, 0);
 
   glEnd();
+  GUIPROFILER_DRAW_CALL();
   if (texture)
     glDisable(GL_TEXTURE_2D);
 }
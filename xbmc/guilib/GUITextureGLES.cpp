@@ -22,6 +22,7 @@
 #if defined(HAS_GLES)
 #include "GUITextureGLES.h"
 #endif
+#include "GUIControlProfiler.h"
 #include "Texture.h"
 #include "utils/log.h"
 #include "utils/GLUtils.h"
@@ -47,6 +48,7 @@ void CGUITextureGLES::Begin(color_t color)
     m_diffuse.m_textures[0]->LoadToGPU();
 
   texture->BindToUnit(0);
+  GUIPROFILER_TEXTURE_BIND(texture);
 
   // Setup Colors
   m_col[0] = (GLubyte)GET_R(color);
@@ -70,6 +72,7 @@ void CGUITextureGLES::Begin(color_t color)
     hasAlpha |= m_diffuse.m_textures[0]->HasAlpha();
 
     m_diffuse.m_textures[0]->BindToUnit(1);
+    GUIPROFILER_TEXTURE_BIND(m_diffuse.m_textures[0]);
 
   }
   else
@@ -119,6 +122,7 @@ void CGUITextureGLES::End()
   glEnableVertexAttribArray(tex0Loc);
 
   glDrawElements(GL_TRIANGLES, m_packedVertices.size()*6 / 4, GL_UNSIGNED_SHORT, m_idx.data());
+  GUIPROFILER_DRAW_CALL();
 
   if (m_diffuse.size())
   {
@@ -225,6 +229,7 @@ void CGUITextureGLES::DrawQuad(const CRect &rect, color_t color, CBaseTexture *t
   {
     texture->LoadToGPU();
     texture->BindToUnit(0);
+    GUIPROFILER_TEXTURE_BIND(texture);
   }
 
   glBlendFunc(GL_SRC_ALPHA,GL_ONE_MINUS_SRC_ALPHA);
@@ -278,6 +283,7 @@ void CGUITextureGLES::DrawQuad(const CRect &rect, color_t color, CBaseTexture *t
     tex[2][1] = tex[3][1] = coords.y2;
   }
   glDrawElements(GL_TRIANGLE_STRIP, 4, GL_UNSIGNED_BYTE, idx);
+  GUIPROFILER_DRAW_CALL();
 
   glDisableVertexAttribArray(posLoc);
   if (texture)
@@ -45,6 +45,19 @@
 
 using namespace KODI::MESSAGING;
 
+static bool IsWindowElement(const TiXmlElement *pRootElement)
+{
+  if (!pRootElement)
+    return false;
+
+  if (strcmpi(pRootElement->Value(), "window"))
+  {
+    CLog::Log(LOGERROR, "file : XML file doesnt contain <window>");
+    return false;
+  }
+  return true;
+}
+
 bool CGUIWindow::icompare::operator()(const std::string &s1, const std::string &s2) const
 {
   return StringUtils::CompareNoCase(s1, s2) < 0;
@@ -69,6 +82,7 @@ CGUIWindow::CGUIWindow(int id, const std::string &xmlFile)
   m_exclusiveMouseControl = 0;
   m_clearBackground = 0xff000000; // opaque black -> always clear
   m_windowXMLRootElement = NULL;
+  m_parseTime = 0;
   m_menuControlID = 0;
   m_menuLastFocusedControlID = 0;
 }
@@ -107,9 +121,24 @@ bool CGUIWindow::Load(const std::string& strFileName, bool bContainsPath)
   }
   CLog::Log(LOGINFO, "Loading skin file: %s, load type: %s", strFileName.c_str(), strLoadType);
   
-  // Find appropriate skin folder + resolution to load from
   std::string strPath;
   std::string strLowerPath;
+  GetXMLPaths(strFileName, bContainsPath, strPath, strLowerPath);
+
+  bool ret = LoadXML(strPath, strLowerPath);
+
+#ifdef _DEBUG
+  int64_t end, freq;
+  end = CurrentHostCounter();
+  freq = CurrentHostFrequency();
+  CLog::Log(LOGDEBUG,"Load %s: %.2fms", GetProperty("xmlfile").c_str(), 1000.f * (end - start) / freq);
+#endif
+  return ret;
+}
+
+void CGUIWindow::GetXMLPaths(const std::string &strFileName, bool bContainsPath, std::string &strPath, std::string &strLowerPath)
+{
+  // Find appropriate skin folder + resolution to load from
   if (bContainsPath)
     strPath = strFileName;
   else
@@ -120,50 +149,86 @@ bool CGUIWindow::Load(const std::string& strFileName, bool bContainsPath)
     strLowerPath =  g_SkinInfo->GetSkinPath(strFileNameLower, &m_coordsRes);
     strPath = g_SkinInfo->GetSkinPath(strFileName, &m_coordsRes);
   }
+}
 
-  bool ret = LoadXML(strPath, strLowerPath);
+void CGUIWindow::Prefetch()
+{
+  if (m_windowLoaded || m_windowXMLRootElement || m_cachedWindow || g_SkinInfo == NULL)
+    return;
 
-#ifdef _DEBUG
-  int64_t end, freq;
-  end = CurrentHostCounter();
-  freq = CurrentHostFrequency();
-  CLog::Log(LOGDEBUG,"Load %s: %.2fms", GetProperty("xmlfile").c_str(), 1000.f * (end - start) / freq);
-#endif
-  return ret;
+  std::string xmlFile = GetProperty("xmlfile").asString();
+  if (xmlFile.empty())
+    return;
+
+  bool bHasPath = xmlFile.find("\\") != std::string::npos || xmlFile.find("/") != std::string::npos;
+  std::string strPath;
+  std::string strLowerPath;
+  GetXMLPaths(xmlFile, bHasPath, strPath, strLowerPath);
+  PrefetchXML(strPath, strLowerPath);
+}
+
+bool CGUIWindow::PrefetchXML(const std::string &strPath, const std::string &strLowerPath)
+{
+  // a skin cache entry with unchanged files saves parsing the xml
+  m_cachedWindow.reset(new CGUIWindowCache::Entry);
+  if (CGUIWindowCache::Read(strPath, *m_cachedWindow))
+    return true;
+  m_cachedWindow.reset();
+
+  return ParseXML(strPath, strLowerPath);
+}
+
+bool CGUIWindow::ParseXML(const std::string &strPath, const std::string &strLowerPath)
+{
+  int64_t start = CurrentHostCounter();
+  CXBMCTinyXML xmlDoc;
+  std::string strPathLower = strPath;
+  StringUtils::ToLower(strPathLower);
+  if (!xmlDoc.LoadFile(strPath) && !xmlDoc.LoadFile(strPathLower) && !xmlDoc.LoadFile(strLowerPath))
+  {
+    CLog::Log(LOGERROR, "unable to load:%s, Line %d\n%s", strPath.c_str(), xmlDoc.ErrorRow(), xmlDoc.ErrorDesc());
+    SetID(WINDOW_INVALID);
+    return false;
+  }
+  m_windowXMLRootElement = (TiXmlElement*)xmlDoc.RootElement()->Clone();
+  m_parseTime = 1000.f * (CurrentHostCounter() - start) / CurrentHostFrequency();
+  return true;
 }
 
 bool CGUIWindow::LoadXML(const std::string &strPath, const std::string &strLowerPath)
 {
-  // load window xml if we don't have it stored yet
-  if (!m_windowXMLRootElement)
+  // set the scaling resolution so that any control creation or initialisation can
+  // be done with respect to the correct aspect ratio
+  g_graphicsContext.SetScalingResolution(m_coordsRes, m_needsScaling);
+
+  // load window xml if we don't have it stored or prefetched yet
+  if (!m_windowXMLRootElement && !m_cachedWindow && !PrefetchXML(strPath, strLowerPath))
+    return false;
+
+  // windows with unchanged files and include conditions come resolved from the skin cache
+  if (m_cachedWindow)
   {
-    CXBMCTinyXML xmlDoc;
-    std::string strPathLower = strPath;
-    StringUtils::ToLower(strPathLower);
-    if (!xmlDoc.LoadFile(strPath) && !xmlDoc.LoadFile(strPathLower) && !xmlDoc.LoadFile(strLowerPath))
-    {
-      CLog::Log(LOGERROR, "unable to load:%s, Line %d\n%s", strPath.c_str(), xmlDoc.ErrorRow(), xmlDoc.ErrorDesc());
-      SetID(WINDOW_INVALID);
+    std::unique_ptr<CGUIWindowCache::Entry> entry(std::move(m_cachedWindow));
+    TiXmlElement *pRootElement = g_SkinInfo->LoadCachedWindow(*entry, m_xmlIncludeConditions);
+    if (pRootElement)
+      return LoadResolved(pRootElement);
+    if (!ParseXML(strPath, strLowerPath))
       return false;
-    }
-    m_windowXMLRootElement = (TiXmlElement*)xmlDoc.RootElement()->Clone();
   }
-  else
-    CLog::Log(LOGDEBUG, "Using already stored xml root node for %s", strPath.c_str());
 
-  return Load(m_windowXMLRootElement);
+  if (!IsWindowElement(m_windowXMLRootElement))
+    return false;
+
+  // resolve a copy of the stored root element, it is used again on reload
+  TiXmlElement *pRootElement = (TiXmlElement*)m_windowXMLRootElement->Clone();
+  g_SkinInfo->ResolveWindowIncludes(pRootElement, strPath, m_xmlIncludeConditions, m_parseTime);
+  return LoadResolved(pRootElement);
 }
 
 bool CGUIWindow::Load(TiXmlElement* pRootElement)
 {
-  if (!pRootElement)
+  if (!IsWindowElement(pRootElement))
     return false;
-  
-  if (strcmpi(pRootElement->Value(), "window"))
-  {
-    CLog::Log(LOGERROR, "file : XML file doesnt contain <window>");
-    return false;
-  }
 
   // we must create copy of root element as we will manipulate it when resolving includes
   // and we don't want original root element to change
@@ -175,6 +240,17 @@ bool CGUIWindow::Load(TiXmlElement* pRootElement)
 
   // Resolve any includes that may be present and save conditions used to do it
   g_SkinInfo->ResolveIncludes(pRootElement, &m_xmlIncludeConditions);
+  return LoadResolved(pRootElement);
+}
+
+bool CGUIWindow::LoadResolved(TiXmlElement* pRootElement)
+{
+  if (!IsWindowElement(pRootElement))
+  {
+    delete pRootElement;
+    return false;
+  }
+
   // now load in the skin file
   SetDefaults();
 
@@ -810,6 +886,7 @@ void CGUIWindow::FreeResources(bool forceUnload /*= FALSE */)
   {
     delete m_windowXMLRootElement;
     m_windowXMLRootElement = NULL;
+    m_cachedWindow.reset();
     m_xmlIncludeConditions.clear();
   }
 }
@@ -1049,6 +1126,7 @@ void CGUIWindow::SetProperty(const std::string &strKey, const CVariant &value)
 {
   CSingleLock lock(*this);
   m_mapProperties[strKey] = value;
+  g_infoManager.NotifyChanged(INFO::DEPENDS_WINDOW);
 }
 
 CVariant CGUIWindow::GetProperty(const std::string &strKey) const
@@ -1065,6 +1143,7 @@ void CGUIWindow::ClearProperties()
 {
   CSingleLock lock(*this);
   m_mapProperties.clear();
+  g_infoManager.NotifyChanged(INFO::DEPENDS_WINDOW);
 }
 
 void CGUIWindow::SetRunActionsManually()
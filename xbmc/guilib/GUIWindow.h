@@ -29,6 +29,7 @@
  */
 
 #include "GUIControlGroup.h"
+#include "GUIWindowCache.h"
 #include <memory>
 #include "threads/CriticalSection.h"
 
@@ -94,6 +95,13 @@ public:
   bool Initialize();  // loads the window
   bool Load(const std::string& strFileName, bool bContainsPath = false);
 
+  /*! \brief Read the window xml ahead of loading the window
+   Reads the skin cache entry of the window or parses its xml, which the next load
+   then uses. Resolving includes and creating the controls is left to the load, so
+   this may be called from any thread as long as the window isn't loaded at the same time.
+   */
+  void Prefetch();
+
   void CenterWindow();
 
   virtual void DoProcess(unsigned int currentTime, CDirtyRegionList &dirtyregions);
@@ -203,7 +211,11 @@ public:
 protected:
   virtual EVENT_RESULT OnMouseEvent(const CPoint &point, const CMouseEvent &event);
   virtual bool LoadXML(const std::string& strPath, const std::string &strLowerPath);  ///< Loads from the given file
+  bool PrefetchXML(const std::string &strPath, const std::string &strLowerPath);      ///< Reads the skin cache entry or parses the given file
+  bool ParseXML(const std::string &strPath, const std::string &strLowerPath);         ///< Parses the given file into m_windowXMLRootElement
+  void GetXMLPaths(const std::string &strFileName, bool bContainsPath, std::string &strPath, std::string &strLowerPath);
   bool Load(TiXmlElement *pRootElement);                 ///< Loads from the given XML root element
+  bool LoadResolved(TiXmlElement *pRootElement);         ///< Loads from the given XML root element with includes resolved, takes ownership
   /*! \brief Check if XML file needs (re)loading
    XML file has to be (re)loaded when window is not loaded or include conditions values were changed
    */
@@ -275,6 +287,8 @@ protected:
   CGUIAction m_unloadActions;
 
   TiXmlElement* m_windowXMLRootElement;
+  float m_parseTime; ///< time in ms it took to parse m_windowXMLRootElement
+  std::unique_ptr<CGUIWindowCache::Entry> m_cachedWindow; ///< skin cache entry read ahead of loading the window
 
   bool m_manualRunActions;
 
@@ -0,0 +1,491 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "GUIWindowCache.h"
+
+#include <algorithm>
+#include <set>
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+
+#include "GUIIncludes.h"
+#include "GUIInfoManager.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "utils/auto_buffer.h"
+#include "utils/Crc32.h"
+#include "utils/log.h"
+#include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
+#include "utils/XBMCTinyXML.h"
+
+using namespace XFILE;
+
+#define CACHE_PATH    "special://temp/skincache/"
+#define CACHE_MAGIC   "KSWC"
+#define CACHE_VERSION 1
+
+// guards against corrupt entries blowing the stack, no skin comes close
+#define MAX_DEPTH     256
+
+namespace
+{
+
+enum NodeTag
+{
+  NODE_ELEMENT = 0,
+  NODE_TEXT
+};
+
+class CWriter
+{
+public:
+  explicit CWriter(std::string &data) : m_data(data) {}
+
+  void WriteByte(uint8_t value)
+  {
+    m_data.push_back((char)value);
+  }
+
+  void WriteVarInt(uint64_t value)
+  {
+    while (value >= 0x80)
+    {
+      WriteByte((uint8_t)(value | 0x80));
+      value >>= 7;
+    }
+    WriteByte((uint8_t)value);
+  }
+
+  void WriteString(const std::string &value)
+  {
+    WriteVarInt(value.size());
+    m_data.append(value);
+  }
+
+private:
+  std::string &m_data;
+};
+
+class CReader
+{
+public:
+  CReader(const char *data, size_t size) : m_data(data), m_size(size), m_pos(0) {}
+
+  bool ReadByte(uint8_t &value)
+  {
+    if (m_pos >= m_size)
+      return false;
+    value = (uint8_t)m_data[m_pos++];
+    return true;
+  }
+
+  bool ReadVarInt(uint64_t &value)
+  {
+    value = 0;
+    for (unsigned int shift = 0; shift < 64; shift += 7)
+    {
+      uint8_t byte;
+      if (!ReadByte(byte))
+        return false;
+      value |= (uint64_t)(byte & 0x7f) << shift;
+      if (!(byte & 0x80))
+        return true;
+    }
+    return false;
+  }
+
+  bool ReadString(std::string &value)
+  {
+    uint64_t size;
+    if (!ReadVarInt(size) || size > m_size - m_pos)
+      return false;
+    value.assign(m_data + m_pos, (size_t)size);
+    m_pos += (size_t)size;
+    return true;
+  }
+
+  const char *GetData() const { return m_data + m_pos; }
+  size_t GetRemaining() const { return m_size - m_pos; }
+
+private:
+  const char *m_data;
+  size_t m_size;
+  size_t m_pos;
+};
+
+class CTreeWriter
+{
+public:
+  void WriteElement(const TiXmlElement *element)
+  {
+    CWriter writer(m_tree);
+    writer.WriteVarInt(Intern(element->ValueStr()));
+
+    size_t attributes = 0;
+    for (const TiXmlAttribute *attribute = element->FirstAttribute(); attribute; attribute = attribute->Next())
+      attributes++;
+    writer.WriteVarInt(attributes);
+    for (const TiXmlAttribute *attribute = element->FirstAttribute(); attribute; attribute = attribute->Next())
+    {
+      writer.WriteVarInt(Intern(attribute->Name()));
+      writer.WriteVarInt(Intern(attribute->Value()));
+    }
+
+    size_t children = 0;
+    for (const TiXmlNode *child = element->FirstChild(); child; child = child->NextSibling())
+    {
+      if (child->ToElement() || child->ToText())
+        children++;
+    }
+    writer.WriteVarInt(children);
+    for (const TiXmlNode *child = element->FirstChild(); child; child = child->NextSibling())
+    {
+      if (child->ToElement())
+      {
+        CWriter(m_tree).WriteByte(NODE_ELEMENT);
+        WriteElement(child->ToElement());
+      }
+      else if (child->ToText())
+      {
+        CWriter(m_tree).WriteByte(NODE_TEXT);
+        CWriter(m_tree).WriteVarInt(Intern(child->ValueStr()));
+      }
+    }
+  }
+
+  void Finish(std::string &data) const
+  {
+    CWriter writer(data);
+    writer.WriteVarInt(m_strings.size());
+    for (std::vector<const std::string*>::const_iterator it = m_strings.begin(); it != m_strings.end(); ++it)
+      writer.WriteString(**it);
+    data.append(m_tree);
+  }
+
+private:
+  size_t Intern(const std::string &value)
+  {
+    std::unordered_map<std::string, size_t>::const_iterator it = m_index.find(value);
+    if (it != m_index.end())
+      return it->second;
+    it = m_index.insert(std::make_pair(value, m_strings.size())).first;
+    m_strings.push_back(&it->first);
+    return it->second;
+  }
+
+  std::unordered_map<std::string, size_t> m_index;
+  std::vector<const std::string*> m_strings;
+  std::string m_tree;
+};
+
+bool ReadIndex(CReader &reader, const std::vector<std::string> &strings, size_t &index)
+{
+  uint64_t value;
+  if (!reader.ReadVarInt(value) || value >= strings.size())
+    return false;
+  index = (size_t)value;
+  return true;
+}
+
+TiXmlElement* ReadElement(CReader &reader, const std::vector<std::string> &strings, unsigned int depth)
+{
+  size_t name;
+  if (depth > MAX_DEPTH || !ReadIndex(reader, strings, name))
+    return NULL;
+
+  TiXmlElement *element = new TiXmlElement(strings[name]);
+
+  uint64_t count;
+  bool valid = reader.ReadVarInt(count);
+  for (uint64_t i = 0; valid && i < count; i++)
+  {
+    size_t attribute, value;
+    valid = ReadIndex(reader, strings, attribute) && ReadIndex(reader, strings, value);
+    if (valid)
+      element->SetAttribute(strings[attribute], strings[value]);
+  }
+
+  valid = valid && reader.ReadVarInt(count);
+  for (uint64_t i = 0; valid && i < count; i++)
+  {
+    uint8_t tag;
+    valid = reader.ReadByte(tag);
+    if (!valid)
+      break;
+    if (tag == NODE_ELEMENT)
+    {
+      TiXmlElement *child = ReadElement(reader, strings, depth + 1);
+      if (child)
+        element->LinkEndChild(child);
+      else
+        valid = false;
+    }
+    else if (tag == NODE_TEXT)
+    {
+      size_t text;
+      valid = ReadIndex(reader, strings, text);
+      if (valid)
+        element->LinkEndChild(new TiXmlText(strings[text]));
+    }
+    else
+      valid = false;
+  }
+
+  if (!valid)
+  {
+    delete element;
+    return NULL;
+  }
+  return element;
+}
+
+TiXmlElement* ReadTree(CReader &reader)
+{
+  uint64_t count;
+  if (!reader.ReadVarInt(count) || count > reader.GetRemaining())
+    return NULL;
+
+  std::vector<std::string> strings((size_t)count);
+  for (std::vector<std::string>::iterator it = strings.begin(); it != strings.end(); ++it)
+  {
+    if (!reader.ReadString(*it))
+      return NULL;
+  }
+  return ReadElement(reader, strings, 0);
+}
+
+bool GetFileStamp(const std::string &path, uint64_t &mtime, uint64_t &size)
+{
+  struct __stat64 buffer;
+  if (CFile::Stat(path, &buffer) != 0)
+    return false;
+  mtime = (uint64_t)buffer.st_mtime;
+  size = (uint64_t)buffer.st_size;
+  return true;
+}
+
+bool WriteFileStamp(CWriter &writer, const std::string &path)
+{
+  uint64_t mtime, size;
+  if (!GetFileStamp(path, mtime, size))
+    return false;
+  writer.WriteString(path);
+  writer.WriteVarInt(mtime);
+  writer.WriteVarInt(size);
+  return true;
+}
+
+bool ReadFileStamp(CReader &reader, std::string &path)
+{
+  uint64_t mtime, size, currentMtime, currentSize;
+  return reader.ReadString(path) && reader.ReadVarInt(mtime) && reader.ReadVarInt(size) &&
+         GetFileStamp(path, currentMtime, currentSize) && mtime == currentMtime && size == currentSize;
+}
+
+}
+
+CGUIWindowCache::Entry::Entry() : root(NULL), loadTime(0), readTime(0)
+{
+}
+
+CGUIWindowCache::Entry::~Entry()
+{
+  delete root;
+}
+
+bool CGUIWindowCache::Read(const std::string &path, Entry &entry)
+{
+  int64_t start = CurrentHostCounter();
+  std::string cacheFile = GetCacheFile(path);
+  if (!CFile::Exists(cacheFile))
+    return false;
+
+  XUTILS::auto_buffer buffer;
+  if (CFile().LoadFile(cacheFile, buffer) <= 0)
+    return false;
+
+  CReader reader(buffer.get(), buffer.size());
+  std::string magic;
+  uint8_t version;
+  if (!reader.ReadString(magic) || magic != CACHE_MAGIC || !reader.ReadByte(version) || version != CACHE_VERSION)
+    return false;
+
+  if (!ReadFileStamp(reader, entry.path) || entry.path != path)
+    return false;
+
+  uint64_t count;
+  if (!reader.ReadVarInt(count))
+    return false;
+  for (uint64_t i = 0; i < count; i++)
+  {
+    std::string file;
+    uint8_t preloaded;
+    if (!ReadFileStamp(reader, file) || !reader.ReadByte(preloaded))
+      return false;
+    entry.includes.push_back(std::make_pair(file, preloaded != 0));
+  }
+
+  if (!reader.ReadVarInt(count))
+    return false;
+  for (uint64_t i = 0; i < count; i++)
+  {
+    std::string expression;
+    uint8_t value;
+    if (!reader.ReadString(expression) || !reader.ReadByte(value))
+      return false;
+    entry.conditions.push_back(std::make_pair(expression, value != 0));
+  }
+
+  uint64_t time;
+  if (!reader.ReadVarInt(time))
+    return false;
+  entry.loadTime = time / 1000.0f;
+
+  entry.root = ReadTree(reader);
+  if (!entry.root)
+  {
+    CLog::Log(LOGERROR, "CGUIWindowCache: invalid entry %s for %s", cacheFile.c_str(), path.c_str());
+    return false;
+  }
+  entry.readTime = 1000.f * (CurrentHostCounter() - start) / CurrentHostFrequency();
+  return true;
+}
+
+TiXmlElement* CGUIWindowCache::Load(Entry &entry, CGUIIncludes &includes, std::map<INFO::InfoPtr, bool> &xmlIncludeConditions)
+{
+  if (!entry.root)
+    return NULL;
+
+  // every include file the skin has loaded must have been there when the window was
+  // resolved and those loaded with the skin must still be loaded. Files the window
+  // loaded on demand are loaded once the entry turns out to be valid.
+  const std::vector<std::string> &loaded = includes.GetFiles();
+  std::set<std::string> files;
+  std::vector<std::string> onDemand;
+  for (std::vector<std::pair<std::string, bool> >::const_iterator it = entry.includes.begin(); it != entry.includes.end(); ++it)
+  {
+    if (std::find(loaded.begin(), loaded.end(), it->first) == loaded.end())
+    {
+      if (it->second)
+        return NULL;
+      onDemand.push_back(it->first);
+    }
+    files.insert(it->first);
+  }
+  for (std::vector<std::string>::const_iterator it = loaded.begin(); it != loaded.end(); ++it)
+  {
+    if (files.find(*it) == files.end())
+      return NULL;
+  }
+
+  // the include conditions have to evaluate to the values the window was resolved with
+  std::map<INFO::InfoPtr, bool> conditions;
+  for (std::vector<std::pair<std::string, bool> >::const_iterator it = entry.conditions.begin(); it != entry.conditions.end(); ++it)
+  {
+    INFO::InfoPtr condition = g_infoManager.Register(it->first);
+    if (!condition || condition->Get() != it->second)
+      return NULL;
+    conditions[condition] = it->second;
+  }
+
+  for (std::vector<std::string>::const_iterator it = onDemand.begin(); it != onDemand.end(); ++it)
+    includes.LoadIncludes(*it);
+
+  xmlIncludeConditions.swap(conditions);
+  TiXmlElement *root = entry.root;
+  entry.root = NULL;
+  return root;
+}
+
+void CGUIWindowCache::Save(const std::string &path, const TiXmlElement *root, const CGUIIncludes &includes, size_t preloaded,
+                           const std::map<INFO::InfoPtr, bool> &xmlIncludeConditions, float loadTime)
+{
+  if (!root)
+    return;
+
+  std::string data;
+  CWriter writer(data);
+  writer.WriteString(CACHE_MAGIC);
+  writer.WriteByte(CACHE_VERSION);
+  if (!WriteFileStamp(writer, path))
+    return;
+
+  const std::vector<std::string> &files = includes.GetFiles();
+  writer.WriteVarInt(files.size());
+  for (size_t i = 0; i < files.size(); i++)
+  {
+    if (!WriteFileStamp(writer, files[i]))
+      return;
+    writer.WriteByte(i < preloaded ? 1 : 0);
+  }
+
+  writer.WriteVarInt(xmlIncludeConditions.size());
+  for (std::map<INFO::InfoPtr, bool>::const_iterator it = xmlIncludeConditions.begin(); it != xmlIncludeConditions.end(); ++it)
+  {
+    writer.WriteString(it->first->GetExpression());
+    writer.WriteByte(it->second ? 1 : 0);
+  }
+
+  writer.WriteVarInt((uint64_t)(std::max(loadTime, 0.0f) * 1000));
+  Serialize(root, data);
+
+  if (!CDirectory::Exists(CACHE_PATH) && !CDirectory::Create(CACHE_PATH))
+    return;
+
+  // write to a temporary file first so a reader never sees a partial entry
+  std::string cacheFile = GetCacheFile(path);
+  std::string tempFile = cacheFile + ".tmp";
+  CFile file;
+  if (!file.OpenForWrite(tempFile, true) || file.Write(data.c_str(), data.size()) != (ssize_t)data.size())
+  {
+    CLog::Log(LOGERROR, "CGUIWindowCache: unable to write %s", tempFile.c_str());
+    file.Close();
+    CFile::Delete(tempFile);
+    return;
+  }
+  file.Close();
+
+  if (CFile::Exists(cacheFile, false))
+    CFile::Delete(cacheFile);
+  if (!CFile::Rename(tempFile, cacheFile))
+    CFile::Delete(tempFile);
+}
+
+void CGUIWindowCache::Serialize(const TiXmlElement *root, std::string &data)
+{
+  CTreeWriter writer;
+  writer.WriteElement(root);
+  writer.Finish(data);
+}
+
+TiXmlElement* CGUIWindowCache::Deserialize(const char *data, size_t size)
+{
+  CReader reader(data, size);
+  return ReadTree(reader);
+}
+
+std::string CGUIWindowCache::GetCacheFile(const std::string &path)
+{
+  Crc32 crc;
+  crc.Compute(path);
+  return StringUtils::Format(CACHE_PATH "%08x.bin", (unsigned int)crc);
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <map>
+#include <stddef.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "interfaces/info/InfoBool.h"
+
+class CGUIIncludes;
+class TiXmlElement;
+
+/*!
+ \ingroup windows
+ \brief Binary cache of window definitions with their includes resolved.
+
+ Each window file gets one entry in special://temp/skincache/. An entry holds the
+ window tree after CGUIIncludes has expanded includes, defaults, constants and
+ expressions, and the inputs it was resolved with: the mtimes of the window file
+ and of every include file, and the values of the include conditions. An entry is
+ only used while all of those are unchanged. Element and attribute names and values
+ are stored once in a string table and referenced by index from the tree.
+ */
+class CGUIWindowCache
+{
+public:
+  /*! \brief An entry read from the cache, not yet checked against the loaded includes
+   */
+  struct Entry
+  {
+    Entry();
+    ~Entry();
+    Entry(const Entry&) = delete;
+    Entry& operator=(const Entry&) = delete;
+
+    std::string path;
+    TiXmlElement *root;
+    std::vector<std::pair<std::string, bool> > includes;  ///< include files and whether they were loaded with the skin
+    std::vector<std::pair<std::string, bool> > conditions;
+    float loadTime;  ///< time in ms it took to parse and resolve the window when the entry was written
+    float readTime;  ///< time in ms it took to read the entry
+  };
+
+  /*! \brief Read the entry of a window
+   Only checks the window and include files are unchanged, so it may be called from any thread.
+   \param path the window file
+   \param entry [out] the entry
+   \return true if there is an entry for the window and the files are unchanged
+   */
+  static bool Read(const std::string &path, Entry &entry);
+
+  /*! \brief Load the resolved definition of a window from its entry
+   Include files the window loaded on demand when it was resolved are loaded into
+   includes, as resolving it again would have done. Evaluates the include conditions,
+   so it must be called from the application thread.
+   \param entry an entry returned by Read(), its root element is taken over
+   \param includes the includes of the skin
+   \param xmlIncludeConditions [out] the include conditions the definition depends on
+   \return the root element or NULL if the entry doesn't apply any longer. Must be deleted by the caller.
+   */
+  static TiXmlElement* Load(Entry &entry, CGUIIncludes &includes, std::map<INFO::InfoPtr, bool> &xmlIncludeConditions);
+
+  /*! \brief Store the resolved definition of a window
+   \param path the window file
+   \param root the window with its includes resolved
+   \param includes the includes of the skin after resolving the window
+   \param preloaded the number of include files that were loaded before resolving the window
+   \param xmlIncludeConditions the include conditions used to resolve the window
+   \param loadTime time in ms it took to parse and resolve the window
+   */
+  static void Save(const std::string &path, const TiXmlElement *root, const CGUIIncludes &includes, size_t preloaded,
+                   const std::map<INFO::InfoPtr, bool> &xmlIncludeConditions, float loadTime);
+
+  /*! \brief Append the binary form of an element tree to data
+   Comments and other non element, non text nodes are dropped.
+   */
+  static void Serialize(const TiXmlElement *root, std::string &data);
+
+  /*! \brief Rebuild an element tree from its binary form
+   \return the root element or NULL if the data is invalid. Must be deleted by the caller.
+   */
+  static TiXmlElement* Deserialize(const char *data, size_t size);
+
+private:
+  static std::string GetCacheFile(const std::string &path);
+};
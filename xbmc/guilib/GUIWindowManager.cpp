@@ -26,12 +26,17 @@
 #include "messaging/helpers/DialogHelper.h"
 #include "GUIPassword.h"
 #include "GUIInfoManager.h"
+#include "threads/Event.h"
 #include "threads/SingleLock.h"
+#include "utils/JobManager.h"
+#include "utils/log.h"
+#include "utils/TimeUtils.h"
 #include "utils/URIUtils.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "addons/Skin.h"
 #include "GUITexture.h"
+#include "GUIFontManager.h"
 #include "utils/Variant.h"
 #include "input/Key.h"
 #include "utils/StringUtils.h"
@@ -148,6 +153,97 @@ using namespace PVR;
 using namespace PERIPHERALS;
 using namespace KODI::MESSAGING;
 
+namespace
+{
+
+/*! \brief Reads the xml of windows ahead on the job manager while the application
+ thread loads them one after another. A window that no job has picked up yet when
+ the application thread gets to it is read on the application thread instead.
+ \sa CGUIWindow::Prefetch()
+ */
+class CWindowPrefetch
+{
+public:
+  explicit CWindowPrefetch(const std::vector<CGUIWindow*> &windows)
+    : m_windows(windows), m_state(windows.size(), PENDING), m_times(windows.size(), 0.f)
+  {
+  }
+
+  void Run(size_t index)
+  {
+    {
+      CSingleLock lock(m_section);
+      if (m_state[index] != PENDING)
+        return;
+      m_state[index] = RUNNING;
+    }
+
+    int64_t start = CurrentHostCounter();
+    m_windows[index]->Prefetch();
+    float time = 1000.f * (CurrentHostCounter() - start) / CurrentHostFrequency();
+
+    {
+      CSingleLock lock(m_section);
+      m_state[index] = DONE;
+      m_times[index] = time;
+    }
+    m_event.Set();
+  }
+
+  /*! \brief Wait until a window is read
+   \return time in ms it took to read the window
+   */
+  float Wait(size_t index)
+  {
+    Run(index);
+
+    CSingleLock lock(m_section);
+    while (m_state[index] != DONE)
+    {
+      CSingleExit exit(m_section);
+      m_event.Wait();
+    }
+    return m_times[index];
+  }
+
+private:
+  enum State
+  {
+    PENDING,
+    RUNNING,
+    DONE
+  };
+
+  std::vector<CGUIWindow*> m_windows;
+  std::vector<State> m_state;
+  std::vector<float> m_times;
+  CCriticalSection m_section;
+  CEvent m_event;
+};
+
+class CWindowPrefetchJob : public CJob
+{
+public:
+  CWindowPrefetchJob(const std::shared_ptr<CWindowPrefetch> &prefetch, size_t index)
+    : m_prefetch(prefetch), m_index(index)
+  {
+  }
+
+  bool DoWork() override
+  {
+    m_prefetch->Run(m_index);
+    return true;
+  }
+
+  const char *GetType() const override { return "windowprefetch"; }
+
+private:
+  std::shared_ptr<CWindowPrefetch> m_prefetch;
+  size_t m_index;
+};
+
+}
+
 CGUIWindowManager::CGUIWindowManager(void)
 {
   m_pCallback = NULL;
@@ -1141,6 +1237,9 @@ void CGUIWindowManager::FrameMove()
       delete *it;
     }
     m_deleteWindows.clear();
+
+    // glyphs rendered in the background since the last frame
+    g_fontManager.UploadGlyphs();
   }
 
   CGUIWindow* pWindow = GetWindow(GetActiveWindow());
@@ -1461,15 +1560,60 @@ bool CGUIWindowManager::IsWindowVisible(const std::string &xmlFile) const
 void CGUIWindowManager::LoadNotOnDemandWindows()
 {
   CSingleLock lock(g_graphicsContext);
+  int64_t start = CurrentHostCounter();
+
+  std::vector<CGUIWindow*> windows;
   for (WindowMap::iterator it = m_mapWindows.begin(); it != m_mapWindows.end(); ++it)
   {
     CGUIWindow *pWindow = (*it).second;
     if (pWindow->GetLoadType() == CGUIWindow::LOAD_ON_GUI_INIT)
     {
       pWindow->FreeResources(true);
-      pWindow->Initialize();
+      windows.push_back(pWindow);
     }
   }
+  size_t loadCount = windows.size();
+
+  // the windows shown first are read ahead as well, they are loaded when activated
+  if (g_SkinInfo)
+  {
+    int ids[] = { g_SkinInfo->GetFirstWindow(), g_SkinInfo->GetStartWindow() };
+    for (size_t i = 0; i < sizeof(ids) / sizeof(ids[0]); i++)
+    {
+      CGUIWindow *pWindow = GetWindow(ids[i]);
+      if (pWindow && std::find(windows.begin(), windows.end(), pWindow) == windows.end())
+        windows.push_back(pWindow);
+    }
+  }
+
+  // reading and parsing the xml runs on the job manager, resolving includes and
+  // creating controls have to be done here as they aren't thread safe
+  std::shared_ptr<CWindowPrefetch> prefetch(new CWindowPrefetch(windows));
+  for (size_t i = 0; i < windows.size(); i++)
+    CJobManager::GetInstance().AddJob(new CWindowPrefetchJob(prefetch, i), NULL, CJob::PRIORITY_HIGH);
+
+  float prefetchTime = 0;
+  for (size_t i = 0; i < loadCount; i++)
+  {
+    int64_t windowStart = CurrentHostCounter();
+    float windowPrefetchTime = prefetch->Wait(i);
+    int64_t loadStart = CurrentHostCounter();
+    windows[i]->Initialize();
+    int64_t end = CurrentHostCounter();
+
+    prefetchTime += windowPrefetchTime;
+    CLog::Log(LOGDEBUG, "Loaded %s in %.2fms (%.2fms reading ahead, %.2fms waiting for it)",
+              windows[i]->GetProperty("xmlfile").c_str(), 1000.f * (end - loadStart) / CurrentHostFrequency(),
+              windowPrefetchTime, 1000.f * (loadStart - windowStart) / CurrentHostFrequency());
+  }
+
+  // make sure no job is still busy with the windows that are loaded later on
+  for (size_t i = loadCount; i < windows.size(); i++)
+    prefetchTime += prefetch->Wait(i);
+
+  CLog::Log(LOGINFO, "Loaded %u windows and read %u ahead in %.2fms, %.2fms of it reading xml",
+            (unsigned int)loadCount, (unsigned int)(windows.size() - loadCount),
+            1000.f * (CurrentHostCounter() - start) / CurrentHostFrequency(), prefetchTime);
 }
 
 void CGUIWindowManager::UnloadNotOnDemandWindows()
@@ -94,6 +94,8 @@ public:
   unsigned int GetOriginalWidth() const { return m_originalWidth; }
   /*! \brief return the original height of the image, before scaling/cropping */
   unsigned int GetOriginalHeight() const { return m_originalHeight; }
+  /*! \brief return the pixel format (XB_FMT_*) of the texture */
+  unsigned int GetTextureFormat() const { return m_format; }
 
   int GetOrientation() const { return m_orientation; }
   void SetOrientation(int orientation) { m_orientation = orientation; }
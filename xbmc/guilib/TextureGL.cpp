@@ -33,6 +33,8 @@
 /************************************************************************/
 /*    CGLTexture                                                       */
 /************************************************************************/
+GLuint CGLTexture::m_boundTextures[CGLTexture::MAX_BOUND_UNITS];
+
 CGLTexture::CGLTexture(unsigned int width, unsigned int height, unsigned int format)
 : CBaseTexture(width, height, format)
 {
@@ -71,6 +73,7 @@ void CGLTexture::LoadToGPU()
 
   // Bind the texture object
   glBindTexture(GL_TEXTURE_2D, m_texture);
+  ResetBindings();
 
   // Set the texture's stretching properties
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
@@ -188,10 +191,23 @@ void CGLTexture::LoadToGPU()
 void CGLTexture::BindToUnit(unsigned int unit)
 {
   glActiveTexture(GL_TEXTURE0 + unit);
-  glBindTexture(GL_TEXTURE_2D, m_texture);
+  // consecutive draws from the same texture (or atlas page) don't need a rebind
+  if (unit < MAX_BOUND_UNITS)
+  {
+    if (!m_texture || m_boundTextures[unit] != m_texture)
+      glBindTexture(GL_TEXTURE_2D, m_texture);
+    m_boundTextures[unit] = m_texture;
+  }
+  else
+    glBindTexture(GL_TEXTURE_2D, m_texture);
 #ifndef HAS_GLES
   glEnable(GL_TEXTURE_2D);
 #endif
 }
 
+void CGLTexture::ResetBindings()
+{
+  memset(m_boundTextures, 0, sizeof(m_boundTextures));
+}
+
 #endif // HAS_GL
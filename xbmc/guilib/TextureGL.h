@@ -40,8 +40,18 @@ public:
   void LoadToGPU();
   void BindToUnit(unsigned int unit);
 
+  /*! \brief Forget which textures BindToUnit() left bound.
+   Must be called whenever GL code other than BindToUnit() may have changed
+   the texture bindings, so the next BindToUnit() binds again.
+   */
+  static void ResetBindings();
+
 protected:
   GLuint m_texture;
+
+private:
+  static const unsigned int MAX_BOUND_UNITS = 4;
+  static GLuint m_boundTextures[MAX_BOUND_UNITS];
 };
 
 #endif
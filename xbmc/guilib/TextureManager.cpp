@@ -20,7 +20,9 @@
 
 #include "TextureManager.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cstring>
 
 #include "addons/Skin.h"
 #include "filesystem/Directory.h"
@@ -34,13 +36,11 @@
 #include "utils/log.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
+#include "windowing/WindowingFactory.h"
 
 #ifdef _DEBUG_TEXTURES
 #include "utils/TimeUtils.h"
 #endif
-#if defined(TARGET_DARWIN_IOS)
-#include "windowing/WindowingFactory.h" // for g_Windowing in CGUITextureManager::FreeUnusedTextures
-#endif
 #include "FFmpegImage.h"
 
 /************************************************************************/
@@ -55,6 +55,9 @@ CTextureArray::CTextureArray(int width, int height, int loops,  bool texCoordsAr
   m_texWidth = 0;
   m_texHeight = 0;
   m_texCoordsArePixels = false;
+  m_atlasPage = -1;
+  m_texOffsetX = 0;
+  m_texOffsetY = 0;
 }
 
 CTextureArray::CTextureArray()
@@ -84,6 +87,9 @@ void CTextureArray::Reset()
   m_texWidth = 0;
   m_texHeight = 0;
   m_texCoordsArePixels = false;
+  m_atlasPage = -1;
+  m_texOffsetX = 0;
+  m_texOffsetY = 0;
 }
 
 void CTextureArray::Add(CBaseTexture *texture, int delay)
@@ -111,9 +117,14 @@ void CTextureArray::Set(CBaseTexture *texture, int width, int height)
 void CTextureArray::Free()
 {
   CSingleLock lock(g_graphicsContext);
-  for (unsigned int i = 0; i < m_textures.size(); i++)
+  if (m_atlasPage >= 0)
+  { // the page is shared with other images and owned by the texture manager
+    g_TextureManager.ReleaseAtlasImage(m_atlasPage, m_texOffsetX, m_texOffsetY, m_width, m_height);
+  }
+  else
   {
-    delete m_textures[i];
+    for (unsigned int i = 0; i < m_textures.size(); i++)
+      delete m_textures[i];
   }
 
   m_textures.clear();
@@ -220,6 +231,16 @@ void CTextureMap::Add(CBaseTexture* texture, int delay)
     m_memUsage += sizeof(CTexture) + (texture->GetTextureWidth() * texture->GetTextureHeight() * 4);
 }
 
+void CTextureMap::AddAtlased(CBaseTexture* page, unsigned int pageIndex, int x, int y)
+{
+  m_texture.Add(page, 100);
+  m_texture.m_atlasPage = pageIndex;
+  m_texture.m_texOffsetX = x;
+  m_texture.m_texOffsetY = y;
+
+  m_memUsage += (m_texture.m_width + 2) * (m_texture.m_height + 2) * 4;
+}
+
 /************************************************************************/
 /*                                                                      */
 /************************************************************************/
@@ -449,7 +470,10 @@ const CTextureArray& CGUITextureManager::Load(const std::string& strTextureName,
   if (!pTexture) return emptyTexture;
 
   CTextureMap* pMap = new CTextureMap(strTextureName, width, height, 0);
-  pMap->Add(pTexture, 100);
+  if (bundle >= 0 && AddToAtlas(pMap, pTexture))
+    delete pTexture;
+  else
+    pMap->Add(pTexture, 100);
   m_vecTextures.push_back(pMap);
 
 #ifdef _DEBUG_TEXTURES
@@ -516,6 +540,9 @@ void CGUITextureManager::FreeUnusedTextures(unsigned int timeDelay)
 #endif
       glDeleteTextures(1, (GLuint*) &m_unusedHwTextures[i]);
   }
+  // deleted names get reused by glGenTextures
+  if (!m_unusedHwTextures.empty())
+    CGLTexture::ResetBindings();
 #endif
   m_unusedHwTextures.clear();
 }
@@ -526,6 +553,76 @@ void CGUITextureManager::ReleaseHwTexture(unsigned int texture)
   m_unusedHwTextures.push_back(texture);
 }
 
+namespace
+{
+  // copy an image into an atlas page, surrounded by a copy of its edge pixels
+  // so filtering at the edges doesn't pull in the neighbouring images
+  void CopyToAtlas(unsigned char *page, unsigned int pitch, unsigned int x, unsigned int y, const CBaseTexture *texture)
+  {
+    const unsigned int width = texture->GetWidth();
+    const unsigned int height = texture->GetHeight();
+    for (unsigned int row = 0; row < height + 2; row++)
+    {
+      unsigned int srcRow = row ? std::min(row - 1, height - 1) : 0;
+      const uint32_t *src = (const uint32_t *)(texture->GetPixels() + srcRow * texture->GetPitch());
+      uint32_t *dst = (uint32_t *)(page + (y + row) * pitch) + x;
+      dst[0] = src[0];
+      memcpy(dst + 1, src, width * 4);
+      dst[width + 1] = src[width - 1];
+    }
+  }
+}
+
+bool CGUITextureManager::AddToAtlas(CTextureMap *map, const CBaseTexture *texture)
+{
+  const unsigned int width = texture->GetWidth();
+  const unsigned int height = texture->GetHeight();
+  if (width > TEXTURE_ATLAS_MAX_IMAGE || height > TEXTURE_ATLAS_MAX_IMAGE ||
+      (texture->GetTextureFormat() & XB_FMT_MASK) != XB_FMT_A8R8G8B8 ||
+      !texture->GetPixels() || texture->GetOrientation())
+    return false;
+
+  if (!m_atlas.GetPageSize())
+    m_atlas.Reset(std::min((unsigned int)TEXTURE_ATLAS_PAGE_SIZE, g_Windowing.GetMaxTextureSize()), TEXTURE_ATLAS_MAX_PAGES);
+
+  unsigned int page, x, y;
+  if (!m_atlas.Allocate(width + 2, height + 2, page, x, y))
+    return false;
+
+  const unsigned int size = m_atlas.GetPageSize();
+  if (page >= m_atlasPages.size())
+    m_atlasPages.resize(page + 1);
+  AtlasPage &atlasPage = m_atlasPages[page];
+  if (!atlasPage.texture)
+  {
+    atlasPage.texture = new CTexture(size, size, XB_FMT_A8R8G8B8);
+    atlasPage.pixels.assign(size * size * 4, 0);
+  }
+
+  // the page is uploaded as a whole on its next bind. If it still holds the
+  // pixels of an earlier pending upload only the new image needs copying.
+  CopyToAtlas(atlasPage.pixels.data(), size * 4, x, y, texture);
+  if (atlasPage.texture->GetPixels())
+    CopyToAtlas(atlasPage.texture->GetPixels(), atlasPage.texture->GetPitch(), x, y, texture);
+  else
+    atlasPage.texture->Update(size, size, size * 4, XB_FMT_A8R8G8B8, atlasPage.pixels.data(), false);
+
+  map->AddAtlased(atlasPage.texture, page, x + 1, y + 1);
+  return true;
+}
+
+void CGUITextureManager::ReleaseAtlasImage(unsigned int page, int x, int y, int width, int height)
+{
+  CSingleLock lock(g_graphicsContext);
+  if (!m_atlas.Release(page, x - 1, y - 1, width + 2, height + 2) || page >= m_atlasPages.size())
+    return;
+
+  AtlasPage &atlasPage = m_atlasPages[page];
+  delete atlasPage.texture;
+  atlasPage.texture = nullptr;
+  std::vector<unsigned char>().swap(atlasPage.pixels);
+}
+
 void CGUITextureManager::Cleanup()
 {
   CSingleLock lock(g_graphicsContext);
@@ -28,6 +28,7 @@
 #include <vector>
 #include <utility>
 
+#include "GUITextureAtlas.h"
 #include "TextureBundle.h"
 #include "threads/CriticalSection.h"
 
@@ -58,6 +59,9 @@ public:
   int m_texWidth;
   int m_texHeight;
   bool m_texCoordsArePixels;
+  int m_atlasPage;   ///< atlas page holding the image, -1 if the texture is its own
+  int m_texOffsetX;  ///< position of the image in the atlas page, in pixels
+  int m_texOffsetY;
 };
 
 /*!
@@ -75,6 +79,7 @@ public:
   virtual ~CTextureMap();
 
   void Add(CBaseTexture* texture, int delay);
+  void AddAtlased(CBaseTexture* page, unsigned int pageIndex, int x, int y);
   bool Release();
 
   const std::string& GetName() const;
@@ -124,7 +129,14 @@ public:
 
   void FreeUnusedTextures(unsigned int timeDelay = 0); ///< Free textures (called from app thread only)
   void ReleaseHwTexture(unsigned int texture);
+
+  /*! \brief Give back the room of an image packed into an atlas page
+   Frees the page once no image uses it any more.
+   */
+  void ReleaseAtlasImage(unsigned int page, int x, int y, int width, int height);
 protected:
+  bool AddToAtlas(CTextureMap *map, const CBaseTexture *texture);
+
   std::vector<CTextureMap*> m_vecTextures;
   std::list<std::pair<CTextureMap*, unsigned int> > m_unusedTextures;
   std::vector<unsigned int> m_unusedHwTextures;
@@ -133,6 +145,16 @@ protected:
   // we have 2 texture bundles (one for the base textures, one for the theme)
   CTextureBundle m_TexBundle[2];
 
+  // small bundled textures are packed into a few shared pages
+  struct AtlasPage
+  {
+    AtlasPage() : texture(nullptr) {}
+    CBaseTexture *texture;
+    std::vector<unsigned char> pixels; ///< copy of the page, the texture drops its pixels once uploaded
+  };
+  CGUITextureAtlas m_atlas;
+  std::vector<AtlasPage> m_atlasPages;
+
   std::vector<std::string> m_texturePaths;
   CCriticalSection m_section;
 };
@@ -92,6 +92,7 @@ void CPiTexture::LoadToGPU()
 
     // Bind the texture object
     glBindTexture(GL_TEXTURE_2D, m_texture);
+    ResetBindings();
 
     m_loadedToGPU = true;
     return;
@@ -0,0 +1,274 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "guilib/GUIFontAtlas.h"
+#include "guilib/GUIFontTTF.h"
+
+#include <chrono>
+#include <map>
+#include <set>
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace
+{
+  const unsigned int width = 256;
+  const unsigned int lineHeight = 16;
+  const unsigned int pageHeight = lineHeight * FONT_ATLAS_PAGE_LINES;
+
+  // fill the page currently being written to, returns the number of cells placed
+  unsigned int FillPage(CGUIFontAtlas &atlas, unsigned int &page)
+  {
+    unsigned int x, y, evicted, cells = 0;
+    unsigned int first;
+    EXPECT_TRUE(atlas.Allocate(width / 4, x, y, first, evicted));
+    page = first;
+    for (cells = 1; cells < 4 * FONT_ATLAS_PAGE_LINES; cells++)
+    {
+      unsigned int p;
+      EXPECT_TRUE(atlas.Allocate(width / 4, x, y, p, evicted));
+      EXPECT_EQ(first, p);
+    }
+    return cells;
+  }
+
+  vecText MakeText(const std::string &label)
+  {
+    return vecText(label.begin(), label.end());
+  }
+
+  // glyph -> page bookkeeping the way CGUIFontTTFBase::GetCharacter keeps it
+  struct GlyphPages
+  {
+    std::map<character_t, unsigned int> glyphs;
+    std::vector<std::vector<character_t> > pages;
+  };
+
+  bool PlaceText(CGUIFontAtlas &atlas, GlyphPages &cache, const vecText &text)
+  {
+    for (vecText::const_iterator ch = text.begin(); ch != text.end(); ++ch)
+    {
+      auto it = cache.glyphs.find(*ch);
+      if (it != cache.glyphs.end())
+      {
+        atlas.Touch(it->second);
+        continue;
+      }
+      unsigned int x, y, page, evicted;
+      if (!atlas.Allocate(20, x, y, page, evicted))
+        return false;
+      if (evicted != CGUIFontAtlas::NO_PAGE)
+      {
+        for (auto drop = cache.pages[evicted].begin(); drop != cache.pages[evicted].end(); ++drop)
+          cache.glyphs.erase(*drop);
+        cache.pages[evicted].clear();
+      }
+      cache.glyphs[*ch] = page;
+      cache.pages[page].push_back(*ch);
+    }
+    return true;
+  }
+}
+
+TEST(TestGUIFontAtlas, PlacesCellsInPages)
+{
+  CGUIFontAtlas atlas;
+  atlas.Reset(width, lineHeight, 4 * pageHeight, 0xffffffff);
+  EXPECT_EQ(4U, atlas.GetMaxPages());
+  EXPECT_EQ(0U, atlas.GetRequiredHeight());
+
+  unsigned int x, y, page, evicted;
+  ASSERT_TRUE(atlas.Allocate(100, x, y, page, evicted));
+  EXPECT_EQ(0U, x);
+  EXPECT_EQ(0U, y);
+  EXPECT_EQ(0U, page);
+  EXPECT_EQ(CGUIFontAtlas::NO_PAGE, evicted);
+  EXPECT_EQ(pageHeight, atlas.GetRequiredHeight());
+
+  ASSERT_TRUE(atlas.Allocate(100, x, y, page, evicted));
+  EXPECT_EQ(100U, x);
+  EXPECT_EQ(0U, y);
+
+  // doesn't fit on the line any more
+  ASSERT_TRUE(atlas.Allocate(100, x, y, page, evicted));
+  EXPECT_EQ(0U, x);
+  EXPECT_EQ(lineHeight, y);
+  EXPECT_EQ(0U, page);
+
+  // wider than the texture
+  EXPECT_FALSE(atlas.Allocate(width + 1, x, y, page, evicted));
+}
+
+TEST(TestGUIFontAtlas, LimitsPagesByMemory)
+{
+  CGUIFontAtlas atlas;
+  atlas.Reset(width, lineHeight, 4096, 3 * width * pageHeight);
+  EXPECT_EQ(3U, atlas.GetMaxPages());
+
+  // a single page is always allowed
+  atlas.Reset(width, lineHeight, 4096, 1);
+  EXPECT_EQ(1U, atlas.GetMaxPages());
+}
+
+TEST(TestGUIFontAtlas, EvictsLeastRecentlyUsedPage)
+{
+  CGUIFontAtlas atlas;
+  atlas.Reset(width, lineHeight, 3 * pageHeight, 0xffffffff);
+
+  unsigned int pages[3];
+  for (unsigned int i = 0; i < 3; i++)
+  {
+    atlas.NextRun();
+    FillPage(atlas, pages[i]);
+    EXPECT_EQ(i, pages[i]);
+  }
+  EXPECT_EQ(3U, atlas.GetPageCount());
+
+  // page 0 is used again, so page 1 is the oldest
+  atlas.NextRun();
+  atlas.Touch(pages[0]);
+  atlas.NextRun();
+
+  unsigned int x, y, page, evicted;
+  ASSERT_TRUE(atlas.Allocate(10, x, y, page, evicted));
+  EXPECT_EQ(pages[1], evicted);
+  EXPECT_EQ(pages[1], page);
+  EXPECT_EQ(0U, x);
+  EXPECT_EQ(atlas.GetPageTop(pages[1]), y);
+  EXPECT_EQ(3U, atlas.GetPageCount());
+  EXPECT_EQ(1U, atlas.GetEvictions());
+}
+
+TEST(TestGUIFontAtlas, KeepsPagesOfCurrentRun)
+{
+  CGUIFontAtlas atlas;
+  atlas.Reset(width, lineHeight, 2 * pageHeight, 0xffffffff);
+
+  // a single run filling every page can't evict anything
+  unsigned int page;
+  atlas.NextRun();
+  FillPage(atlas, page);
+  FillPage(atlas, page);
+
+  unsigned int x, y, evicted;
+  EXPECT_FALSE(atlas.Allocate(width, x, y, page, evicted));
+  EXPECT_EQ(0U, atlas.GetEvictions());
+
+  atlas.NextRun();
+  EXPECT_TRUE(atlas.Allocate(width, x, y, page, evicted));
+  EXPECT_EQ(0U, evicted);
+}
+
+TEST(TestGUIFontAtlas, DefersEviction)
+{
+  CGUIFontAtlas atlas;
+  atlas.Reset(width, lineHeight, 2 * pageHeight, 0xffffffff);
+
+  unsigned int page;
+  atlas.NextRun();
+  FillPage(atlas, page);
+  atlas.NextRun();
+  FillPage(atlas, page);
+  atlas.NextRun();
+
+  // full, but recycling isn't allowed while a batch is being drawn
+  unsigned int x, y, evicted;
+  EXPECT_FALSE(atlas.Allocate(10, x, y, page, evicted, false));
+  EXPECT_EQ(0U, atlas.GetEvictions());
+
+  EXPECT_EQ(0U, atlas.EvictOldest());
+  EXPECT_EQ(1U, atlas.GetEvictions());
+  ASSERT_TRUE(atlas.Allocate(10, x, y, page, evicted, false));
+  EXPECT_EQ(0U, page);
+  EXPECT_EQ(CGUIFontAtlas::NO_PAGE, evicted);
+  EXPECT_EQ(0U, y);
+
+  // nothing to evict while there is room for another page
+  atlas.Reset(width, lineHeight, 2 * pageHeight, 0xffffffff);
+  EXPECT_EQ(CGUIFontAtlas::NO_PAGE, atlas.EvictOldest());
+}
+
+TEST(TestGUIFontCache, HashCoversWholeString)
+{
+  // list labels sharing a long prefix must end up in different buckets
+  vecColors colors(1, 0xffffffff);
+  TransformMatrix matrix;
+  CGUIFontCacheHash<CGUIFontCacheStaticPosition> hash;
+  std::set<size_t> buckets;
+  for (int i = 0; i < 10000; i++)
+  {
+    vecText text = MakeText("Episode " + std::to_string(i));
+    CGUIFontCacheKey<CGUIFontCacheStaticPosition> key(CGUIFontCacheStaticPosition(0, 0),
+                                                      colors, text, 0, 0, false, matrix, 1, 1);
+    buckets.insert(hash(key));
+  }
+  EXPECT_GE(buckets.size(), 9990U);
+
+  // colours other than the first matter too
+  vecText text = MakeText("Episode 1");
+  vecColors other(colors);
+  other.push_back(0xff00ff00);
+  CGUIFontCacheKey<CGUIFontCacheStaticPosition> a(CGUIFontCacheStaticPosition(0, 0),
+                                                  colors, text, 0, 0, false, matrix, 1, 1);
+  CGUIFontCacheKey<CGUIFontCacheStaticPosition> b(CGUIFontCacheStaticPosition(0, 0),
+                                                  other, text, 0, 0, false, matrix, 1, 1);
+  EXPECT_NE(hash(a), hash(b));
+}
+
+TEST(TestGUIFontAtlas, DISABLED_ScrollsLargeList)
+{
+  // Scroll a 10k item list through a 20 row view, one row per frame. The
+  // labels mix in characters from a large alphabet so the atlas has to evict
+  // pages.
+  const int items = 10000;
+  const int rows = 20;
+  const unsigned int alphabet = 20000;
+  CGUIFontAtlas atlas;
+  atlas.Reset(1024, 33, 4096);
+
+  std::vector<vecText> labels(items);
+  for (int i = 0; i < items; i++)
+  {
+    labels[i] = MakeText("Item " + std::to_string(i) + " - ");
+    for (int c = 0; c < 8; c++)
+      labels[i].push_back(0x4e00 + (i * 7919 + c * 104729) % alphabet);
+  }
+
+  GlyphPages cache;
+  cache.pages.resize(atlas.GetMaxPages());
+  int frames = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int top = 0; top + rows <= items; top++, frames++)
+  {
+    for (int row = top; row < top + rows; row++)
+    {
+      atlas.NextRun();
+      ASSERT_TRUE(PlaceText(atlas, cache, labels[row]));
+    }
+  }
+  auto end = std::chrono::steady_clock::now();
+
+  EXPECT_GT(atlas.GetEvictions(), 0U);
+  RecordProperty("uploads_per_frame", std::to_string(static_cast<double>(atlas.GetUploads()) / frames));
+  RecordProperty("evictions", static_cast<int>(atlas.GetEvictions()));
+  RecordProperty("us_per_frame", std::to_string(std::chrono::duration<double, std::micro>(end - start).count() / frames));
+}
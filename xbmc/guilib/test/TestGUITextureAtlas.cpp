@@ -0,0 +1,205 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "guilib/GUITextureAtlas.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace
+{
+  const unsigned int pageSize = 256;
+
+  struct Image
+  {
+    unsigned int width, height;
+    unsigned int page, x, y;
+  };
+
+  bool Overlaps(const Image &a, const Image &b)
+  {
+    return a.page == b.page &&
+           a.x < b.x + b.width && b.x < a.x + a.width &&
+           a.y < b.y + b.height && b.y < a.y + a.height;
+  }
+
+  // binds needed to draw the images in order, as consecutive images on the
+  // same page share a bind
+  unsigned int CountBinds(const std::vector<Image> &images)
+  {
+    unsigned int binds = 0;
+    unsigned int page = CGUITextureAtlas::NO_PAGE;
+    for (auto i = images.begin(); i != images.end(); ++i)
+    {
+      if (i->page != page)
+        binds++;
+      page = i->page;
+    }
+    return binds;
+  }
+}
+
+TEST(TestGUITextureAtlas, PlacesImagesOnShelves)
+{
+  CGUITextureAtlas atlas;
+  atlas.Reset(pageSize, 2);
+
+  unsigned int page, x, y;
+  ASSERT_TRUE(atlas.Allocate(100, 30, page, x, y));
+  EXPECT_EQ(0U, page);
+  EXPECT_EQ(0U, x);
+  EXPECT_EQ(0U, y);
+
+  // same height goes next to it
+  ASSERT_TRUE(atlas.Allocate(100, 30, page, x, y));
+  EXPECT_EQ(100U, x);
+  EXPECT_EQ(0U, y);
+
+  // much smaller images get a shelf of their own
+  ASSERT_TRUE(atlas.Allocate(10, 10, page, x, y));
+  EXPECT_EQ(0U, x);
+  EXPECT_EQ(32U, y);
+
+  // doesn't fit on the first shelf any more
+  ASSERT_TRUE(atlas.Allocate(100, 30, page, x, y));
+  EXPECT_EQ(0U, x);
+  EXPECT_EQ(44U, y);
+  EXPECT_EQ(0U, page);
+
+  // larger than a page
+  EXPECT_FALSE(atlas.Allocate(pageSize + 1, 10, page, x, y));
+  EXPECT_FALSE(atlas.Allocate(0, 10, page, x, y));
+}
+
+TEST(TestGUITextureAtlas, LimitsPages)
+{
+  CGUITextureAtlas atlas;
+  atlas.Reset(pageSize, 2);
+
+  unsigned int page, x, y;
+  ASSERT_TRUE(atlas.Allocate(pageSize, pageSize, page, x, y));
+  EXPECT_EQ(0U, page);
+  ASSERT_TRUE(atlas.Allocate(pageSize, pageSize, page, x, y));
+  EXPECT_EQ(1U, page);
+  EXPECT_FALSE(atlas.Allocate(1, 1, page, x, y));
+  EXPECT_EQ(2U, atlas.GetPageCount());
+}
+
+TEST(TestGUITextureAtlas, ReusesReleasedRoom)
+{
+  CGUITextureAtlas atlas;
+  atlas.Reset(pageSize, 1);
+
+  unsigned int page, x[4], y;
+  for (int i = 0; i < 4; i++)
+    ASSERT_TRUE(atlas.Allocate(64, 64, page, x[i], y));
+  unsigned int keep;
+  ASSERT_TRUE(atlas.Allocate(64, 64, page, keep, y));
+  EXPECT_EQ(64U, y);
+
+  // the first shelf is full, release two neighbours and fill the gap again
+  EXPECT_FALSE(atlas.Release(0, x[1], 0, 64, 64));
+  EXPECT_FALSE(atlas.Release(0, x[2], 0, 64, 64));
+  unsigned int gap;
+  ASSERT_TRUE(atlas.Allocate(128, 64, page, gap, y));
+  EXPECT_EQ(x[1], gap);
+  EXPECT_EQ(0U, y);
+  EXPECT_EQ(5U * 64 * 64, atlas.GetUsedArea(0));
+}
+
+TEST(TestGUITextureAtlas, ReportsEmptyPage)
+{
+  CGUITextureAtlas atlas;
+  atlas.Reset(pageSize, 2);
+
+  unsigned int page, x1, y1, x2, y2;
+  ASSERT_TRUE(atlas.Allocate(32, 32, page, x1, y1));
+  ASSERT_TRUE(atlas.Allocate(32, 16, page, x2, y2));
+  EXPECT_TRUE(atlas.IsPageUsed(0));
+
+  EXPECT_FALSE(atlas.Release(0, x1, y1, 32, 32));
+  EXPECT_TRUE(atlas.Release(0, x2, y2, 32, 16));
+  EXPECT_FALSE(atlas.IsPageUsed(0));
+  EXPECT_EQ(0U, atlas.GetUsedArea(0));
+
+  // the slot is handed out again from the top
+  unsigned int x, y;
+  ASSERT_TRUE(atlas.Allocate(200, 200, page, x, y));
+  EXPECT_EQ(0U, page);
+  EXPECT_EQ(0U, x);
+  EXPECT_EQ(0U, y);
+}
+
+TEST(TestGUITextureAtlas, DISABLED_OpensAndClosesWindows)
+{
+  // Load the textures of a skin window by window, closing older windows as
+  // new ones open, the way CGUITextureManager sees them.
+  const int windows = 200;
+  const int imagesPerWindow = 150;
+  const size_t openWindows = 3;
+  CGUITextureAtlas atlas;
+  atlas.Reset(TEXTURE_ATLAS_PAGE_SIZE, TEXTURE_ATLAS_MAX_PAGES);
+
+  srand(42);
+  std::vector<std::vector<Image> > open;
+  unsigned int placed = 0, binds = 0;
+
+  auto start = std::chrono::steady_clock::now();
+  for (int w = 0; w < windows; w++)
+  {
+    if (open.size() == openWindows)
+    {
+      for (auto i = open.front().begin(); i != open.front().end(); ++i)
+        atlas.Release(i->page, i->x, i->y, i->width, i->height);
+      open.erase(open.begin());
+    }
+
+    std::vector<Image> images(imagesPerWindow);
+    for (auto i = images.begin(); i != images.end(); ++i)
+    {
+      // mostly icons and button parts, a few larger backgrounds
+      i->width = 2 + (rand() % 8 ? 8 + rand() % 64 : 64 + rand() % 190);
+      i->height = 2 + (rand() % 8 ? 8 + rand() % 64 : 64 + rand() % 190);
+      ASSERT_TRUE(atlas.Allocate(i->width, i->height, i->page, i->x, i->y));
+      placed++;
+    }
+    binds += CountBinds(images);
+    open.push_back(images);
+  }
+  auto end = std::chrono::steady_clock::now();
+
+  std::vector<Image> all;
+  for (auto window = open.begin(); window != open.end(); ++window)
+    all.insert(all.end(), window->begin(), window->end());
+  for (size_t a = 0; a < all.size(); a++)
+  {
+    for (size_t b = a + 1; b < all.size(); b++)
+      ASSERT_FALSE(Overlaps(all[a], all[b]));
+  }
+
+  // without the atlas every image needs a bind of its own
+  RecordProperty("binds_per_window", std::to_string(static_cast<double>(binds) / windows));
+  RecordProperty("images_per_window", imagesPerWindow);
+  RecordProperty("ns_per_image", static_cast<int>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / placed));
+}
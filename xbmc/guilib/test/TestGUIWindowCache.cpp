@@ -0,0 +1,290 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "GUIInfoManager.h"
+#include "filesystem/File.h"
+#include "guilib/GUIIncludes.h"
+#include "guilib/GUIWindowCache.h"
+#include "utils/Crc32.h"
+#include "utils/StringUtils.h"
+#include "utils/XBMCTinyXML.h"
+#include "gtest/gtest.h"
+#include <chrono>
+#include <map>
+#include <memory>
+#include <string>
+
+namespace
+{
+std::string Print(const TiXmlElement *element)
+{
+  TiXmlPrinter printer;
+  element->Accept(&printer);
+  return printer.Str();
+}
+
+bool WriteFile(const std::string &path, const std::string &content)
+{
+  XFILE::CFile file;
+  return file.OpenForWrite(path, true) && file.Write(content.c_str(), content.size()) == (ssize_t)content.size();
+}
+
+// a window about the size of a resolved media window: groups of list controls
+// with item layouts, each with a handful of labels and images
+std::string MediaWindow()
+{
+  std::string window = "<window id=\"10025\"><defaultcontrol always=\"true\">50</defaultcontrol><controls>";
+  for (int group = 0; group < 20; group++)
+  {
+    window += StringUtils::Format("<control type=\"group\" id=\"%d\"><visible>Container.Content(%d)</visible>", 100 + group, group);
+    for (int list = 0; list < 4; list++)
+    {
+      window += StringUtils::Format("<control type=\"list\" id=\"%d\"><left>%d</left><top>0</top><width>1920</width>"
+                                    "<height>1080</height><onup>%d</onup><itemlayout height=\"90\">", 50 + list, list * 10, 50 + list);
+      for (int item = 0; item < 6; item++)
+        window += StringUtils::Format("<control type=\"label\"><left>%d</left><width>600</width><font>font12</font>"
+                                      "<label>$INFO[ListItem.Property(%d)]</label><textcolor>grey</textcolor></control>"
+                                      "<control type=\"image\"><texture background=\"true\">$INFO[ListItem.Art(%d)]</texture>"
+                                      "<aspectratio>keep</aspectratio><visible>!String.IsEmpty(ListItem.Art(%d))</visible></control>",
+                                      item * 100, item, item, item);
+      window += "</itemlayout></control>";
+    }
+    window += "</control>";
+  }
+  return window + "</controls></window>";
+}
+
+std::string CacheFile(const std::string &path)
+{
+  Crc32 crc;
+  crc.Compute(path);
+  return StringUtils::Format("special://temp/skincache/%08x.bin", (unsigned int)crc);
+}
+
+class TestGUIWindowCacheEntry : public testing::Test
+{
+protected:
+  TestGUIWindowCacheEntry()
+    : m_window("special://temp/TestGUIWindowCache_window.xml")
+    , m_other("special://temp/TestGUIWindowCache_other.xml")
+    , m_include("special://temp/TestGUIWindowCache_includes.xml")
+  {
+  }
+
+  virtual void SetUp()
+  {
+    ASSERT_TRUE(WriteFile(m_window, "<window><controls><include>Label</include></controls></window>"));
+    ASSERT_TRUE(WriteFile(m_other, "<window><controls/></window>"));
+    ASSERT_TRUE(WriteFile(m_include, "<includes><include name=\"Label\"><control type=\"label\"/></include></includes>"));
+    m_doc.Parse("<window><controls><control type=\"label\"/></controls></window>");
+    ASSERT_TRUE(m_doc.RootElement() != NULL);
+  }
+
+  virtual void TearDown()
+  {
+    const std::string files[] = { m_window, m_other, m_include, CacheFile(m_window), CacheFile(m_other) };
+    for (const std::string &file : files)
+    {
+      if (XFILE::CFile::Exists(file, false))
+        XFILE::CFile::Delete(file);
+    }
+  }
+
+  // saves the entry of the window resolved with the include file loaded and a condition
+  void Save(size_t preloaded, bool conditionValue)
+  {
+    CGUIIncludes includes;
+    ASSERT_TRUE(includes.LoadIncludes(m_include));
+    std::map<INFO::InfoPtr, bool> conditions;
+    conditions[g_infoManager.Register("true")] = conditionValue;
+    CGUIWindowCache::Save(m_window, m_doc.RootElement(), includes, preloaded, conditions, 1.0f);
+  }
+
+  std::string m_window;
+  std::string m_other;
+  std::string m_include;
+  CXBMCTinyXML m_doc;
+};
+}
+
+TEST(TestGUIWindowCache, RoundTrip)
+{
+  CXBMCTinyXML doc;
+  doc.Parse("<window id=\"1\"><!-- comment --><controls><control type=\"label\" id=\"2\">"
+            "<label>$LOCALIZE[31000] &amp; more</label><visible>true</visible></control>"
+            "<control type=\"label\" id=\"3\"><visible>true</visible></control></controls></window>");
+  ASSERT_TRUE(doc.RootElement() != NULL);
+
+  std::string data;
+  CGUIWindowCache::Serialize(doc.RootElement(), data);
+  std::unique_ptr<TiXmlElement> root(CGUIWindowCache::Deserialize(data.c_str(), data.size()));
+  ASSERT_TRUE(root.get() != NULL);
+
+  // the comment is dropped, everything else comes back unchanged
+  CXBMCTinyXML expected;
+  expected.Parse("<window id=\"1\"><controls><control type=\"label\" id=\"2\">"
+                 "<label>$LOCALIZE[31000] &amp; more</label><visible>true</visible></control>"
+                 "<control type=\"label\" id=\"3\"><visible>true</visible></control></controls></window>");
+  EXPECT_EQ(Print(expected.RootElement()), Print(root.get()));
+
+  // repeated names and values are stored once
+  EXPECT_EQ(1, StringUtils::FindNumber(data, "visible"));
+  EXPECT_EQ(1, StringUtils::FindNumber(data, "label"));
+}
+
+TEST(TestGUIWindowCache, RejectsTruncatedData)
+{
+  CXBMCTinyXML doc;
+  doc.Parse("<window><controls><control type=\"image\"><texture>a.png</texture></control></controls></window>");
+  ASSERT_TRUE(doc.RootElement() != NULL);
+
+  std::string data;
+  CGUIWindowCache::Serialize(doc.RootElement(), data);
+  for (size_t size = 0; size < data.size(); size++)
+  {
+    TiXmlElement *root = CGUIWindowCache::Deserialize(data.c_str(), size);
+    EXPECT_TRUE(root == NULL) << "size " << size;
+    delete root;
+  }
+}
+
+TEST_F(TestGUIWindowCacheEntry, Loads)
+{
+  Save(1, true);
+
+  CGUIWindowCache::Entry entry;
+  ASSERT_TRUE(CGUIWindowCache::Read(m_window, entry));
+  EXPECT_EQ(m_window, entry.path);
+  ASSERT_EQ(1u, entry.includes.size());
+  EXPECT_EQ(m_include, entry.includes[0].first);
+  EXPECT_TRUE(entry.includes[0].second);
+
+  CGUIIncludes includes;
+  ASSERT_TRUE(includes.LoadIncludes(m_include));
+  std::map<INFO::InfoPtr, bool> conditions;
+  std::unique_ptr<TiXmlElement> root(CGUIWindowCache::Load(entry, includes, conditions));
+  ASSERT_TRUE(root.get() != NULL);
+  EXPECT_EQ(Print(m_doc.RootElement()), Print(root.get()));
+  EXPECT_EQ(1u, conditions.size());
+}
+
+TEST_F(TestGUIWindowCacheEntry, RejectsChangedWindow)
+{
+  Save(1, true);
+  ASSERT_TRUE(WriteFile(m_window, "<window><controls><include>Label</include><include>Label</include></controls></window>"));
+
+  CGUIWindowCache::Entry entry;
+  EXPECT_FALSE(CGUIWindowCache::Read(m_window, entry));
+}
+
+TEST_F(TestGUIWindowCacheEntry, RejectsChangedInclude)
+{
+  Save(1, true);
+  ASSERT_TRUE(WriteFile(m_include, "<includes><include name=\"Label\"><control type=\"image\"/></include></includes>"));
+
+  CGUIWindowCache::Entry entry;
+  EXPECT_FALSE(CGUIWindowCache::Read(m_window, entry));
+}
+
+TEST_F(TestGUIWindowCacheEntry, RejectsOtherPath)
+{
+  // as if both paths had the same crc
+  Save(1, true);
+  ASSERT_TRUE(XFILE::CFile::Copy(CacheFile(m_window), CacheFile(m_other)));
+
+  CGUIWindowCache::Entry entry;
+  EXPECT_FALSE(CGUIWindowCache::Read(m_other, entry));
+}
+
+TEST_F(TestGUIWindowCacheEntry, RejectsIncludeNoLongerPreloaded)
+{
+  Save(1, true);
+
+  CGUIWindowCache::Entry entry;
+  ASSERT_TRUE(CGUIWindowCache::Read(m_window, entry));
+  CGUIIncludes includes;
+  std::map<INFO::InfoPtr, bool> conditions;
+  std::unique_ptr<TiXmlElement> root(CGUIWindowCache::Load(entry, includes, conditions));
+  EXPECT_TRUE(root.get() == NULL);
+  EXPECT_TRUE(includes.GetFiles().empty());
+}
+
+TEST_F(TestGUIWindowCacheEntry, LoadsIncludeOnDemand)
+{
+  Save(0, true);
+
+  CGUIWindowCache::Entry entry;
+  ASSERT_TRUE(CGUIWindowCache::Read(m_window, entry));
+  CGUIIncludes includes;
+  std::map<INFO::InfoPtr, bool> conditions;
+  std::unique_ptr<TiXmlElement> root(CGUIWindowCache::Load(entry, includes, conditions));
+  EXPECT_TRUE(root.get() != NULL);
+  ASSERT_EQ(1u, includes.GetFiles().size());
+  EXPECT_EQ(m_include, includes.GetFiles()[0]);
+}
+
+TEST_F(TestGUIWindowCacheEntry, RejectsChangedCondition)
+{
+  // the condition was false when the window was resolved and is true now
+  Save(1, false);
+
+  CGUIWindowCache::Entry entry;
+  ASSERT_TRUE(CGUIWindowCache::Read(m_window, entry));
+  CGUIIncludes includes;
+  ASSERT_TRUE(includes.LoadIncludes(m_include));
+  std::map<INFO::InfoPtr, bool> conditions;
+  std::unique_ptr<TiXmlElement> root(CGUIWindowCache::Load(entry, includes, conditions));
+  EXPECT_TRUE(root.get() == NULL);
+  EXPECT_TRUE(conditions.empty());
+}
+
+TEST(TestGUIWindowCache, DISABLED_LoadsMediaWindow)
+{
+  CXBMCTinyXML doc;
+  doc.Parse(MediaWindow());
+  ASSERT_TRUE(doc.RootElement() != NULL);
+
+  std::string xml = Print(doc.RootElement());
+  std::string data;
+  CGUIWindowCache::Serialize(doc.RootElement(), data);
+
+  const int runs = 200;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < runs; i++)
+  {
+    CXBMCTinyXML parsed;
+    parsed.Parse(xml);
+    ASSERT_TRUE(parsed.RootElement() != NULL);
+  }
+  auto parsed = std::chrono::steady_clock::now();
+  for (int i = 0; i < runs; i++)
+  {
+    std::unique_ptr<TiXmlElement> root(CGUIWindowCache::Deserialize(data.c_str(), data.size()));
+    ASSERT_TRUE(root.get() != NULL);
+    if (i == 0)
+      EXPECT_EQ(xml, Print(root.get()));
+  }
+  auto loaded = std::chrono::steady_clock::now();
+
+  RecordProperty("xml_bytes", static_cast<int>(xml.size()));
+  RecordProperty("cache_bytes", static_cast<int>(data.size()));
+  RecordProperty("parse_us", static_cast<int>(std::chrono::duration_cast<std::chrono::microseconds>(parsed - start).count() / runs));
+  RecordProperty("load_us", static_cast<int>(std::chrono::duration_cast<std::chrono::microseconds>(loaded - parsed).count() / runs));
+}
@@ -27,8 +27,10 @@ namespace INFO
     : m_value(false),
       m_context(context),
       m_listItemDependent(false),
+      m_dependencies(DEPENDS_ALWAYS),
       m_expression(expression),
-      m_dirty(true)
+      m_dirty(true),
+      m_evaluated(false)
   {
     StringUtils::ToLower(m_expression);
   }
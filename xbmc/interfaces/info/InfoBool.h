@@ -27,6 +27,23 @@ class CGUIListItem;
 
 namespace INFO
 {
+/*!
+ \ingroup info
+ \brief Inputs an info bool can depend on.
+ Info bools are only set dirty at the end of a frame if one of their dependencies
+ changed, see CGUIInfoManager::ResetFrameCache(). Anything that isn't notified on
+ change is DEPENDS_ALWAYS and is re-evaluated every frame.
+ */
+enum InfoDependency
+{
+  DEPENDS_NONE    = 0,
+  DEPENDS_PLAYER  = 1 << 0, ///< player state, changes while playing or on playback start/stop
+  DEPENDS_LIBRARY = 1 << 1, ///< library content bools
+  DEPENDS_SKIN    = 1 << 2, ///< skin settings
+  DEPENDS_WINDOW  = 1 << 3, ///< window properties
+  DEPENDS_ALWAYS  = 1 << 30
+};
+
 /*!
  \ingroup info
  \brief Base class, wrapping boolean conditions and expressions
@@ -44,6 +61,18 @@ public:
   {
     m_dirty = true;
   }
+  /*! \brief Set the info bool dirty if any of its dependencies changed.
+   \param changed the InfoDependency flags that changed since the last call
+   \return true if the info bool was evaluated since the last call
+   */
+  bool Invalidate(unsigned int changed)
+  {
+    bool evaluated = m_evaluated;
+    m_evaluated = false;
+    if (m_dependencies & changed)
+      m_dirty = true;
+    return evaluated;
+  }
   /*! \brief Get the value of this info bool
    This is called to update (if dirty) and fetch the value of the info bool
    \param item the item used to evaluate the bool
@@ -56,6 +85,7 @@ public:
     {
       Update(NULL);
       m_dirty = false;
+      m_evaluated = true;
     }
     return m_value;
   }
@@ -73,15 +103,19 @@ public:
 
   const std::string &GetExpression() const { return m_expression; }
   bool ListItemDependent() const { return m_listItemDependent; }
+  bool IsDirty() const { return m_dirty; }
+  unsigned int GetDependencies() const { return m_dependencies; }
 protected:
 
   bool m_value;                ///< current value
   int m_context;               ///< contextual information to go with the condition
   bool m_listItemDependent;    ///< do not cache if a listitem pointer is given
+  unsigned int m_dependencies; ///< InfoDependency flags that cause an update when changed
 
 private:
   std::string  m_expression;   ///< original expression
   bool         m_dirty;        ///< whether we need an update
+  bool         m_evaluated;    ///< whether we updated since the last Invalidate()
 };
 
 typedef std::shared_ptr<InfoBool> InfoPtr;
@@ -22,6 +22,7 @@
 #include <stack>
 #include "utils/log.h"
 #include "GUIInfoManager.h"
+#include <algorithm>
 #include <list>
 #include <memory>
 
@@ -31,6 +32,7 @@ InfoSingle::InfoSingle(const std::string &expression, int context)
 : InfoBool(expression, context)
 {
   m_condition = g_infoManager.TranslateSingleString(expression, m_listItemDependent);
+  m_dependencies = g_infoManager.GetDependencies(m_condition);
 }
 
 void InfoSingle::Update(const CGUIListItem *item)
@@ -41,16 +43,58 @@ void InfoSingle::Update(const CGUIListItem *item)
 InfoExpression::InfoExpression(const std::string &expression, int context)
 : InfoBool(expression, context)
 {
-  if (!Parse(expression))
+  Initialize(expression, [](const std::string &condition, int context) {
+    return g_infoManager.Register(condition, context);
+  });
+}
+
+InfoExpression::InfoExpression(const std::string &expression, int context, const RegisterFunc &registerFunc)
+: InfoBool(expression, context)
+{
+  Initialize(expression, registerFunc);
+}
+
+void InfoExpression::Initialize(const std::string &expression, const RegisterFunc &registerFunc)
+{
+  m_dependencies = DEPENDS_NONE;
+  if (!Parse(expression, registerFunc) || !Compile())
   {
     CLog::Log(LOGERROR, "Error parsing boolean expression %s", expression.c_str());
-    m_expression_tree = std::make_shared<InfoLeaf>(g_infoManager.Register("false", 0), false);
+    m_expression_tree = std::make_shared<InfoLeaf>(registerFunc("false", 0), false);
+    m_dependencies = DEPENDS_NONE;
+    Compile();
   }
 }
 
 void InfoExpression::Update(const CGUIListItem *item)
 {
-  m_value = m_expression_tree->Evaluate(item);
+  // Promote() reorders instructions in place, so these stay valid
+  const Instruction *program = m_program.data();
+  const size_t size = m_program.size();
+
+  bool value = false;
+  size_t pc = 0;
+  while (pc < size)
+  {
+    const Instruction &instruction = program[pc];
+    if (instruction.op & OP_LEAF)
+      value = (instruction.invert != 0) ^ instruction.leaf->Get(item);
+    if (instruction.op & (value ? OP_EXIT_IF_TRUE : OP_EXIT_IF_FALSE))
+    {
+      size_t end = pc + instruction.end;
+      if (instruction.block != instruction.group)
+        Promote(pc);
+      pc = end;
+    }
+    else
+      pc++;
+  }
+  m_value = value;
+}
+
+bool InfoExpression::EvaluateTree(const CGUIListItem *item)
+{
+  return m_expression_tree->Evaluate(item);
 }
 
 /* Expressions are rewritten at parse time into a form which favours the
@@ -207,7 +251,7 @@ void InfoExpression::OperatorPop(std::stack<operator_t> &operator_stack, bool &i
   }
 }
 
-bool InfoExpression::Parse(const std::string &expression)
+bool InfoExpression::Parse(const std::string &expression, const RegisterFunc &registerFunc)
 {
   const char *s = expression.c_str();
   std::string operand;
@@ -242,7 +286,7 @@ bool InfoExpression::Parse(const std::string &expression)
       }
       if (!operand.empty())
       {
-        InfoPtr info = g_infoManager.Register(operand, m_context);
+        InfoPtr info = registerFunc(operand, m_context);
         if (!info)
         {
           CLog::Log(LOGERROR, "Bad operand '%s'", operand.c_str());
@@ -250,6 +294,7 @@ bool InfoExpression::Parse(const std::string &expression)
         }
         /* Propagate any listItem dependency from the operand to the expression */
         m_listItemDependent |= info->ListItemDependent();
+        m_dependencies |= info->GetDependencies();
         nodes.push(std::make_shared<InfoLeaf>(info, invert));
         /* Reuse operand string for next operand */
         operand.clear();
@@ -293,7 +338,7 @@ bool InfoExpression::Parse(const std::string &expression)
   }
   if (!operand.empty())
   {
-    InfoPtr info = g_infoManager.Register(operand, m_context);
+    InfoPtr info = registerFunc(operand, m_context);
     if (!info)
     {
       CLog::Log(LOGERROR, "Bad operand '%s'", operand.c_str());
@@ -301,6 +346,7 @@ bool InfoExpression::Parse(const std::string &expression)
     }
     /* Propagate any listItem dependency from the operand to the expression */
     m_listItemDependent |= info->ListItemDependent();
+    m_dependencies |= info->GetDependencies();
     nodes.push(std::make_shared<InfoLeaf>(info, invert));
   }
   while (!operator_stack.empty())
@@ -309,3 +355,88 @@ bool InfoExpression::Parse(const std::string &expression)
   m_expression_tree = nodes.top();
   return true;
 }
+
+/* The tree is compiled depth first. Each child of a group ends in an exit to
+ * the end of the group, taken when the child decides the value of the group
+ * (true for OR, false for AND). Like the tree, the program adapts at runtime:
+ * a child whose exit is taken is moved to the front of its group.
+ */
+
+bool InfoExpression::Compile()
+{
+  m_program.clear();
+  m_leaves.clear();
+  m_expression_tree->Compile(*this);
+  if (m_program.size() > UINT16_MAX)
+  {
+    CLog::Log(LOGERROR, "Boolean expression too large to compile");
+    return false;
+  }
+  return true;
+}
+
+InfoBool *InfoExpression::AddLeaf(const InfoPtr &info)
+{
+  if (std::find(m_leaves.begin(), m_leaves.end(), info) == m_leaves.end())
+    m_leaves.push_back(info);
+  return info.get();
+}
+
+void InfoExpression::InfoLeaf::Compile(InfoExpression &expression) const
+{
+  Instruction instruction = { expression.AddLeaf(m_info), OP_LEAF, m_invert, 0, 0, 0 };
+  expression.m_program.push_back(instruction);
+}
+
+void InfoExpression::InfoAssociativeGroup::Compile(InfoExpression &expression) const
+{
+  std::vector<Instruction> &program = expression.m_program;
+  uint8_t exit = m_type == NODE_AND ? OP_EXIT_IF_FALSE : OP_EXIT_IF_TRUE;
+  size_t start = program.size();
+  std::vector<size_t> exits;
+  for (std::list<InfoSubexpressionPtr>::const_iterator i = m_children.begin(); i != m_children.end(); ++i)
+  {
+    (*i)->Compile(expression);
+    if ((*i)->Type() == NODE_LEAF)
+      program.back().op |= exit;
+    else
+    {
+      Instruction instruction = { NULL, exit, 0, 0, 0, 0 };
+      program.push_back(instruction);
+    }
+    exits.push_back(program.size() - 1);
+  }
+  SetExits(program, start, program.size(), exits);
+}
+
+void InfoExpression::SetExits(std::vector<Instruction> &program, size_t start, size_t end, const std::vector<size_t> &exits)
+{
+  size_t block = start;
+  for (std::vector<size_t>::const_iterator i = exits.begin(); i != exits.end(); ++i)
+  {
+    program[*i].end = static_cast<uint16_t>(end - *i);
+    program[*i].block = static_cast<uint16_t>(*i - block);
+    program[*i].group = static_cast<uint16_t>(*i - start);
+    block = *i + 1;
+  }
+}
+
+void InfoExpression::Promote(size_t exit)
+{
+  size_t start = exit - m_program[exit].group;
+  size_t block = exit - m_program[exit].block;
+  size_t end = exit + m_program[exit].end;
+
+  // the exits of this group are the only instructions in it that lead to its end
+  std::vector<size_t> exits;
+  exits.push_back(start + exit - block);
+  for (size_t pc = start; pc < end; pc++)
+  {
+    const Instruction &instruction = m_program[pc];
+    if (pc != exit && (instruction.op & (OP_EXIT_IF_TRUE | OP_EXIT_IF_FALSE)) && pc + instruction.end == end)
+      exits.push_back(pc < block ? pc + exit + 1 - block : pc);
+  }
+
+  std::rotate(m_program.begin() + start, m_program.begin() + block, m_program.begin() + exit + 1);
+  SetExits(m_program, start, end, exits);
+}
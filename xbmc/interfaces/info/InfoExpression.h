@@ -20,9 +20,11 @@
 
 #pragma once
 
-#include <vector>
+#include <functional>
 #include <list>
 #include <stack>
+#include <stdint.h>
+#include <vector>
 #include "InfoBool.h"
 
 class CGUIListItem;
@@ -43,14 +45,30 @@ private:
 };
 
 /*! \brief Class to wrap active boolean expressions
+ The expression is parsed into a tree, which is then compiled into a flat
+ program of leaf evaluations and short-circuit jumps that Update() runs.
  */
 class InfoExpression : public InfoBool
 {
 public:
+  /*! \brief Registers an operand of the expression, see CGUIInfoManager::Register
+   */
+  typedef std::function<InfoPtr(const std::string &condition, int context)> RegisterFunc;
+
   InfoExpression(const std::string &expression, int context);
+  InfoExpression(const std::string &expression, int context, const RegisterFunc &registerFunc);
   virtual ~InfoExpression() {};
 
   virtual void Update(const CGUIListItem *item);
+
+  /*! \brief Evaluate the parsed tree instead of the compiled program
+   Gives the same result as Update(), used to compare the two.
+   */
+  bool EvaluateTree(const CGUIListItem *item);
+
+  /*! \brief Number of instructions in the compiled program
+   */
+  size_t GetProgramSize() const { return m_program.size(); }
 private:
   typedef enum
   {
@@ -76,6 +94,7 @@ private:
     virtual ~InfoSubexpression(void) {}; // so we can destruct derived classes using a pointer to their base class
     virtual bool Evaluate(const CGUIListItem *item) = 0;
     virtual node_type_t Type() const=0;
+    virtual void Compile(InfoExpression &expression) const = 0;
   };
 
   typedef std::shared_ptr<InfoSubexpression> InfoSubexpressionPtr;
@@ -87,6 +106,7 @@ private:
     InfoLeaf(InfoPtr info, bool invert) : m_info(info), m_invert(invert) {};
     virtual bool Evaluate(const CGUIListItem *item);
     virtual node_type_t Type() const { return NODE_LEAF; };
+    virtual void Compile(InfoExpression &expression) const;
   private:
     InfoPtr m_info;
     bool m_invert;
@@ -101,15 +121,45 @@ private:
     void Merge(std::shared_ptr<InfoAssociativeGroup> other);
     virtual bool Evaluate(const CGUIListItem *item);
     virtual node_type_t Type() const { return m_type; };
+    virtual void Compile(InfoExpression &expression) const;
   private:
     node_type_t m_type;
     std::list<InfoSubexpressionPtr> m_children;
   };
 
+  typedef enum
+  {
+    OP_LEAF          = 1, // value = leaf ^ invert
+    OP_EXIT_IF_TRUE  = 2, // jump to the end of an OR group if value is true
+    OP_EXIT_IF_FALSE = 4, // jump to the end of an AND group if value is false
+  } opcode_t;
+
+  /* Every child of a group ends in an exit to the end of the group, either
+   * combined with the leaf or as a separate instruction after a subgroup, so
+   * a child can be moved to the front of its group together with its exit.
+   */
+  struct Instruction
+  {
+    InfoBool *leaf;    // owned by m_leaves
+    uint8_t op;        // opcode_t flags
+    uint8_t invert;
+    uint16_t end;      // exits: distance to the end of the group
+    uint16_t block;    // exits: distance back to the start of the child
+    uint16_t group;    // exits: distance back to the start of the group
+  };
+
   static operator_t GetOperator(char ch);
   static void OperatorPop(std::stack<operator_t> &operator_stack, bool &invert, std::stack<InfoSubexpressionPtr> &nodes);
-  bool Parse(const std::string &expression);
+  void Initialize(const std::string &expression, const RegisterFunc &registerFunc);
+  bool Parse(const std::string &expression, const RegisterFunc &registerFunc);
+  bool Compile();
+  InfoBool *AddLeaf(const InfoPtr &info);
+  void Promote(size_t exit);
+  static void SetExits(std::vector<Instruction> &program, size_t start, size_t end, const std::vector<size_t> &exits);
+
   InfoSubexpressionPtr m_expression_tree;
+  std::vector<Instruction> m_program;
+  std::vector<InfoPtr> m_leaves;
 };
 
 };
@@ -0,0 +1,210 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "FileItem.h"
+#include "filesystem/Directory.h"
+#include "interfaces/info/InfoExpression.h"
+#include "test/TestUtils.h"
+#include "utils/XBMCTinyXML.h"
+#include "gtest/gtest.h"
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace INFO;
+
+namespace
+{
+class TestBool : public InfoBool
+{
+public:
+  TestBool(const std::string &condition, bool value)
+    : InfoBool(condition, 0), value(value), updates(0) {}
+
+  virtual void Update(const CGUIListItem *item)
+  {
+    m_value = value;
+    updates++;
+  }
+
+  bool value;
+  unsigned int updates;
+};
+
+class TestInfoExpression : public testing::Test
+{
+protected:
+  std::shared_ptr<InfoExpression> Create(const std::string &expression)
+  {
+    return std::make_shared<InfoExpression>(expression, 0,
+      [this](const std::string &condition, int context) { return Leaf(condition); });
+  }
+
+  InfoPtr Leaf(std::string condition)
+  {
+    // CGUIInfoManager::Register() trims the operands as well
+    condition.erase(condition.find_last_not_of(' ') + 1);
+    std::shared_ptr<TestBool> &leaf = m_leaves[condition];
+    if (!leaf)
+      leaf = std::make_shared<TestBool>(condition, condition == "true" || m_value(condition));
+    return leaf;
+  }
+
+  void Set(const std::string &condition, bool value)
+  {
+    Leaf(condition);
+    m_leaves[condition]->value = value;
+    m_leaves[condition]->SetDirty();
+  }
+
+  std::map<std::string, std::shared_ptr<TestBool> > m_leaves;
+  std::function<bool(const std::string&)> m_value = [](const std::string &) { return false; };
+};
+
+void CollectConditions(const TiXmlElement *element, std::vector<std::string> &conditions)
+{
+  for (; element; element = element->NextSiblingElement())
+  {
+    const char *condition = element->Attribute("condition");
+    if (condition)
+      conditions.push_back(condition);
+    if ((element->ValueStr() == "visible" || element->ValueStr() == "enable" ||
+         element->ValueStr() == "selected") && element->FirstChild())
+      conditions.push_back(element->FirstChild()->ValueStr());
+    CollectConditions(element->FirstChildElement(), conditions);
+  }
+}
+}
+
+TEST_F(TestInfoExpression, MatchesTree)
+{
+  const char *expressions[] = {
+    "a + b | !c",
+    "![a | b] + c",
+    "[a + b] | [c + [d | !e]]",
+    "!a",
+    "a | [b + !c + [d | e]] | ![c + e]",
+  };
+  const char *names[] = { "a", "b", "c", "d", "e" };
+
+  for (const char *expression : expressions)
+  {
+    std::shared_ptr<InfoExpression> info = Create(expression);
+    // go through the combinations twice, the program reorders itself on the way
+    for (unsigned int bits = 0; bits < 64; bits++)
+    {
+      for (unsigned int i = 0; i < 5; i++)
+        Set(names[i], (bits & (1 << i)) != 0);
+      info->Update(NULL);
+      EXPECT_EQ(info->EvaluateTree(NULL), info->Get()) << expression << " " << bits;
+      info->SetDirty();
+    }
+  }
+  EXPECT_EQ(5u, m_leaves.size());
+}
+
+TEST_F(TestInfoExpression, PromotesDecidingChild)
+{
+  std::shared_ptr<InfoExpression> info = Create("a | b | [c + d]");
+  Set("c", true);
+  Set("d", true);
+  EXPECT_EQ(5u, info->GetProgramSize());
+
+  EXPECT_TRUE(info->Get());
+  EXPECT_EQ(1u, m_leaves["a"]->updates);
+  EXPECT_EQ(1u, m_leaves["c"]->updates);
+
+  // [c + d] decided the group, so it is evaluated first from now on
+  Set("a", false);
+  Set("c", true);
+  info->SetDirty();
+  EXPECT_TRUE(info->Get());
+  EXPECT_EQ(1u, m_leaves["a"]->updates);
+  EXPECT_EQ(2u, m_leaves["c"]->updates);
+
+  Set("c", false);
+  Set("b", true);
+  info->SetDirty();
+  EXPECT_TRUE(info->Get());
+  EXPECT_EQ(2u, m_leaves["a"]->updates);
+  EXPECT_EQ(3u, m_leaves["c"]->updates);
+}
+
+TEST_F(TestInfoExpression, DISABLED_EvaluateSkinExpressions)
+{
+  std::vector<std::string> conditions;
+  CFileItemList items;
+  ASSERT_TRUE(XFILE::CDirectory::GetDirectory(XBMC_REF_FILE_PATH("addons/skin.estuary/1080i/"), items, ".xml"));
+  for (int i = 0; i < items.Size(); i++)
+  {
+    CXBMCTinyXML doc;
+    if (doc.LoadFile(items[i]->GetPath()))
+      CollectConditions(doc.RootElement(), conditions);
+  }
+
+  // the skin's expressions, with unresolved parameters left out
+  std::hash<std::string> hash;
+  m_value = [&hash](const std::string &condition) { return (hash(condition) & 1) != 0; };
+  std::vector<std::shared_ptr<InfoExpression> > expressions;
+  for (const std::string &condition : conditions)
+  {
+    if (condition.find('$') == std::string::npos && condition.find_first_of("|+[]!") != std::string::npos)
+      expressions.push_back(Create(condition));
+  }
+  ASSERT_FALSE(expressions.empty());
+
+  // evaluate once per frame, with the caches flushed by whatever else the frame does
+  const int frames = 200;
+  std::vector<char> frame(16 * 1024 * 1024);
+  unsigned int hits = 0;
+  double tree = 0.0;
+  double program = 0.0;
+  for (int i = 0; i < frames; i++)
+  {
+    for (size_t j = 0; j < frame.size(); j += 64)
+      frame[j]++;
+    auto start = std::chrono::steady_clock::now();
+    for (const auto &expression : expressions)
+      hits += expression->EvaluateTree(NULL);
+    tree += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    for (size_t j = 0; j < frame.size(); j += 64)
+      frame[j]++;
+    start = std::chrono::steady_clock::now();
+    for (const auto &expression : expressions)
+    {
+      expression->Update(NULL);
+      hits -= expression->Get();
+    }
+    program += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+  EXPECT_EQ(0u, hits);
+
+  double evaluations = static_cast<double>(frames) * expressions.size();
+  RecordProperty("expressions", static_cast<int>(expressions.size()));
+  RecordProperty("conditions", static_cast<int>(conditions.size()));
+  RecordProperty("leaves", static_cast<int>(m_leaves.size()));
+  RecordProperty("tree_ns", std::to_string(tree * 1e9 / evaluations));
+  RecordProperty("compiled_ns", std::to_string(program * 1e9 / evaluations));
+}
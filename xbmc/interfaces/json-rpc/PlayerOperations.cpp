@@ -39,6 +39,7 @@
 #include "pvr/channels/PVRChannel.h"
 #include "pvr/channels/PVRChannelGroupsContainer.h"
 #include "pvr/recordings/PVRRecordings.h"
+#include "cores/DataCacheCore.h"
 #include "cores/IPlayer.h"
 #include "cores/playercorefactory/PlayerCoreFactory.h"
 #include "utils/SeekHandler.h"
@@ -259,6 +260,25 @@ JSONRPC_STATUS CPlayerOperations::GetItem(const std::string &method, ITransportL
   return OK;
 }
 
+JSONRPC_STATUS CPlayerOperations::GetStatistics(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
+{
+  switch (GetPlayer(parameterObject["playerid"]))
+  {
+    case Video:
+    case Audio:
+      if (!g_application.m_pPlayer->HasPlayer())
+        return FailedToExecute;
+
+      g_dataCacheCore.GetAVSyncStats(result);
+      return OK;
+
+    case Picture:
+    case None:
+    default:
+      return FailedToExecute;
+  }
+}
+
 JSONRPC_STATUS CPlayerOperations::PlayPause(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
 {
   CGUIWindowSlideShow *slideshow = NULL;
@@ -1734,6 +1754,30 @@ JSONRPC_STATUS CPlayerOperations::GetPropertyValue(PlayerType player, const std:
   }
   else if (property == "live")
     result = IsPVRChannel();
+  else if (property == "cache")
+  {
+    switch (player)
+    {
+    case Video:
+    case Audio:
+    {
+      XFILE::SCacheStatus status = g_dataCacheCore.GetCacheStatus();
+      result = CVariant(CVariant::VariantTypeObject);
+      result["forward"] = status.forward;
+      result["cached"] = status.cached;
+      result["read"] = status.read;
+      result["refill"] = status.refill;
+      result["level"] = status.level;
+      result["readrate"] = status.currate;
+      result["maxrate"] = status.maxrate;
+      break;
+    }
+    case Picture:
+    default:
+      result = CVariant(CVariant::VariantTypeNull);
+      break;
+    }
+  }
   else
     return InvalidParams;
 
@@ -27,6 +27,7 @@
 #include "guilib/GraphicContext.h"
 #include "settings/AdvancedSettings.h"
 #include "guilib/MatrixGLES.h"
+#include "guilib/TextureGL.h"
 #include "settings/DisplaySettings.h"
 #include "utils/log.h"
 #include "utils/GLUtils.h"
@@ -247,6 +248,9 @@ bool CRenderSystemGL::BeginRender()
   if (!m_bRenderCreated)
     return false;
 
+  // anything may have touched the texture bindings since the last frame
+  CGLTexture::ResetBindings();
+
   return true;
 }
 
@@ -370,6 +374,7 @@ void CRenderSystemGL::ApplyStateBlock()
   glMatrixProject.PopLoad();
   glMatrixModview.PopLoad();
   glMatrixTexture.PopLoad();
+  CGLTexture::ResetBindings();
 
   if (glActiveTextureARB)
     glActiveTextureARB(GL_TEXTURE0_ARB);
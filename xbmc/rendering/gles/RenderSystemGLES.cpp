@@ -27,6 +27,7 @@
 #include "settings/AdvancedSettings.h"
 #include "RenderSystemGLES.h"
 #include "guilib/MatrixGLES.h"
+#include "guilib/TextureGL.h"
 #include "windowing/WindowingFactory.h"
 #include "utils/log.h"
 #include "utils/GLUtils.h"
@@ -208,6 +209,9 @@ bool CRenderSystemGLES::BeginRender()
   if (!m_bRenderCreated)
     return false;
 
+  // anything may have touched the texture bindings since the last frame
+  CGLTexture::ResetBindings();
+
   return true;
 }
 
@@ -339,6 +343,7 @@ void CRenderSystemGLES::ApplyStateBlock()
   glMatrixProject.PopLoad();
   glMatrixModview.PopLoad();
   glMatrixTexture.PopLoad();
+  CGLTexture::ResetBindings();
   glActiveTexture(GL_TEXTURE0);
   glEnable(GL_BLEND);
   glEnable(GL_SCISSOR_TEST);  
@@ -117,6 +117,9 @@ void CAdvancedSettings::Initialize()
   //default hold time of 25 ms, this allows a 20 hertz sine to pass undistorted
   m_limiterHold = 0.025f;
   m_limiterRelease = 0.1f;
+  m_audioZones.clear();
+  m_audioFreewheel = false;
+  m_audioFreewheelFile.clear();
 
   m_seekSteps = { 10, 30, 60, 180, 300, 600, 1800 };
 
@@ -160,6 +163,14 @@ void CAdvancedSettings::Initialize()
   m_DXVAAllowHqScaling = true;
   m_videoFpsDetect = 1;
   m_videoBusyDialogDelay_ms = 500;
+  m_videoDemuxZeroCopy = true;
+  m_videoDecoderThreadType = DECODER_THREADS_AUTO;
+  m_videoDecoderThreads = 0;
+  m_videoDecoderCodecThreads.clear();
+  m_videoDecoderLowLatencyLive = false;
+  m_videoDumpAVSyncStats = false;
+  m_videoSeekIndex = true;
+  m_videoExtractionThreads = 0;
 
   m_mediacodecForceSoftwareRendring = false;
 
@@ -319,6 +330,11 @@ void CAdvancedSettings::Initialize()
   m_curlconnecttimeout = 10;
   m_curllowspeedtime = 20;
   m_curlretries = 2;
+  m_curlParallelConnections = 1;
+  m_curlMaxHostConnections = 4;
+  m_curlMaxIdleSessions = 16;
+  m_curlKeepAliveTime = 30;
+  m_curlPipelining = false;
   m_curlDisableIPV6 = false;      //Certain hardware/OS combinations have trouble
                                   //with ipv6.
 
@@ -356,6 +372,8 @@ void CAdvancedSettings::Initialize()
   m_iPVRNumericChannelSwitchTimeout = 1000;
 
   m_cacheMemBufferSize = 1024 * 1024 * 20;
+  m_cacheDiskRingSize = 0; // disabled, a/v streams use the memory buffer
+  m_cacheRamWindow = 1024 * 1024 * 16;
   m_networkBufferMode = 0; // Default (buffer all internet streams/filesystems)
   // the following setting determines the readRate of a player data
   // as multiply of the default data read rate
@@ -374,6 +392,7 @@ void CAdvancedSettings::Initialize()
 #endif
   m_guiVisualizeDirtyRegions = false;
   m_guiAlgorithmDirtyRegions = 3;
+  m_guiAsyncGlyphs = true;
   m_airTunesPort = 36666;
   m_airPlayPort = 36667;
 
@@ -490,6 +509,30 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
 
     XMLUtils::GetFloat(pElement, "limiterhold", m_limiterHold, 0.0f, 100.0f);
     XMLUtils::GetFloat(pElement, "limiterrelease", m_limiterRelease, 0.001f, 100.0f);
+
+    // additional outputs playing the same mix, <zone latency="20">ALSA:hw:1,0</zone>
+    TiXmlElement* pZones = pElement->FirstChildElement("zones");
+    if (pZones)
+    {
+      m_audioZones.clear();
+      TiXmlElement* pZone = pZones->FirstChildElement("zone");
+      while (pZone)
+      {
+        if (pZone->FirstChild())
+        {
+          AudioZone zone;
+          zone.device = pZone->FirstChild()->ValueStr();
+          zone.latency = 0;
+          pZone->QueryIntAttribute("latency", &zone.latency);
+          m_audioZones.push_back(zone);
+        }
+        pZone = pZone->NextSiblingElement("zone");
+      }
+    }
+
+    // benchmark the engine, <freewheel file="special://temp/freewheel.wav">true</freewheel>
+    if (XMLUtils::GetBoolean(pElement, "freewheel", m_audioFreewheel))
+      m_audioFreewheelFile = XMLUtils::GetAttribute(pElement->FirstChildElement("freewheel"), "file");
   }
 
   pElement = pRootElement->FirstChildElement("omx");
@@ -653,6 +696,59 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     // the busy dialog is shown when starting video playback.
     XMLUtils::GetInt(pElement, "busydialogdelayms", m_videoBusyDialogDelay_ms, 0, 1000);
 
+    // hand ffmpeg's packet buffers to the decoders instead of copying them
+    XMLUtils::GetBoolean(pElement, "demuxzerocopy", m_videoDemuxZeroCopy);
+
+    // write a/v sync statistics to the log folder when playback ends
+    XMLUtils::GetBoolean(pElement, "dumpavsyncstats", m_videoDumpAVSyncStats);
+
+    // remember keyframe offsets of network files for faster seeking
+    XMLUtils::GetBoolean(pElement, "seekindex", m_videoSeekIndex);
+
+    // concurrent thumbnail / stream details extraction jobs, 0 = half the cores
+    XMLUtils::GetInt(pElement, "extractionthreads", m_videoExtractionThreads, 0, 32);
+
+    // software decoder threading policy
+    TiXmlElement* pDecoderThreads = pElement->FirstChildElement("decoderthreads");
+    if (pDecoderThreads)
+    {
+      std::string type;
+      if (XMLUtils::GetString(pDecoderThreads, "type", type))
+      {
+        StringUtils::ToLower(type);
+        if (type == "frame")
+          m_videoDecoderThreadType = DECODER_THREADS_FRAME;
+        else if (type == "slice")
+          m_videoDecoderThreadType = DECODER_THREADS_SLICE;
+        else if (type == "frameslice")
+          m_videoDecoderThreadType = DECODER_THREADS_FRAME_SLICE;
+        else
+          m_videoDecoderThreadType = DECODER_THREADS_AUTO;
+      }
+
+      // 0 = pick from the number of cpus
+      XMLUtils::GetInt(pDecoderThreads, "count", m_videoDecoderThreads, 0, 64);
+      XMLUtils::GetBoolean(pDecoderThreads, "lowlatencylive", m_videoDecoderLowLatencyLive);
+
+      // <codec name="hevc">8</codec>, name as reported by ffmpeg
+      TiXmlElement* pCodec = pDecoderThreads->FirstChildElement("codec");
+      while (pCodec)
+      {
+        const char* name = pCodec->Attribute("name");
+        if (name && pCodec->FirstChild())
+        {
+          int threads = atoi(pCodec->FirstChild()->Value());
+          std::string codec = name;
+          StringUtils::ToLower(codec);
+          if (threads >= 0 && threads <= 64)
+            m_videoDecoderCodecThreads[codec] = threads;
+          else
+            CLog::Log(LOGWARNING, "Ignoring invalid decoder thread count %d for codec %s", threads, name);
+        }
+        pCodec = pCodec->NextSiblingElement("codec");
+      }
+    }
+
     // Store global display latency settings
     TiXmlElement* pVideoLatency = pElement->FirstChildElement("latency");
     if (pVideoLatency)
@@ -743,8 +839,15 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetInt(pElement, "curlclienttimeout", m_curlconnecttimeout, 1, 1000);
     XMLUtils::GetInt(pElement, "curllowspeedtime", m_curllowspeedtime, 1, 1000);
     XMLUtils::GetInt(pElement, "curlretries", m_curlretries, 0, 10);
+    XMLUtils::GetInt(pElement, "curlparallelconnections", m_curlParallelConnections, 1, 16);
+    XMLUtils::GetInt(pElement, "curlmaxhostconnections", m_curlMaxHostConnections, 1, 32);
+    XMLUtils::GetInt(pElement, "curlmaxidlesessions", m_curlMaxIdleSessions, 0, 256);
+    XMLUtils::GetInt(pElement, "curlkeepalivetime", m_curlKeepAliveTime, 1, 600);
+    XMLUtils::GetBoolean(pElement, "curlpipelining", m_curlPipelining);
     XMLUtils::GetBoolean(pElement,"disableipv6", m_curlDisableIPV6);
     XMLUtils::GetUInt(pElement, "cachemembuffersize", m_cacheMemBufferSize);
+    XMLUtils::GetUInt(pElement, "cachediskringsize", m_cacheDiskRingSize);
+    XMLUtils::GetUInt(pElement, "cacheramwindow", m_cacheRamWindow);
     XMLUtils::GetUInt(pElement, "buffermode", m_networkBufferMode, 0, 3);
     XMLUtils::GetFloat(pElement, "readbufferfactor", m_readBufferFactor);
   }
@@ -1118,6 +1221,7 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
   {
     XMLUtils::GetBoolean(pElement, "visualizedirtyregions", m_guiVisualizeDirtyRegions);
     XMLUtils::GetInt(pElement, "algorithmdirtyregions",     m_guiAlgorithmDirtyRegions);
+    XMLUtils::GetBoolean(pElement, "asyncglyphs", m_guiAsyncGlyphs);
   }
 
   std::string seekSteps;
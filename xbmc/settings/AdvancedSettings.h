@@ -19,6 +19,7 @@
  *
  */
 
+#include <map>
 #include <set>
 #include <string>
 #include <utility>
@@ -94,6 +95,20 @@ struct RefreshOverride
 };
 
 
+enum DecoderThreadType
+{
+  DECODER_THREADS_AUTO = 0,
+  DECODER_THREADS_FRAME,
+  DECODER_THREADS_SLICE,
+  DECODER_THREADS_FRAME_SLICE
+};
+
+struct AudioZone
+{
+  std::string device;
+  int latency; // ms the device plays later than it reports
+};
+
 struct RefreshVideoLatency
 {
   float refreshmin;
@@ -136,6 +151,9 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     bool m_VideoPlayerIgnoreDTSinWAV;
     float m_limiterHold;
     float m_limiterRelease;
+    std::vector<AudioZone> m_audioZones;
+    bool m_audioFreewheel;
+    std::string m_audioFreewheelFile;
 
     bool  m_omxDecodeStartWithValidFrame;
 
@@ -186,6 +204,14 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     bool m_DXVAAllowHqScaling;
     int  m_videoFpsDetect;
     int  m_videoBusyDialogDelay_ms;
+    bool m_videoDemuxZeroCopy;
+    int  m_videoDecoderThreadType;
+    int  m_videoDecoderThreads;
+    std::map<std::string, int> m_videoDecoderCodecThreads;
+    bool m_videoDecoderLowLatencyLive;
+    bool m_videoDumpAVSyncStats;
+    bool m_videoSeekIndex;
+    int m_videoExtractionThreads;
     bool m_mediacodecForceSoftwareRendring;
 
     std::string m_videoDefaultPlayer;
@@ -291,6 +317,11 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     int m_curlconnecttimeout;
     int m_curllowspeedtime;
     int m_curlretries;
+    int m_curlParallelConnections;
+    int m_curlMaxHostConnections;
+    int m_curlMaxIdleSessions;
+    int m_curlKeepAliveTime;
+    bool m_curlPipelining;
     bool m_curlDisableIPV6;
 
     bool m_fullScreen;
@@ -333,9 +364,12 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
 
     bool m_guiVisualizeDirtyRegions;
     int  m_guiAlgorithmDirtyRegions;
+    bool m_guiAsyncGlyphs;
     unsigned int m_addonPackageFolderSize;
 
     unsigned int m_cacheMemBufferSize;
+    unsigned int m_cacheDiskRingSize;
+    unsigned int m_cacheRamWindow;
     unsigned int m_networkBufferMode;
     float m_readBufferFactor;
 
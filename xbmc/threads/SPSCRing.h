@@ -0,0 +1,120 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+/*!
+ * \brief Bounded, wait-free single-producer/single-consumer ring.
+ *
+ * Exactly one thread may call Push() and exactly one (other) thread may call
+ * Pop()/Front(). Size() and Empty() may be called from either side and give
+ * a snapshot. The capacity is rounded up to a power of two so indices can be
+ * masked instead of divided.
+ */
+template<typename T>
+class CSPSCRing
+{
+public:
+  explicit CSPSCRing(size_t capacity = 0)
+  {
+    Resize(capacity);
+  }
+
+  CSPSCRing(const CSPSCRing&) = delete;
+  CSPSCRing& operator=(const CSPSCRing&) = delete;
+
+  /*!
+   * \brief Reallocate the ring. Must not be called while either side is active.
+   */
+  void Resize(size_t capacity)
+  {
+    size_t size = 1;
+    while (size < capacity)
+      size <<= 1;
+    m_buffer.assign(capacity ? size : 0, T());
+    m_mask = size - 1;
+    m_head.store(0, std::memory_order_relaxed);
+    m_tail.store(0, std::memory_order_relaxed);
+  }
+
+  size_t Capacity() const { return m_buffer.size(); }
+
+  /*!
+   * \brief Producer side. Returns false if the ring is full.
+   */
+  bool Push(const T& item)
+  {
+    const size_t head = m_head.load(std::memory_order_relaxed);
+    if (head - m_tail.load(std::memory_order_acquire) >= m_buffer.size())
+      return false;
+
+    m_buffer[head & m_mask] = item;
+    m_head.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  /*!
+   * \brief Consumer side. Returns false if the ring is empty.
+   */
+  bool Pop(T& item)
+  {
+    const size_t tail = m_tail.load(std::memory_order_relaxed);
+    if (tail == m_head.load(std::memory_order_acquire))
+      return false;
+
+    item = m_buffer[tail & m_mask];
+    m_buffer[tail & m_mask] = T();
+    m_tail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  /*!
+   * \brief Consumer side. Peek at the oldest element without removing it.
+   */
+  const T* Front() const
+  {
+    const size_t tail = m_tail.load(std::memory_order_relaxed);
+    if (tail == m_head.load(std::memory_order_acquire))
+      return nullptr;
+
+    return &m_buffer[tail & m_mask];
+  }
+
+  size_t Size() const
+  {
+    // load the tail first so the difference can't underflow
+    const size_t tail = m_tail.load(std::memory_order_acquire);
+    return m_head.load(std::memory_order_acquire) - tail;
+  }
+
+  bool Empty() const { return Size() == 0; }
+
+private:
+  std::vector<T> m_buffer;
+  size_t m_mask = 0;
+
+  // keep producer and consumer indices on separate cache lines
+  alignas(64) std::atomic<size_t> m_head{0};
+  alignas(64) std::atomic<size_t> m_tail{0};
+};
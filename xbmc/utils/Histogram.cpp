@@ -0,0 +1,128 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "Histogram.h"
+#include "utils/Variant.h"
+
+#include <algorithm>
+#include <math.h>
+
+CHistogram::CHistogram()
+  : CHistogram(0.0, 1.0, 1)
+{
+}
+
+CHistogram::CHistogram(double min, double max, unsigned int buckets)
+  : m_min(min),
+    m_max(max),
+    m_width((max - min) / std::max(buckets, 1U)),
+    m_buckets(std::max(buckets, 1U))
+{
+  Reset();
+}
+
+void CHistogram::Reset()
+{
+  std::fill(m_buckets.begin(), m_buckets.end(), 0);
+  m_underflow = 0;
+  m_overflow = 0;
+  m_count = 0;
+  m_sum = 0.0;
+  m_sumSquares = 0.0;
+  m_lowest = 0.0;
+  m_highest = 0.0;
+}
+
+void CHistogram::Add(double value)
+{
+  if (value < m_min)
+    m_underflow++;
+  else if (value >= m_max)
+    m_overflow++;
+  else
+  {
+    size_t bucket = static_cast<size_t>((value - m_min) / m_width);
+    m_buckets[std::min(bucket, m_buckets.size() - 1)]++;
+  }
+
+  if (m_count == 0 || value < m_lowest)
+    m_lowest = value;
+  if (m_count == 0 || value > m_highest)
+    m_highest = value;
+
+  m_count++;
+  m_sum += value;
+  m_sumSquares += value * value;
+}
+
+double CHistogram::GetMean() const
+{
+  return m_count ? m_sum / m_count : 0.0;
+}
+
+double CHistogram::GetStdDev() const
+{
+  if (m_count < 2)
+    return 0.0;
+
+  double mean = GetMean();
+  double variance = m_sumSquares / m_count - mean * mean;
+  return variance > 0.0 ? sqrt(variance) : 0.0;
+}
+
+double CHistogram::GetPercentile(double percent) const
+{
+  if (m_count == 0)
+    return 0.0;
+
+  double rank = percent / 100.0 * m_count;
+  uint64_t seen = m_underflow;
+  if (rank <= seen && m_underflow)
+    return m_lowest;
+
+  for (size_t i = 0; i < m_buckets.size(); i++)
+  {
+    seen += m_buckets[i];
+    if (rank <= seen && m_buckets[i])
+      return std::min(m_min + (i + 1) * m_width, m_highest);
+  }
+  return m_highest;
+}
+
+void CHistogram::Serialize(CVariant &value) const
+{
+  value["min"] = m_min;
+  value["max"] = m_max;
+  value["bucketwidth"] = m_width;
+  value["buckets"] = CVariant(CVariant::VariantTypeArray);
+  for (auto count : m_buckets)
+    value["buckets"].push_back(count);
+  value["underflow"] = m_underflow;
+  value["overflow"] = m_overflow;
+  value["count"] = m_count;
+  value["mean"] = GetMean();
+  value["stddev"] = GetStdDev();
+  value["lowest"] = m_lowest;
+  value["highest"] = m_highest;
+  value["p50"] = GetPercentile(50.0);
+  value["p95"] = GetPercentile(95.0);
+  value["p99"] = GetPercentile(99.0);
+}
@@ -0,0 +1,70 @@
+#pragma once
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <stdint.h>
+#include <vector>
+
+class CVariant;
+
+/*!
+ \brief Histogram with fixed, equally sized buckets.
+
+ Adding a value is a few arithmetic operations and never allocates, so it
+ can be fed from playback threads. Values outside [min, max) are counted
+ as under- or overflow. Not thread safe, callers lock.
+ */
+class CHistogram
+{
+public:
+  CHistogram();
+  CHistogram(double min, double max, unsigned int buckets);
+
+  void Reset();
+  void Add(double value);
+
+  uint64_t GetCount() const { return m_count; }
+  double GetMean() const;
+  double GetStdDev() const;
+
+  /*!
+   \brief Estimate a percentile from the buckets.
+   \param percent in the range 0..100
+   \return the upper edge of the bucket holding the percentile, the observed
+   extreme if it is in under- or overflow
+   */
+  double GetPercentile(double percent) const;
+
+  void Serialize(CVariant &value) const;
+
+private:
+  double m_min;
+  double m_max;
+  double m_width;
+  std::vector<uint64_t> m_buckets;
+  uint64_t m_underflow;
+  uint64_t m_overflow;
+  uint64_t m_count;
+  double m_sum;
+  double m_sumSquares;
+  double m_lowest;
+  double m_highest;
+};
@@ -270,7 +270,7 @@ void CJobManager::StartWorkers(CJob::PRIORITY priority)
   CSingleLock lock(m_section);
 
   // check how many free threads we have
-  if (m_processing.size() >= GetMaxWorkers(priority))
+  if (GetBusyWorkers(priority) >= GetMaxWorkers(priority))
     return;
 
   // do we have any sleeping threads?
@@ -293,7 +293,7 @@ CJob *CJobManager::PopJob()
     if (priority == CJob::PRIORITY_LOW_PAUSABLE && m_pauseJobs)
       continue;
 
-    if (m_jobQueue[priority].size() && m_processing.size() < GetMaxWorkers(CJob::PRIORITY(priority)))
+    if (m_jobQueue[priority].size() && GetBusyWorkers(CJob::PRIORITY(priority)) < GetMaxWorkers(CJob::PRIORITY(priority)))
     {
       // pop the job off the queue
       CWorkItem job = m_jobQueue[priority].front();
@@ -432,8 +432,48 @@ void CJobManager::RemoveWorker(const CJobWorker *worker)
     m_workers.erase(i); // workers auto-delete
 }
 
-unsigned int CJobManager::GetMaxWorkers(CJob::PRIORITY priority)
+void CJobManager::RequestBackgroundWorkers(unsigned int workers)
+{
+  CSingleLock lock(m_section);
+  m_backgroundWorkers.insert(workers);
+}
+
+void CJobManager::ReleaseBackgroundWorkers(unsigned int workers)
+{
+  CSingleLock lock(m_section);
+  std::multiset<unsigned int>::iterator it = m_backgroundWorkers.find(workers);
+  if (it != m_backgroundWorkers.end())
+    m_backgroundWorkers.erase(it);
+}
+
+unsigned int CJobManager::GetDefaultMaxWorkers(CJob::PRIORITY priority)
 {
   static const unsigned int max_workers = 5;
   return max_workers - (CJob::PRIORITY_HIGH - priority);
 }
+
+unsigned int CJobManager::GetMaxWorkers(CJob::PRIORITY priority) const
+{
+  unsigned int workers = GetDefaultMaxWorkers(priority);
+  if (priority == CJob::PRIORITY_LOW_PAUSABLE && !m_backgroundWorkers.empty())
+    workers = std::max(workers, *m_backgroundWorkers.rbegin());
+  return workers;
+}
+
+unsigned int CJobManager::GetBusyWorkers(CJob::PRIORITY priority) const
+{
+  unsigned int busy = m_processing.size();
+  if (priority == CJob::PRIORITY_LOW_PAUSABLE)
+    return busy;
+
+  // pausable jobs above their default limit run on the requested extra
+  // workers, they don't take the spare workers of higher priorities
+  unsigned int pausable = std::count_if(m_processing.begin(), m_processing.end(), [](const CWorkItem &item)
+  {
+    return item.m_priority == CJob::PRIORITY_LOW_PAUSABLE;
+  });
+  unsigned int pausableLimit = GetDefaultMaxWorkers(CJob::PRIORITY_LOW_PAUSABLE);
+  if (pausable > pausableLimit)
+    busy -= pausable - pausableLimit;
+  return busy;
+}
@@ -20,6 +20,7 @@
  */
 
 #include <queue>
+#include <set>
 #include <vector>
 #include <string>
 #include "threads/CriticalSection.h"
@@ -290,6 +291,21 @@ public:
    */
   void UnPauseJobs();
 
+  /*!
+   \brief Allow more PRIORITY_LOW_PAUSABLE jobs to run at once, e.g. for batch media extraction.
+   The limits of the other priorities are unchanged, pausable jobs above the default limit don't
+   count against them. Holds until the matching ReleaseBackgroundWorkers.
+   \param workers the number of low priority pausable jobs that may run concurrently
+   \sa ReleaseBackgroundWorkers
+   */
+  void RequestBackgroundWorkers(unsigned int workers);
+
+  /*!
+   \brief Drop a request made with RequestBackgroundWorkers.
+   \param workers the value passed to RequestBackgroundWorkers
+   */
+  void ReleaseBackgroundWorkers(unsigned int workers);
+
   /*!
    \brief Checks to see if any jobs with specific priority are currently processing.
    \param priority to search for
@@ -342,7 +358,9 @@ private:
 
   void StartWorkers(CJob::PRIORITY priority);
   void RemoveWorker(const CJobWorker *worker);
-  static unsigned int GetMaxWorkers(CJob::PRIORITY priority);
+  static unsigned int GetDefaultMaxWorkers(CJob::PRIORITY priority);
+  unsigned int GetMaxWorkers(CJob::PRIORITY priority) const;
+  unsigned int GetBusyWorkers(CJob::PRIORITY priority) const;
 
   unsigned int m_jobCounter;
 
@@ -352,6 +370,7 @@ private:
 
   JobQueue   m_jobQueue[CJob::PRIORITY_HIGH+1];
   bool       m_pauseJobs;
+  std::multiset<unsigned int> m_backgroundWorkers;
   Processing m_processing;
   Workers    m_workers;
 
@@ -0,0 +1,64 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "utils/Histogram.h"
+#include "utils/Variant.h"
+
+#include "gtest/gtest.h"
+
+TEST(TestHistogram, Buckets)
+{
+  CHistogram histogram(-10.0, 10.0, 20);
+  histogram.Add(-20.0);
+  histogram.Add(-10.0);
+  histogram.Add(0.5);
+  histogram.Add(9.9);
+  histogram.Add(10.0);
+
+  CVariant value;
+  histogram.Serialize(value);
+  EXPECT_EQ(20u, value["buckets"].size());
+  EXPECT_EQ(1u, value["buckets"][0].asUnsignedInteger());
+  EXPECT_EQ(1u, value["buckets"][10].asUnsignedInteger());
+  EXPECT_EQ(1u, value["buckets"][19].asUnsignedInteger());
+  EXPECT_EQ(1u, value["underflow"].asUnsignedInteger());
+  EXPECT_EQ(1u, value["overflow"].asUnsignedInteger());
+  EXPECT_EQ(5u, histogram.GetCount());
+  EXPECT_DOUBLE_EQ(-20.0, value["lowest"].asDouble());
+  EXPECT_DOUBLE_EQ(10.0, value["highest"].asDouble());
+}
+
+TEST(TestHistogram, Statistics)
+{
+  CHistogram histogram(0.0, 100.0, 100);
+  for (int i = 0; i < 100; i++)
+    histogram.Add(i + 0.5);
+
+  EXPECT_DOUBLE_EQ(50.0, histogram.GetMean());
+  EXPECT_NEAR(28.87, histogram.GetStdDev(), 0.01);
+  EXPECT_DOUBLE_EQ(50.0, histogram.GetPercentile(50.0));
+  EXPECT_DOUBLE_EQ(95.0, histogram.GetPercentile(95.0));
+  EXPECT_DOUBLE_EQ(99.5, histogram.GetPercentile(100.0));
+
+  histogram.Reset();
+  EXPECT_EQ(0u, histogram.GetCount());
+  EXPECT_DOUBLE_EQ(0.0, histogram.GetPercentile(50.0));
+}
@@ -22,6 +22,10 @@
 #include "settings/Settings.h"
 #include "utils/SystemInfo.h"
 
+#ifdef TARGET_POSIX
+#include "linux/XTimeUtils.h"
+#endif
+
 #include "gtest/gtest.h"
 
 /* CSysInfoJob::GetInternetState() will test for network connectivity. */
@@ -177,3 +181,59 @@ TEST_F(TestJobManager, IsProcessing)
 
   job->FinishAndStopBlocking();
 }
+
+namespace
+{
+// outlives the jobs, the fixture only cancels them after the test
+CEvent blockingJobRelease(true);
+
+class BlockingJob : public CJob
+{
+public:
+  const char *GetType() const { return "BlockingJob"; }
+
+  bool DoWork()
+  {
+    blockingJobRelease.Wait();
+    return true;
+  }
+};
+
+int AddBlockingJobs(int count, CJob::PRIORITY priority)
+{
+  // one at a time, a new worker is only created when all others are busy
+  for (int i = 0; i < count; i++)
+  {
+    int running = CJobManager::GetInstance().IsProcessing("BlockingJob");
+    CJobManager::GetInstance().AddJob(new BlockingJob(), NULL, priority);
+    for (int wait = 0; wait < 50 && CJobManager::GetInstance().IsProcessing("BlockingJob") == running; wait++)
+      Sleep(10);
+  }
+  return CJobManager::GetInstance().IsProcessing("BlockingJob");
+}
+}
+
+TEST_F(TestJobManager, BackgroundWorkers)
+{
+  blockingJobRelease.Reset();
+  CJobManager::GetInstance().RequestBackgroundWorkers(4);
+
+  EXPECT_EQ(4, AddBlockingJobs(6, CJob::PRIORITY_LOW_PAUSABLE));
+
+  // higher priorities keep their spare worker
+  EXPECT_EQ(5, AddBlockingJobs(1, CJob::PRIORITY_LOW));
+
+  blockingJobRelease.Set();
+  CJobManager::GetInstance().ReleaseBackgroundWorkers(4);
+}
+
+TEST_F(TestJobManager, BackgroundWorkersDontRaiseOtherPriorities)
+{
+  blockingJobRelease.Reset();
+  CJobManager::GetInstance().RequestBackgroundWorkers(6);
+
+  EXPECT_EQ(3, AddBlockingJobs(5, CJob::PRIORITY_LOW));
+
+  blockingJobRelease.Set();
+  CJobManager::GetInstance().ReleaseBackgroundWorkers(6);
+}
@@ -54,7 +54,8 @@
 #include "linux/XTimeUtils.h"
 #endif
 
-CVideoReferenceClock::CVideoReferenceClock() : CThread("RefClock")
+CVideoReferenceClock::CVideoReferenceClock() : CThread("RefClock"),
+  m_VblankJitter(-4.0, 4.0, 80)
 {
   m_SystemFrequency = CurrentHostFrequency();
   m_ClockSpeed = 1.0;
@@ -68,6 +69,7 @@ CVideoReferenceClock::CVideoReferenceClock() : CThread("RefClock")
   m_RefreshRate = 0.0;
   m_MissedVblanks = 0;
   m_VblankTime = 0;
+  m_LastVblankCallback = 0;
 
   m_pVideoSync = nullptr;
 
@@ -90,6 +92,13 @@ void CVideoReferenceClock::CBUpdateClock(int NrVBlanks, uint64_t time, CVideoRef
 {
   {
     CSingleLock lock(clock->m_CritSection);
+    if (clock->m_LastVblankCallback && NrVBlanks > 0 && clock->m_RefreshRate > 0.0)
+    {
+      double interval = static_cast<double>(time - clock->m_LastVblankCallback);
+      double expected = NrVBlanks * clock->m_SystemFrequency / clock->m_RefreshRate;
+      clock->m_VblankJitter.Add((interval - expected) * 1000.0 / clock->m_SystemFrequency);
+    }
+    clock->m_LastVblankCallback = time;
     clock->m_VblankTime = time;
     clock->UpdateClock(NrVBlanks, true);
   }
@@ -141,6 +150,8 @@ void CVideoReferenceClock::Process()
     m_ClockSpeed = 1.0;
     m_TotalMissedVblanks = 0;
     m_MissedVblanks = 0;
+    m_LastVblankCallback = 0;
+    m_VblankJitter.Reset();
 
     if (SetupSuccess)
     {
@@ -330,3 +341,15 @@ bool CVideoReferenceClock::GetClockInfo(int& MissedVblanks, double& ClockSpeed,
   }
   return false;
 }
+
+//for playback telemetry
+bool CVideoReferenceClock::GetVblankJitter(CHistogram& Jitter)
+{
+  CSingleLock SingleLock(m_CritSection);
+  if (m_UseVblank)
+  {
+    Jitter = m_VblankJitter;
+    return true;
+  }
+  return false;
+}
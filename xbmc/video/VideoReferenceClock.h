@@ -21,6 +21,7 @@
 
 #include "threads/Thread.h"
 #include "threads/CriticalSection.h"
+#include "utils/Histogram.h"
 
 class CVideoSync;
 
@@ -35,6 +36,7 @@ class CVideoReferenceClock : public CThread
     double  GetSpeed();
     double  GetRefreshRate(double* interval = nullptr);
     bool    GetClockInfo(int& MissedVblanks, double& ClockSpeed, double& RefreshRate) const;
+    bool    GetVblankJitter(CHistogram& Jitter);
 
   private:
     void    Process() override;
@@ -57,6 +59,8 @@ class CVideoReferenceClock : public CThread
     int     m_MissedVblanks;     //number of clock updates missed by the vblank clock
     int     m_TotalMissedVblanks;//total number of clock updates missed, used by codec information screen
     int64_t m_VblankTime;        //last time the clock was updated when using vblank as clock
+    int64_t m_LastVblankCallback;//time of the previous vblank reported by the video sync
+    CHistogram m_VblankJitter;   //deviation of the vblank intervals from the refreshrate in ms
 
     CCriticalSection m_CritSection;
 
@@ -23,6 +23,7 @@
 #include <cstdlib>
 #include <utility>
 
+#include "cores/VideoPlayer/DVDExtractorPool.h"
 #include "cores/VideoPlayer/DVDFileInfo.h"
 #include "FileItem.h"
 #include "filesystem/DirectoryCache.h"
@@ -180,14 +181,17 @@ bool CThumbExtractor::DoWork()
 }
 
 CVideoThumbLoader::CVideoThumbLoader() :
-  CThumbLoader(), CJobQueue(true, 1, CJob::PRIORITY_LOW_PAUSABLE)
+  CThumbLoader(), CJobQueue(true, CDVDExtractorPool::GetThreadCount(), CJob::PRIORITY_LOW_PAUSABLE)
 {
   m_videoDatabase = new CVideoDatabase();
+  m_extractionThreads = CDVDExtractorPool::GetThreadCount();
+  CJobManager::GetInstance().RequestBackgroundWorkers(m_extractionThreads);
 }
 
 CVideoThumbLoader::~CVideoThumbLoader()
 {
   StopThread();
+  CJobManager::GetInstance().ReleaseBackgroundWorkers(m_extractionThreads);
   delete m_videoDatabase;
 }
 
@@ -577,6 +581,10 @@ void CVideoThumbLoader::OnJobComplete(unsigned int jobID, bool success, CJob* jo
     g_windowManager.SendThreadMessage(msg);
   }
   CJobQueue::OnJobComplete(jobID, success, job);
+
+  // batch is done, release the pooled decoders
+  if (!IsProcessing())
+    CDVDExtractorPool::GetInstance().Trim();
 }
 
 void CVideoThumbLoader::DetectAndAddMissingItemData(CFileItem &item)
@@ -127,6 +127,7 @@ public:
 
 protected:
   CVideoDatabase *m_videoDatabase;
+  unsigned int m_extractionThreads; ///< background workers requested from the job manager
   typedef std::map<int, std::map<std::string, std::string> > ArtCache;
   ArtCache m_showArt;
   ArtCache m_seasonArt;
@@ -155,6 +155,9 @@ void CGUIWindowDebugInfo::Process(unsigned int currentTime, CDirtyRegionList &di
       if (control)
         info += StringUtils::Format("Focused: %i (%s)", control->GetID(), CGUIControlFactory::TranslateControlType(control->GetControlType()).c_str());
     }
+    unsigned int evaluated, skipped;
+    g_infoManager.GetBoolStats(evaluated, skipped);
+    info += StringUtils::Format("\nInfobools: %u evaluated, %u skipped", evaluated, skipped);
   }
 
   float w, h;